@@ -0,0 +1,138 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * Benchmark.cpp
+ *
+ * Frame time statistics for benchmark mode. Implementation of the CBenchmark
+ * class.
+ *
+ * Report Format
+ * -------------
+ *
+ *    {
+ *      "game": "scud",
+ *      "frames": 3600,
+ *      "totalSeconds": 12.345,
+ *      "fps": 291.6,
+ *      "ppcTicks": { "mean": ..., "p50": ..., "p90": ..., "p99": ..., "max": ... },
+ *      ...
+ *      "wallMicroseconds": { ... }
+ *    }
+ *
+ * The *Ticks entries are the emulator's own subsystem timings (FrameTimings,
+ * in milliseconds). wallMicroseconds is the wall clock time of each frame as
+ * measured by the main loop, including input polling and buffer swaps.
+ * Percentiles use the nearest-rank method.
+ */
+
+#include "Supermodel.h"
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+
+static double Percentile(const std::vector<double> &sorted, double p)
+{
+  if (sorted.empty())
+    return 0;
+  size_t rank = size_t(std::ceil(p / 100.0 * double(sorted.size())));
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+bool CBenchmark::IsEnabled(void) const
+{
+  return m_numFrames > 0;
+}
+
+bool CBenchmark::IsFinished(void) const
+{
+  return m_framesDone >= m_numFrames;
+}
+
+void CBenchmark::AddFrame(const FrameTimings &timings, double frameMicroseconds)
+{
+  m_series[SERIES_PPC].samples.push_back(timings.ppcTicks);
+  m_series[SERIES_SYNC].samples.push_back(timings.syncTicks);
+  m_series[SERIES_RENDER].samples.push_back(timings.renderTicks);
+  m_series[SERIES_SOUND].samples.push_back(timings.sndTicks);
+  m_series[SERIES_DRIVE].samples.push_back(timings.drvTicks);
+  m_series[SERIES_FRAME].samples.push_back(timings.frameTicks);
+  m_series[SERIES_WALL].samples.push_back(frameMicroseconds);
+  m_framesDone++;
+}
+
+bool CBenchmark::WriteReport(const std::string &gameName) const
+{
+  FILE *fp = stdout;
+  if (!m_outputFile.empty())
+  {
+    fp = fopen(m_outputFile.c_str(), "w");
+    if (NULL == fp)
+      return ErrorLog("Unable to write benchmark report to '%s'.", m_outputFile.c_str());
+  }
+
+  const std::vector<double> &wall = m_series[SERIES_WALL].samples;
+  double totalSeconds = 0;
+  for (double t: wall)
+    totalSeconds += t / 1e6;
+
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"game\": \"%s\",\n", gameName.c_str());
+  fprintf(fp, "  \"frames\": %u,\n", m_framesDone);
+  fprintf(fp, "  \"totalSeconds\": %.3f,\n", totalSeconds);
+  fprintf(fp, "  \"fps\": %.1f", totalSeconds > 0 ? double(m_framesDone) / totalSeconds : 0.0);
+  for (auto &series: m_series)
+  {
+    std::vector<double> sorted(series.samples);
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0;
+    for (double t: sorted)
+      mean += t;
+    mean = sorted.empty() ? 0 : mean / double(sorted.size());
+    fprintf(fp, ",\n  \"%s\": { \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f }",
+      series.name, mean, Percentile(sorted, 50), Percentile(sorted, 90), Percentile(sorted, 99), sorted.empty() ? 0.0 : sorted.back());
+  }
+  fprintf(fp, "\n}\n");
+
+  bool error = ferror(fp) != 0;
+  if (fp != stdout)
+    error |= fclose(fp) != 0;
+  else
+    fflush(fp);
+  if (error)
+    return ErrorLog("Unable to write benchmark report to '%s'.", m_outputFile.c_str());
+  InfoLog("Benchmark: %u frames in %.3f seconds.", m_framesDone, totalSeconds);
+  return OKAY;
+}
+
+CBenchmark::CBenchmark(const Util::Config::Node &config)
+  : m_numFrames(config["Benchmark"].ValueAsDefault<unsigned>(0)),
+    m_framesDone(0),
+    m_outputFile(config["BenchmarkOutput"].ValueAsDefault<std::string>(""))
+{
+  static const char *names[NUM_SERIES] = { "ppcTicks", "syncTicks", "renderTicks", "sndTicks", "drvTicks", "frameTicks", "wallMicroseconds" };
+  for (int i = 0; i < NUM_SERIES; i++)
+  {
+    m_series[i].name = names[i];
+    m_series[i].samples.reserve(m_numFrames);
+  }
+}
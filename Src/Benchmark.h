@@ -0,0 +1,123 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * Benchmark.h
+ *
+ * Header file for the frame time statistics collected in benchmark mode.
+ */
+
+#ifndef INCLUDED_BENCHMARK_H
+#define INCLUDED_BENCHMARK_H
+
+#include "Util/NewConfig.h"
+#include <string>
+#include <vector>
+
+struct FrameTimings;
+
+/*
+ * CBenchmark:
+ *
+ * Collects per-frame timings over a fixed number of frames and reports
+ * percentiles of each as JSON. Benchmark mode is enabled by a non-zero
+ * Benchmark setting (the number of frames to run). The report is written to
+ * the file named by BenchmarkOutput, or to stdout if it is empty.
+ */
+class CBenchmark
+{
+public:
+  /*
+   * IsEnabled(void):
+   *
+   * Returns:
+   *    True if benchmark mode is enabled.
+   */
+  bool IsEnabled(void) const;
+
+  /*
+   * IsFinished(void):
+   *
+   * Returns:
+   *    True once all frames have been recorded.
+   */
+  bool IsFinished(void) const;
+
+  /*
+   * AddFrame(timings, frameMicroseconds):
+   *
+   * Records an emulated frame.
+   *
+   * Parameters:
+   *    timings             Emulator subsystem timings for the frame (ms).
+   *    frameMicroseconds   Wall clock time taken by the whole frame.
+   */
+  void AddFrame(const FrameTimings &timings, double frameMicroseconds);
+
+  /*
+   * WriteReport(gameName):
+   *
+   * Writes the JSON report for the frames recorded so far.
+   *
+   * Parameters:
+   *    gameName  ROM set name, included in the report.
+   *
+   * Returns:
+   *    OKAY if successful, FAIL if the output file could not be written.
+   */
+  bool WriteReport(const std::string &gameName) const;
+
+  /*
+   * CBenchmark(config):
+   *
+   * Constructor. Reads Benchmark and BenchmarkOutput from the config.
+   */
+  CBenchmark(const Util::Config::Node &config);
+
+private:
+  // One series of samples per reported quantity
+  struct Series
+  {
+    const char          *name;
+    std::vector<double> samples;
+  };
+
+  enum
+  {
+    SERIES_PPC = 0,
+    SERIES_SYNC,
+    SERIES_RENDER,
+    SERIES_SOUND,
+    SERIES_DRIVE,
+    SERIES_FRAME,
+    SERIES_WALL,
+    NUM_SERIES
+  };
+
+  unsigned    m_numFrames;    // frames to run (0 if disabled)
+  unsigned    m_framesDone;
+  std::string m_outputFile;
+  Series      m_series[NUM_SERIES];
+};
+
+
+#endif  // INCLUDED_BENCHMARK_H
@@ -29,6 +29,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdint>
+#include <zlib.h>
 #include "Supermodel.h"
 
 
@@ -38,85 +39,65 @@
 
 void CBlockFile::ReadString(std::string *str, uint32_t length)
 {
-  if (NULL == fp)
+  if (NULL == readData)
     return;
   str->clear();
-  //TODO: use fstream to get rid of this ugly hack
-  bool keep_loading = true;
-  for (size_t i = 0; i < length; i++)
-  {
-    char c;
-    fread(&c, sizeof(char), 1, fp);
-    if (keep_loading)
-    {
-      if (!c)
-        keep_loading = false;
-      else
-        *str += c;
-    }
-  }
+  size_t available = filePos < fileSize ? fileSize - filePos : 0;
+  size_t n = length < available ? length : available;
+  const char *s = reinterpret_cast<const char *>(&readData[filePos]);
+  str->assign(s, strnlen(s, n));
+  filePos += length;
 }
 
 unsigned CBlockFile::ReadBytes(void *data, uint32_t numBytes)
 {
-  if (NULL == fp)
+  if (NULL == readData || filePos >= fileSize)
     return 0;
-  return fread(data, sizeof(uint8_t), numBytes, fp);
+  size_t available = fileSize - filePos;
+  size_t n = numBytes < available ? numBytes : available;
+  memcpy(data, &readData[filePos], n);
+  filePos += n;
+  return unsigned(n);
 }
 
 unsigned CBlockFile::ReadDWord(uint32_t *data)
 {
-  if (NULL == fp)
+  if (NULL == readData)
     return 0;
-  fread(data, sizeof(uint32_t), 1, fp);
+  ReadBytes(data, sizeof(uint32_t));
   return 4;
 }
   
 void CBlockFile::UpdateBlockSize(void)
 {
-  long int  curPos;
-  unsigned  newBlockSize;
-  
-  if (NULL == fp)
-    return;
-  curPos = ftell(fp);       // save current file position
-  fseek(fp, blockStartPos, SEEK_SET);
-  newBlockSize = curPos - blockStartPos;
-  fwrite(&newBlockSize, sizeof(uint32_t), 1, fp);
-  fseek(fp, curPos, SEEK_SET);  // go back
-}
-
-void CBlockFile::WriteByte(uint8_t data)
-{
-  if (NULL == fp)
+  if (NULL == writeBuffer)
     return;
-  fwrite(&data, sizeof(uint8_t), 1, fp);
-  UpdateBlockSize();
+  uint32_t newBlockSize = uint32_t(filePos - blockStartPos);
+  memcpy(&(*writeBuffer)[blockStartPos], &newBlockSize, sizeof(uint32_t));
 }
 
 void CBlockFile::WriteDWord(uint32_t data)
 {
-  if (NULL == fp)
-    return;
-  fwrite(&data, sizeof(uint32_t), 1, fp);
-  UpdateBlockSize();
+  WriteBytes(&data, sizeof(uint32_t));
 }
 
 void CBlockFile::WriteBytes(const void *data, uint32_t numBytes)
 {
-  if (NULL == fp)
+  if (NULL == writeBuffer)
     return;
-  fwrite(data, sizeof(uint8_t), numBytes, fp);
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+  writeBuffer->insert(writeBuffer->end(), bytes, bytes + numBytes);
+  filePos += numBytes;
   UpdateBlockSize();
 }
 
 void CBlockFile::WriteBlockHeader(const std::string &name, const std::string &comment)
 {
-  if (NULL == fp)
+  if (NULL == writeBuffer)
     return;
   
   // Record current block starting position
-  blockStartPos = ftell(fp);
+  blockStartPos = filePos;
 
   // Write the total block length field
   WriteDWord(0);  // will be automatically updated as we write the file
@@ -128,14 +109,16 @@ void CBlockFile::WriteBlockHeader(const std::string &name, const std::string &co
   Write(comment);
   
   // Record the start of the current data section
-  dataStartPos = ftell(fp);
+  dataStartPos = filePos;
 } 
 
 
 /******************************************************************************
  Block Format Container File Implementation
  
- Files are just a consecutive array of blocks that must be searched.
+ Files are just a consecutive array of blocks. When a file is loaded, the
+ block headers are walked once to build an index of block names, which
+ FindBlock() then uses.
  
  Block Format
  ------------
@@ -146,8 +129,44 @@ void CBlockFile::WriteBlockHeader(const std::string &name, const std::string &co
  name     ...     Name string (null-terminated, up to 1025 bytes).
  comment    ...     Comment string (same as above).
  data     ...     Raw data (blockLength - total header size).
+
+ Compressed Format
+ -----------------
+ magic      (16 bytes)  "Supermodel BlkZ" (null-terminated).
+ version    (uint32_t)  Compressed format version.
+ numBlocks  (uint32_t)  Number of blocks.
+ blocks     ...         Each block (header and data, exactly as above)
+                        deflated separately, in their original order.
+ index      ...         For each block: file offset of compressed data
+                        (uint64_t), compressed size (uint32_t), uncompressed
+                        size (uint32_t), name length (uint32_t), and name.
+ indexPos   (uint64_t)  File offset of index.
+
+ Compressed files are expanded back into the uncompressed layout when loaded,
+ and their index is used in place of the one built from the block headers.
 ******************************************************************************/
 
+static const char     COMPRESSED_MAGIC[16] = "Supermodel BlkZ";
+static const uint32_t COMPRESSED_VERSION = 1;
+
+// Little helpers for reading and writing the compressed format
+template <typename T>
+static void Append(std::vector<uint8_t> *buffer, T value)
+{
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+  buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static bool Extract(T *value, const std::vector<uint8_t> &buffer, size_t *pos)
+{
+  if (*pos > buffer.size() || buffer.size() - *pos < sizeof(T))
+    return false;
+  memcpy(value, &buffer[*pos], sizeof(T));
+  *pos += sizeof(T);
+  return true;
+}
+
 unsigned CBlockFile::Read(void *data, uint32_t numBytes)
 {
   if (mode == 'r')
@@ -188,51 +207,65 @@ void CBlockFile::NewBlock(const std::string &name, const std::string &comment)
     WriteBlockHeader(name, comment);
 }
 
+void CBlockFile::BuildIndex(void)
+{
+  // Walk the chain of block headers once. If names repeat, the first block
+  // wins.
+  blockIndex.clear();
+  size_t curPos = 0;
+  while (curPos < fileSize && fileSize - curPos >= 12)
+  {
+    uint32_t block_length = 0;
+    uint32_t name_length = 0;
+    memcpy(&block_length, &readData[curPos + 0], sizeof(uint32_t));
+    memcpy(&name_length, &readData[curPos + 4], sizeof(uint32_t));
+    size_t available = fileSize - curPos - 12;
+    const char *name = reinterpret_cast<const char *>(&readData[curPos + 12]);
+    blockIndex.emplace(std::string(name, strnlen(name, name_length < available ? name_length : available)), curPos);
+    if (block_length == 0)  // this would never advance
+      break;
+    curPos += block_length;
+  }
+}
+
 bool CBlockFile::FindBlock(const std::string &name)
 {
   if (mode != 'r')
     return FAIL;
     
-  fseek(fp, 0, SEEK_SET);
-  
-  long int  curPos = 0;
-  while (curPos < fileSize)
-  {
-    blockStartPos = curPos;
-    
-    // Read header
-    uint32_t block_length;
-    uint32_t name_length;
-    uint32_t comment_length;
-    curPos += ReadDWord(&block_length);
-    curPos += ReadDWord(&name_length);
-    curPos += ReadDWord(&comment_length);
-    std::string block_name;
-    ReadString(&block_name, name_length);
-    
-    // Is this the block we want?
-    if (block_name == name)
-    {
-      fseek(fp, blockStartPos + 12 + name_length + comment_length, SEEK_SET); // move to beginning of data
-      dataStartPos = ftell(fp);
-      return OKAY;
-    }
+  auto it = blockIndex.find(name);
+  if (it == blockIndex.end())
+    return FAIL;
     
-    // Move to next block
-    fseek(fp, blockStartPos + block_length, SEEK_SET);
-    curPos = blockStartPos + block_length;
-    if (block_length == 0)  // this would never advance
-      break;
-  }
-  
-  return FAIL;
+  // Move to beginning of data
+  uint32_t name_length = 0;
+  uint32_t comment_length = 0;
+  blockStartPos = it->second;
+  filePos = blockStartPos + 4;
+  ReadDWord(&name_length);
+  ReadDWord(&comment_length);
+  filePos = blockStartPos + 12 + name_length + comment_length;
+  dataStartPos = filePos;
+  return OKAY;
 }
 
 bool CBlockFile::Create(const std::string &file, const std::string &headerName, const std::string &comment)
 {
+  Close();
   fp = fopen(file.c_str(), "wb");
   if (NULL == fp)
     return FAIL;
+  fileBuffer.clear();
+  return Create(&fileBuffer, headerName, comment);
+}
+
+bool CBlockFile::Create(std::vector<uint8_t> *buffer, const std::string &headerName, const std::string &comment)
+{
+  if (buffer != &fileBuffer)
+    Close();
+  buffer->clear();
+  writeBuffer = buffer;
+  filePos = 0;
   mode = 'w';
   WriteBlockHeader(headerName, comment);
   return OKAY;
@@ -240,39 +273,202 @@ bool CBlockFile::Create(const std::string &file, const std::string &headerName,
   
 bool CBlockFile::Load(const std::string &file)
 {
-  fp = fopen(file.c_str(), "rb");
-  if (NULL == fp)
+  Close();
+  FILE *in = fopen(file.c_str(), "rb");
+  if (NULL == in)
     return FAIL;
-  mode = 'r';
   
   // TODO: is this a valid block file?
   
-  // Get the file size
-  fseek(fp, 0, SEEK_END);
-  fileSize = ftell(fp);
-  fseek(fp, 0, SEEK_SET);
+  // Read in the whole file
+  fseek(in, 0, SEEK_END);
+  long size = ftell(in);
+  fseek(in, 0, SEEK_SET);
+  fileBuffer.resize(size > 0 ? size_t(size) : 0);
+  size_t bytesRead = fileBuffer.empty() ? 0 : fread(fileBuffer.data(), 1, fileBuffer.size(), in);
+  fclose(in);
+  fileBuffer.resize(bytesRead);
+  
+  // Expand compressed files
+  if (bytesRead >= sizeof(COMPRESSED_MAGIC) && !memcmp(fileBuffer.data(), COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC)))
+  {
+    std::vector<uint8_t> compressed;
+    compressed.swap(fileBuffer);
+    if (!Decompress(compressed))
+    {
+      Close();
+      return FAIL;
+    }
+  }
+  return Load(fileBuffer.data(), fileBuffer.size());
+}
+
+bool CBlockFile::Decompress(const std::vector<uint8_t> &file)
+{
+  fileBuffer.clear();
+  blockIndex.clear();
+  
+  // Header and location of index
+  size_t pos = sizeof(COMPRESSED_MAGIC);
+  uint32_t version = 0;
+  uint32_t numBlocks = 0;
+  uint64_t indexPos = 0;
+  size_t trailerPos = file.size() - sizeof(indexPos);
+  if (!Extract(&version, file, &pos) || !Extract(&numBlocks, file, &pos) || version != COMPRESSED_VERSION)
+    return false;
+  if (file.size() < pos + sizeof(indexPos) || !Extract(&indexPos, file, &trailerPos) || indexPos > file.size())
+    return false;
+  
+  // Inflate each block listed in the index
+  pos = size_t(indexPos);
+  for (uint32_t i = 0; i < numBlocks; i++)
+  {
+    uint64_t offset = 0;
+    uint32_t compressedSize = 0;
+    uint32_t size = 0;
+    uint32_t nameLength = 0;
+    if (!Extract(&offset, file, &pos) || !Extract(&compressedSize, file, &pos) || !Extract(&size, file, &pos) || !Extract(&nameLength, file, &pos))
+      return false;
+    if (nameLength > file.size() - pos || offset > indexPos || compressedSize > indexPos - offset)
+      return false;
+    const char *name = reinterpret_cast<const char *>(&file[pos]);
+    pos += nameLength;
+    
+    size_t blockPos = fileBuffer.size();
+    fileBuffer.resize(blockPos + size);
+    uLongf inflatedSize = size;
+    if (Z_OK != uncompress(&fileBuffer[blockPos], &inflatedSize, &file[size_t(offset)], compressedSize) || inflatedSize != size)
+      return false;
+    blockIndex.emplace(std::string(name, strnlen(name, nameLength)), blockPos); // first block of a given name wins, as when scanning
+  }
+  return true;
+}
+
+bool CBlockFile::WriteCompressed(const std::string &file, const uint8_t *data, size_t size)
+{
+  struct IndexEntry
+  {
+    uint64_t    offset;
+    uint32_t    compressedSize;
+    uint32_t    size;
+    std::string name;
+  };
+  std::vector<IndexEntry> index;
+  
+  // Header
+  std::vector<uint8_t> out;
+  out.insert(out.end(), COMPRESSED_MAGIC, COMPRESSED_MAGIC + sizeof(COMPRESSED_MAGIC));
+  Append<uint32_t>(&out, COMPRESSED_VERSION);
+  Append<uint32_t>(&out, 0);  // number of blocks, filled in below
   
+  // Deflate each block
+  size_t pos = 0;
+  while (pos < size)
+  {
+    uint32_t blockLength = 0;
+    uint32_t nameLength = 0;
+    if (size - pos < 12)
+      return FAIL;
+    memcpy(&blockLength, &data[pos + 0], sizeof(uint32_t));
+    memcpy(&nameLength, &data[pos + 4], sizeof(uint32_t));
+    if (blockLength < 12 || blockLength > size - pos || nameLength > blockLength - 12)
+      return FAIL;
+    const char *name = reinterpret_cast<const char *>(&data[pos + 12]);
+    
+    IndexEntry entry;
+    entry.offset = out.size();
+    entry.size = blockLength;
+    entry.name.assign(name, strnlen(name, nameLength));
+    uLongf compressedSize = compressBound(blockLength);
+    out.resize(size_t(entry.offset) + compressedSize);
+    if (Z_OK != compress2(&out[size_t(entry.offset)], &compressedSize, &data[pos], blockLength, Z_BEST_SPEED))
+      return FAIL;
+    out.resize(size_t(entry.offset) + compressedSize);
+    entry.compressedSize = uint32_t(compressedSize);
+    index.push_back(entry);
+    pos += blockLength;
+  }
+  uint32_t numBlocks = uint32_t(index.size());
+  memcpy(&out[sizeof(COMPRESSED_MAGIC) + 4], &numBlocks, sizeof(numBlocks));
+  
+  // Index goes at the end, followed by its position
+  uint64_t indexPos = out.size();
+  for (auto &entry: index)
+  {
+    Append<uint64_t>(&out, entry.offset);
+    Append<uint32_t>(&out, entry.compressedSize);
+    Append<uint32_t>(&out, entry.size);
+    Append<uint32_t>(&out, uint32_t(entry.name.size() + 1));
+    out.insert(out.end(), entry.name.c_str(), entry.name.c_str() + entry.name.size() + 1);
+  }
+  Append<uint64_t>(&out, indexPos);
+  
+  // Write to a temporary file first so that a failed write does not destroy
+  // the previous file
+  std::string tempFile = file + ".tmp";
+  FILE *out_fp = fopen(tempFile.c_str(), "wb");
+  if (NULL == out_fp)
+    return FAIL;
+  bool error = fwrite(out.data(), 1, out.size(), out_fp) != out.size();
+  error |= fclose(out_fp) != 0;
+  if (!error)
+  {
+    remove(file.c_str()); // rename() will not replace an existing file on Windows
+    error = rename(tempFile.c_str(), file.c_str()) != 0;
+  }
+  if (error)
+  {
+    remove(tempFile.c_str());
+    return FAIL;
+  }
+  return OKAY;
+}
+
+bool CBlockFile::Load(const uint8_t *data, size_t size)
+{
+  if (data != fileBuffer.data())
+    Close();
+  readData = data;
+  fileSize = size;
+  filePos = 0;
+  mode = 'r';
+  if (blockIndex.empty())   // compressed files come with an index
+    BuildIndex();
   return OKAY;
 }
   
 void CBlockFile::Close(void)
 {
   if (fp != NULL)
+  {
+    if (!fileBuffer.empty())
+      fwrite(fileBuffer.data(), 1, fileBuffer.size(), fp);
     fclose(fp);
+  }
   fp = NULL;
+  fileBuffer.clear();
+  fileBuffer.shrink_to_fit();
+  writeBuffer = NULL;
+  readData = NULL;
+  fileSize = 0;
+  filePos = 0;
   mode = 0;
+  blockIndex.clear();
 }
 
 CBlockFile::CBlockFile(void)
 {
   fp = NULL;
+  writeBuffer = NULL;
+  readData = NULL;
+  fileSize = 0;
+  filePos = 0;
+  blockStartPos = 0;
+  dataStartPos = 0;
   mode = 0;   // neither reading nor writing (do nothing)
 }
 
 CBlockFile::~CBlockFile(void)
 {
-  if (fp != NULL) // in case user forgot
-    fclose(fp);
-  fp = NULL;
-  mode = 0;
+  Close();  // in case user forgot
 }
@@ -29,7 +29,10 @@
 #define INCLUDED_BLOCKFILE_H
 
 #include <cstdint>
+#include <cstdio>
+#include <map>
 #include <string>
+#include <vector>
 
 /*
  * CBlockFile:
@@ -40,6 +43,15 @@
  * All strings (comments and names) will be truncated to 1024 bytes, not
  * including the null terminator.
  *
+ * Block files are assembled and parsed in memory. Files are read in whole by
+ * Load() and written out in one go by Close(). Alternatively, a block file can
+ * be created in or loaded from a caller-supplied buffer, which allows states
+ * to be snapshotted without touching the disk.
+ *
+ * A finished block file may also be stored compressed with WriteCompressed().
+ * Each block is deflated separately and an index of block names and offsets
+ * is appended to the end of the file. Load() recognizes both formats.
+ *
  * Members do not generate any output messages.
  */
 class CBlockFile
@@ -76,8 +88,9 @@ public:
   /*
    * FindBlock(name):
    *
-   * Scans the file for a block with the given name string. When it is found,
-   * the file pointer is set to the beginning of the data region.
+   * Looks up a block with the given name string in the index built when the
+   * file was loaded. When it is found, the file pointer is set to the
+   * beginning of the data region.
    *
    * Parameters:
    *    name  Name of block to locate.
@@ -151,6 +164,24 @@ public:
    */
   bool Create(const std::string &file, const std::string &headerName, const std::string &comment);
 
+  /*
+   * Create(buffer, headerName, comment):
+   *
+   * Same as above but the block file is written to a buffer owned by the
+   * caller, which is cleared first (its capacity is retained, so reusing a
+   * buffer avoids reallocation). The buffer is complete once Close() is
+   * called and must remain valid until then.
+   *
+   * Parameters:
+   *    buffer      Buffer to write to.
+   *    headerName  Block name for header. Must be unique and not NULL.
+   *    comment     Comment string that will be embedded into file header.
+   *
+   * Returns:
+   *    Always OKAY.
+   */
+  bool Create(std::vector<uint8_t> *buffer, const std::string &headerName, const std::string &comment);
+
   /*
    * Load(file):
    *
@@ -167,10 +198,46 @@ public:
    */
   bool Load(const std::string &file);
 
+  /*
+   * Load(data, size):
+   *
+   * Opens a block file held in memory for reading. The data is not copied and
+   * must remain valid until Close() is called.
+   *
+   * Parameters:
+   *    data  Block file contents.
+   *    size  Size of block file in bytes.
+   *
+   * Returns:
+   *    OKAY.
+   */
+  bool Load(const uint8_t *data, size_t size);
+
+  /*
+   * WriteCompressed(file, data, size):
+   *
+   * Writes a complete block file (e.g., one produced in memory by Create())
+   * to disk in compressed form. The file is written under a temporary name
+   * and then renamed so that an existing file is only replaced once the new
+   * one is complete. This function does not touch any CBlockFile object and
+   * may be called from any thread.
+   *
+   * Parameters:
+   *    file  File path.
+   *    data  Block file contents.
+   *    size  Size of block file in bytes.
+   *
+   * Returns:
+   *    OKAY if successful, FAIL if the data is not a well-formed block file or
+   *    the file could not be written.
+   */
+  static bool WriteCompressed(const std::string &file, const uint8_t *data, size_t size);
+
   /*
    * Close(void):
    *
-   * Closes the file.
+   * Closes the file. If it was created on disk, this is when its contents are
+   * written out.
    */
   void Close(void);
 
@@ -189,17 +256,23 @@ private:
   unsigned  ReadBytes(void *data, uint32_t numBytes);
   unsigned  ReadDWord(uint32_t *data);
   void      UpdateBlockSize(void);
-  void      WriteByte(uint8_t data);
   void      WriteDWord(uint32_t data);
   void      WriteBytes(const void *data, uint32_t numBytes);
   void      WriteBlockHeader(const std::string &name, const std::string &comment);
+  void      BuildIndex(void);
+  bool      Decompress(const std::vector<uint8_t> &file);
 
   // File state data
-  FILE      *fp;
-  int       mode;           // 'r' for read, 'w' for write
-  long int  fileSize;       // size of file in bytes
-  long int  blockStartPos;  // points to beginning of current block (or file) header
-  long int  dataStartPos;   // points to beginning of current block's data section 
+  FILE                  *fp;            // file being written (flushed on Close())
+  std::vector<uint8_t>  fileBuffer;     // contents of file on disk
+  std::vector<uint8_t>  *writeBuffer;   // buffer being written (fileBuffer or caller's)
+  const uint8_t         *readData;      // data being read (fileBuffer or caller's)
+  size_t                fileSize;       // size of file in bytes
+  size_t                filePos;        // current read or write position
+  int                   mode;           // 'r' for read, 'w' for write
+  size_t                blockStartPos;  // points to beginning of current block (or file) header
+  size_t                dataStartPos;   // points to beginning of current block's data section 
+  std::map<std::string, size_t> blockIndex; // offset of each block's header, by name
 };
 
 
@@ -46,18 +46,18 @@
 ******************************************************************************/
 
 // Bus
-static IBus	*s_Bus = NULL;
+static thread_local IBus	*s_Bus = NULL;
 
 #ifdef SUPERMODEL_DEBUGGER
 // Debugger
-static Debugger::CMusashi68KDebug *s_Debug = NULL;
+static thread_local Debugger::CMusashi68KDebug *s_Debug = NULL;
 #endif
 
 // IRQ callback
-static int	(*IRQAck)(int nIRQ) = NULL;
+static thread_local int	(*IRQAck)(int nIRQ) = NULL;
 
 // Cycles remaining in timeslice
-static int s_lastCycles;
+static thread_local int s_lastCycles;
 
 
 /******************************************************************************
@@ -254,7 +254,9 @@ extern void M68KGetContext(M68KCtx *Dest);
 /*
  * M68KSetContext(M68KCtx *Src):
  *
- * Sets the specified 68K context by copying it to the internal context.
+ * Sets the specified 68K context by copying it to the internal context. The
+ * internal context is per thread, so boards running on different threads can
+ * each have their own context set at the same time.
  *
  * Parameters:
  *		Src		Location from which to copy 68K context.
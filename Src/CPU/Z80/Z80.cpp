@@ -32,24 +32,37 @@
 #include <cstdio> // for NULL
 #include "Supermodel.h"
 #include "Z80.h"  // must include this first to define CZ80
+#ifdef Z80_LOCKSTEP
+#include <cstdarg>
+#include <vector>
+#endif
 
 
 /******************************************************************************
  Internal Helper Macros
 ******************************************************************************/
 
+// Instruction dispatch: threaded code (computed goto) requires GCC or Clang
+#if defined(__GNUC__) && !defined(SUPERMODEL_DEBUGGER) && !defined(Z80_SWITCH_CORE)
+#define Z80_THREADED_CODE
+#endif
+
+#if defined(Z80_LOCKSTEP) && !defined(Z80_THREADED_CODE)
+#error "Z80_LOCKSTEP compares the threaded and switch cores and requires GCC or Clang (and no debugger)"
+#endif
+
 // Address space access
-#define GetBYTE(a)    ( Bus->Read8(a&0xFFFF) )
-#define GetBYTE_pp(a) ( Bus->Read8(((a)++)&0xFFFF) )
-#define GetBYTE_mm(a) ( Bus->Read8(((a)--)&0xFFFF) )
-#define mm_GetBYTE(a) ( Bus->Read8((--(a))&0xFFFF) )
+#define GetBYTE(a)    ( ReadMem((a)&0xFFFF) )
+#define GetBYTE_pp(a) ( ReadMem(((a)++)&0xFFFF) )
+#define GetBYTE_mm(a) ( ReadMem(((a)--)&0xFFFF) )
+#define mm_GetBYTE(a) ( ReadMem((--(a))&0xFFFF) )
 
-#define PutBYTE(a,v)  Bus->Write8((a)&0xFFFF,v)
-#define PutBYTE_pp(a,v) Bus->Write8(((a)++)&0xFFFF,v)
-#define PutBYTE_mm(a,v) Bus->Write8(((a)--)&0xFFFF,v)
-#define mm_PutBYTE(a,v) Bus->Write8((--(a))&0xFFFF,v)
+#define PutBYTE(a,v)  WriteMem((a)&0xFFFF,v)
+#define PutBYTE_pp(a,v) WriteMem(((a)++)&0xFFFF,v)
+#define PutBYTE_mm(a,v) WriteMem(((a)--)&0xFFFF,v)
+#define mm_PutBYTE(a,v) WriteMem((--(a))&0xFFFF,v)
 
-#define GetWORD(a)    (Bus->Read8((a)&0xFFFF) | (Bus->Read8(((a)+1)&0xFFFF)<<8))
+#define GetWORD(a)    (ReadMem((a)&0xFFFF) | (ReadMem(((a)+1)&0xFFFF)<<8))
 
 #define PutWORD(a, v)         \
   do                          \
@@ -229,11 +242,65 @@ static const unsigned char cycleTables[5][256] = {
   }
   
 
+// Instruction dispatch
+#ifdef Z80_THREADED_CODE
+/*
+ * Each opcode handler is also a label (<table>_<opcode>) so that it can be
+ * reached through the dispatch tables. A handler finishes with Z80_NEXT,
+ * which fetches the next opcode and jumps straight to its handler unless the
+ * cycle budget is exhausted or an interrupt must be taken, in which case it
+ * leaves the switch to the bottom of the execution loop like the switch core.
+ * Prefixed opcodes (DD, ED, FD) are dispatched through their own tables.
+ */
+#define Z80_CASE(table, n)  case n: table##_##n
+#define Z80_DEFAULT(table)  default: table##_default
+#define Z80_PREFIX_DISPATCH(table)  \
+  if (threaded)                     \
+    goto *table##Table[op]
+#define Z80_NEXT                                                          \
+  if (threaded && cycles > 0 && !nmiTrigger && !(intLine && (iff&1)))   \
+  {                                                                      \
+    op = GetBYTE_pp(pc);                                                 \
+    goto *mainTable[op];                                                 \
+  }                                                                      \
+  break
+#else
+#define Z80_CASE(table, n)  case n
+#define Z80_DEFAULT(table)  default
+#define Z80_PREFIX_DISPATCH(table)
+#define Z80_NEXT  break
+#endif // Z80_THREADED_CODE
+
+
 /*******************************************************************************
  Functions
 *******************************************************************************/
 
-int CZ80::Run(int numCycles)
+inline UINT8 CZ80::ReadMem(UINT32 addr)
+{
+#if !defined(SUPERMODEL_DEBUGGER) && !defined(Z80_LOCKSTEP)
+  const UINT8 *page = readMap[addr>>8];
+  if (page != NULL)
+    return page[addr&0xFF];
+#endif
+  return Bus->Read8(addr);
+}
+
+inline void CZ80::WriteMem(UINT32 addr, UINT8 data)
+{
+#if !defined(SUPERMODEL_DEBUGGER) && !defined(Z80_LOCKSTEP)
+  UINT8 *page = writeMap[addr>>8];
+  if (page != NULL)
+  {
+    page[addr&0xFF] = data;
+    return;
+  }
+#endif
+  Bus->Write8(addr, data);
+}
+
+template <bool threaded>
+int CZ80::Execute(int numCycles)
 {
 #ifdef SUPERMODEL_DEBUGGER
   // If debugging enabled, don't optimize access to registers as they need to be accesible to debugger during execution
@@ -261,6 +328,150 @@ int CZ80::Run(int numCycles)
   unsigned int op = 0;
   unsigned int adr = 0;
 
+#ifdef Z80_THREADED_CODE
+  // Dispatch tables for threaded code
+  static const void * const mainTable[256] =
+  {
+    &&main_0x00, &&main_0x01, &&main_0x02, &&main_0x03, &&main_0x04, &&main_0x05, &&main_0x06, &&main_0x07,
+    &&main_0x08, &&main_0x09, &&main_0x0A, &&main_0x0B, &&main_0x0C, &&main_0x0D, &&main_0x0E, &&main_0x0F,
+    &&main_0x10, &&main_0x11, &&main_0x12, &&main_0x13, &&main_0x14, &&main_0x15, &&main_0x16, &&main_0x17,
+    &&main_0x18, &&main_0x19, &&main_0x1A, &&main_0x1B, &&main_0x1C, &&main_0x1D, &&main_0x1E, &&main_0x1F,
+    &&main_0x20, &&main_0x21, &&main_0x22, &&main_0x23, &&main_0x24, &&main_0x25, &&main_0x26, &&main_0x27,
+    &&main_0x28, &&main_0x29, &&main_0x2A, &&main_0x2B, &&main_0x2C, &&main_0x2D, &&main_0x2E, &&main_0x2F,
+    &&main_0x30, &&main_0x31, &&main_0x32, &&main_0x33, &&main_0x34, &&main_0x35, &&main_0x36, &&main_0x37,
+    &&main_0x38, &&main_0x39, &&main_0x3A, &&main_0x3B, &&main_0x3C, &&main_0x3D, &&main_0x3E, &&main_0x3F,
+    &&main_0x40, &&main_0x41, &&main_0x42, &&main_0x43, &&main_0x44, &&main_0x45, &&main_0x46, &&main_0x47,
+    &&main_0x48, &&main_0x49, &&main_0x4A, &&main_0x4B, &&main_0x4C, &&main_0x4D, &&main_0x4E, &&main_0x4F,
+    &&main_0x50, &&main_0x51, &&main_0x52, &&main_0x53, &&main_0x54, &&main_0x55, &&main_0x56, &&main_0x57,
+    &&main_0x58, &&main_0x59, &&main_0x5A, &&main_0x5B, &&main_0x5C, &&main_0x5D, &&main_0x5E, &&main_0x5F,
+    &&main_0x60, &&main_0x61, &&main_0x62, &&main_0x63, &&main_0x64, &&main_0x65, &&main_0x66, &&main_0x67,
+    &&main_0x68, &&main_0x69, &&main_0x6A, &&main_0x6B, &&main_0x6C, &&main_0x6D, &&main_0x6E, &&main_0x6F,
+    &&main_0x70, &&main_0x71, &&main_0x72, &&main_0x73, &&main_0x74, &&main_0x75, &&main_0x76, &&main_0x77,
+    &&main_0x78, &&main_0x79, &&main_0x7A, &&main_0x7B, &&main_0x7C, &&main_0x7D, &&main_0x7E, &&main_0x7F,
+    &&main_0x80, &&main_0x81, &&main_0x82, &&main_0x83, &&main_0x84, &&main_0x85, &&main_0x86, &&main_0x87,
+    &&main_0x88, &&main_0x89, &&main_0x8A, &&main_0x8B, &&main_0x8C, &&main_0x8D, &&main_0x8E, &&main_0x8F,
+    &&main_0x90, &&main_0x91, &&main_0x92, &&main_0x93, &&main_0x94, &&main_0x95, &&main_0x96, &&main_0x97,
+    &&main_0x98, &&main_0x99, &&main_0x9A, &&main_0x9B, &&main_0x9C, &&main_0x9D, &&main_0x9E, &&main_0x9F,
+    &&main_0xA0, &&main_0xA1, &&main_0xA2, &&main_0xA3, &&main_0xA4, &&main_0xA5, &&main_0xA6, &&main_0xA7,
+    &&main_0xA8, &&main_0xA9, &&main_0xAA, &&main_0xAB, &&main_0xAC, &&main_0xAD, &&main_0xAE, &&main_0xAF,
+    &&main_0xB0, &&main_0xB1, &&main_0xB2, &&main_0xB3, &&main_0xB4, &&main_0xB5, &&main_0xB6, &&main_0xB7,
+    &&main_0xB8, &&main_0xB9, &&main_0xBA, &&main_0xBB, &&main_0xBC, &&main_0xBD, &&main_0xBE, &&main_0xBF,
+    &&main_0xC0, &&main_0xC1, &&main_0xC2, &&main_0xC3, &&main_0xC4, &&main_0xC5, &&main_0xC6, &&main_0xC7,
+    &&main_0xC8, &&main_0xC9, &&main_0xCA, &&main_0xCB, &&main_0xCC, &&main_0xCD, &&main_0xCE, &&main_0xCF,
+    &&main_0xD0, &&main_0xD1, &&main_0xD2, &&main_0xD3, &&main_0xD4, &&main_0xD5, &&main_0xD6, &&main_0xD7,
+    &&main_0xD8, &&main_0xD9, &&main_0xDA, &&main_0xDB, &&main_0xDC, &&main_0xDD, &&main_0xDE, &&main_0xDF,
+    &&main_0xE0, &&main_0xE1, &&main_0xE2, &&main_0xE3, &&main_0xE4, &&main_0xE5, &&main_0xE6, &&main_0xE7,
+    &&main_0xE8, &&main_0xE9, &&main_0xEA, &&main_0xEB, &&main_0xEC, &&main_0xED, &&main_0xEE, &&main_0xEF,
+    &&main_0xF0, &&main_0xF1, &&main_0xF2, &&main_0xF3, &&main_0xF4, &&main_0xF5, &&main_0xF6, &&main_0xF7,
+    &&main_0xF8, &&main_0xF9, &&main_0xFA, &&main_0xFB, &&main_0xFC, &&main_0xFD, &&main_0xFE, &&main_0xFF
+  };
+  static const void * const ddTable[256] =
+  {
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_0x09, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_0x19, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_0x21, &&dd_0x22, &&dd_0x23, &&dd_0x24, &&dd_0x25, &&dd_0x26, &&dd_default,
+    &&dd_default, &&dd_0x29, &&dd_0x2A, &&dd_0x2B, &&dd_0x2C, &&dd_0x2D, &&dd_0x2E, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x34, &&dd_0x35, &&dd_0x36, &&dd_default,
+    &&dd_default, &&dd_0x39, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x44, &&dd_0x45, &&dd_0x46, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x4C, &&dd_0x4D, &&dd_0x4E, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x54, &&dd_0x55, &&dd_0x56, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x5C, &&dd_0x5D, &&dd_0x5E, &&dd_default,
+    &&dd_0x60, &&dd_0x61, &&dd_0x62, &&dd_0x63, &&dd_0x64, &&dd_0x65, &&dd_0x66, &&dd_0x67,
+    &&dd_0x68, &&dd_0x69, &&dd_0x6A, &&dd_0x6B, &&dd_0x6C, &&dd_0x6D, &&dd_0x6E, &&dd_0x6F,
+    &&dd_0x70, &&dd_0x71, &&dd_0x72, &&dd_0x73, &&dd_0x74, &&dd_0x75, &&dd_default, &&dd_0x77,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x7C, &&dd_0x7D, &&dd_0x7E, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x84, &&dd_0x85, &&dd_0x86, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x8C, &&dd_0x8D, &&dd_0x8E, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x94, &&dd_0x95, &&dd_0x96, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x9C, &&dd_0x9D, &&dd_0x9E, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xA4, &&dd_0xA5, &&dd_0xA6, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xAC, &&dd_0xAD, &&dd_0xAE, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xB4, &&dd_0xB5, &&dd_0xB6, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xBC, &&dd_0xBD, &&dd_0xBE, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_0xCB, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_0xE1, &&dd_default, &&dd_0xE3, &&dd_default, &&dd_0xE5, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_0xE9, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+    &&dd_default, &&dd_0xF9, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default
+  };
+  static const void * const edTable[256] =
+  {
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_0x40, &&ed_0x41, &&ed_0x42, &&ed_0x43, &&ed_0x44, &&ed_0x45, &&ed_0x46, &&ed_0x47,
+    &&ed_0x48, &&ed_0x49, &&ed_0x4A, &&ed_0x4B, &&ed_default, &&ed_0x4D, &&ed_default, &&ed_0x4F,
+    &&ed_0x50, &&ed_0x51, &&ed_0x52, &&ed_0x53, &&ed_default, &&ed_default, &&ed_0x56, &&ed_0x57,
+    &&ed_0x58, &&ed_0x59, &&ed_0x5A, &&ed_0x5B, &&ed_default, &&ed_default, &&ed_0x5E, &&ed_0x5F,
+    &&ed_0x60, &&ed_0x61, &&ed_0x62, &&ed_0x63, &&ed_default, &&ed_default, &&ed_default, &&ed_0x67,
+    &&ed_0x68, &&ed_0x69, &&ed_0x6A, &&ed_0x6B, &&ed_default, &&ed_default, &&ed_default, &&ed_0x6F,
+    &&ed_0x70, &&ed_0x71, &&ed_0x72, &&ed_0x73, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_0x78, &&ed_0x79, &&ed_0x7A, &&ed_0x7B, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_0xA0, &&ed_0xA1, &&ed_0xA2, &&ed_0xA3, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_0xA8, &&ed_0xA9, &&ed_0xAA, &&ed_0xAB, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_0xB0, &&ed_0xB1, &&ed_0xB2, &&ed_0xB3, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_0xB8, &&ed_0xB9, &&ed_0xBA, &&ed_0xBB, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+    &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default
+  };
+  static const void * const fdTable[256] =
+  {
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_0x09, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_0x19, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_0x21, &&fd_0x22, &&fd_0x23, &&fd_0x24, &&fd_0x25, &&fd_0x26, &&fd_default,
+    &&fd_default, &&fd_0x29, &&fd_0x2A, &&fd_0x2B, &&fd_0x2C, &&fd_0x2D, &&fd_0x2E, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x34, &&fd_0x35, &&fd_0x36, &&fd_default,
+    &&fd_default, &&fd_0x39, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x44, &&fd_0x45, &&fd_0x46, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x4C, &&fd_0x4D, &&fd_0x4E, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x54, &&fd_0x55, &&fd_0x56, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x5C, &&fd_0x5D, &&fd_0x5E, &&fd_default,
+    &&fd_0x60, &&fd_0x61, &&fd_0x62, &&fd_0x63, &&fd_0x64, &&fd_0x65, &&fd_0x66, &&fd_0x67,
+    &&fd_0x68, &&fd_0x69, &&fd_0x6A, &&fd_0x6B, &&fd_0x6C, &&fd_0x6D, &&fd_0x6E, &&fd_0x6F,
+    &&fd_0x70, &&fd_0x71, &&fd_0x72, &&fd_0x73, &&fd_0x74, &&fd_0x75, &&fd_default, &&fd_0x77,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x7C, &&fd_0x7D, &&fd_0x7E, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x84, &&fd_0x85, &&fd_0x86, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x8C, &&fd_0x8D, &&fd_0x8E, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x94, &&fd_0x95, &&fd_0x96, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x9C, &&fd_0x9D, &&fd_0x9E, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xA4, &&fd_0xA5, &&fd_0xA6, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xAC, &&fd_0xAD, &&fd_0xAE, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xB4, &&fd_0xB5, &&fd_0xB6, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xBC, &&fd_0xBD, &&fd_0xBE, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_0xCB, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_0xE1, &&fd_default, &&fd_0xE3, &&fd_default, &&fd_0xE5, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_0xE9, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+    &&fd_default, &&fd_0xF9, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default
+  };
+#endif // Z80_THREADED_CODE
+
   int cycles = numCycles;
 #ifdef SUPERMODEL_DEBUGGER
   if (Debug != NULL)
@@ -282,23 +493,23 @@ int CZ80::Run(int numCycles)
   }
 #endif // SUPERMODEL_DEBUGGER
   switch(op) {
-  case 0x00:      /* NOP */
+  Z80_CASE(main, 0x00):      /* NOP */
     cycles -= cycleTables[0][0x00];
-    break;
-  case 0x01:      /* LD BC,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x01):      /* LD BC,nnnn */
     cycles -= cycleTables[0][0x01];
     BC = GetWORD(pc);
     pc += 2;
-    break;
-  case 0x02:      /* LD (BC),A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x02):      /* LD (BC),A */
     cycles -= cycleTables[0][0x02];
     PutBYTE(BC, hreg(AF));
-    break;
-  case 0x03:      /* INC BC */
+    Z80_NEXT;
+  Z80_CASE(main, 0x03):      /* INC BC */
     cycles -= cycleTables[0][0x03];
     ++BC;
-    break;
-  case 0x04:      /* INC B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x04):      /* INC B */
     cycles -= cycleTables[0][0x04];
     BC += 0x100;
     temp = hreg(BC);
@@ -306,8 +517,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x05:      /* DEC B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x05):      /* DEC B */
     cycles -= cycleTables[0][0x05];
     BC -= 0x100;
     temp = hreg(BC);
@@ -315,23 +526,23 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x06:      /* LD B,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x06):      /* LD B,nn */
     cycles -= cycleTables[0][0x06];
     Sethreg(BC, GetBYTE_pp(pc));
-    break;
-  case 0x07:      /* RLCA */
+    Z80_NEXT;
+  Z80_CASE(main, 0x07):      /* RLCA */
     cycles -= cycleTables[0][0x07];
     AF = ((AF >> 7) & 0x0128) | ((AF << 1) & ~0x1ff) |
       (AF & 0xc4) | ((AF >> 15) & 1);
-    break;
-  case 0x08:      /* EX AF,AF' */
+    Z80_NEXT;
+  Z80_CASE(main, 0x08):      /* EX AF,AF' */
     cycles -= cycleTables[0][0x08];
     af[af_sel] = AF;
     af_sel = 1 - af_sel;
     AF = af[af_sel];
-    break;
-  case 0x09:      /* ADD HL,BC */
+    Z80_NEXT;
+  Z80_CASE(main, 0x09):      /* ADD HL,BC */
     cycles -= cycleTables[0][0x09];
     HL &= 0xffff;
     BC &= 0xffff;
@@ -340,16 +551,16 @@ int CZ80::Run(int numCycles)
     HL = sum;
     AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0x0A:      /* LD A,(BC) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x0A):      /* LD A,(BC) */
     cycles -= cycleTables[0][0x0A];
     Sethreg(AF, GetBYTE(BC));
-    break;
-  case 0x0B:      /* DEC BC */
+    Z80_NEXT;
+  Z80_CASE(main, 0x0B):      /* DEC BC */
     cycles -= cycleTables[0][0x0B];
     --BC;
-    break;
-  case 0x0C:      /* INC C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x0C):      /* INC C */
     cycles -= cycleTables[0][0x0C];
     temp = lreg(BC)+1;
     Setlreg(BC, temp);
@@ -357,8 +568,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x0D:      /* DEC C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x0D):      /* DEC C */
     cycles -= cycleTables[0][0x0D];
     temp = lreg(BC)-1;
     Setlreg(BC, temp);
@@ -366,36 +577,36 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x0E:      /* LD C,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x0E):      /* LD C,nn */
     cycles -= cycleTables[0][0x0E];
     Setlreg(BC, GetBYTE_pp(pc));
-    break;
-  case 0x0F:      /* RRCA */
+    Z80_NEXT;
+  Z80_CASE(main, 0x0F):      /* RRCA */
     cycles -= cycleTables[0][0x0F];
     temp = hreg(AF);
     sum = temp >> 1;
     AF = ((temp & 1) << 15) | (sum << 8) |
       (sum & 0x28) | (AF & 0xc4) | (temp & 1);
-    break;
-  case 0x10:      /* DJNZ dd */
+    Z80_NEXT;
+  Z80_CASE(main, 0x10):      /* DJNZ dd */
     cycles -= cycleTables[0][0x10];
     pc += ((BC -= 0x100) & 0xff00) ? (signed char) GetBYTE(pc) + 1 : 1;
-    break;
-  case 0x11:      /* LD DE,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x11):      /* LD DE,nnnn */
     cycles -= cycleTables[0][0x11];
     DE = GetWORD(pc);
     pc += 2;
-    break;
-  case 0x12:      /* LD (DE),A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x12):      /* LD (DE),A */
     cycles -= cycleTables[0][0x12];
     PutBYTE(DE, hreg(AF));
-    break;
-  case 0x13:      /* INC DE */
+    Z80_NEXT;
+  Z80_CASE(main, 0x13):      /* INC DE */
     cycles -= cycleTables[0][0x13];
     ++DE;
-    break;
-  case 0x14:      /* INC D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x14):      /* INC D */
     cycles -= cycleTables[0][0x14];
     DE += 0x100;
     temp = hreg(DE);
@@ -403,8 +614,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x15:      /* DEC D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x15):      /* DEC D */
     cycles -= cycleTables[0][0x15];
     DE -= 0x100;
     temp = hreg(DE);
@@ -412,21 +623,21 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x16:      /* LD D,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x16):      /* LD D,nn */
     cycles -= cycleTables[0][0x16];
     Sethreg(DE, GetBYTE_pp(pc));
-    break;
-  case 0x17:      /* RLA */
+    Z80_NEXT;
+  Z80_CASE(main, 0x17):      /* RLA */
     cycles -= cycleTables[0][0x17];
     AF = ((AF << 8) & 0x0100) | ((AF >> 7) & 0x28) | ((AF << 1) & ~0x01ff) |
       (AF & 0xc4) | ((AF >> 15) & 1);
-    break;
-  case 0x18:      /* JR dd */
+    Z80_NEXT;
+  Z80_CASE(main, 0x18):      /* JR dd */
     cycles -= cycleTables[0][0x18];
     pc += (1) ? (signed char) GetBYTE(pc) + 1 : 1;
-    break;
-  case 0x19:      /* ADD HL,DE */
+    Z80_NEXT;
+  Z80_CASE(main, 0x19):      /* ADD HL,DE */
     cycles -= cycleTables[0][0x19];
     HL &= 0xffff;
     DE &= 0xffff;
@@ -435,16 +646,16 @@ int CZ80::Run(int numCycles)
     HL = sum;
     AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0x1A:      /* LD A,(DE) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x1A):      /* LD A,(DE) */
     cycles -= cycleTables[0][0x1A];
     Sethreg(AF, GetBYTE(DE));
-    break;
-  case 0x1B:      /* DEC DE */
+    Z80_NEXT;
+  Z80_CASE(main, 0x1B):      /* DEC DE */
     cycles -= cycleTables[0][0x1B];
     --DE;
-    break;
-  case 0x1C:      /* INC E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x1C):      /* INC E */
     cycles -= cycleTables[0][0x1C];
     temp = lreg(DE)+1;
     Setlreg(DE, temp);
@@ -452,8 +663,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x1D:      /* DEC E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x1D):      /* DEC E */
     cycles -= cycleTables[0][0x1D];
     temp = lreg(DE)-1;
     Setlreg(DE, temp);
@@ -461,38 +672,38 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x1E:      /* LD E,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x1E):      /* LD E,nn */
     cycles -= cycleTables[0][0x1E];
     Setlreg(DE, GetBYTE_pp(pc));
-    break;
-  case 0x1F:      /* RRA */
+    Z80_NEXT;
+  Z80_CASE(main, 0x1F):      /* RRA */
     cycles -= cycleTables[0][0x1F];
     temp = hreg(AF);
     sum = temp >> 1;
     AF = ((AF & 1) << 15) | (sum << 8) |
       (sum & 0x28) | (AF & 0xc4) | (temp & 1);
-    break;
-  case 0x20:      /* JR NZ,dd */
+    Z80_NEXT;
+  Z80_CASE(main, 0x20):      /* JR NZ,dd */
     cycles -= cycleTables[0][0x20];
     pc += (!TSTFLAG(Z)) ? (signed char) GetBYTE(pc) + 1 : 1;
-    break;
-  case 0x21:      /* LD HL,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x21):      /* LD HL,nnnn */
     cycles -= cycleTables[0][0x21];
     HL = GetWORD(pc);
     pc += 2;
-    break;
-  case 0x22:      /* LD (nnnn),HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0x22):      /* LD (nnnn),HL */
     cycles -= cycleTables[0][0x22];
     temp = GetWORD(pc);
     PutWORD(temp, HL);
     pc += 2;
-    break;
-  case 0x23:      /* INC HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0x23):      /* INC HL */
     cycles -= cycleTables[0][0x23];
     ++HL;
-    break;
-  case 0x24:      /* INC H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x24):      /* INC H */
     cycles -= cycleTables[0][0x24];
     HL += 0x100;
     temp = hreg(HL);
@@ -500,8 +711,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x25:      /* DEC H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x25):      /* DEC H */
     cycles -= cycleTables[0][0x25];
     HL -= 0x100;
     temp = hreg(HL);
@@ -509,12 +720,12 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x26:      /* LD H,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x26):      /* LD H,nn */
     cycles -= cycleTables[0][0x26];
     Sethreg(HL, GetBYTE_pp(pc));
-    break;
-  case 0x27:      /* DAA */
+    Z80_NEXT;
+  Z80_CASE(main, 0x27):      /* DAA */
     cycles -= cycleTables[0][0x27];
     acu = hreg(AF);
     temp = ldig(acu);
@@ -542,12 +753,12 @@ int CZ80::Run(int numCycles)
     acu &= 0xff;
     AF = (acu << 8) | (acu & 0xa8) | ((acu == 0) << 6) |
       (AF & 0x12) | partab[acu] | cbits;
-    break;
-  case 0x28:      /* JR Z,dd */
+    Z80_NEXT;
+  Z80_CASE(main, 0x28):      /* JR Z,dd */
     cycles -= cycleTables[0][0x28];
     pc += (TSTFLAG(Z)) ? (signed char) GetBYTE(pc) + 1 : 1;
-    break;
-  case 0x29:      /* ADD HL,HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0x29):      /* ADD HL,HL */
     cycles -= cycleTables[0][0x29];
     HL &= 0xffff;
     sum = HL + HL;
@@ -555,18 +766,18 @@ int CZ80::Run(int numCycles)
     HL = sum;
     AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0x2A:      /* LD HL,(nnnn) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x2A):      /* LD HL,(nnnn) */
     cycles -= cycleTables[0][0x2A];
     temp = GetWORD(pc);
     HL = GetWORD(temp);
     pc += 2;
-    break;
-  case 0x2B:      /* DEC HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0x2B):      /* DEC HL */
     cycles -= cycleTables[0][0x2B];
     --HL;
-    break;
-  case 0x2C:      /* INC L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x2C):      /* INC L */
     cycles -= cycleTables[0][0x2C];
     temp = lreg(HL)+1;
     Setlreg(HL, temp);
@@ -574,8 +785,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x2D:      /* DEC L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x2D):      /* DEC L */
     cycles -= cycleTables[0][0x2D];
     temp = lreg(HL)-1;
     Setlreg(HL, temp);
@@ -583,35 +794,35 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x2E:      /* LD L,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x2E):      /* LD L,nn */
     cycles -= cycleTables[0][0x2E];
     Setlreg(HL, GetBYTE_pp(pc));
-    break;
-  case 0x2F:      /* CPL */
+    Z80_NEXT;
+  Z80_CASE(main, 0x2F):      /* CPL */
     cycles -= cycleTables[0][0x2F];
     AF = (~AF & ~0xff) | (AF & 0xc5) | ((~AF >> 8) & 0x28) | 0x12;
-    break;
-  case 0x30:      /* JR NC,dd */
+    Z80_NEXT;
+  Z80_CASE(main, 0x30):      /* JR NC,dd */
     cycles -= cycleTables[0][0x30];
     pc += (!TSTFLAG(C)) ? (signed char) GetBYTE(pc) + 1 : 1;
-    break;
-  case 0x31:      /* LD SP,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x31):      /* LD SP,nnnn */
     cycles -= cycleTables[0][0x31];
     SP = GetWORD(pc);
     pc += 2;
-    break;
-  case 0x32:      /* LD (nnnn),A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x32):      /* LD (nnnn),A */
     cycles -= cycleTables[0][0x32];
     temp = GetWORD(pc);
     PutBYTE(temp, hreg(AF));
     pc += 2;
-    break;
-  case 0x33:      /* INC SP */
+    Z80_NEXT;
+  Z80_CASE(main, 0x33):      /* INC SP */
     cycles -= cycleTables[0][0x33];
     ++SP;
-    break;
-  case 0x34:      /* INC (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x34):      /* INC (HL) */
     cycles -= cycleTables[0][0x34];
     temp = GetBYTE(HL)+1;
     PutBYTE(HL, temp);
@@ -619,8 +830,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x35:      /* DEC (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x35):      /* DEC (HL) */
     cycles -= cycleTables[0][0x35];
     temp = GetBYTE(HL)-1;
     PutBYTE(HL, temp);
@@ -628,20 +839,20 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x36:      /* LD (HL),nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x36):      /* LD (HL),nn */
     cycles -= cycleTables[0][0x36];
     PutBYTE(HL, GetBYTE_pp(pc));
-    break;
-  case 0x37:      /* SCF */
+    Z80_NEXT;
+  Z80_CASE(main, 0x37):      /* SCF */
     cycles -= cycleTables[0][0x37];
     AF = (AF&~0x3b)|((AF>>8)&0x28)|1;
-    break;
-  case 0x38:      /* JR C,dd */
+    Z80_NEXT;
+  Z80_CASE(main, 0x38):      /* JR C,dd */
     cycles -= cycleTables[0][0x38];
     pc += (TSTFLAG(C)) ? (signed char) GetBYTE(pc) + 1 : 1;
-    break;
-  case 0x39:      /* ADD HL,SP */
+    Z80_NEXT;
+  Z80_CASE(main, 0x39):      /* ADD HL,SP */
     cycles -= cycleTables[0][0x39];
     HL &= 0xffff;
     SP &= 0xffff;
@@ -650,18 +861,18 @@ int CZ80::Run(int numCycles)
     HL = sum;
     AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0x3A:      /* LD A,(nnnn) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x3A):      /* LD A,(nnnn) */
     cycles -= cycleTables[0][0x3A];
     temp = GetWORD(pc);
     Sethreg(AF, GetBYTE(temp));
     pc += 2;
-    break;
-  case 0x3B:      /* DEC SP */
+    Z80_NEXT;
+  Z80_CASE(main, 0x3B):      /* DEC SP */
     cycles -= cycleTables[0][0x3B];
     --SP;
-    break;
-  case 0x3C:      /* INC A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x3C):      /* INC A */
     cycles -= cycleTables[0][0x3C];
     AF += 0x100;
     temp = hreg(AF);
@@ -669,8 +880,8 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0) << 4) |
       ((temp == 0x80) << 2);
-    break;
-  case 0x3D:      /* DEC A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x3D):      /* DEC A */
     cycles -= cycleTables[0][0x3D];
     AF -= 0x100;
     temp = hreg(AF);
@@ -678,272 +889,272 @@ int CZ80::Run(int numCycles)
       (((temp & 0xff) == 0) << 6) |
       (((temp & 0xf) == 0xf) << 4) |
       ((temp == 0x7f) << 2) | 2;
-    break;
-  case 0x3E:      /* LD A,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0x3E):      /* LD A,nn */
     cycles -= cycleTables[0][0x3E];
     Sethreg(AF, GetBYTE_pp(pc));
-    break;
-  case 0x3F:      /* CCF */
+    Z80_NEXT;
+  Z80_CASE(main, 0x3F):      /* CCF */
     cycles -= cycleTables[0][0x3F];
     AF = (AF&~0x3b)|((AF>>8)&0x28)|((AF&1)<<4)|(~AF&1);
-    break;
-  case 0x40:      /* LD B,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x40):      /* LD B,B */
     cycles -= cycleTables[0][0x40];
     /* nop */
-    break;
-  case 0x41:      /* LD B,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x41):      /* LD B,C */
     cycles -= cycleTables[0][0x41];
     BC = (BC & 255) | ((BC & 255) << 8);
-    break;
-  case 0x42:      /* LD B,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x42):      /* LD B,D */
     cycles -= cycleTables[0][0x42];
     BC = (BC & 255) | (DE & ~255);
-    break;
-  case 0x43:      /* LD B,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x43):      /* LD B,E */
     cycles -= cycleTables[0][0x43];
     BC = (BC & 255) | ((DE & 255) << 8);
-    break;
-  case 0x44:      /* LD B,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x44):      /* LD B,H */
     cycles -= cycleTables[0][0x44];
     BC = (BC & 255) | (HL & ~255);
-    break;
-  case 0x45:      /* LD B,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x45):      /* LD B,L */
     cycles -= cycleTables[0][0x45];
     BC = (BC & 255) | ((HL & 255) << 8);
-    break;
-  case 0x46:      /* LD B,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x46):      /* LD B,(HL) */
     cycles -= cycleTables[0][0x46];
     Sethreg(BC, GetBYTE(HL));
-    break;
-  case 0x47:      /* LD B,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x47):      /* LD B,A */
     cycles -= cycleTables[0][0x47];
     BC = (BC & 255) | (AF & ~255);
-    break;
-  case 0x48:      /* LD C,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x48):      /* LD C,B */
     cycles -= cycleTables[0][0x48];
     BC = (BC & ~255) | ((BC >> 8) & 255);
-    break;
-  case 0x49:      /* LD C,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x49):      /* LD C,C */
     cycles -= cycleTables[0][0x49];
     /* nop */
-    break;
-  case 0x4A:      /* LD C,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x4A):      /* LD C,D */
     cycles -= cycleTables[0][0x4A];
     BC = (BC & ~255) | ((DE >> 8) & 255);
-    break;
-  case 0x4B:      /* LD C,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x4B):      /* LD C,E */
     cycles -= cycleTables[0][0x4B];
     BC = (BC & ~255) | (DE & 255);
-    break;
-  case 0x4C:      /* LD C,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x4C):      /* LD C,H */
     cycles -= cycleTables[0][0x4C];
     BC = (BC & ~255) | ((HL >> 8) & 255);
-    break;
-  case 0x4D:      /* LD C,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x4D):      /* LD C,L */
     cycles -= cycleTables[0][0x4D];
     BC = (BC & ~255) | (HL & 255);
-    break;
-  case 0x4E:      /* LD C,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x4E):      /* LD C,(HL) */
     cycles -= cycleTables[0][0x4E];
     Setlreg(BC, GetBYTE(HL));
-    break;
-  case 0x4F:      /* LD C,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x4F):      /* LD C,A */
     cycles -= cycleTables[0][0x4F];
     BC = (BC & ~255) | ((AF >> 8) & 255);
-    break;
-  case 0x50:      /* LD D,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x50):      /* LD D,B */
     cycles -= cycleTables[0][0x50];
     DE = (DE & 255) | (BC & ~255);
-    break;
-  case 0x51:      /* LD D,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x51):      /* LD D,C */
     cycles -= cycleTables[0][0x51];
     DE = (DE & 255) | ((BC & 255) << 8);
-    break;
-  case 0x52:      /* LD D,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x52):      /* LD D,D */
     cycles -= cycleTables[0][0x52];
     /* nop */
-    break;
-  case 0x53:      /* LD D,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x53):      /* LD D,E */
     cycles -= cycleTables[0][0x53];
     DE = (DE & 255) | ((DE & 255) << 8);
-    break;
-  case 0x54:      /* LD D,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x54):      /* LD D,H */
     cycles -= cycleTables[0][0x54];
     DE = (DE & 255) | (HL & ~255);
-    break;
-  case 0x55:      /* LD D,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x55):      /* LD D,L */
     cycles -= cycleTables[0][0x55];
     DE = (DE & 255) | ((HL & 255) << 8);
-    break;
-  case 0x56:      /* LD D,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x56):      /* LD D,(HL) */
     cycles -= cycleTables[0][0x56];
     Sethreg(DE, GetBYTE(HL));
-    break;
-  case 0x57:      /* LD D,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x57):      /* LD D,A */
     cycles -= cycleTables[0][0x57];
     DE = (DE & 255) | (AF & ~255);
-    break;
-  case 0x58:      /* LD E,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x58):      /* LD E,B */
     cycles -= cycleTables[0][0x58];
     DE = (DE & ~255) | ((BC >> 8) & 255);
-    break;
-  case 0x59:      /* LD E,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x59):      /* LD E,C */
     cycles -= cycleTables[0][0x59];
     DE = (DE & ~255) | (BC & 255);
-    break;
-  case 0x5A:      /* LD E,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x5A):      /* LD E,D */
     cycles -= cycleTables[0][0x5A];
     DE = (DE & ~255) | ((DE >> 8) & 255);
-    break;
-  case 0x5B:      /* LD E,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x5B):      /* LD E,E */
     cycles -= cycleTables[0][0x5B];
     /* nop */
-    break;
-  case 0x5C:      /* LD E,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x5C):      /* LD E,H */
     cycles -= cycleTables[0][0x5C];
     DE = (DE & ~255) | ((HL >> 8) & 255);
-    break;
-  case 0x5D:      /* LD E,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x5D):      /* LD E,L */
     cycles -= cycleTables[0][0x5D];
     DE = (DE & ~255) | (HL & 255);
-    break;
-  case 0x5E:      /* LD E,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x5E):      /* LD E,(HL) */
     cycles -= cycleTables[0][0x5E];
     Setlreg(DE, GetBYTE(HL));
-    break;
-  case 0x5F:      /* LD E,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x5F):      /* LD E,A */
     cycles -= cycleTables[0][0x5F];
     DE = (DE & ~255) | ((AF >> 8) & 255);
-    break;
-  case 0x60:      /* LD H,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x60):      /* LD H,B */
     cycles -= cycleTables[0][0x60];
     HL = (HL & 255) | (BC & ~255);
-    break;
-  case 0x61:      /* LD H,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x61):      /* LD H,C */
     cycles -= cycleTables[0][0x61];
     HL = (HL & 255) | ((BC & 255) << 8);
-    break;
-  case 0x62:      /* LD H,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x62):      /* LD H,D */
     cycles -= cycleTables[0][0x62];
     HL = (HL & 255) | (DE & ~255);
-    break;
-  case 0x63:      /* LD H,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x63):      /* LD H,E */
     cycles -= cycleTables[0][0x63];
     HL = (HL & 255) | ((DE & 255) << 8);
-    break;
-  case 0x64:      /* LD H,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x64):      /* LD H,H */
     cycles -= cycleTables[0][0x64];
     /* nop */
-    break;
-  case 0x65:      /* LD H,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x65):      /* LD H,L */
     cycles -= cycleTables[0][0x65];
     HL = (HL & 255) | ((HL & 255) << 8);
-    break;
-  case 0x66:      /* LD H,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x66):      /* LD H,(HL) */
     cycles -= cycleTables[0][0x66];
     Sethreg(HL, GetBYTE(HL));
-    break;
-  case 0x67:      /* LD H,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x67):      /* LD H,A */
     cycles -= cycleTables[0][0x67];
     HL = (HL & 255) | (AF & ~255);
-    break;
-  case 0x68:      /* LD L,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x68):      /* LD L,B */
     cycles -= cycleTables[0][0x68];
     HL = (HL & ~255) | ((BC >> 8) & 255);
-    break;
-  case 0x69:      /* LD L,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x69):      /* LD L,C */
     cycles -= cycleTables[0][0x69];
     HL = (HL & ~255) | (BC & 255);
-    break;
-  case 0x6A:      /* LD L,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x6A):      /* LD L,D */
     cycles -= cycleTables[0][0x6A];
     HL = (HL & ~255) | ((DE >> 8) & 255);
-    break;
-  case 0x6B:      /* LD L,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x6B):      /* LD L,E */
     cycles -= cycleTables[0][0x6B];
     HL = (HL & ~255) | (DE & 255);
-    break;
-  case 0x6C:      /* LD L,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x6C):      /* LD L,H */
     cycles -= cycleTables[0][0x6C];
     HL = (HL & ~255) | ((HL >> 8) & 255);
-    break;
-  case 0x6D:      /* LD L,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x6D):      /* LD L,L */
     cycles -= cycleTables[0][0x6D];
     /* nop */
-    break;
-  case 0x6E:      /* LD L,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x6E):      /* LD L,(HL) */
     cycles -= cycleTables[0][0x6E];
     Setlreg(HL, GetBYTE(HL));
-    break;
-  case 0x6F:      /* LD L,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x6F):      /* LD L,A */
     cycles -= cycleTables[0][0x6F];
     HL = (HL & ~255) | ((AF >> 8) & 255);
-    break;
-  case 0x70:      /* LD (HL),B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x70):      /* LD (HL),B */
     cycles -= cycleTables[0][0x70];
     PutBYTE(HL, hreg(BC));
-    break;
-  case 0x71:      /* LD (HL),C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x71):      /* LD (HL),C */
     cycles -= cycleTables[0][0x71];
     PutBYTE(HL, lreg(BC));
-    break;
-  case 0x72:      /* LD (HL),D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x72):      /* LD (HL),D */
     cycles -= cycleTables[0][0x72];
     PutBYTE(HL, hreg(DE));
-    break;
-  case 0x73:      /* LD (HL),E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x73):      /* LD (HL),E */
     cycles -= cycleTables[0][0x73];
     PutBYTE(HL, lreg(DE));
-    break;
-  case 0x74:      /* LD (HL),H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x74):      /* LD (HL),H */
     cycles -= cycleTables[0][0x74];
     PutBYTE(HL, hreg(HL));
-    break;
-  case 0x75:      /* LD (HL),L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x75):      /* LD (HL),L */
     cycles -= cycleTables[0][0x75];
     PutBYTE(HL, lreg(HL));
-    break;
-  case 0x76:      /* HALT */
+    Z80_NEXT;
+  Z80_CASE(main, 0x76):      /* HALT */
     cycles -= cycleTables[0][0x76];
 //    ErrorLog("Z80 encountered an unemulated instruction at 0x%04X", (pc-1)&0xFFFF);
     goto HALTExit;
-  case 0x77:      /* LD (HL),A */
+  Z80_CASE(main, 0x77):      /* LD (HL),A */
     cycles -= cycleTables[0][0x77];
     PutBYTE(HL, hreg(AF));
-    break;
-  case 0x78:      /* LD A,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x78):      /* LD A,B */
     cycles -= cycleTables[0][0x78];
     AF = (AF & 255) | (BC & ~255);
-    break;
-  case 0x79:      /* LD A,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x79):      /* LD A,C */
     cycles -= cycleTables[0][0x79];
     AF = (AF & 255) | ((BC & 255) << 8);
-    break;
-  case 0x7A:      /* LD A,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x7A):      /* LD A,D */
     cycles -= cycleTables[0][0x7A];
     AF = (AF & 255) | (DE & ~255);
-    break;
-  case 0x7B:      /* LD A,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x7B):      /* LD A,E */
     cycles -= cycleTables[0][0x7B];
     AF = (AF & 255) | ((DE & 255) << 8);
-    break;
-  case 0x7C:      /* LD A,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x7C):      /* LD A,H */
     cycles -= cycleTables[0][0x7C];
     AF = (AF & 255) | (HL & ~255);
-    break;
-  case 0x7D:      /* LD A,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x7D):      /* LD A,L */
     cycles -= cycleTables[0][0x7D];
     AF = (AF & 255) | ((HL & 255) << 8);
-    break;
-  case 0x7E:      /* LD A,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x7E):      /* LD A,(HL) */
     cycles -= cycleTables[0][0x7E];
     Sethreg(AF, GetBYTE(HL));
-    break;
-  case 0x7F:      /* LD A,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x7F):      /* LD A,A */
     cycles -= cycleTables[0][0x7F];
     /* nop */
-    break;
-  case 0x80:      /* ADD A,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x80):      /* ADD A,B */
     cycles -= cycleTables[0][0x80];
     temp = hreg(BC);
     acu = hreg(AF);
@@ -953,8 +1164,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x81:      /* ADD A,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x81):      /* ADD A,C */
     cycles -= cycleTables[0][0x81];
     temp = lreg(BC);
     acu = hreg(AF);
@@ -964,8 +1175,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x82:      /* ADD A,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x82):      /* ADD A,D */
     cycles -= cycleTables[0][0x82];
     temp = hreg(DE);
     acu = hreg(AF);
@@ -975,8 +1186,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x83:      /* ADD A,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x83):      /* ADD A,E */
     cycles -= cycleTables[0][0x83];
     temp = lreg(DE);
     acu = hreg(AF);
@@ -986,8 +1197,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x84:      /* ADD A,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x84):      /* ADD A,H */
     cycles -= cycleTables[0][0x84];
     temp = hreg(HL);
     acu = hreg(AF);
@@ -997,8 +1208,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x85:      /* ADD A,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x85):      /* ADD A,L */
     cycles -= cycleTables[0][0x85];
     temp = lreg(HL);
     acu = hreg(AF);
@@ -1008,8 +1219,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x86:      /* ADD A,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x86):      /* ADD A,(HL) */
     cycles -= cycleTables[0][0x86];
     temp = GetBYTE(HL);
     acu = hreg(AF);
@@ -1019,8 +1230,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x87:      /* ADD A,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x87):      /* ADD A,A */
     cycles -= cycleTables[0][0x87];
     temp = hreg(AF);
     acu = hreg(AF);
@@ -1030,8 +1241,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x88:      /* ADC A,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x88):      /* ADC A,B */
     cycles -= cycleTables[0][0x88];
     temp = hreg(BC);
     acu = hreg(AF);
@@ -1041,8 +1252,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x89:      /* ADC A,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x89):      /* ADC A,C */
     cycles -= cycleTables[0][0x89];
     temp = lreg(BC);
     acu = hreg(AF);
@@ -1052,8 +1263,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x8A:      /* ADC A,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x8A):      /* ADC A,D */
     cycles -= cycleTables[0][0x8A];
     temp = hreg(DE);
     acu = hreg(AF);
@@ -1063,8 +1274,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x8B:      /* ADC A,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x8B):      /* ADC A,E */
     cycles -= cycleTables[0][0x8B];
     temp = lreg(DE);
     acu = hreg(AF);
@@ -1074,8 +1285,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x8C:      /* ADC A,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x8C):      /* ADC A,H */
     cycles -= cycleTables[0][0x8C];
     temp = hreg(HL);
     acu = hreg(AF);
@@ -1085,8 +1296,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x8D:      /* ADC A,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x8D):      /* ADC A,L */
     cycles -= cycleTables[0][0x8D];
     temp = lreg(HL);
     acu = hreg(AF);
@@ -1096,8 +1307,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x8E:      /* ADC A,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x8E):      /* ADC A,(HL) */
     cycles -= cycleTables[0][0x8E];
     temp = GetBYTE(HL);
     acu = hreg(AF);
@@ -1107,8 +1318,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x8F:      /* ADC A,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x8F):      /* ADC A,A */
     cycles -= cycleTables[0][0x8F];
     temp = hreg(AF);
     acu = hreg(AF);
@@ -1118,8 +1329,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0x90:      /* SUB B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x90):      /* SUB B */
     cycles -= cycleTables[0][0x90];
     temp = hreg(BC);
     acu = hreg(AF);
@@ -1129,8 +1340,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x91:      /* SUB C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x91):      /* SUB C */
     cycles -= cycleTables[0][0x91];
     temp = lreg(BC);
     acu = hreg(AF);
@@ -1140,8 +1351,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x92:      /* SUB D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x92):      /* SUB D */
     cycles -= cycleTables[0][0x92];
     temp = hreg(DE);
     acu = hreg(AF);
@@ -1151,8 +1362,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x93:      /* SUB E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x93):      /* SUB E */
     cycles -= cycleTables[0][0x93];
     temp = lreg(DE);
     acu = hreg(AF);
@@ -1162,8 +1373,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x94:      /* SUB H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x94):      /* SUB H */
     cycles -= cycleTables[0][0x94];
     temp = hreg(HL);
     acu = hreg(AF);
@@ -1173,8 +1384,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x95:      /* SUB L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x95):      /* SUB L */
     cycles -= cycleTables[0][0x95];
     temp = lreg(HL);
     acu = hreg(AF);
@@ -1184,8 +1395,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x96:      /* SUB (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x96):      /* SUB (HL) */
     cycles -= cycleTables[0][0x96];
     temp = GetBYTE(HL);
     acu = hreg(AF);
@@ -1195,8 +1406,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x97:      /* SUB A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x97):      /* SUB A */
     cycles -= cycleTables[0][0x97];
     temp = hreg(AF);
     acu = hreg(AF);
@@ -1206,8 +1417,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x98:      /* SBC A,B */
+    Z80_NEXT;
+  Z80_CASE(main, 0x98):      /* SBC A,B */
     cycles -= cycleTables[0][0x98];
     temp = hreg(BC);
     acu = hreg(AF);
@@ -1217,8 +1428,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x99:      /* SBC A,C */
+    Z80_NEXT;
+  Z80_CASE(main, 0x99):      /* SBC A,C */
     cycles -= cycleTables[0][0x99];
     temp = lreg(BC);
     acu = hreg(AF);
@@ -1228,8 +1439,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x9A:      /* SBC A,D */
+    Z80_NEXT;
+  Z80_CASE(main, 0x9A):      /* SBC A,D */
     cycles -= cycleTables[0][0x9A];
     temp = hreg(DE);
     acu = hreg(AF);
@@ -1239,8 +1450,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x9B:      /* SBC A,E */
+    Z80_NEXT;
+  Z80_CASE(main, 0x9B):      /* SBC A,E */
     cycles -= cycleTables[0][0x9B];
     temp = lreg(DE);
     acu = hreg(AF);
@@ -1250,8 +1461,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x9C:      /* SBC A,H */
+    Z80_NEXT;
+  Z80_CASE(main, 0x9C):      /* SBC A,H */
     cycles -= cycleTables[0][0x9C];
     temp = hreg(HL);
     acu = hreg(AF);
@@ -1261,8 +1472,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x9D:      /* SBC A,L */
+    Z80_NEXT;
+  Z80_CASE(main, 0x9D):      /* SBC A,L */
     cycles -= cycleTables[0][0x9D];
     temp = lreg(HL);
     acu = hreg(AF);
@@ -1272,8 +1483,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x9E:      /* SBC A,(HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0x9E):      /* SBC A,(HL) */
     cycles -= cycleTables[0][0x9E];
     temp = GetBYTE(HL);
     acu = hreg(AF);
@@ -1283,8 +1494,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0x9F:      /* SBC A,A */
+    Z80_NEXT;
+  Z80_CASE(main, 0x9F):      /* SBC A,A */
     cycles -= cycleTables[0][0x9F];
     temp = hreg(AF);
     acu = hreg(AF);
@@ -1294,136 +1505,136 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0xA0:      /* AND B */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA0):      /* AND B */
     cycles -= cycleTables[0][0xA0];
     sum = ((AF & (BC)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) |
       ((sum == 0) << 6) | 0x10 | partab[sum];
-    break;
-  case 0xA1:      /* AND C */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA1):      /* AND C */
     cycles -= cycleTables[0][0xA1];
     sum = ((AF >> 8) & BC) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | 0x10 |
       ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xA2:      /* AND D */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA2):      /* AND D */
     cycles -= cycleTables[0][0xA2];
     sum = ((AF & (DE)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) |
       ((sum == 0) << 6) | 0x10 | partab[sum];
-    break;
-  case 0xA3:      /* AND E */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA3):      /* AND E */
     cycles -= cycleTables[0][0xA3];
     sum = ((AF >> 8) & DE) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | 0x10 |
       ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xA4:      /* AND H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA4):      /* AND H */
     cycles -= cycleTables[0][0xA4];
     sum = ((AF & (HL)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) |
       ((sum == 0) << 6) | 0x10 | partab[sum];
-    break;
-  case 0xA5:      /* AND L */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA5):      /* AND L */
     cycles -= cycleTables[0][0xA5];
     sum = ((AF >> 8) & HL) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | 0x10 |
       ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xA6:      /* AND (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA6):      /* AND (HL) */
     cycles -= cycleTables[0][0xA6];
     sum = ((AF >> 8) & GetBYTE(HL)) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | 0x10 |
       ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xA7:      /* AND A */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA7):      /* AND A */
     cycles -= cycleTables[0][0xA7];
     sum = ((AF & (AF)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) |
       ((sum == 0) << 6) | 0x10 | partab[sum];
-    break;
-  case 0xA8:      /* XOR B */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA8):      /* XOR B */
     cycles -= cycleTables[0][0xA8];
     sum = ((AF ^ (BC)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xA9:      /* XOR C */
+    Z80_NEXT;
+  Z80_CASE(main, 0xA9):      /* XOR C */
     cycles -= cycleTables[0][0xA9];
     sum = ((AF >> 8) ^ BC) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xAA:      /* XOR D */
+    Z80_NEXT;
+  Z80_CASE(main, 0xAA):      /* XOR D */
     cycles -= cycleTables[0][0xAA];
     sum = ((AF ^ (DE)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xAB:      /* XOR E */
+    Z80_NEXT;
+  Z80_CASE(main, 0xAB):      /* XOR E */
     cycles -= cycleTables[0][0xAB];
     sum = ((AF >> 8) ^ DE) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xAC:      /* XOR H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xAC):      /* XOR H */
     cycles -= cycleTables[0][0xAC];
     sum = ((AF ^ (HL)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xAD:      /* XOR L */
+    Z80_NEXT;
+  Z80_CASE(main, 0xAD):      /* XOR L */
     cycles -= cycleTables[0][0xAD];
     sum = ((AF >> 8) ^ HL) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xAE:      /* XOR (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0xAE):      /* XOR (HL) */
     cycles -= cycleTables[0][0xAE];
     sum = ((AF >> 8) ^ GetBYTE(HL)) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xAF:      /* XOR A */
+    Z80_NEXT;
+  Z80_CASE(main, 0xAF):      /* XOR A */
     cycles -= cycleTables[0][0xAF];
     sum = ((AF ^ (AF)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB0:      /* OR B */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB0):      /* OR B */
     cycles -= cycleTables[0][0xB0];
     sum = ((AF | (BC)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB1:      /* OR C */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB1):      /* OR C */
     cycles -= cycleTables[0][0xB1];
     sum = ((AF >> 8) | BC) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB2:      /* OR D */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB2):      /* OR D */
     cycles -= cycleTables[0][0xB2];
     sum = ((AF | (DE)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB3:      /* OR E */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB3):      /* OR E */
     cycles -= cycleTables[0][0xB3];
     sum = ((AF >> 8) | DE) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB4:      /* OR H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB4):      /* OR H */
     cycles -= cycleTables[0][0xB4];
     sum = ((AF | (HL)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB5:      /* OR L */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB5):      /* OR L */
     cycles -= cycleTables[0][0xB5];
     sum = ((AF >> 8) | HL) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB6:      /* OR (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB6):      /* OR (HL) */
     cycles -= cycleTables[0][0xB6];
     sum = ((AF >> 8) | GetBYTE(HL)) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB7:      /* OR A */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB7):      /* OR A */
     cycles -= cycleTables[0][0xB7];
     sum = ((AF | (AF)) >> 8) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xB8:      /* CP B */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB8):      /* CP B */
     cycles -= cycleTables[0][0xB8];
     temp = hreg(BC);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1434,8 +1645,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xB9:      /* CP C */
+    Z80_NEXT;
+  Z80_CASE(main, 0xB9):      /* CP C */
     cycles -= cycleTables[0][0xB9];
     temp = lreg(BC);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1446,8 +1657,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xBA:      /* CP D */
+    Z80_NEXT;
+  Z80_CASE(main, 0xBA):      /* CP D */
     cycles -= cycleTables[0][0xBA];
     temp = hreg(DE);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1458,8 +1669,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xBB:      /* CP E */
+    Z80_NEXT;
+  Z80_CASE(main, 0xBB):      /* CP E */
     cycles -= cycleTables[0][0xBB];
     temp = lreg(DE);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1470,8 +1681,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xBC:      /* CP H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xBC):      /* CP H */
     cycles -= cycleTables[0][0xBC];
     temp = hreg(HL);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1482,8 +1693,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xBD:      /* CP L */
+    Z80_NEXT;
+  Z80_CASE(main, 0xBD):      /* CP L */
     cycles -= cycleTables[0][0xBD];
     temp = lreg(HL);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1494,8 +1705,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xBE:      /* CP (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0xBE):      /* CP (HL) */
     cycles -= cycleTables[0][0xBE];
     temp = GetBYTE(HL);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1506,8 +1717,8 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xBF:      /* CP A */
+    Z80_NEXT;
+  Z80_CASE(main, 0xBF):      /* CP A */
     cycles -= cycleTables[0][0xBF];
     temp = hreg(AF);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -1518,32 +1729,32 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xC0:      /* RET NZ */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC0):      /* RET NZ */
     cycles -= cycleTables[0][0xC0];
     if (!TSTFLAG(Z)) POP(pc);
-    break;
-  case 0xC1:      /* POP BC */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC1):      /* POP BC */
     cycles -= cycleTables[0][0xC1];
     POP(BC);
-    break;
-  case 0xC2:      /* JP NZ,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC2):      /* JP NZ,nnnn */
     cycles -= cycleTables[0][0xC2];
     Jpc(!TSTFLAG(Z));
-    break;
-  case 0xC3:      /* JP nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC3):      /* JP nnnn */
     cycles -= cycleTables[0][0xC3];
     Jpc(1);
-    break;
-  case 0xC4:      /* CALL NZ,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC4):      /* CALL NZ,nnnn */
     cycles -= cycleTables[0][0xC4];
     CALLC(!TSTFLAG(Z));
-    break;
-  case 0xC5:      /* PUSH BC */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC5):      /* PUSH BC */
     cycles -= cycleTables[0][0xC5];
     PUSH(BC);
-    break;
-  case 0xC6:      /* ADD A,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC6):      /* ADD A,nn */
     cycles -= cycleTables[0][0xC6];
     temp = GetBYTE_pp(pc);
     acu = hreg(AF);
@@ -1553,24 +1764,24 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0xC7:      /* RST 0 */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC7):      /* RST 0 */
     cycles -= cycleTables[0][0xC7];
     PUSH(pc); pc = 0;
-    break;
-  case 0xC8:      /* RET Z */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC8):      /* RET Z */
     cycles -= cycleTables[0][0xC8];
     if (TSTFLAG(Z)) POP(pc);
-    break;
-  case 0xC9:      /* RET */
+    Z80_NEXT;
+  Z80_CASE(main, 0xC9):      /* RET */
     cycles -= cycleTables[0][0xC9];
     POP(pc);
-    break;
-  case 0xCA:      /* JP Z,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xCA):      /* JP Z,nnnn */
     cycles -= cycleTables[0][0xCA];
     Jpc(TSTFLAG(Z));
-    break;
-  case 0xCB:      /* CB prefix */
+    Z80_NEXT;
+  Z80_CASE(main, 0xCB):      /* CB prefix */
     adr = HL;
     op = GetBYTE(pc);
     cycles -= cycleTables[1][op];
@@ -1651,16 +1862,16 @@ int CZ80::Run(int numCycles)
     case 6: PutBYTE(adr, temp);  break;
     case 7: Sethreg(AF, temp); break;
     }
-    break;
-  case 0xCC:      /* CALL Z,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xCC):      /* CALL Z,nnnn */
     cycles -= cycleTables[0][0xCC];
     CALLC(TSTFLAG(Z));
-    break;
-  case 0xCD:      /* CALL nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xCD):      /* CALL nnnn */
     cycles -= cycleTables[0][0xCD];
     CALLC(1);
-    break;
-  case 0xCE:      /* ADC A,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xCE):      /* ADC A,nn */
     cycles -= cycleTables[0][0xCE];
     temp = GetBYTE_pp(pc);
     acu = hreg(AF);
@@ -1670,36 +1881,36 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) |
       ((cbits >> 8) & 1);
-    break;
-  case 0xCF:      /* RST 8 */
+    Z80_NEXT;
+  Z80_CASE(main, 0xCF):      /* RST 8 */
     cycles -= cycleTables[0][0xCF];
     PUSH(pc); pc = 8;
-    break;
-  case 0xD0:      /* RET NC */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD0):      /* RET NC */
     cycles -= cycleTables[0][0xD0];
     if (!TSTFLAG(C)) POP(pc);
-    break;
-  case 0xD1:      /* POP DE */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD1):      /* POP DE */
     cycles -= cycleTables[0][0xD1];
     POP(DE);
-    break;
-  case 0xD2:      /* JP NC,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD2):      /* JP NC,nnnn */
     cycles -= cycleTables[0][0xD2];
     Jpc(!TSTFLAG(C));
-    break;
-  case 0xD3:      /* OUT (nn),A */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD3):      /* OUT (nn),A */
     cycles -= cycleTables[0][0xD3];
     OUTPUT(GetBYTE_pp(pc), hreg(AF));
-    break;
-  case 0xD4:      /* CALL NC,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD4):      /* CALL NC,nnnn */
     cycles -= cycleTables[0][0xD4];
     CALLC(!TSTFLAG(C));
-    break;
-  case 0xD5:      /* PUSH DE */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD5):      /* PUSH DE */
     cycles -= cycleTables[0][0xD5];
     PUSH(DE);
-    break;
-  case 0xD6:      /* SUB nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD6):      /* SUB nn */
     cycles -= cycleTables[0][0xD6];
     temp = GetBYTE_pp(pc);
     acu = hreg(AF);
@@ -1709,16 +1920,16 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0xD7:      /* RST 10H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD7):      /* RST 10H */
     cycles -= cycleTables[0][0xD7];
     PUSH(pc); pc = 0x10;
-    break;
-  case 0xD8:      /* RET C */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD8):      /* RET C */
     cycles -= cycleTables[0][0xD8];
     if (TSTFLAG(C)) POP(pc);
-    break;
-  case 0xD9:      /* EXX */
+    Z80_NEXT;
+  Z80_CASE(main, 0xD9):      /* EXX */
     cycles -= cycleTables[0][0xD9];
     regs[regs_sel].bc = BC;
     regs[regs_sel].de = DE;
@@ -1727,23 +1938,24 @@ int CZ80::Run(int numCycles)
     BC = regs[regs_sel].bc;
     DE = regs[regs_sel].de;
     HL = regs[regs_sel].hl;
-    break;
-  case 0xDA:      /* JP C,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xDA):      /* JP C,nnnn */
     cycles -= cycleTables[0][0xDA];
     Jpc(TSTFLAG(C));
-    break;
-  case 0xDB:      /* IN A,(nn) */
+    Z80_NEXT;
+  Z80_CASE(main, 0xDB):      /* IN A,(nn) */
     cycles -= cycleTables[0][0xDB];
     Sethreg(AF, INPUT(GetBYTE_pp(pc)));
-    break;
-  case 0xDC:      /* CALL C,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xDC):      /* CALL C,nnnn */
     cycles -= cycleTables[0][0xDC];
     CALLC(TSTFLAG(C));
-    break;
-  case 0xDD:      /* DD prefix */
+    Z80_NEXT;
+  Z80_CASE(main, 0xDD):      /* DD prefix */
     op = GetBYTE_pp(pc);
+    Z80_PREFIX_DISPATCH(dd);
     switch (op) {
-    case 0x09:      /* ADD IX,BC */
+    Z80_CASE(dd, 0x09):      /* ADD IX,BC */
       cycles -= cycleTables[3][0x09];
       IX &= 0xffff;
       BC &= 0xffff;
@@ -1752,8 +1964,8 @@ int CZ80::Run(int numCycles)
       IX = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x19:      /* ADD IX,DE */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x19):      /* ADD IX,DE */
       cycles -= cycleTables[3][0x19];
       IX &= 0xffff;
       DE &= 0xffff;
@@ -1762,23 +1974,23 @@ int CZ80::Run(int numCycles)
       IX = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x21:      /* LD IX,nnnn */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x21):      /* LD IX,nnnn */
       cycles -= cycleTables[3][0x21];
       IX = GetWORD(pc);
       pc += 2;
-      break;
-    case 0x22:      /* LD (nnnn),IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x22):      /* LD (nnnn),IX */
       cycles -= cycleTables[3][0x22];
       temp = GetWORD(pc);
       PutWORD(temp, IX);
       pc += 2;
-      break;
-    case 0x23:      /* INC IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x23):      /* INC IX */
       cycles -= cycleTables[3][0x23];
       ++IX;
-      break;
-    case 0x24:      /* INC IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x24):      /* INC IXH */
       cycles -= cycleTables[3][0x24];
       IX += 0x100;
       temp = hreg(IX);
@@ -1786,8 +1998,8 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0) << 4) |
         ((temp == 0x80) << 2);
-      break;
-    case 0x25:      /* DEC IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x25):      /* DEC IXH */
       cycles -= cycleTables[3][0x25];
       IX -= 0x100;
       temp = hreg(IX);
@@ -1795,12 +2007,12 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0xf) << 4) |
         ((temp == 0x7f) << 2) | 2;
-      break;
-    case 0x26:      /* LD IXH,nn */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x26):      /* LD IXH,nn */
       cycles -= cycleTables[3][0x26];
       Sethreg(IX, GetBYTE_pp(pc));
-      break;
-    case 0x29:      /* ADD IX,IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x29):      /* ADD IX,IX */
       cycles -= cycleTables[3][0x29];
       IX &= 0xffff;
       sum = IX + IX;
@@ -1808,18 +2020,18 @@ int CZ80::Run(int numCycles)
       IX = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x2A:      /* LD IX,(nnnn) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x2A):      /* LD IX,(nnnn) */
       cycles -= cycleTables[3][0x2A];
       temp = GetWORD(pc);
       IX = GetWORD(temp);
       pc += 2;
-      break;
-    case 0x2B:      /* DEC IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x2B):      /* DEC IX */
       cycles -= cycleTables[3][0x2B];
       --IX;
-      break;
-    case 0x2C:      /* INC IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x2C):      /* INC IXL */
       cycles -= cycleTables[3][0x2C];
       temp = lreg(IX)+1;
       Setlreg(IX, temp);
@@ -1827,8 +2039,8 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0) << 4) |
         ((temp == 0x80) << 2);
-      break;
-    case 0x2D:      /* DEC IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x2D):      /* DEC IXL */
       cycles -= cycleTables[3][0x2D];
       temp = lreg(IX)-1;
       Setlreg(IX, temp);
@@ -1836,12 +2048,12 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0xf) << 4) |
         ((temp == 0x7f) << 2) | 2;
-      break;
-    case 0x2E:      /* LD IXL,nn */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x2E):      /* LD IXL,nn */
       cycles -= cycleTables[3][0x2E];
       Setlreg(IX, GetBYTE_pp(pc));
-      break;
-    case 0x34:      /* INC (IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x34):      /* INC (IX+dd) */
       cycles -= cycleTables[3][0x34];
       adr = IX + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr)+1;
@@ -1850,8 +2062,8 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0) << 4) |
         ((temp == 0x80) << 2);
-      break;
-    case 0x35:      /* DEC (IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x35):      /* DEC (IX+dd) */
       cycles -= cycleTables[3][0x35];
       adr = IX + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr)-1;
@@ -1860,13 +2072,13 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0xf) << 4) |
         ((temp == 0x7f) << 2) | 2;
-      break;
-    case 0x36:      /* LD (IX+dd),nn */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x36):      /* LD (IX+dd),nn */
       cycles -= cycleTables[3][0x36];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, GetBYTE_pp(pc));
-      break;
-    case 0x39:      /* ADD IX,SP */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x39):      /* ADD IX,SP */
       cycles -= cycleTables[3][0x39];
       IX &= 0xffff;
       SP &= 0xffff;
@@ -1875,174 +2087,174 @@ int CZ80::Run(int numCycles)
       IX = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x44:      /* LD B,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x44):      /* LD B,IXH */
       cycles -= cycleTables[3][0x44];
       Sethreg(BC, hreg(IX));
-      break;
-    case 0x45:      /* LD B,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x45):      /* LD B,IXL */
       cycles -= cycleTables[3][0x45];
       Sethreg(BC, lreg(IX));
-      break;
-    case 0x46:      /* LD B,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x46):      /* LD B,(IX+dd) */
       cycles -= cycleTables[3][0x46];
       adr = IX + (signed char) GetBYTE_pp(pc);
       Sethreg(BC, GetBYTE(adr));
-      break;
-    case 0x4C:      /* LD C,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x4C):      /* LD C,IXH */
       cycles -= cycleTables[3][0x4C];
       Setlreg(BC, hreg(IX));
-      break;
-    case 0x4D:      /* LD C,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x4D):      /* LD C,IXL */
       cycles -= cycleTables[3][0x4D];
       Setlreg(BC, lreg(IX));
-      break;
-    case 0x4E:      /* LD C,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x4E):      /* LD C,(IX+dd) */
       cycles -= cycleTables[3][0x4E];
       adr = IX + (signed char) GetBYTE_pp(pc);
       Setlreg(BC, GetBYTE(adr));
-      break;
-    case 0x54:      /* LD D,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x54):      /* LD D,IXH */
       cycles -= cycleTables[3][0x54];
       Sethreg(DE, hreg(IX));
-      break;
-    case 0x55:      /* LD D,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x55):      /* LD D,IXL */
       cycles -= cycleTables[3][0x55];
       Sethreg(DE, lreg(IX));
-      break;
-    case 0x56:      /* LD D,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x56):      /* LD D,(IX+dd) */
       cycles -= cycleTables[3][0x56];
       adr = IX + (signed char) GetBYTE_pp(pc);
       Sethreg(DE, GetBYTE(adr));
-      break;
-    case 0x5C:      /* LD E,H */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x5C):      /* LD E,H */
       cycles -= cycleTables[3][0x5C];
       Setlreg(DE, hreg(IX));
-      break;
-    case 0x5D:      /* LD E,L */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x5D):      /* LD E,L */
       cycles -= cycleTables[3][0x5D];
       Setlreg(DE, lreg(IX));
-      break;
-    case 0x5E:      /* LD E,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x5E):      /* LD E,(IX+dd) */
       cycles -= cycleTables[3][0x5E];
       adr = IX + (signed char) GetBYTE_pp(pc);
       Setlreg(DE, GetBYTE(adr));
-      break;
-    case 0x60:      /* LD IXH,B */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x60):      /* LD IXH,B */
       cycles -= cycleTables[3][0x60];
       Sethreg(IX, hreg(BC));
-      break;
-    case 0x61:      /* LD IXH,C */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x61):      /* LD IXH,C */
       cycles -= cycleTables[3][0x61];
       Sethreg(IX, lreg(BC));
-      break;
-    case 0x62:      /* LD IXH,D */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x62):      /* LD IXH,D */
       cycles -= cycleTables[3][0x62];
       Sethreg(IX, hreg(DE));
-      break;
-    case 0x63:      /* LD IXH,E */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x63):      /* LD IXH,E */
       cycles -= cycleTables[3][0x63];
       Sethreg(IX, lreg(DE));
-      break;
-    case 0x64:      /* LD IXH,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x64):      /* LD IXH,IXH */
       cycles -= cycleTables[3][0x64];
       /* nop */
-      break;
-    case 0x65:      /* LD IXH,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x65):      /* LD IXH,IXL */
       cycles -= cycleTables[3][0x65];
       Sethreg(IX, lreg(IX));
-      break;
-    case 0x66:      /* LD H,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x66):      /* LD H,(IX+dd) */
       cycles -= cycleTables[3][0x66];
       adr = IX + (signed char) GetBYTE_pp(pc);
       Sethreg(HL, GetBYTE(adr));
-      break;
-    case 0x67:      /* LD IXH,A */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x67):      /* LD IXH,A */
       cycles -= cycleTables[3][0x67];
       Sethreg(IX, hreg(AF));
-      break;
-    case 0x68:      /* LD IXL,B */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x68):      /* LD IXL,B */
       cycles -= cycleTables[3][0x68];
       Setlreg(IX, hreg(BC));
-      break;
-    case 0x69:      /* LD IXL,C */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x69):      /* LD IXL,C */
       cycles -= cycleTables[3][0x69];
       Setlreg(IX, lreg(BC));
-      break;
-    case 0x6A:      /* LD IXL,D */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x6A):      /* LD IXL,D */
       cycles -= cycleTables[3][0x6A];
       Setlreg(IX, hreg(DE));
-      break;
-    case 0x6B:      /* LD IXL,E */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x6B):      /* LD IXL,E */
       cycles -= cycleTables[3][0x6B];
       Setlreg(IX, lreg(DE));
-      break;
-    case 0x6C:      /* LD IXL,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x6C):      /* LD IXL,IXH */
       cycles -= cycleTables[3][0x6C];
       Setlreg(IX, hreg(IX));
-      break;
-    case 0x6D:      /* LD IXL,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x6D):      /* LD IXL,IXL */
       cycles -= cycleTables[3][0x6D];
       /* nop */
-      break;
-    case 0x6E:      /* LD L,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x6E):      /* LD L,(IX+dd) */
       cycles -= cycleTables[3][0x6E];
       adr = IX + (signed char) GetBYTE_pp(pc);
       Setlreg(HL, GetBYTE(adr));
-      break;
-    case 0x6F:      /* LD IXL,A */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x6F):      /* LD IXL,A */
       cycles -= cycleTables[3][0x6F];
       Setlreg(IX, hreg(AF));
-      break;
-    case 0x70:      /* LD (IX+dd),B */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x70):      /* LD (IX+dd),B */
       cycles -= cycleTables[3][0x70];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(BC));
-      break;
-    case 0x71:      /* LD (IX+dd),C */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x71):      /* LD (IX+dd),C */
       cycles -= cycleTables[3][0x71];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, lreg(BC));
-      break;
-    case 0x72:      /* LD (IX+dd),D */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x72):      /* LD (IX+dd),D */
       cycles -= cycleTables[3][0x72];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(DE));
-      break;
-    case 0x73:      /* LD (IX+dd),E */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x73):      /* LD (IX+dd),E */
       cycles -= cycleTables[3][0x73];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, lreg(DE));
-      break;
-    case 0x74:      /* LD (IX+dd),H */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x74):      /* LD (IX+dd),H */
       cycles -= cycleTables[3][0x74];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(HL));
-      break;
-    case 0x75:      /* LD (IX+dd),L */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x75):      /* LD (IX+dd),L */
       cycles -= cycleTables[3][0x75];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, lreg(HL));
-      break;
-    case 0x77:      /* LD (IX+dd),A */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x77):      /* LD (IX+dd),A */
       cycles -= cycleTables[3][0x77];
       adr = IX + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(AF));
-      break;
-    case 0x7C:      /* LD A,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x7C):      /* LD A,IXH */
       cycles -= cycleTables[3][0x7C];
       Sethreg(AF, hreg(IX));
-      break;
-    case 0x7D:      /* LD A,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x7D):      /* LD A,IXL */
       cycles -= cycleTables[3][0x7D];
       Sethreg(AF, lreg(IX));
-      break;
-    case 0x7E:      /* LD A,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x7E):      /* LD A,(IX+dd) */
       cycles -= cycleTables[3][0x7E];
       adr = IX + (signed char) GetBYTE_pp(pc);
       Sethreg(AF, GetBYTE(adr));
-      break;
-    case 0x84:      /* ADD A,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x84):      /* ADD A,IXH */
       cycles -= cycleTables[3][0x84];
       temp = hreg(IX);
       acu = hreg(AF);
@@ -2052,8 +2264,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x85:      /* ADD A,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x85):      /* ADD A,IXL */
       cycles -= cycleTables[3][0x85];
       temp = lreg(IX);
       acu = hreg(AF);
@@ -2063,8 +2275,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x86:      /* ADD A,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x86):      /* ADD A,(IX+dd) */
       cycles -= cycleTables[3][0x86];
       adr = IX + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -2075,8 +2287,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x8C:      /* ADC A,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x8C):      /* ADC A,IXH */
       cycles -= cycleTables[3][0x8C];
       temp = hreg(IX);
       acu = hreg(AF);
@@ -2086,8 +2298,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x8D:      /* ADC A,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x8D):      /* ADC A,IXL */
       cycles -= cycleTables[3][0x8D];
       temp = lreg(IX);
       acu = hreg(AF);
@@ -2097,8 +2309,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x8E:      /* ADC A,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x8E):      /* ADC A,(IX+dd) */
       cycles -= cycleTables[3][0x8E];
       adr = IX + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -2109,8 +2321,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x94:      /* SUB IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x94):      /* SUB IXH */
       cycles -= cycleTables[3][0x94];
       temp = hreg(IX);
       acu = hreg(AF);
@@ -2120,8 +2332,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x95:      /* SUB IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x95):      /* SUB IXL */
       cycles -= cycleTables[3][0x95];
       temp = lreg(IX);
       acu = hreg(AF);
@@ -2131,8 +2343,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x96:      /* SUB (IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x96):      /* SUB (IX+dd) */
       cycles -= cycleTables[3][0x96];
       adr = IX + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -2143,8 +2355,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x9C:      /* SBC A,IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x9C):      /* SBC A,IXH */
       cycles -= cycleTables[3][0x9C];
       temp = hreg(IX);
       acu = hreg(AF);
@@ -2154,8 +2366,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x9D:      /* SBC A,IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x9D):      /* SBC A,IXL */
       cycles -= cycleTables[3][0x9D];
       temp = lreg(IX);
       acu = hreg(AF);
@@ -2165,8 +2377,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x9E:      /* SBC A,(IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0x9E):      /* SBC A,(IX+dd) */
       cycles -= cycleTables[3][0x9E];
       adr = IX + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -2177,59 +2389,59 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0xA4:      /* AND IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xA4):      /* AND IXH */
       cycles -= cycleTables[3][0xA4];
       sum = ((AF & (IX)) >> 8) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) |
         ((sum == 0) << 6) | 0x10 | partab[sum];
-      break;
-    case 0xA5:      /* AND IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xA5):      /* AND IXL */
       cycles -= cycleTables[3][0xA5];
       sum = ((AF >> 8) & IX) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | 0x10 |
         ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xA6:      /* AND (IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xA6):      /* AND (IX+dd) */
       cycles -= cycleTables[3][0xA6];
       adr = IX + (signed char) GetBYTE_pp(pc);
       sum = ((AF >> 8) & GetBYTE(adr)) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | 0x10 |
         ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xAC:      /* XOR IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xAC):      /* XOR IXH */
       cycles -= cycleTables[3][0xAC];
       sum = ((AF ^ (IX)) >> 8) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xAD:      /* XOR IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xAD):      /* XOR IXL */
       cycles -= cycleTables[3][0xAD];
       sum = ((AF >> 8) ^ IX) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xAE:      /* XOR (IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xAE):      /* XOR (IX+dd) */
       cycles -= cycleTables[3][0xAE];
       adr = IX + (signed char) GetBYTE_pp(pc);
       sum = ((AF >> 8) ^ GetBYTE(adr)) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xB4:      /* OR IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xB4):      /* OR IXH */
       cycles -= cycleTables[3][0xB4];
       sum = ((AF | (IX)) >> 8) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xB5:      /* OR IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xB5):      /* OR IXL */
       cycles -= cycleTables[3][0xB5];
       sum = ((AF >> 8) | IX) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xB6:      /* OR (IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xB6):      /* OR (IX+dd) */
       cycles -= cycleTables[3][0xB6];
       adr = IX + (signed char) GetBYTE_pp(pc);
       sum = ((AF >> 8) | GetBYTE(adr)) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xBC:      /* CP IXH */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xBC):      /* CP IXH */
       cycles -= cycleTables[3][0xBC];
       temp = hreg(IX);
       AF = (AF & ~0x28) | (temp & 0x28);
@@ -2240,8 +2452,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0xBD:      /* CP IXL */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xBD):      /* CP IXL */
       cycles -= cycleTables[3][0xBD];
       temp = lreg(IX);
       AF = (AF & ~0x28) | (temp & 0x28);
@@ -2252,8 +2464,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0xBE:      /* CP (IX+dd) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xBE):      /* CP (IX+dd) */
       cycles -= cycleTables[3][0xBE];
       adr = IX + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -2265,8 +2477,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0xCB:      /* CB prefix */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xCB):      /* CB prefix */
       adr = IX + (signed char) GetBYTE_pp(pc);
       adr = adr;
       op = GetBYTE(pc);
@@ -2348,31 +2560,31 @@ int CZ80::Run(int numCycles)
       case 6: PutBYTE(adr, temp);  break;
       case 7: Sethreg(AF, temp); break;
       }
-      break;
-    case 0xE1:      /* POP IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xE1):      /* POP IX */
       cycles -= cycleTables[3][0xE1];
       POP(IX);
-      break;
-    case 0xE3:      /* EX (SP),IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xE3):      /* EX (SP),IX */
       cycles -= cycleTables[3][0xE3];
       temp = IX; POP(IX); PUSH(temp);
-      break;
-    case 0xE5:      /* PUSH IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xE5):      /* PUSH IX */
       cycles -= cycleTables[3][0xE5];
       PUSH(IX);
-      break;
-    case 0xE9:      /* JP (IX) */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xE9):      /* JP (IX) */
       cycles -= cycleTables[3][0xE9];
       pc = IX;
-      break;
-    case 0xF9:      /* LD SP,IX */
+      Z80_NEXT;
+    Z80_CASE(dd, 0xF9):      /* LD SP,IX */
       cycles -= cycleTables[3][0xF9];
       SP = IX;
-      break;
-    default: pc--;    /* ignore DD */
+      Z80_NEXT;
+    Z80_DEFAULT(dd): pc--;    /* ignore DD */
     }
-    break;
-  case 0xDE:      /* SBC A,nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xDE):      /* SBC A,nn */
     cycles -= cycleTables[0][0xDE];
     temp = GetBYTE_pp(pc);
     acu = hreg(AF);
@@ -2382,81 +2594,82 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       ((cbits >> 8) & 1);
-    break;
-  case 0xDF:      /* RST 18H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xDF):      /* RST 18H */
     cycles -= cycleTables[0][0xDF];
     PUSH(pc); pc = 0x18;
-    break;
-  case 0xE0:      /* RET PO */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE0):      /* RET PO */
     cycles -= cycleTables[0][0xE0];
     if (!TSTFLAG(P)) POP(pc);
-    break;
-  case 0xE1:      /* POP HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE1):      /* POP HL */
     cycles -= cycleTables[0][0xE1];
     POP(HL);
-    break;
-  case 0xE2:      /* JP PO,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE2):      /* JP PO,nnnn */
     cycles -= cycleTables[0][0xE2];
     Jpc(!TSTFLAG(P));
-    break;
-  case 0xE3:      /* EX (SP),HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE3):      /* EX (SP),HL */
     cycles -= cycleTables[0][0xE3];
     temp = HL; POP(HL); PUSH(temp);
-    break;
-  case 0xE4:      /* CALL PO,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE4):      /* CALL PO,nnnn */
     cycles -= cycleTables[0][0xE4];
     CALLC(!TSTFLAG(P));
-    break;
-  case 0xE5:      /* PUSH HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE5):      /* PUSH HL */
     cycles -= cycleTables[0][0xE5];
     PUSH(HL);
-    break;
-  case 0xE6:      /* AND nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE6):      /* AND nn */
     cycles -= cycleTables[0][0xE6];
     sum = ((AF >> 8) & GetBYTE_pp(pc)) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | 0x10 |
       ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xE7:      /* RST 20H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE7):      /* RST 20H */
     cycles -= cycleTables[0][0xE7];
     PUSH(pc); pc = 0x20;
-    break;
-  case 0xE8:      /* RET PE */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE8):      /* RET PE */
     cycles -= cycleTables[0][0xE8];
     if (TSTFLAG(P)) POP(pc);
-    break;
-  case 0xE9:      /* JP (HL) */
+    Z80_NEXT;
+  Z80_CASE(main, 0xE9):      /* JP (HL) */
     cycles -= cycleTables[0][0xE9];
     pc = HL;
-    break;
-  case 0xEA:      /* JP PE,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xEA):      /* JP PE,nnnn */
     cycles -= cycleTables[0][0xEA];
     Jpc(TSTFLAG(P));
-    break;
-  case 0xEB:      /* EX DE,HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0xEB):      /* EX DE,HL */
     cycles -= cycleTables[0][0xEB];
     temp = HL; HL = DE; DE = temp;
-    break;
-  case 0xEC:      /* CALL PE,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xEC):      /* CALL PE,nnnn */
     cycles -= cycleTables[0][0xEC];
     CALLC(TSTFLAG(P));
-    break;
-  case 0xED:      /* ED prefix */
+    Z80_NEXT;
+  Z80_CASE(main, 0xED):      /* ED prefix */
     op = GetBYTE_pp(pc);
+    Z80_PREFIX_DISPATCH(ed);
     switch (op) {
-    case 0x40:      /* IN B,(C) */
+    Z80_CASE(ed, 0x40):      /* IN B,(C) */
       cycles -= cycleTables[2][0x40];
       temp = INPUT(lreg(BC));
       Sethreg(BC, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x41:      /* OUT (C),B */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x41):      /* OUT (C),B */
       cycles -= cycleTables[2][0x41];
       OUTPUT(lreg(BC), BC);
-      break;
-    case 0x42:      /* SBC HL,BC */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x42):      /* SBC HL,BC */
       cycles -= cycleTables[2][0x42];
       HL &= 0xffff;
       BC &= 0xffff;
@@ -2467,47 +2680,47 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | 2 | ((cbits >> 8) & 1);
-      break;
-    case 0x43:      /* LD (nnnn),BC */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x43):      /* LD (nnnn),BC */
       cycles -= cycleTables[2][0x43];
       temp = GetWORD(pc);
       PutWORD(temp, BC);
       pc += 2;
-      break;
-    case 0x44:      /* NEG */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x44):      /* NEG */
       cycles -= cycleTables[2][0x44];
       temp = hreg(AF);
       AF = (-(AF & 0xff00) & 0xff00);
       AF |= ((AF >> 8) & 0xa8) | (((AF & 0xff00) == 0) << 6) |
         (((temp & 0x0f) != 0) << 4) | ((temp == 0x80) << 2) |
         2 | (temp != 0);
-      break;
-    case 0x45:      /* RETN */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x45):      /* RETN */
       cycles -= cycleTables[2][0x45];
       iff |= iff >> 1;
       POP(pc);
-      break;
-    case 0x46:      /* IM 0 */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x46):      /* IM 0 */
       cycles -= cycleTables[2][0x46];
       im = 0; // interrupt mode 0
-      break;
-    case 0x47:      /* LD I,A */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x47):      /* LD I,A */
       cycles -= cycleTables[2][0x47];
       ir = (ir & 255) | (AF & ~255);
-      break;
-    case 0x48:      /* IN C,(C) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x48):      /* IN C,(C) */
       cycles -= cycleTables[2][0x48];
       temp = INPUT(lreg(BC));
       Setlreg(BC, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x49:      /* OUT (C),C */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x49):      /* OUT (C),C */
       cycles -= cycleTables[2][0x49];
       OUTPUT(lreg(BC), BC);
-      break;
-    case 0x4A:      /* ADC HL,BC */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x4A):      /* ADC HL,BC */
       cycles -= cycleTables[2][0x4A];
       HL &= 0xffff;
       BC &= 0xffff;
@@ -2518,35 +2731,35 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x4B:      /* LD BC,(nnnn) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x4B):      /* LD BC,(nnnn) */
       cycles -= cycleTables[2][0x4B];
       temp = GetWORD(pc);
       BC = GetWORD(temp);
       pc += 2;
-      break;
-    case 0x4D:      /* RETI */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x4D):      /* RETI */
       cycles -= cycleTables[2][0x4D];
       iff |= iff >> 1;
       POP(pc);
-      break;
-    case 0x4F:      /* LD R,A */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x4F):      /* LD R,A */
       cycles -= cycleTables[2][0x4F];
       ir = (ir & ~255) | ((AF >> 8) & 255);
-      break;
-    case 0x50:      /* IN D,(C) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x50):      /* IN D,(C) */
       cycles -= cycleTables[2][0x50];
       temp = INPUT(lreg(BC));
       Sethreg(DE, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x51:      /* OUT (C),D */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x51):      /* OUT (C),D */
       cycles -= cycleTables[2][0x51];
       OUTPUT(lreg(BC), DE);
-      break;
-    case 0x52:      /* SBC HL,DE */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x52):      /* SBC HL,DE */
       cycles -= cycleTables[2][0x52];
       HL &= 0xffff;
       DE &= 0xffff;
@@ -2557,34 +2770,34 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | 2 | ((cbits >> 8) & 1);
-      break;
-    case 0x53:      /* LD (nnnn),DE */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x53):      /* LD (nnnn),DE */
       cycles -= cycleTables[2][0x53];
       temp = GetWORD(pc);
       PutWORD(temp, DE);
       pc += 2;
-      break;
-    case 0x56:      /* IM 1 */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x56):      /* IM 1 */
       cycles -= cycleTables[2][0x56];
       im = 1; // interrupt mode 1
-      break;
-    case 0x57:      /* LD A,I */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x57):      /* LD A,I */
       cycles -= cycleTables[2][0x57];
       AF = (AF & 0x29) | (ir & ~255) | ((ir >> 8) & 0x80) | (((ir & ~255) == 0) << 6) | ((iff & 2) << 1);
-      break;
-    case 0x58:      /* IN E,(C) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x58):      /* IN E,(C) */
       cycles -= cycleTables[2][0x58];
       temp = INPUT(lreg(BC));
       Setlreg(DE, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x59:      /* OUT (C),E */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x59):      /* OUT (C),E */
       cycles -= cycleTables[2][0x59];
       OUTPUT(lreg(BC), DE);
-      break;
-    case 0x5A:      /* ADC HL,DE */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x5A):      /* ADC HL,DE */
       cycles -= cycleTables[2][0x5A];
       HL &= 0xffff;
       DE &= 0xffff;
@@ -2595,34 +2808,34 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x5B:      /* LD DE,(nnnn) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x5B):      /* LD DE,(nnnn) */
       cycles -= cycleTables[2][0x5B];
       temp = GetWORD(pc);
       DE = GetWORD(temp);
       pc += 2;
-      break;
-    case 0x5E:      /* IM 2 */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x5E):      /* IM 2 */
       cycles -= cycleTables[2][0x5E];
       im = 2; // interrupt mode 2
-      break;
-    case 0x5F:      /* LD A,R */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x5F):      /* LD A,R */
       cycles -= cycleTables[2][0x5F];
       AF = (AF & 0x29) | ((ir & 255) << 8) | (ir & 0x80) | (((ir & 255) == 0) << 6) | ((iff & 2) << 1);
-      break;
-    case 0x60:      /* IN H,(C) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x60):      /* IN H,(C) */
       cycles -= cycleTables[2][0x60];
       temp = INPUT(lreg(BC));
       Sethreg(HL, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x61:      /* OUT (C),H */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x61):      /* OUT (C),H */
       cycles -= cycleTables[2][0x61];
       OUTPUT(lreg(BC), HL);
-      break;
-    case 0x62:      /* SBC HL,HL */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x62):      /* SBC HL,HL */
       cycles -= cycleTables[2][0x62];
       HL &= 0xffff;
       sum = HL - HL - TSTFLAG(C);
@@ -2632,14 +2845,14 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | 2 | ((cbits >> 8) & 1);
-      break;
-    case 0x63:      /* LD (nnnn),HL */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x63):      /* LD (nnnn),HL */
       cycles -= cycleTables[2][0x63];
       temp = GetWORD(pc);
       PutWORD(temp, HL);
       pc += 2;
-      break;
-    case 0x67:      /* RRD */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x67):      /* RRD */
       cycles -= cycleTables[2][0x67];
       temp = GetBYTE(HL);
       acu = hreg(AF);
@@ -2647,20 +2860,20 @@ int CZ80::Run(int numCycles)
       acu = (acu & 0xf0) | ldig(temp);
       AF = (acu << 8) | (acu & 0xa8) | (((acu & 0xff) == 0) << 6) |
         partab[acu] | (AF & 1);
-      break;
-    case 0x68:      /* IN L,(C) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x68):      /* IN L,(C) */
       cycles -= cycleTables[2][0x68];
       temp = INPUT(lreg(BC));
       Setlreg(HL, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x69:      /* OUT (C),L */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x69):      /* OUT (C),L */
       cycles -= cycleTables[2][0x69];
       OUTPUT(lreg(BC), HL);
-      break;
-    case 0x6A:      /* ADC HL,HL */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x6A):      /* ADC HL,HL */
       cycles -= cycleTables[2][0x6A];
       HL &= 0xffff;
       sum = HL + HL + TSTFLAG(C);
@@ -2670,14 +2883,14 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x6B:      /* LD HL,(nnnn) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x6B):      /* LD HL,(nnnn) */
       cycles -= cycleTables[2][0x6B];
       temp = GetWORD(pc);
       HL = GetWORD(temp);
       pc += 2;
-      break;
-    case 0x6F:      /* RLD */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x6F):      /* RLD */
       cycles -= cycleTables[2][0x6F];
       temp = GetBYTE(HL);
       acu = hreg(AF);
@@ -2685,20 +2898,20 @@ int CZ80::Run(int numCycles)
       acu = (acu & 0xf0) | hdig(temp);
       AF = (acu << 8) | (acu & 0xa8) | (((acu & 0xff) == 0) << 6) |
         partab[acu] | (AF & 1);
-      break;
-    case 0x70:      /* IN (C) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x70):      /* IN (C) */
       cycles -= cycleTables[2][0x70];
       temp = INPUT(lreg(BC));
       Setlreg(temp, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x71:      /* OUT (C),0 */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x71):      /* OUT (C),0 */
       cycles -= cycleTables[2][0x71];
       OUTPUT(lreg(BC), 0);
-      break;
-    case 0x72:      /* SBC HL,SP */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x72):      /* SBC HL,SP */
       cycles -= cycleTables[2][0x72];
       HL &= 0xffff;
       SP &= 0xffff;
@@ -2709,26 +2922,26 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | 2 | ((cbits >> 8) & 1);
-      break;
-    case 0x73:      /* LD (nnnn),SP */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x73):      /* LD (nnnn),SP */
       cycles -= cycleTables[2][0x73];
       temp = GetWORD(pc);
       PutWORD(temp, SP);
       pc += 2;
-      break;
-    case 0x78:      /* IN A,(C) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x78):      /* IN A,(C) */
       cycles -= cycleTables[2][0x78];
       temp = INPUT(lreg(BC));
       Sethreg(AF, temp);
       AF = (AF & ~0xfe) | (temp & 0xa8) |
         (((temp & 0xff) == 0) << 6) |
         parity(temp);
-      break;
-    case 0x79:      /* OUT (C),A */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x79):      /* OUT (C),A */
       cycles -= cycleTables[2][0x79];
       OUTPUT(lreg(BC), AF);
-      break;
-    case 0x7A:      /* ADC HL,SP */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x7A):      /* ADC HL,SP */
       cycles -= cycleTables[2][0x7A];
       HL &= 0xffff;
       SP &= 0xffff;
@@ -2739,22 +2952,22 @@ int CZ80::Run(int numCycles)
         (((sum & 0xffff) == 0) << 6) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x7B:      /* LD SP,(nnnn) */
+      Z80_NEXT;
+    Z80_CASE(ed, 0x7B):      /* LD SP,(nnnn) */
       cycles -= cycleTables[2][0x7B];
       temp = GetWORD(pc);
       SP = GetWORD(temp);
       pc += 2;
-      break;
-    case 0xA0:      /* LDI */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xA0):      /* LDI */
       cycles -= cycleTables[2][0xA0];
       acu = GetBYTE_pp(HL);
       PutBYTE_pp(DE, acu);
       acu += hreg(AF);
       AF = (AF & ~0x3e) | (acu & 8) | ((acu & 2) << 4) |
         (((--BC & 0xffff) != 0) << 2);
-      break;
-    case 0xA1:      /* CPI */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xA1):      /* CPI */
       cycles -= cycleTables[2][0xA1];
       acu = hreg(AF);
       temp = GetBYTE_pp(HL);
@@ -2766,29 +2979,29 @@ int CZ80::Run(int numCycles)
         ((--BC & 0xffff) != 0) << 2 | 2;
       if ((sum & 15) == 8 && (cbits & 16) != 0)
         AF &= ~8;
-      break;
-    case 0xA2:      /* INI */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xA2):      /* INI */
       cycles -= cycleTables[2][0xA2];
       PutBYTE(HL, INPUT(lreg(BC))); ++HL;
       SETFLAG(N, 1);
       SETFLAG(P, (--BC & 0xffff) != 0);
-      break;
-    case 0xA3:      /* OUTI */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xA3):      /* OUTI */
       cycles -= cycleTables[2][0xA3];
       OUTPUT(lreg(BC), GetBYTE(HL)); ++HL;
       SETFLAG(N, 1);
       Sethreg(BC, hreg(BC) - 1);
       SETFLAG(Z, hreg(BC) == 0);
-      break;
-    case 0xA8:      /* LDD */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xA8):      /* LDD */
       cycles -= cycleTables[2][0xA8];
       acu = GetBYTE_mm(HL);
       PutBYTE_mm(DE, acu);
       acu += hreg(AF);
       AF = (AF & ~0x3e) | (acu & 8) | ((acu & 2) << 4) |
         (((--BC & 0xffff) != 0) << 2);
-      break;
-    case 0xA9:      /* CPD */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xA9):      /* CPD */
       cycles -= cycleTables[2][0xA9];
       acu = hreg(AF);
       temp = GetBYTE_mm(HL);
@@ -2800,22 +3013,22 @@ int CZ80::Run(int numCycles)
         ((--BC & 0xffff) != 0) << 2 | 2;
       if ((sum & 15) == 8 && (cbits & 16) != 0)
         AF &= ~8;
-      break;
-    case 0xAA:      /* IND */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xAA):      /* IND */
       cycles -= cycleTables[2][0xAA];
       PutBYTE(HL, INPUT(lreg(BC))); --HL;
       SETFLAG(N, 1);
       Sethreg(BC, lreg(BC) - 1);
       SETFLAG(Z, lreg(BC) == 0);
-      break;
-    case 0xAB:      /* OUTD */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xAB):      /* OUTD */
       cycles -= cycleTables[2][0xAB];
       OUTPUT(lreg(BC), GetBYTE(HL)); --HL;
       SETFLAG(N, 1);
       Sethreg(BC, hreg(BC) - 1);
       SETFLAG(Z, hreg(BC) == 0);
-      break;
-    case 0xB0:      /* LDIR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xB0):      /* LDIR */
       cycles -= cycleTables[2][0xB0];
       acu = hreg(AF);
       BC &= 0xffff;
@@ -2825,8 +3038,8 @@ int CZ80::Run(int numCycles)
       } while (--BC);
       acu += hreg(AF);
       AF = (AF & ~0x3e) | (acu & 8) | ((acu & 2) << 4);
-      break;
-    case 0xB1:      /* CPIR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xB1):      /* CPIR */
       cycles -= cycleTables[2][0xB1];
       acu = hreg(AF);
       BC &= 0xffff;
@@ -2842,8 +3055,8 @@ int CZ80::Run(int numCycles)
         op << 2 | 2;
       if ((sum & 15) == 8 && (cbits & 16) != 0)
         AF &= ~8;
-      break;
-    case 0xB2:      /* INIR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xB2):      /* INIR */
       cycles -= cycleTables[2][0xB2];
       temp = hreg(BC);
       do {
@@ -2852,8 +3065,8 @@ int CZ80::Run(int numCycles)
       Sethreg(BC, 0);
       SETFLAG(N, 1);
       SETFLAG(Z, 1);
-      break;
-    case 0xB3:      /* OTIR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xB3):      /* OTIR */
       cycles -= cycleTables[2][0xB3];
       temp = hreg(BC);
       do {
@@ -2862,8 +3075,8 @@ int CZ80::Run(int numCycles)
       Sethreg(BC, 0);
       SETFLAG(N, 1);
       SETFLAG(Z, 1);
-      break;
-    case 0xB8:      /* LDDR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xB8):      /* LDDR */
       cycles -= cycleTables[2][0xB8];
       BC &= 0xffff;
       do {
@@ -2872,8 +3085,8 @@ int CZ80::Run(int numCycles)
       } while (--BC);
       acu += hreg(AF);
       AF = (AF & ~0x3e) | (acu & 8) | ((acu & 2) << 4);
-      break;
-    case 0xB9:      /* CPDR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xB9):      /* CPDR */
       cycles -= cycleTables[2][0xB9];
       acu = hreg(AF);
       BC &= 0xffff;
@@ -2889,8 +3102,8 @@ int CZ80::Run(int numCycles)
         op << 2 | 2;
       if ((sum & 15) == 8 && (cbits & 16) != 0)
         AF &= ~8;
-      break;
-    case 0xBA:      /* INDR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xBA):      /* INDR */
       cycles -= cycleTables[2][0xBA];
       temp = hreg(BC);
       do {
@@ -2899,8 +3112,8 @@ int CZ80::Run(int numCycles)
       Sethreg(BC, 0);
       SETFLAG(N, 1);
       SETFLAG(Z, 1);
-      break;
-    case 0xBB:      /* OTDR */
+      Z80_NEXT;
+    Z80_CASE(ed, 0xBB):      /* OTDR */
       cycles -= cycleTables[2][0xBB];
       temp = hreg(BC);
       do {
@@ -2909,76 +3122,77 @@ int CZ80::Run(int numCycles)
       Sethreg(BC, 0);
       SETFLAG(N, 1);
       SETFLAG(Z, 1);
-      break;
-    default: if (0x40 <= op && op <= 0x7f) pc--;    /* ignore ED */
+      Z80_NEXT;
+    Z80_DEFAULT(ed): if (0x40 <= op && op <= 0x7f) pc--;    /* ignore ED */
     }
-    break;
-  case 0xEE:      /* XOR nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xEE):      /* XOR nn */
     cycles -= cycleTables[0][0xEE];
     sum = ((AF >> 8) ^ GetBYTE_pp(pc)) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xEF:      /* RST 28H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xEF):      /* RST 28H */
     cycles -= cycleTables[0][0xEF];
     PUSH(pc); pc = 0x28;
-    break;
-  case 0xF0:      /* RET P */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF0):      /* RET P */
     cycles -= cycleTables[0][0xF0];
     if (!TSTFLAG(S)) POP(pc);
-    break;
-  case 0xF1:      /* POP AF */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF1):      /* POP AF */
     cycles -= cycleTables[0][0xF1];
     POP(AF);
-    break;
-  case 0xF2:      /* JP P,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF2):      /* JP P,nnnn */
     cycles -= cycleTables[0][0xF2];
     Jpc(!TSTFLAG(S));
-    break;
-  case 0xF3:      /* DI */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF3):      /* DI */
     cycles -= cycleTables[0][0xF3];
     iff = 0;
-    break;
-  case 0xF4:      /* CALL P,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF4):      /* CALL P,nnnn */
     cycles -= cycleTables[0][0xF4];
     CALLC(!TSTFLAG(S));
-    break;
-  case 0xF5:      /* PUSH AF */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF5):      /* PUSH AF */
     cycles -= cycleTables[0][0xF5];
     PUSH(AF);
-    break;
-  case 0xF6:      /* OR nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF6):      /* OR nn */
     cycles -= cycleTables[0][0xF6];
     sum = ((AF >> 8) | GetBYTE_pp(pc)) & 0xff;
     AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-    break;
-  case 0xF7:      /* RST 30H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF7):      /* RST 30H */
     cycles -= cycleTables[0][0xF7];
     PUSH(pc); pc = 0x30;
-    break;
-  case 0xF8:      /* RET M */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF8):      /* RET M */
     cycles -= cycleTables[0][0xF8];
     if (TSTFLAG(S)) POP(pc);
-    break;
-  case 0xF9:      /* LD SP,HL */
+    Z80_NEXT;
+  Z80_CASE(main, 0xF9):      /* LD SP,HL */
     cycles -= cycleTables[0][0xF9];
     SP = HL;
-    break;
-  case 0xFA:      /* JP M,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xFA):      /* JP M,nnnn */
     cycles -= cycleTables[0][0xFA];
     Jpc(TSTFLAG(S));
-    break;
-  case 0xFB:      /* EI */
+    Z80_NEXT;
+  Z80_CASE(main, 0xFB):      /* EI */
     cycles -= cycleTables[0][0xFB];
     iff = 3;
-    break;
-  case 0xFC:      /* CALL M,nnnn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xFC):      /* CALL M,nnnn */
     cycles -= cycleTables[0][0xFC];
     CALLC(TSTFLAG(S));
-    break;
-  case 0xFD:      /* FD prefix */
+    Z80_NEXT;
+  Z80_CASE(main, 0xFD):      /* FD prefix */
     op = GetBYTE_pp(pc);
+    Z80_PREFIX_DISPATCH(fd);
     switch (op) {
-    case 0x09:      /* ADD IY,BC */
+    Z80_CASE(fd, 0x09):      /* ADD IY,BC */
       cycles -= cycleTables[3][0x09];
       IY &= 0xffff;
       BC &= 0xffff;
@@ -2987,8 +3201,8 @@ int CZ80::Run(int numCycles)
       IY = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x19:      /* ADD IY,DE */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x19):      /* ADD IY,DE */
       cycles -= cycleTables[3][0x19];
       IY &= 0xffff;
       DE &= 0xffff;
@@ -2997,23 +3211,23 @@ int CZ80::Run(int numCycles)
       IY = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x21:      /* LD IY,nnnn */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x21):      /* LD IY,nnnn */
       cycles -= cycleTables[3][0x21];
       IY = GetWORD(pc);
       pc += 2;
-      break;
-    case 0x22:      /* LD (nnnn),IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x22):      /* LD (nnnn),IY */
       cycles -= cycleTables[3][0x22];
       temp = GetWORD(pc);
       PutWORD(temp, IY);
       pc += 2;
-      break;
-    case 0x23:      /* INC IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x23):      /* INC IY */
       cycles -= cycleTables[3][0x23];
       ++IY;
-      break;
-    case 0x24:      /* INC IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x24):      /* INC IYH */
       cycles -= cycleTables[3][0x24];
       IY += 0x100;
       temp = hreg(IY);
@@ -3021,8 +3235,8 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0) << 4) |
         ((temp == 0x80) << 2);
-      break;
-    case 0x25:      /* DEC IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x25):      /* DEC IYH */
       cycles -= cycleTables[3][0x25];
       IY -= 0x100;
       temp = hreg(IY);
@@ -3030,12 +3244,12 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0xf) << 4) |
         ((temp == 0x7f) << 2) | 2;
-      break;
-    case 0x26:      /* LD IYH,nn */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x26):      /* LD IYH,nn */
       cycles -= cycleTables[3][0x26];
       Sethreg(IY, GetBYTE_pp(pc));
-      break;
-    case 0x29:      /* ADD IY,IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x29):      /* ADD IY,IY */
       cycles -= cycleTables[3][0x29];
       IY &= 0xffff;
       sum = IY + IY;
@@ -3043,18 +3257,18 @@ int CZ80::Run(int numCycles)
       IY = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x2A:      /* LD IY,(nnnn) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x2A):      /* LD IY,(nnnn) */
       cycles -= cycleTables[3][0x2A];
       temp = GetWORD(pc);
       IY = GetWORD(temp);
       pc += 2;
-      break;
-    case 0x2B:      /* DEC IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x2B):      /* DEC IY */
       cycles -= cycleTables[3][0x2B];
       --IY;
-      break;
-    case 0x2C:      /* INC IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x2C):      /* INC IYL */
       cycles -= cycleTables[3][0x2C];
       temp = lreg(IY)+1;
       Setlreg(IY, temp);
@@ -3062,8 +3276,8 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0) << 4) |
         ((temp == 0x80) << 2);
-      break;
-    case 0x2D:      /* DEC IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x2D):      /* DEC IYL */
       cycles -= cycleTables[3][0x2D];
       temp = lreg(IY)-1;
       Setlreg(IY, temp);
@@ -3071,12 +3285,12 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0xf) << 4) |
         ((temp == 0x7f) << 2) | 2;
-      break;
-    case 0x2E:      /* LD IYL,nn */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x2E):      /* LD IYL,nn */
       cycles -= cycleTables[3][0x2E];
       Setlreg(IY, GetBYTE_pp(pc));
-      break;
-    case 0x34:      /* INC (IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x34):      /* INC (IY+dd) */
       cycles -= cycleTables[3][0x34];
       adr = IY + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr)+1;
@@ -3085,8 +3299,8 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0) << 4) |
         ((temp == 0x80) << 2);
-      break;
-    case 0x35:      /* DEC (IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x35):      /* DEC (IY+dd) */
       cycles -= cycleTables[3][0x35];
       adr = IY + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr)-1;
@@ -3095,13 +3309,13 @@ int CZ80::Run(int numCycles)
         (((temp & 0xff) == 0) << 6) |
         (((temp & 0xf) == 0xf) << 4) |
         ((temp == 0x7f) << 2) | 2;
-      break;
-    case 0x36:      /* LD (IY+dd),nn */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x36):      /* LD (IY+dd),nn */
       cycles -= cycleTables[3][0x36];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, GetBYTE_pp(pc));
-      break;
-    case 0x39:      /* ADD IY,SP */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x39):      /* ADD IY,SP */
       cycles -= cycleTables[3][0x39];
       IY &= 0xffff;
       SP &= 0xffff;
@@ -3110,174 +3324,174 @@ int CZ80::Run(int numCycles)
       IY = sum;
       AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0x44:      /* LD B,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x44):      /* LD B,IYH */
       cycles -= cycleTables[3][0x44];
       Sethreg(BC, hreg(IY));
-      break;
-    case 0x45:      /* LD B,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x45):      /* LD B,IYL */
       cycles -= cycleTables[3][0x45];
       Sethreg(BC, lreg(IY));
-      break;
-    case 0x46:      /* LD B,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x46):      /* LD B,(IY+dd) */
       cycles -= cycleTables[3][0x46];
       adr = IY + (signed char) GetBYTE_pp(pc);
       Sethreg(BC, GetBYTE(adr));
-      break;
-    case 0x4C:      /* LD C,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x4C):      /* LD C,IYH */
       cycles -= cycleTables[3][0x4C];
       Setlreg(BC, hreg(IY));
-      break;
-    case 0x4D:      /* LD C,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x4D):      /* LD C,IYL */
       cycles -= cycleTables[3][0x4D];
       Setlreg(BC, lreg(IY));
-      break;
-    case 0x4E:      /* LD C,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x4E):      /* LD C,(IY+dd) */
       cycles -= cycleTables[3][0x4E];
       adr = IY + (signed char) GetBYTE_pp(pc);
       Setlreg(BC, GetBYTE(adr));
-      break;
-    case 0x54:      /* LD D,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x54):      /* LD D,IYH */
       cycles -= cycleTables[3][0x54];
       Sethreg(DE, hreg(IY));
-      break;
-    case 0x55:      /* LD D,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x55):      /* LD D,IYL */
       cycles -= cycleTables[3][0x55];
       Sethreg(DE, lreg(IY));
-      break;
-    case 0x56:      /* LD D,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x56):      /* LD D,(IY+dd) */
       cycles -= cycleTables[3][0x56];
       adr = IY + (signed char) GetBYTE_pp(pc);
       Sethreg(DE, GetBYTE(adr));
-      break;
-    case 0x5C:      /* LD E,H */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x5C):      /* LD E,H */
       cycles -= cycleTables[3][0x5C];
       Setlreg(DE, hreg(IY));
-      break;
-    case 0x5D:      /* LD E,L */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x5D):      /* LD E,L */
       cycles -= cycleTables[3][0x5D];
       Setlreg(DE, lreg(IY));
-      break;
-    case 0x5E:      /* LD E,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x5E):      /* LD E,(IY+dd) */
       cycles -= cycleTables[3][0x5E];
       adr = IY + (signed char) GetBYTE_pp(pc);
       Setlreg(DE, GetBYTE(adr));
-      break;
-    case 0x60:      /* LD IYH,B */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x60):      /* LD IYH,B */
       cycles -= cycleTables[3][0x60];
       Sethreg(IY, hreg(BC));
-      break;
-    case 0x61:      /* LD IYH,C */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x61):      /* LD IYH,C */
       cycles -= cycleTables[3][0x61];
       Sethreg(IY, lreg(BC));
-      break;
-    case 0x62:      /* LD IYH,D */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x62):      /* LD IYH,D */
       cycles -= cycleTables[3][0x62];
       Sethreg(IY, hreg(DE));
-      break;
-    case 0x63:      /* LD IYH,E */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x63):      /* LD IYH,E */
       cycles -= cycleTables[3][0x63];
       Sethreg(IY, lreg(DE));
-      break;
-    case 0x64:      /* LD IYH,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x64):      /* LD IYH,IYH */
       cycles -= cycleTables[3][0x64];
       /* nop */
-      break;
-    case 0x65:      /* LD IYH,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x65):      /* LD IYH,IYL */
       cycles -= cycleTables[3][0x65];
       Sethreg(IY, lreg(IY));
-      break;
-    case 0x66:      /* LD H,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x66):      /* LD H,(IY+dd) */
       cycles -= cycleTables[3][0x66];
       adr = IY + (signed char) GetBYTE_pp(pc);
       Sethreg(HL, GetBYTE(adr));
-      break;
-    case 0x67:      /* LD IYH,A */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x67):      /* LD IYH,A */
       cycles -= cycleTables[3][0x67];
       Sethreg(IY, hreg(AF));
-      break;
-    case 0x68:      /* LD IYL,B */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x68):      /* LD IYL,B */
       cycles -= cycleTables[3][0x68];
       Setlreg(IY, hreg(BC));
-      break;
-    case 0x69:      /* LD IYL,C */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x69):      /* LD IYL,C */
       cycles -= cycleTables[3][0x69];
       Setlreg(IY, lreg(BC));
-      break;
-    case 0x6A:      /* LD IYL,D */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x6A):      /* LD IYL,D */
       cycles -= cycleTables[3][0x6A];
       Setlreg(IY, hreg(DE));
-      break;
-    case 0x6B:      /* LD IYL,E */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x6B):      /* LD IYL,E */
       cycles -= cycleTables[3][0x6B];
       Setlreg(IY, lreg(DE));
-      break;
-    case 0x6C:      /* LD IYL,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x6C):      /* LD IYL,IYH */
       cycles -= cycleTables[3][0x6C];
       Setlreg(IY, hreg(IY));
-      break;
-    case 0x6D:      /* LD IYL,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x6D):      /* LD IYL,IYL */
       cycles -= cycleTables[3][0x6D];
       /* nop */
-      break;
-    case 0x6E:      /* LD L,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x6E):      /* LD L,(IY+dd) */
       cycles -= cycleTables[3][0x6E];
       adr = IY + (signed char) GetBYTE_pp(pc);
       Setlreg(HL, GetBYTE(adr));
-      break;
-    case 0x6F:      /* LD IYL,A */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x6F):      /* LD IYL,A */
       cycles -= cycleTables[3][0x6F];
       Setlreg(IY, hreg(AF));
-      break;
-    case 0x70:      /* LD (IY+dd),B */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x70):      /* LD (IY+dd),B */
       cycles -= cycleTables[3][0x70];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(BC));
-      break;
-    case 0x71:      /* LD (IY+dd),C */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x71):      /* LD (IY+dd),C */
       cycles -= cycleTables[3][0x71];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, lreg(BC));
-      break;
-    case 0x72:      /* LD (IY+dd),D */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x72):      /* LD (IY+dd),D */
       cycles -= cycleTables[3][0x72];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(DE));
-      break;
-    case 0x73:      /* LD (IY+dd),E */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x73):      /* LD (IY+dd),E */
       cycles -= cycleTables[3][0x73];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, lreg(DE));
-      break;
-    case 0x74:      /* LD (IY+dd),H */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x74):      /* LD (IY+dd),H */
       cycles -= cycleTables[3][0x74];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(HL));
-      break;
-    case 0x75:      /* LD (IY+dd),L */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x75):      /* LD (IY+dd),L */
       cycles -= cycleTables[3][0x75];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, lreg(HL));
-      break;
-    case 0x77:      /* LD (IY+dd),A */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x77):      /* LD (IY+dd),A */
       cycles -= cycleTables[3][0x77];
       adr = IY + (signed char) GetBYTE_pp(pc);
       PutBYTE(adr, hreg(AF));
-      break;
-    case 0x7C:      /* LD A,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x7C):      /* LD A,IYH */
       cycles -= cycleTables[3][0x7C];
       Sethreg(AF, hreg(IY));
-      break;
-    case 0x7D:      /* LD A,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x7D):      /* LD A,IYL */
       cycles -= cycleTables[3][0x7D];
       Sethreg(AF, lreg(IY));
-      break;
-    case 0x7E:      /* LD A,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x7E):      /* LD A,(IY+dd) */
       cycles -= cycleTables[3][0x7E];
       adr = IY + (signed char) GetBYTE_pp(pc);
       Sethreg(AF, GetBYTE(adr));
-      break;
-    case 0x84:      /* ADD A,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x84):      /* ADD A,IYH */
       cycles -= cycleTables[3][0x84];
       temp = hreg(IY);
       acu = hreg(AF);
@@ -3287,8 +3501,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x85:      /* ADD A,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x85):      /* ADD A,IYL */
       cycles -= cycleTables[3][0x85];
       temp = lreg(IY);
       acu = hreg(AF);
@@ -3298,8 +3512,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x86:      /* ADD A,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x86):      /* ADD A,(IY+dd) */
       cycles -= cycleTables[3][0x86];
       adr = IY + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -3310,8 +3524,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x8C:      /* ADC A,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x8C):      /* ADC A,IYH */
       cycles -= cycleTables[3][0x8C];
       temp = hreg(IY);
       acu = hreg(AF);
@@ -3321,8 +3535,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x8D:      /* ADC A,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x8D):      /* ADC A,IYL */
       cycles -= cycleTables[3][0x8D];
       temp = lreg(IY);
       acu = hreg(AF);
@@ -3332,8 +3546,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x8E:      /* ADC A,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x8E):      /* ADC A,(IY+dd) */
       cycles -= cycleTables[3][0x8E];
       adr = IY + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -3344,8 +3558,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) |
         ((cbits >> 8) & 1);
-      break;
-    case 0x94:      /* SUB IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x94):      /* SUB IYH */
       cycles -= cycleTables[3][0x94];
       temp = hreg(IY);
       acu = hreg(AF);
@@ -3355,8 +3569,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x95:      /* SUB IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x95):      /* SUB IYL */
       cycles -= cycleTables[3][0x95];
       temp = lreg(IY);
       acu = hreg(AF);
@@ -3366,8 +3580,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x96:      /* SUB (IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x96):      /* SUB (IY+dd) */
       cycles -= cycleTables[3][0x96];
       adr = IY + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -3378,8 +3592,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x9C:      /* SBC A,IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x9C):      /* SBC A,IYH */
       cycles -= cycleTables[3][0x9C];
       temp = hreg(IY);
       acu = hreg(AF);
@@ -3389,8 +3603,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x9D:      /* SBC A,IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x9D):      /* SBC A,IYL */
       cycles -= cycleTables[3][0x9D];
       temp = lreg(IY);
       acu = hreg(AF);
@@ -3400,8 +3614,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0x9E:      /* SBC A,(IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0x9E):      /* SBC A,(IY+dd) */
       cycles -= cycleTables[3][0x9E];
       adr = IY + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -3412,59 +3626,59 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (cbits & 0x10) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         ((cbits >> 8) & 1);
-      break;
-    case 0xA4:      /* AND IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xA4):      /* AND IYH */
       cycles -= cycleTables[3][0xA4];
       sum = ((AF & (IY)) >> 8) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) |
         ((sum == 0) << 6) | 0x10 | partab[sum];
-      break;
-    case 0xA5:      /* AND IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xA5):      /* AND IYL */
       cycles -= cycleTables[3][0xA5];
       sum = ((AF >> 8) & IY) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | 0x10 |
         ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xA6:      /* AND (IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xA6):      /* AND (IY+dd) */
       cycles -= cycleTables[3][0xA6];
       adr = IY + (signed char) GetBYTE_pp(pc);
       sum = ((AF >> 8) & GetBYTE(adr)) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | 0x10 |
         ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xAC:      /* XOR IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xAC):      /* XOR IYH */
       cycles -= cycleTables[3][0xAC];
       sum = ((AF ^ (IY)) >> 8) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xAD:      /* XOR IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xAD):      /* XOR IYL */
       cycles -= cycleTables[3][0xAD];
       sum = ((AF >> 8) ^ IY) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xAE:      /* XOR (IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xAE):      /* XOR (IY+dd) */
       cycles -= cycleTables[3][0xAE];
       adr = IY + (signed char) GetBYTE_pp(pc);
       sum = ((AF >> 8) ^ GetBYTE(adr)) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xB4:      /* OR IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xB4):      /* OR IYH */
       cycles -= cycleTables[3][0xB4];
       sum = ((AF | (IY)) >> 8) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xB5:      /* OR IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xB5):      /* OR IYL */
       cycles -= cycleTables[3][0xB5];
       sum = ((AF >> 8) | IY) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xB6:      /* OR (IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xB6):      /* OR (IY+dd) */
       cycles -= cycleTables[3][0xB6];
       adr = IY + (signed char) GetBYTE_pp(pc);
       sum = ((AF >> 8) | GetBYTE(adr)) & 0xff;
       AF = (sum << 8) | (sum & 0xa8) | ((sum == 0) << 6) | partab[sum];
-      break;
-    case 0xBC:      /* CP IYH */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xBC):      /* CP IYH */
       cycles -= cycleTables[3][0xBC];
       temp = hreg(IY);
       AF = (AF & ~0x28) | (temp & 0x28);
@@ -3475,8 +3689,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0xBD:      /* CP IYL */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xBD):      /* CP IYL */
       cycles -= cycleTables[3][0xBD];
       temp = lreg(IY);
       AF = (AF & ~0x28) | (temp & 0x28);
@@ -3487,8 +3701,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0xBE:      /* CP (IY+dd) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xBE):      /* CP (IY+dd) */
       cycles -= cycleTables[3][0xBE];
       adr = IY + (signed char) GetBYTE_pp(pc);
       temp = GetBYTE(adr);
@@ -3500,8 +3714,8 @@ int CZ80::Run(int numCycles)
         (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
         (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
         (cbits & 0x10) | ((cbits >> 8) & 1);
-      break;
-    case 0xCB:      /* CB prefix */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xCB):      /* CB prefix */
       adr = IY + (signed char) GetBYTE_pp(pc);
       adr = adr;
       op = GetBYTE(pc);
@@ -3583,31 +3797,31 @@ int CZ80::Run(int numCycles)
       case 6: PutBYTE(adr, temp);  break;
       case 7: Sethreg(AF, temp); break;
       }
-      break;
-    case 0xE1:      /* POP IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xE1):      /* POP IY */
       cycles -= cycleTables[3][0xE1];
       POP(IY);
-      break;
-    case 0xE3:      /* EX (SP),IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xE3):      /* EX (SP),IY */
       cycles -= cycleTables[3][0xE3];
       temp = IY; POP(IY); PUSH(temp);
-      break;
-    case 0xE5:      /* PUSH IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xE5):      /* PUSH IY */
       cycles -= cycleTables[3][0xE5];
       PUSH(IY);
-      break;
-    case 0xE9:      /* JP (IY) */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xE9):      /* JP (IY) */
       cycles -= cycleTables[3][0xE9];
       pc = IY;
-      break;
-    case 0xF9:      /* LD SP,IY */
+      Z80_NEXT;
+    Z80_CASE(fd, 0xF9):      /* LD SP,IY */
       cycles -= cycleTables[3][0xF9];
       SP = IY;
-      break;
-    default: pc--;    /* ignore DD */
+      Z80_NEXT;
+    Z80_DEFAULT(fd): pc--;    /* ignore DD */
     }
-    break;
-  case 0xFE:      /* CP nn */
+    Z80_NEXT;
+  Z80_CASE(main, 0xFE):      /* CP nn */
     cycles -= cycleTables[0][0xFE];
     temp = GetBYTE_pp(pc);
     AF = (AF & ~0x28) | (temp & 0x28);
@@ -3618,11 +3832,11 @@ int CZ80::Run(int numCycles)
       (((sum & 0xff) == 0) << 6) | (temp & 0x28) |
       (((cbits >> 6) ^ (cbits >> 5)) & 4) | 2 |
       (cbits & 0x10) | ((cbits >> 8) & 1);
-    break;
-  case 0xFF:      /* RST 38H */
+    Z80_NEXT;
+  Z80_CASE(main, 0xFF):      /* RST 38H */
     cycles -= cycleTables[0][0xFF];
     PUSH(pc); pc = 0x38;
-    break;
+    Z80_NEXT;
     }
     
   // Interrupts
@@ -3791,6 +4005,216 @@ HALTExit:
     return numCycles - cycles;
 }
 
+int CZ80::Run(int numCycles)
+{
+#if defined(Z80_LOCKSTEP)
+  return RunLockstep(numCycles);
+#elif defined(Z80_THREADED_CODE)
+  return Execute<true>(numCycles);
+#else
+  return Execute<false>(numCycles);
+#endif
+}
+
+void CZ80::MapMemory(UINT32 start, UINT32 end, const UINT8 *readPtr, UINT8 *writePtr)
+{
+  // Only whole pages lying within the region can be mapped
+  for (UINT32 page = (start + 0xFF) >> 8; page <= 0xFF && (page << 8) + 0xFF <= end; page++)
+  {
+    UINT32 offset = (page << 8) - start;
+    readMap[page] = (readPtr != NULL) ? readPtr + offset : NULL;
+    writeMap[page] = (writePtr != NULL) ? writePtr + offset : NULL;
+  }
+}
+
+#ifdef Z80_LOCKSTEP
+/*
+ * Lockstep validation:
+ *
+ * The threaded core runs first against the real bus through a CLockstepBus in
+ * record mode. The switch core then runs the same number of cycles on a copy
+ * of the initial state with the CLockstepBus in replay mode, which supplies
+ * the recorded read data and interrupt vectors (so that device side effects
+ * only happen once) and checks that every access matches.
+ */
+class CZ80::CLockstepBus final : public IBus
+{
+public:
+  enum AccessType
+  {
+    MemRead = 0,
+    MemWrite,
+    IORead,
+    IOWrite,
+    Interrupt
+  };
+
+  struct Access
+  {
+    AccessType  type;
+    UINT32      addr;
+    int         data;
+    bool        intLine;    // interrupt state of threaded core after access (bus handlers may change it)
+    bool        nmiTrigger;
+  };
+
+  CZ80                *cpu;       // CPU currently running
+  IBus                *bus;       // real bus when recording, NULL when replaying
+  int                 (*callback)(CZ80 *Z80); // real interrupt callback
+  std::vector<Access> log;
+  size_t              replayIdx;
+  bool                mismatch;   // only first mismatch in each run is reported
+
+  void Mismatch(const char *fmt, ...)
+  {
+    if (mismatch)
+      return;
+    mismatch = true;
+    char msg[256];
+    va_list vl;
+    va_start(vl, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, vl);
+    va_end(vl);
+    ErrorLog("Z80 lockstep mismatch at PC=%04X (%s core): %s", cpu->pc, bus != NULL ? "threaded" : "switch", msg);
+  }
+
+  void Record(AccessType type, UINT32 addr, int data)
+  {
+    Access access = { type, addr, data, cpu->intLine, cpu->nmiTrigger };
+    log.push_back(access);
+  }
+
+  int Replay(AccessType type, UINT32 addr, int data)
+  {
+    static const char *names[] = { "read", "write", "IO read", "IO write", "interrupt" };
+    if (replayIdx >= log.size())
+    {
+      Mismatch("unexpected %s of %04X", names[type], addr);
+      return 0xFF;
+    }
+    const Access &access = log[replayIdx++];
+    if (access.type != type || access.addr != addr || ((type == MemWrite || type == IOWrite) && access.data != data))
+      Mismatch("%s of %04X (%02X), threaded core made %s of %04X (%02X)", names[type], addr, data & 0xFF, names[access.type], access.addr, access.data & 0xFF);
+    cpu->intLine = access.intLine;
+    cpu->nmiTrigger = access.nmiTrigger;
+    return access.data;
+  }
+
+  UINT8 Read8(UINT32 addr)
+  {
+    if (bus == NULL)
+      return (UINT8) Replay(MemRead, addr, 0);
+    UINT8 data = bus->Read8(addr);
+    const UINT8 *page = cpu->readMap[addr>>8];
+    if (page != NULL && page[addr&0xFF] != data)
+      Mismatch("mapped memory at %04X reads %02X but bus returns %02X", addr, page[addr&0xFF], data);
+    Record(MemRead, addr, data);
+    return data;
+  }
+
+  void Write8(UINT32 addr, UINT8 data)
+  {
+    if (bus == NULL)
+    {
+      Replay(MemWrite, addr, data);
+      return;
+    }
+    bus->Write8(addr, data);
+    const UINT8 *page = cpu->writeMap[addr>>8];
+    if (page != NULL && page[addr&0xFF] != data)
+      Mismatch("bus write of %02X to %04X does not reach mapped memory", data, addr);
+    Record(MemWrite, addr, data);
+  }
+
+  UINT8 IORead8(UINT32 addr)
+  {
+    if (bus == NULL)
+      return (UINT8) Replay(IORead, addr, 0);
+    UINT8 data = bus->IORead8(addr);
+    Record(IORead, addr, data);
+    return data;
+  }
+
+  void IOWrite8(UINT32 addr, UINT8 data)
+  {
+    if (bus == NULL)
+    {
+      Replay(IOWrite, addr, data);
+      return;
+    }
+    bus->IOWrite8(addr, data);
+    Record(IOWrite, addr, data);
+  }
+
+  static void FormatState(const CZ80 &z80, char *buf, size_t size)
+  {
+    snprintf(buf, size, "PC=%04X SP=%04X AF=%04X BC=%04X DE=%04X HL=%04X IX=%04X IY=%04X AF'=%04X BC'=%04X DE'=%04X HL'=%04X IR=%04X IFF=%X IM=%d sel=%d/%d INT=%d NMI=%d",
+      z80.pc, z80.sp, z80.af[0], z80.regs[0].bc, z80.regs[0].de, z80.regs[0].hl, z80.ix, z80.iy, z80.af[1], z80.regs[1].bc, z80.regs[1].de, z80.regs[1].hl,
+      z80.ir, z80.iff, z80.im, z80.af_sel, z80.regs_sel, z80.intLine, z80.nmiTrigger);
+  }
+};
+
+int CZ80::LockstepINTCallback(CZ80 *Z80)
+{
+  CLockstepBus *ls = Z80->lockstep;
+  if (ls->bus == NULL)
+    return ls->Replay(CLockstepBus::Interrupt, 0, 0);
+  int v = ls->callback(Z80);
+  ls->Record(CLockstepBus::Interrupt, 0, v);
+  return v;
+}
+
+int CZ80::RunLockstep(int numCycles)
+{
+  if (lockstep == NULL)
+    lockstep = new CLockstepBus();
+  CLockstepBus *ls = lockstep;
+
+  // Switch core will start from same state
+  CZ80 ref(*this);
+
+  // Run threaded core, recording all bus activity and interrupt vectors
+  IBus *realBus = Bus;
+  int (*realCallback)(CZ80 *Z80) = INTCallback;
+  ls->cpu = this;
+  ls->bus = realBus;
+  ls->callback = realCallback;
+  ls->log.clear();
+  ls->replayIdx = 0;
+  ls->mismatch = false;
+  Bus = ls;
+  if (realCallback != NULL)
+    INTCallback = LockstepINTCallback;
+  int cycles = Execute<true>(numCycles);
+  Bus = realBus;
+  INTCallback = realCallback;
+
+  // Replay with switch core
+  ls->cpu = &ref;
+  ls->bus = NULL;
+  ref.Bus = ls;
+  if (realCallback != NULL)
+    ref.INTCallback = LockstepINTCallback;
+  int refCycles = ref.Execute<false>(numCycles);
+  ref.lockstep = NULL;
+  if (ls->replayIdx != ls->log.size())
+    ls->Mismatch("%u fewer bus accesses than threaded core", (unsigned) (ls->log.size() - ls->replayIdx));
+
+  // Compare final state
+  char threadedState[256];
+  char switchState[256];
+  CLockstepBus::FormatState(*this, threadedState, sizeof(threadedState));
+  CLockstepBus::FormatState(ref, switchState, sizeof(switchState));
+  if (cycles != refCycles || strcmp(threadedState, switchState) != 0)
+  {
+    ErrorLog("Z80 lockstep mismatch after %d cycles (switch core ran %d):", cycles, refCycles);
+    ErrorLog("  threaded: %s", threadedState);
+    ErrorLog("  switch:   %s", switchState);
+  }
+  return cycles;
+}
+#endif // Z80_LOCKSTEP
+
 void CZ80::TriggerNMI(void)
 {
   nmiTrigger = true;
@@ -3976,6 +4400,13 @@ void CZ80::Init(IBus *BusPtr, int (*INTF)(CZ80 *Z80))
 {
   Bus = BusPtr;
   INTCallback = INTF;
+  
+  // No memory is mapped until MapMemory() is called
+  for (int i = 0; i < 256; i++)
+  {
+    readMap[i] = NULL;
+    writeMap[i] = NULL;
+  }
 }
 
 #ifdef SUPERMODEL_DEBUGGER
@@ -4000,6 +4431,14 @@ CZ80::CZ80(void)
 {
   INTCallback = NULL; // so we can later check to see if one has been installed
   Bus = NULL;
+  for (int i = 0; i < 256; i++)
+  {
+    readMap[i] = NULL;
+    writeMap[i] = NULL;
+  }
+#ifdef Z80_LOCKSTEP
+  lockstep = NULL;
+#endif // Z80_LOCKSTEP
 #ifdef SUPERMODEL_DEBUGGER
   Debug = NULL;
 #endif //SUPERMODEL_DEBUGGER
@@ -4007,6 +4446,10 @@ CZ80::CZ80(void)
 
 CZ80::~CZ80(void)
 {
+#ifdef Z80_LOCKSTEP
+  delete lockstep;
+  lockstep = NULL;
+#endif // Z80_LOCKSTEP
   INTCallback = NULL;
   Bus = NULL;
 #ifdef SUPERMODEL_DEBUGGER
@@ -38,6 +38,19 @@
  *  - HALT instruction is not implemented (it just exits).
  *  - 16-bit words are read as two bytes but these reads may not occur in
  *    the exact same order as the real device. Needs to be checked.
+ *
+ * Build options:
+ *
+ *  - With GCC and Clang, instructions are dispatched as threaded code
+ *    (computed goto through per-prefix opcode tables). Define
+ *    Z80_SWITCH_CORE to use the portable switch-based dispatch instead. The
+ *    switch core is always used when the debugger is enabled.
+ *  - Define Z80_LOCKSTEP to validate the threaded core against the switch
+ *    core: every call to Run() is repeated by the switch core on a copy of
+ *    the CPU state, fed the bus data and interrupt vectors recorded from the
+ *    threaded core, and any difference in bus activity or final state is
+ *    reported. Memory is always accessed through the bus so that mappings
+ *    set up with MapMemory() are checked against it as well. Very slow.
  */
 
 #ifndef INCLUDED_Z80_H
@@ -279,6 +292,26 @@ public:
    */
   void Init(IBus *BusPtr, int (*INTF)(CZ80 *Z80));
 
+  /*
+   * MapMemory(start, end, readPtr, writePtr):
+   *
+   * Maps a region of the address space directly onto memory, bypassing the
+   * bus. Intended for ROM and RAM, which make up most accesses. Must be
+   * called after Init(). The bus must behave identically for these
+   * addresses because it is still used when the debugger is attached.
+   * Mappings have a granularity of 256 bytes and only whole pages within the
+   * region are mapped.
+   *
+   * Parameters:
+   *    start     Start address of region.
+   *    end       End address of region (inclusive).
+   *    readPtr   Memory that reads from start are taken from, or NULL if
+   *              reads should go through the bus.
+   *    writePtr  Memory that writes to start are stored in, or NULL if
+   *              writes should go through the bus (e.g. for ROM).
+   */
+  void MapMemory(UINT32 start, UINT32 end, const UINT8 *readPtr, UINT8 *writePtr);
+
 #ifdef SUPERMODEL_DEBUGGER
   /*
    * AttachDebugger(DebugPtr):
@@ -324,6 +357,8 @@ private:
   
   // Memory and IO bus
   IBus  *Bus;
+  const UINT8 *readMap[256];  // directly mapped 256-byte pages (NULL if accessed through bus)
+  UINT8 *writeMap[256];
   
   // Interrupts
   bool  nmiTrigger;
@@ -334,6 +369,22 @@ private:
   int   lastCycles;
   Debugger::CZ80Debug *Debug;
 #endif // SUPERMODEL_DEBUGGER
+
+#ifdef Z80_LOCKSTEP
+  class CLockstepBus;
+  CLockstepBus *lockstep;   // records bus activity of threaded core for replay by switch core
+  
+  static int LockstepINTCallback(CZ80 *Z80);
+  int RunLockstep(int numCycles);
+#endif // Z80_LOCKSTEP
+
+  // Memory access (through mapped pages if possible)
+  UINT8 ReadMem(UINT32 addr);
+  void  WriteMem(UINT32 addr, UINT8 data);
+
+  // Instruction execution loop (threaded or switch dispatch)
+  template <bool threaded>
+  int Execute(int numCycles);
 };
 
 #endif  // INCLUDED_Z80_H
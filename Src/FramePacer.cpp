@@ -0,0 +1,80 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * FramePacer.cpp
+ *
+ * Frame rate limiter. Implementation of the CFramePacer class.
+ *
+ * OS sleeps are only accurate to about a millisecond (worse on some
+ * systems), so the wait sleeps until SPIN_TIME before the deadline and then
+ * polls the clock. Each deadline is one period after the previous one, not
+ * after the time the wait actually returned. If the loop falls more than
+ * MAX_LAG periods behind (a slow frame, a pause, or a debugger break), the
+ * schedule restarts rather than running frames back to back to catch up.
+ */
+
+#include "FramePacer.h"
+#include <thread>
+
+static const std::chrono::microseconds SPIN_TIME(1000);
+static const int MAX_LAG = 2;
+
+void CFramePacer::Wait(void)
+{
+  Clock::time_point now = Clock::now();
+  if (m_vsyncLocked || now - m_deadline > MAX_LAG * m_period)
+  {
+    m_deadline = now + m_period;
+    return;
+  }
+
+  if (m_deadline - now > SPIN_TIME)
+    std::this_thread::sleep_for(m_deadline - now - SPIN_TIME);
+  while (Clock::now() < m_deadline)
+    std::this_thread::yield();
+
+  m_deadline += m_period;
+}
+
+void CFramePacer::Reset(void)
+{
+  m_deadline = Clock::now() + m_period;
+}
+
+void CFramePacer::SetVSyncLocked(bool locked)
+{
+  m_vsyncLocked = locked;
+}
+
+double CFramePacer::GetRefreshRate(void) const
+{
+  return m_refreshRate;
+}
+
+CFramePacer::CFramePacer(double refreshRate)
+  : m_refreshRate(refreshRate > 0 ? refreshRate : 60.0),
+    m_vsyncLocked(false)
+{
+  m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_refreshRate));
+  Reset();
+}
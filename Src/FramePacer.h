@@ -0,0 +1,102 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * FramePacer.h
+ *
+ * Header file for the frame rate limiter.
+ */
+
+#ifndef INCLUDED_FRAMEPACER_H
+#define INCLUDED_FRAMEPACER_H
+
+#include <chrono>
+
+/*
+ * CFramePacer:
+ *
+ * Holds the main loop to a target refresh rate. Frame deadlines are laid out
+ * on a fixed schedule so that oversleeping on one frame is made up on the
+ * next rather than accumulating as drift. The wait sleeps until shortly
+ * before the deadline and spins only for the remainder, so a core is not
+ * kept busy for the whole frame.
+ *
+ * When VSync is locked (the display refreshes at the target rate and buffer
+ * swaps are synchronized to it), the swap itself paces the loop and Wait()
+ * only keeps the schedule in step.
+ */
+class CFramePacer
+{
+public:
+  /*
+   * Wait(void):
+   *
+   * Waits for the end of the current frame period.
+   */
+  void Wait(void);
+
+  /*
+   * Reset(void):
+   *
+   * Restarts the schedule from the current time. Should be called after any
+   * interruption (e.g., when throttling is re-enabled).
+   */
+  void Reset(void);
+
+  /*
+   * SetVSyncLocked(locked):
+   *
+   * Parameters:
+   *    locked  True if buffer swaps already pace frames at the target rate.
+   */
+  void SetVSyncLocked(bool locked);
+
+  /*
+   * GetRefreshRate(void):
+   *
+   * Returns:
+   *    Target refresh rate in Hz.
+   */
+  double GetRefreshRate(void) const;
+
+  /*
+   * CFramePacer(refreshRate):
+   *
+   * Constructor.
+   *
+   * Parameters:
+   *    refreshRate   Target refresh rate in Hz (e.g., 57.524 for the Model 3
+   *                  video timing). Non-positive values select 60 Hz.
+   */
+  CFramePacer(double refreshRate);
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  double              m_refreshRate;
+  Clock::duration     m_period;
+  Clock::time_point   m_deadline;   // end of current frame
+  bool                m_vsyncLocked;
+};
+
+
+#endif  // INCLUDED_FRAMEPACER_H
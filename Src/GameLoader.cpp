@@ -5,8 +5,11 @@
 #include "Util/ByteSwap.h"
 #include "Util/Format.h"
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <system_error>
+#include <thread>
 
 bool GameLoader::LoadZipArchive(ZipArchive *zip, const std::string &zipfilename) const
 {
@@ -28,7 +31,8 @@ bool GameLoader::LoadZipArchive(ZipArchive *zip, const std::string &zipfilename)
     if (UNZ_OK != unzGetCurrentFileInfo(zf, &file_info, filename_buffer, sizeof(filename_buffer), NULL, 0, NULL, 0))
       continue;
     zip->files_by_crc[file_info.crc].zf = zf;
-    zip->files_by_crc[file_info.crc].zipfilename = filename_buffer;
+    zip->files_by_crc[file_info.crc].zipfilename = zipfilename;
+    zip->files_by_crc[file_info.crc].zip_idx = zip->zfs.size() - 1;
     zip->files_by_crc[file_info.crc].filename = filename_buffer;
     zip->files_by_crc[file_info.crc].uncompressed_size = file_info.uncompressed_size;
     zip->files_by_crc[file_info.crc].crc32 = file_info.crc;
@@ -89,36 +93,49 @@ const GameLoader::ZippedFile *GameLoader::LookupFile(const File::ptr_t &file, co
   return nullptr;
 }
 
-bool GameLoader::LoadZippedFile(std::shared_ptr<uint8_t> *buffer, size_t *file_size, const GameLoader::File::ptr_t &file, const ZipArchive &zip) const
+bool GameLoader::LoadZippedFile(std::shared_ptr<uint8_t> *buffer, size_t *file_size, const GameLoader::File::ptr_t &file, const ZipArchive &zip, std::vector<unzFile> *zfs) const
 {
   // Locate file
   const ZippedFile *zipped_file = LookupFile(file, zip);
   if (!zipped_file)
     return true;
-  if (UNZ_OK != unzLocateFile(zipped_file->zf, zipped_file->filename.c_str(), 2))
+
+  // Each loader thread reads through its own handle because minizip handles
+  // cannot be shared between threads
+  unzFile &zf = (*zfs)[zipped_file->zip_idx];
+  if (!zf)
+  {
+    zf = unzOpen(zipped_file->zipfilename.c_str());
+    if (!zf)
+    {
+      ErrorLog("Could not open '%s'.", zipped_file->zipfilename.c_str());
+      return true;
+    }
+  }
+  if (UNZ_OK != unzLocateFile(zf, zipped_file->filename.c_str(), 2))
   {
     ErrorLog("Unable to locate '%s' in '%s'. Is zip file corrupt?", zipped_file->filename.c_str(), zipped_file->zipfilename.c_str());
     return true;
   }
   
   // Read it in
-  if (UNZ_OK != unzOpenCurrentFile(zipped_file->zf))
+  if (UNZ_OK != unzOpenCurrentFile(zf))
   {
     ErrorLog("Unable to read '%s' from '%s'. Is zip file corrupt?", zipped_file->filename.c_str(), zipped_file->zipfilename.c_str());
     return true;
   }
   *file_size = zipped_file->uncompressed_size;
   buffer->reset(new uint8_t[*file_size], std::default_delete<uint8_t[]>());
-  ZPOS64_T bytes_read = unzReadCurrentFile(zipped_file->zf, buffer->get(), *file_size);
+  ZPOS64_T bytes_read = unzReadCurrentFile(zf, buffer->get(), *file_size);
   if (bytes_read != *file_size)
   {
     ErrorLog("Unable to read '%s' from '%s'. Is zip file corrupt?", zipped_file->filename.c_str(), zipped_file->zipfilename.c_str());
-    unzCloseCurrentFile(zipped_file->zf);
+    unzCloseCurrentFile(zf);
     return true;
   }
   
   // And close it
-  if (UNZ_CRCERROR == unzCloseCurrentFile(zipped_file->zf))
+  if (UNZ_CRCERROR == unzCloseCurrentFile(zf))
     ErrorLog("CRC error reading '%s' from '%s'. File may be corrupt.", zipped_file->filename.c_str(), zipped_file->zipfilename.c_str());
   return false;
 }
@@ -707,45 +724,160 @@ static inline void CopyBytes(uint8_t *dest_base, uint32_t dest_offset, const uin
   }
 }
 
-bool GameLoader::LoadRegion(ROM *rom, const GameLoader::Region::ptr_t &region, const ZipArchive &zip) const
+// Interleaves 16-bit chunks (the common case for graphics ROMs), optionally
+// swapping the bytes of each. Destination offset must be even.
+static void Interleave16(uint8_t *dest, const uint8_t *src, uint32_t num_chunks, uint32_t stride, bool byte_swap)
 {
-  bool error = false;
-  for (auto &file: region->files)
+  if (byte_swap)
+  {
+    for (uint32_t i = 0; i < num_chunks; i++)
+    {
+      uint16_t chunk;
+      memcpy(&chunk, src, 2);
+      chunk = uint16_t((chunk >> 8) | (chunk << 8));
+      memcpy(dest, &chunk, 2);
+      src += 2;
+      dest += stride;
+    }
+  }
+  else
+  {
+    for (uint32_t i = 0; i < num_chunks; i++)
+    {
+      memcpy(dest, src, 2);
+      src += 2;
+      dest += stride;
+    }
+  }
+}
+
+bool GameLoader::LoadFileIntoRegion(LoadJob *job, const ZipArchive &zip, std::vector<unzFile> *zfs) const
+{
+  auto &region = job->region;
+  auto &file = job->file;
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<uint8_t> tmp;
+  size_t file_size;
+  if (LoadZippedFile(&tmp, &file_size, file, zip, zfs))
+    return true;
+  auto inflated = std::chrono::steady_clock::now();
+
+  // Files within a region occupy disjoint bytes, so several may be copied in at once
+  uint8_t *dest = job->rom->data.get();
+  uint8_t *src = tmp.get();
+  if (region->chunk_size == region->stride && (!region->byte_swap || (file->offset & 1) == 0))
   {
-    std::shared_ptr<uint8_t> tmp;
-    size_t file_size;
-    error |= LoadZippedFile(&tmp, &file_size, file, zip);
-    if (!error)
+    memcpy(dest + file->offset, src, file_size);
+    if (region->byte_swap)
+      Util::FlipEndian16(dest + file->offset, file_size);
+  }
+  else
+  {
+    uint32_t num_chunks = (uint32_t)file_size / region->chunk_size;
+    uint32_t dest_offset = file->offset;
+    uint32_t src_offset = 0;
+    uint32_t chunk_size = (uint32_t)region->chunk_size;		// cache these as pointer dereferencing cripples performance in a tight loop
+    uint32_t stride = (uint32_t)region->stride;
+    uint32_t byte_swap = region->byte_swap;
+    if (chunk_size == 2 && (dest_offset & 1) == 0 && (stride & 1) == 0)
+      Interleave16(dest + dest_offset, src, num_chunks, stride, byte_swap != 0);
+    else if (!byte_swap)
     {
-      uint8_t *dest = rom->data.get();
-      uint8_t *src = tmp.get();
-      if (region->chunk_size == region->stride)
+      for (uint32_t i = 0; i < num_chunks; i++)
       {
-        memcpy(dest + file->offset, src, file_size);
-        if (region->byte_swap)
-          Util::FlipEndian16(dest + file->offset, file_size);
+        memcpy(dest + dest_offset, src + src_offset, chunk_size);
+        dest_offset += stride;
+        src_offset += chunk_size;
       }
-      else
+    }
+    else
+    {
+      for (uint32_t i = 0; i < num_chunks; i++)
       {
-        uint32_t num_chunks = (uint32_t)file_size / region->chunk_size;
-        uint32_t dest_offset = file->offset;
-        uint32_t src_offset = 0;
-        uint32_t chunk_size = (uint32_t)region->chunk_size;		// cache these as pointer dereferencing cripples performance in a tight loop
-        uint32_t stride = (uint32_t)region->stride;
-        uint32_t byte_swap = region->byte_swap;
-        for (uint32_t i = 0; i < num_chunks; i++)
-        {
-          CopyBytes(dest, dest_offset, src, src_offset, chunk_size, byte_swap);
-          dest_offset += stride;
-          src_offset += chunk_size;
-        }
+        CopyBytes(dest, dest_offset, src, src_offset, chunk_size, byte_swap);
+        dest_offset += stride;
+        src_offset += chunk_size;
       }
     }
   }
-  return error;
+  auto copied = std::chrono::steady_clock::now();
+
+  job->inflate_ms = std::chrono::duration<double, std::milli>(inflated - start).count();
+  job->copy_ms = std::chrono::duration<double, std::milli>(copied - inflated).count();
+  return false;
+}
+
+void GameLoader::AttachPatches(ROMSet *rom_set, const std::string &game_name, const RegionsByName_t &regions_by_name) const
+{
+  // Attach the patches and do some more error checking here
+  auto &patches_by_region = m_patches_by_game.find(game_name)->second;
+  for (auto &v: patches_by_region)
+  {
+    auto &region_name = v.first;
+    auto &patches = v.second;
+    if (regions_by_name.find(region_name) == regions_by_name.end())
+      ErrorLog("%s: Ignoring ROM patch for undefined region '%s' in '%s'.", m_xml_filename.c_str(), region_name.c_str(), game_name.c_str());
+    else if (rom_set->rom_by_region.find(region_name) != rom_set->rom_by_region.end())
+      rom_set->rom_by_region[region_name].patches = patches;
+  }
+}
+
+// 64-bit FNV-1a hash
+static void HashBytes(uint64_t *hash, const void *data, size_t size)
+{
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; i++)
+  {
+    *hash ^= p[i];
+    *hash *= 0x100000001B3ULL;
+  }
+}
+
+template <typename T>
+static void HashValue(uint64_t *hash, T value)
+{
+  HashBytes(hash, &value, sizeof(value));
 }
 
-bool GameLoader::LoadROMs(ROMSet *rom_set, const std::string &game_name, const ZipArchive &zip) const
+uint64_t GameLoader::ComputeFingerprint(const std::string &game_name, const RegionsByName_t &regions_by_name, const ZipArchive &zip) const
+{
+  // Identifies the ROM data (by the CRCs of the files actually found) and
+  // everything that determines how it is laid out in memory
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  HashBytes(&hash, game_name.c_str(), game_name.size() + 1);
+  for (auto &v: regions_by_name)
+  {
+    auto &region = v.second;
+    HashBytes(&hash, region->region_name.c_str(), region->region_name.size() + 1);
+    HashValue(&hash, (uint64_t)region->stride);
+    HashValue(&hash, (uint64_t)region->chunk_size);
+    HashValue(&hash, (uint8_t)region->byte_swap);
+    for (auto &file: region->files)
+    {
+      const ZippedFile *zipped_file = LookupFile(file, zip);
+      HashValue(&hash, file->offset);
+      HashValue(&hash, zipped_file ? zipped_file->crc32 : file->crc32);
+      HashValue(&hash, (uint64_t)(zipped_file ? zipped_file->uncompressed_size : 0));
+    }
+  }
+  auto it = m_patches_by_game.find(game_name);
+  if (it != m_patches_by_game.end())
+  {
+    for (auto &v: it->second)
+    {
+      HashBytes(&hash, v.first.c_str(), v.first.size() + 1);
+      for (auto &patch: v.second)
+      {
+        HashValue(&hash, patch.offset);
+        HashValue(&hash, patch.value);
+        HashValue(&hash, patch.bits);
+      }
+    }
+  }
+  return hash;
+}
+
+bool GameLoader::LoadROMs(ROMSet *rom_set, const std::string &game_name, const ZipArchive &zip, const SkipROMDataFPtr &skip_rom_data) const
 {
   auto it = m_game_info_by_game.find(game_name);
   if (it == m_game_info_by_game.end())
@@ -754,9 +886,10 @@ bool GameLoader::LoadROMs(ROMSet *rom_set, const std::string &game_name, const Z
     return true;
   }
 
-  // Load up the ROMs
+  // Size up the ROM regions
   auto &regions_by_name = IsChildSet(it->second) ? m_regions_by_merged_game.find(game_name)->second : m_regions_by_game.find(game_name)->second;
   LogROMDefinition(game_name, regions_by_name);
+  auto load_start = std::chrono::steady_clock::now();
   bool error = false;
   for (auto &v: regions_by_name)
   {
@@ -765,26 +898,99 @@ bool GameLoader::LoadROMs(ROMSet *rom_set, const std::string &game_name, const Z
     if (ComputeRegionSize(&region_size, region, zip))
       error |= true;
     else
+      rom_set->rom_by_region[region->region_name].size = region_size;
+  }
+  if (error)
+    return true;
+  rom_set->fingerprint = ComputeFingerprint(game_name, regions_by_name, zip);
+  AttachPatches(rom_set, game_name, regions_by_name);
+  if (skip_rom_data && skip_rom_data(it->second, *rom_set))
+  {
+    InfoLog("Skipped loading ROM data for '%s'.", game_name.c_str());
+    return false;
+  }
+
+  // Allocate the ROM regions and gather up the files to load into them
+  std::vector<LoadJob> jobs;
+  for (auto &v: regions_by_name)
+  {
+    auto &region = v.second;
+    auto &rom = rom_set->rom_by_region[region->region_name];
+    rom.data.reset(new uint8_t[rom.size], std::default_delete<uint8_t[]>());
+    for (auto &file: region->files)
     {
-      // Load up the ROM region
-      auto &rom = rom_set->rom_by_region[region->region_name];
-      rom.data.reset(new uint8_t[region_size], std::default_delete<uint8_t[]>());
-      rom.size = region_size;
-      error |= LoadRegion(&rom, region, zip);
+      LoadJob job;
+      job.region = region;
+      job.file = file;
+      job.rom = &rom;
+      job.file_size = LookupFile(file, zip)->uncompressed_size;
+      jobs.push_back(job);
     }
   }
-  
-  // Attach the patches and do some more error checking here
-  auto &patches_by_region = m_patches_by_game.find(game_name)->second;
-  for (auto &v: patches_by_region)
+
+  // Inflate files concurrently, largest first so that the threads finish at
+  // about the same time
+  std::stable_sort(jobs.begin(), jobs.end(), [](const LoadJob &a, const LoadJob &b) { return a.file_size > b.file_size; });
+  std::atomic<size_t> next_job(0);
+  auto worker = [&]()
   {
-    auto &region_name = v.first;
-    auto &patches = v.second;
-    if (regions_by_name.find(region_name) == regions_by_name.end())
-      ErrorLog("%s: Ignoring ROM patch for undefined region '%s' in '%s'.", m_xml_filename.c_str(), region_name.c_str(), game_name.c_str());
-    else if (rom_set->rom_by_region.find(region_name) != rom_set->rom_by_region.end())
-      rom_set->rom_by_region[region_name].patches = patches;
+    std::vector<unzFile> zfs(zip.zipfilenames.size(), nullptr);
+    for (size_t i = next_job++; i < jobs.size(); i = next_job++)
+    {
+      jobs[i].start = std::chrono::steady_clock::now();
+      jobs[i].error = LoadFileIntoRegion(&jobs[i], zip, &zfs);
+      jobs[i].end = std::chrono::steady_clock::now();
+    }
+    for (auto &zf: zfs)
+    {
+      if (zf)
+        unzClose(zf);
+    }
+  };
+  unsigned num_threads = std::max(1u, std::min(std::thread::hardware_concurrency(), (unsigned)jobs.size()));
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < num_threads; i++)
+  {
+    try
+    {
+      threads.emplace_back(worker);
+    }
+    catch (const std::system_error &)
+    {
+      break;  // make do with the threads we have
+    }
+  }
+  worker();
+  for (auto &thread: threads)
+    thread.join();
+
+  // Report load times per region
+  for (auto &v: regions_by_name)
+  {
+    auto &region = v.second;
+    size_t bytes = 0;
+    double inflate_ms = 0;
+    double copy_ms = 0;
+    auto start = std::chrono::steady_clock::time_point::max();
+    auto end = std::chrono::steady_clock::time_point::min();
+    for (auto &job: jobs)
+    {
+      if (job.region != region)
+        continue;
+      error |= job.error;
+      bytes += job.file_size;
+      inflate_ms += job.inflate_ms;
+      copy_ms += job.copy_ms;
+      start = std::min(start, job.start);
+      end = std::max(end, job.end);
+    }
+    if (region->files.empty())
+      continue;
+    InfoLog("Loaded region '%s': %u files, %u bytes in %1.1f ms (inflate %1.1f ms, copy %1.1f ms).", region->region_name.c_str(), (unsigned)region->files.size(), (unsigned)bytes,
+      std::chrono::duration<double, std::milli>(end - start).count(), inflate_ms, copy_ms);
   }
+  InfoLog("Loaded ROMs for '%s' in %1.1f ms using %u threads.", game_name.c_str(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count(), (unsigned)threads.size() + 1);
+  rom_set->data_loaded = !error;
   return error;
 }
 
@@ -809,7 +1015,7 @@ std::string StripFilename(const std::string &filepath)
   return std::string(filepath, 0, last_slash + 1);
 }
 
-bool GameLoader::Load(Game *game, ROMSet *rom_set, const std::string &zipfilename) const
+bool GameLoader::Load(Game *game, ROMSet *rom_set, const std::string &zipfilename, const SkipROMDataFPtr &skip_rom_data) const
 {
   *game = Game();
   
@@ -840,7 +1046,7 @@ bool GameLoader::Load(Game *game, ROMSet *rom_set, const std::string &zipfilenam
   }
 
   // Load 
-  bool error = LoadROMs(rom_set, game->name, zip);
+  bool error = LoadROMs(rom_set, game->name, zip, skip_rom_data);
   if (error)
     *game = Game();
   return error;
@@ -5,11 +5,22 @@
 #include "Pkgs/unzip.h"
 #include "Game.h"
 #include "ROMSet.h"
+#include <chrono>
+#include <functional>
 #include <map>
 #include <set>
 
 class GameLoader
 {
+public:
+  /*
+   * Optional predicate passed to Load(). It is called once the game has been
+   * identified and the ROM set's region sizes and fingerprint are known. If it
+   * returns true, the ROM data itself is not inflated (e.g., because a cached
+   * memory image is available) and rom_set->data_loaded remains false.
+   */
+  typedef std::function<bool(const Game &game, const ROMSet &rom_set)> SkipROMDataFPtr;
+
 private:
   // Describes a file node in the game XML
   struct File
@@ -57,6 +68,7 @@ private:
   {
     unzFile zf = nullptr;
     std::string zipfilename;  // zip archive 
+    size_t zip_idx = 0;       // index of zip archive in ZipArchive
     std::string filename;     // file inside the zip archive
     size_t uncompressed_size = 0;
     uint32_t crc32 = 0;
@@ -78,10 +90,24 @@ private:
     }
   };
 
+  // Single file to be inflated and copied into its region (files are loaded concurrently)
+  struct LoadJob
+  {
+    Region::ptr_t region;
+    File::ptr_t file;
+    ROM *rom = nullptr;
+    size_t file_size = 0;
+    bool error = false;
+    double inflate_ms = 0;
+    double copy_ms = 0;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+  };
+
   bool LoadZipArchive(ZipArchive *zip, const std::string &zipfilename) const;
   const ZippedFile *LookupFile(const File::ptr_t &file, const ZipArchive &zip) const;
   bool FileExistsInZipArchive(const File::ptr_t &file, const ZipArchive &zip) const;
-  bool LoadZippedFile(std::shared_ptr<uint8_t> *buffer, size_t *file_size, const GameLoader::File::ptr_t &file, const ZipArchive &zip) const;
+  bool LoadZippedFile(std::shared_ptr<uint8_t> *buffer, size_t *file_size, const GameLoader::File::ptr_t &file, const ZipArchive &zip, std::vector<unzFile> *zfs) const;
   static bool MissingAttrib(const GameLoader &loader, const Util::Config::Node &node, const std::string &attribute);
   bool LoadGamesFromXML(const Util::Config::Node &xml);
   bool MergeChildrenWithParents();
@@ -96,14 +122,16 @@ private:
     const std::map<std::string, RegionsByName_t> &regions_by_game) const;
   bool ComputeRegionSize(uint32_t *region_size, const Region::ptr_t &region, const ZipArchive &zip) const;
   void ChooseGameInZipArchive(std::string *chosen_game, bool *missing_parent_roms, const ZipArchive &zip, const std::string &zipfilename) const;
-  bool LoadRegion(ROM *buffer, const GameLoader::Region::ptr_t &region, const ZipArchive &zip) const;
-  bool LoadROMs(ROMSet *rom_set, const std::string &game_name, const ZipArchive &zip) const;
+  bool LoadFileIntoRegion(LoadJob *job, const ZipArchive &zip, std::vector<unzFile> *zfs) const;
+  void AttachPatches(ROMSet *rom_set, const std::string &game_name, const RegionsByName_t &regions_by_name) const;
+  uint64_t ComputeFingerprint(const std::string &game_name, const RegionsByName_t &regions_by_name, const ZipArchive &zip) const;
+  bool LoadROMs(ROMSet *rom_set, const std::string &game_name, const ZipArchive &zip, const SkipROMDataFPtr &skip_rom_data) const;
   std::string ChooseGame(const std::set<std::string> &games_found, const std::string &zipfilename) const;
   static bool CompareFilesByName(const File::ptr_t &a,const File::ptr_t &b);
 
 public:
   GameLoader(const std::string &xml_file);
-  bool Load(Game *game, ROMSet *rom_set, const std::string &zipfilename) const;
+  bool Load(Game *game, ROMSet *rom_set, const std::string &zipfilename, const SkipROMDataFPtr &skip_rom_data = nullptr) const;
   const std::map<std::string, Game> &GetGames() const
   {
     return m_game_info_by_game;
@@ -6,6 +6,8 @@
 #include <limits>
 #include <string.h>
 #include "R3DFloat.h"
+#include "Util/Profiler.h"
+#include "Util/PerfCounters.h"
 
 #define MAX_RAM_VERTS 300000	
 #define MAX_ROM_VERTS 1500000
@@ -291,6 +293,8 @@ void CNew3D::DisableRenderStates()
 
 void CNew3D::RenderFrame(void)
 {
+	PROFILE_SCOPE("New3D");
+
 	for (int i = 0; i < 4; i++) {
 		m_nfPairs[i].zNear = -std::numeric_limits<float>::max();
 		m_nfPairs[i].zFar  =  std::numeric_limits<float>::max();
@@ -306,9 +310,13 @@ void CNew3D::RenderFrame(void)
 	m_modelMat.Release();			// would hope we wouldn't need this but no harm in checking
 	m_nodeAttribs.Reset();
 
-	RenderViewport(0x800000);						// build model structure
+	{
+		PROFILE_SCOPE("New3D build models");
+		RenderViewport(0x800000);					// build model structure
+	}
 	DrawScrollFog();								// fog layer if applicable must be drawn here
 	
+	PROFILE_SCOPE("New3D upload and draw");
 	m_vbo.Bind(true);
 	m_vbo.BufferSubData(MAX_ROM_VERTS*sizeof(FVertex), m_polyBufferRam.size()*sizeof(FVertex), m_polyBufferRam.data());	// upload all the dynamic data to GPU in one go
 
@@ -452,10 +460,12 @@ bool CNew3D::DrawModel(UINT32 modelAddr)
 
 		if (m->meshes) {
 			cached = true;
+			Util::PerfCounters::Add(Util::PerfCounters::ModelCacheHits);
 		}
 		else {
 			m->meshes = std::make_shared<std::vector<Mesh>>();
 			m_romMap[modelAddr] = m->meshes;		// store meshes in our rom map here
+			Util::PerfCounters::Add(Util::PerfCounters::ModelCacheMisses);
 		}
 
 		m->dynamic = false;
@@ -1,4 +1,5 @@
 #include "TextureSheet.h"
+#include "Util/PerfCounters.h"
 
 namespace New3D {
 
@@ -36,6 +37,8 @@ std::shared_ptr<Texture> TextureSheet::BindTexture(const UINT16* src, int format
 		std::shared_ptr<Texture> t(new Texture());
 		m_texMap.insert(std::pair<int, std::shared_ptr<Texture>>(index, t));
 		t->UploadTexture(src, m_temp.data(), format, x, y, width, height);
+		Util::PerfCounters::Add(Util::PerfCounters::TextureUploads);
+		Util::PerfCounters::Add(Util::PerfCounters::TextureTexels, width * height);
 		return t;
 	}
 	else {
@@ -58,6 +61,8 @@ std::shared_ptr<Texture> TextureSheet::BindTexture(const UINT16* src, int format
 		std::shared_ptr<Texture> t(new Texture());
 		m_texMap.insert(std::pair<int, std::shared_ptr<Texture>>(index, t));
 		t->UploadTexture(src, m_temp.data(), format, x, y, width, height);
+		Util::PerfCounters::Add(Util::PerfCounters::TextureUploads);
+		Util::PerfCounters::Add(Util::PerfCounters::TextureTexels, width * height);
 		return t;
 	}
 }
@@ -437,6 +437,7 @@ static void DrawLayer(uint32_t *pixels, int layerNum, const uint32_t *vram, cons
 
 std::pair<bool, bool> CRender2D::DrawTilemaps(uint32_t *pixelsBottom, uint32_t *pixelsTop)
 {
+  PROFILE_SCOPE("Draw tile maps");
   unsigned priority = (m_regs[0x20/4] >> 8) & 0xF;
   
   // Render bottom layers
@@ -30,7 +30,7 @@
 
 CInput::CInput(const char *inputId, const char *inputLabel, unsigned inputFlags, unsigned inputGameFlags, const char *defaultMapping, UINT16 initValue) : 
 	id(inputId), label(inputLabel), flags(inputFlags), gameFlags(inputGameFlags), m_defaultMapping(defaultMapping), value(initValue), prevValue(initValue),
-	m_system(NULL), m_source(NULL)
+	m_system(NULL), m_published(initValue), m_source(NULL)
 {
 	ResetToDefaultMapping();
 }
@@ -70,6 +70,9 @@ void CInput::CreateSource()
 			}
 		}
 	}
+
+	// Compile source for polling
+	m_program.Compile(m_source);
 }
 
 void CInput::Initialize(CInputSystem *system)
@@ -197,6 +200,16 @@ bool CInput::Configure(bool append, const char *escapeMapping)
 	return true;
 }
 
+void CInput::PollMidFrame()
+{
+	Poll();
+}
+
+void CInput::Publish()
+{
+	m_published.store(value, std::memory_order_relaxed);
+}
+
 bool CInput::Changed()
 {
 	return value != prevValue;
@@ -32,8 +32,9 @@
 #include "Types.h"
 #include "Game.h"
 #include "Util/NewConfig.h"
+#include "InputProgram.h"
+#include <atomic>
 
-class CInputSource;
 class CInputSystem;
 
 // Flags for inputs
@@ -76,6 +77,10 @@ private:
 	// Assigned input system
 	CInputSystem *m_system;
 
+	// Value last published with Publish().  The polling thread works on value and the emulation reads this copy, so
+	// that it never sees a partially updated value.
+	std::atomic<UINT16> m_published;
+
 	/*
 	 * Creates an input source using the current input system and assigns it to this input.
 	 */
@@ -84,6 +89,9 @@ private:
 protected:
 	// Current input source
 	CInputSource *m_source;
+
+	// Input source compiled for polling
+	CInputProgram m_program;
 	
 	/*
 	 * Constructs an input with the given identifier, label, flags, game flags, default mapping and initial value.
@@ -188,6 +196,22 @@ public:
 	 */
 	virtual void Poll() = 0;
 
+	/*
+	 * Polls this input in between frames.  By default this is the same as Poll() but inputs whose behaviour is timed
+	 * in frames can override it to hold their state until the next full poll.
+	 */
+	virtual void PollMidFrame();
+
+	/*
+	 * Publishes the current value so that it is returned by LatestValue().  Called after each poll.
+	 */
+	virtual void Publish();
+
+	/*
+	 * Returns the most recently published value.  May be called from any thread.
+	 */
+	UINT16 LatestValue() const;
+
 	/*
 	 * Returns true if the value of this input changed during the last poll.
 	 */
@@ -203,6 +227,11 @@ public:
 // Inlined methods
 //
 
+inline UINT16 CInput::LatestValue() const
+{
+	return m_published.load(std::memory_order_relaxed);
+}
+
 inline bool CInput::IsUIInput()
 {
 	return gameFlags == Game::INPUT_UI;
@@ -0,0 +1,157 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011 Bart Trzynadlowski, Nik Henson
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free 
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * InputProgram.cpp
+ *
+ * Implementation of CInputProgram.
+ */
+
+#include "Supermodel.h"
+
+void CInputProgram::Clear()
+{
+	m_code.clear();
+}
+
+void CInputProgram::Compile(CInputSource *source)
+{
+	m_code.clear();
+	if (source != NULL)
+		source->Compile(*this);
+}
+
+void CInputProgram::AddLeaf(CInputSource *source)
+{
+	Instr instr = { source, 1, OpLeaf, source->type };
+	m_code.push_back(instr);
+}
+
+size_t CInputProgram::BeginNode(EOp op, ESourceType type)
+{
+	Instr instr = { NULL, 1, op, type };
+	m_code.push_back(instr);
+	return m_code.size() - 1;
+}
+
+void CInputProgram::EndNode(size_t node)
+{
+	m_code[node].length = m_code.size() - node;
+}
+
+bool CInputProgram::GetValueAsSwitch(bool &val)
+{
+	return !m_code.empty() && EvalSwitch(&m_code[0], val);
+}
+
+bool CInputProgram::GetValueAsAnalog(int &val, int minVal, int offVal, int maxVal)
+{
+	return !m_code.empty() && EvalAnalog(&m_code[0], val, minVal, offVal, maxVal);
+}
+
+bool CInputProgram::EvalSwitch(const Instr *node, bool &val)
+{
+	const Instr *end = node + node->length;
+	const Instr *child;
+	bool oldVal;
+	switch (node->op)
+	{
+	default:
+	case OpLeaf:
+		return node->leaf->GetValueAsSwitch(val);
+
+	case OpOr:
+		// Return value for first child that is active
+		for (child = node + 1; child < end; child += child->length)
+		{
+			if (EvalSwitch(child, val))
+				return true;
+		}
+		return false;
+
+	case OpAnd:
+		// Check all children are active
+		for (child = node + 1; child < end; child += child->length)
+		{
+			if (!EvalSwitch(child, val))
+				return false;
+		}
+		return node->length > 1;
+
+	case OpNeg:
+		oldVal = val;
+		if (EvalSwitch(node + 1, val))
+		{
+			val = oldVal;
+			return false;
+		}
+		val = true;
+		return true;
+	}
+}
+
+bool CInputProgram::EvalAnalog(const Instr *node, int &val, int minVal, int offVal, int maxVal)
+{
+	const Instr *end = node + node->length;
+	const Instr *child;
+	int oldVal;
+	switch (node->op)
+	{
+	default:
+	case OpLeaf:
+		return node->leaf->GetValueAsAnalog(val, minVal, offVal, maxVal);
+
+	case OpOr:
+		// Return value for first child that is active
+		for (child = node + 1; child < end; child += child->length)
+		{
+			if (EvalAnalog(child, val, minVal, offVal, maxVal))
+				return true;
+		}
+		return false;
+
+	case OpAnd:
+		// Check all switch children are active
+		for (child = node + 1; child < end; child += child->length)
+		{
+			if (child->type == SourceSwitch && !EvalAnalog(child, val, minVal, offVal, maxVal))
+				return false;
+		}
+		// If so, then return value for first non-switch child that is active
+		for (child = node + 1; child < end; child += child->length)
+		{
+			if (child->type != SourceSwitch && EvalAnalog(child, val, minVal, offVal, maxVal))
+				return true;
+		}
+		// If none found, then value is only valid if not empty and all children are switches
+		return node->length > 1 && node->type == SourceSwitch;
+
+	case OpNeg:
+		oldVal = val;
+		if (EvalAnalog(node + 1, val, minVal, offVal, maxVal))
+		{
+			val = oldVal;
+			return false;
+		}
+		val = maxVal;
+		return true;
+	}
+}
@@ -0,0 +1,104 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011 Bart Trzynadlowski, Nik Henson
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free 
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * InputProgram.h
+ *
+ * Header file for CInputProgram, a flattened form of an input source tree.
+ */
+ 
+#ifndef INCLUDED_INPUTPROGRAM_H
+#define INCLUDED_INPUTPROGRAM_H
+
+#include "InputSource.h"
+#include <vector>
+
+/*
+ * Holds the input source tree parsed from an input's mapping (see CInputSystem::ParseSource()) compiled into a single
+ * array of instructions, so that polling walks contiguous memory rather than making a virtual call for every node of
+ * the tree.  Leaf sources (keys, mouse and joystick parts) are referenced, not owned, so the program must be recompiled
+ * whenever the tree it came from is released.  The tree itself is still used for configuration and force feedback.
+ *
+ * Each combining node (an or/and of CMultiInputSource or a CNegInputSource) is followed by its children and records its
+ * total length, so that any node can be skipped without being evaluated.  Evaluation follows exactly the same rules
+ * (and order) as the tree, which matters because analog key sources change state each time they are read.
+ */
+class CInputProgram
+{
+public:
+	enum EOp
+	{
+		OpLeaf,
+		OpOr,
+		OpAnd,
+		OpNeg
+	};
+
+	/*
+	 * Discards the current program, leaving one that always returns no value.
+	 */
+	void Clear();
+
+	/*
+	 * Compiles the given source tree, replacing the current program.  A NULL source gives an empty program.
+	 */
+	void Compile(CInputSource *source);
+
+	/*
+	 * Appends a leaf source.  Called by CInputSource::Compile().
+	 */
+	void AddLeaf(CInputSource *source);
+
+	/*
+	 * Appends a combining node of the given type, whose children must be appended next followed by a call to EndNode()
+	 * with the returned index.  Called by CInputSource::Compile() overrides.
+	 */
+	size_t BeginNode(EOp op, ESourceType type);
+
+	void EndNode(size_t node);
+
+	/*
+	 * Equivalent to CInputSource::GetValueAsSwitch() on the compiled tree.
+	 */
+	bool GetValueAsSwitch(bool &val);
+
+	/*
+	 * Equivalent to CInputSource::GetValueAsAnalog() on the compiled tree.
+	 */
+	bool GetValueAsAnalog(int &val, int minVal, int offVal, int maxVal);
+
+private:
+	struct Instr
+	{
+		CInputSource *leaf;   // Source to read (leaves only)
+		unsigned length;      // Number of instructions making up this node, including its children
+		EOp op;
+		ESourceType type;
+	};
+
+	std::vector<Instr> m_code;
+
+	bool EvalSwitch(const Instr *node, bool &val);
+
+	bool EvalAnalog(const Instr *node, int &val, int minVal, int offVal, int maxVal);
+};
+
+#endif	// INCLUDED_INPUTPROGRAM_H
\ No newline at end of file
@@ -0,0 +1,314 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * InputRecorder.cpp
+ *
+ * Implementation of CInputRecorder.
+ *
+ * File Format
+ * -----------
+ *
+ * All integers are little endian. Those marked varint are encoded in 7-bit
+ * groups, least significant first, with the top bit set on all but the last.
+ *
+ *    magic       (16 bytes)  "Supermodel Input" (without terminator)
+ *    version     (uint32)    File format version
+ *    gameName    (string)    ROM set name
+ *    stateFile   (string)    Save state the recording starts from (may be empty)
+ *    numInputs   (varint)    Number of inputs, each consisting of:
+ *      id        (string)    Input id (eg "Start1")
+ *      trigger   (uint8)     1 if a trigger input (followed by offscreen value)
+ *
+ * Strings are a varint length followed by that many characters. The rest of
+ * the file is a sequence of frames, each of which lists only the inputs that
+ * changed since the previous frame (all inputs start out as 0):
+ *
+ *    numChanged  (varint)    Number of changed inputs, each consisting of:
+ *      index     (varint)    Input index, as listed in header
+ *      value     (varint)    New value
+ *      offscreen (varint)    New offscreen value (trigger inputs only)
+ */
+
+#include "Supermodel.h"
+#include "InputRecorder.h"
+
+#include <cstring>
+#include <vector>
+using namespace std;
+
+static const char MAGIC[16] = { 'S','u','p','e','r','m','o','d','e','l',' ','I','n','p','u','t' };
+static const UINT32 VERSION = 1;
+
+static void PutVarint(vector<UINT8> *out, unsigned value)
+{
+	while (value >= 0x80)
+	{
+		out->push_back(UINT8(value | 0x80));
+		value >>= 7;
+	}
+	out->push_back(UINT8(value));
+}
+
+static void PutString(vector<UINT8> *out, const std::string &str)
+{
+	PutVarint(out, unsigned(str.size()));
+	out->insert(out->end(), str.begin(), str.end());
+}
+
+static bool GetVarint(FILE *fp, unsigned *value)
+{
+	*value = 0;
+	for (unsigned shift = 0; shift < 32; shift += 7)
+	{
+		int c = fgetc(fp);
+		if (c == EOF)
+			return false;
+		*value |= unsigned(c & 0x7F) << shift;
+		if (!(c & 0x80))
+			return true;
+	}
+	return false;
+}
+
+static bool GetString(FILE *fp, std::string *str)
+{
+	unsigned length;
+	if (!GetVarint(fp, &length) || length > 1024)
+		return false;
+	str->resize(length);
+	return length == 0 || fread(&(*str)[0], 1, length, fp) == length;
+}
+
+void CInputRecorder::Reset()
+{
+	m_inputs.clear();
+	m_triggers.clear();
+	m_hasOffscreen.clear();
+	m_values.clear();
+	m_offscreenValues.clear();
+}
+
+bool CInputRecorder::StartRecording(const std::string &file, const std::string &gameName, const std::string &stateFile, const vector<CInput*> &inputs)
+{
+	Stop();
+	m_file = fopen(file.c_str(), "wb");
+	if (m_file == NULL)
+	{
+		ErrorLog("Unable to create input recording '%s'.", file.c_str());
+		return false;
+	}
+
+	m_inputs = inputs;
+	for (vector<CInput*>::iterator it = m_inputs.begin(); it != m_inputs.end(); it++)
+	{
+		m_triggers.push_back(dynamic_cast<CTriggerInput*>(*it));
+		m_hasOffscreen.push_back(m_triggers.back() != NULL);
+	}
+	m_values.assign(m_inputs.size(), 0);
+	m_offscreenValues.assign(m_inputs.size(), 0);
+
+	// Write header
+	vector<UINT8> header(MAGIC, MAGIC + sizeof(MAGIC));
+	for (int i = 0; i < 4; i++)
+		header.push_back(UINT8(VERSION >> (i * 8)));
+	PutString(&header, gameName);
+	PutString(&header, stateFile);
+	PutVarint(&header, unsigned(m_inputs.size()));
+	for (size_t i = 0; i < m_inputs.size(); i++)
+	{
+		PutString(&header, m_inputs[i]->id);
+		header.push_back(m_hasOffscreen[i] ? 1 : 0);
+	}
+	if (fwrite(header.data(), 1, header.size(), m_file) != header.size())
+	{
+		ErrorLog("Unable to write input recording '%s'.", file.c_str());
+		Stop();
+		return false;
+	}
+	m_replaying = false;
+	return true;
+}
+
+bool CInputRecorder::ReadHeader(const std::string &gameName, std::string *stateFile, const vector<CInput*> &inputs)
+{
+	char magic[sizeof(MAGIC)];
+	UINT8 version[4];
+	if (fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+		return false;
+	if (fread(version, 1, sizeof(version), m_file) != sizeof(version) || 
+		(version[0] | (version[1] << 8) | (version[2] << 16) | (UINT32(version[3]) << 24)) != VERSION)
+		return false;
+
+	std::string recordedGame;
+	unsigned numInputs;
+	if (!GetString(m_file, &recordedGame) || !GetString(m_file, stateFile) || !GetVarint(m_file, &numInputs))
+		return false;
+	if (recordedGame != gameName)
+	{
+		ErrorLog("Input recording was made with '%s', not '%s'.", recordedGame.c_str(), gameName.c_str());
+		return false;
+	}
+
+	// Match recorded inputs to current ones by id (inputs that no longer exist are read but ignored)
+	for (unsigned i = 0; i < numInputs; i++)
+	{
+		std::string id;
+		int trigger = EOF;
+		if (!GetString(m_file, &id) || (trigger = fgetc(m_file)) == EOF)
+			return false;
+		CInput *input = NULL;
+		for (vector<CInput*>::const_iterator it = inputs.begin(); it != inputs.end(); it++)
+		{
+			if (id == (*it)->id)
+				input = *it;
+		}
+		CTriggerInput *triggerInput = dynamic_cast<CTriggerInput*>(input);
+		if ((trigger != 0) != (triggerInput != NULL))
+			input = NULL;	// input type has changed
+		m_inputs.push_back(input);
+		m_triggers.push_back(input != NULL ? triggerInput : NULL);
+		m_hasOffscreen.push_back(trigger != 0);
+	}
+	m_values.assign(m_inputs.size(), 0);
+	m_offscreenValues.assign(m_inputs.size(), 0);
+	return true;
+}
+
+bool CInputRecorder::StartReplay(const std::string &file, const std::string &gameName, std::string *stateFile, const vector<CInput*> &inputs)
+{
+	Stop();
+	m_file = fopen(file.c_str(), "rb");
+	if (m_file == NULL)
+	{
+		ErrorLog("Unable to open input recording '%s'.", file.c_str());
+		return false;
+	}
+	if (!ReadHeader(gameName, stateFile, inputs))
+	{
+		ErrorLog("'%s' is not a valid input recording for '%s'.", file.c_str(), gameName.c_str());
+		Stop();
+		return false;
+	}
+	m_replaying = true;
+	return true;
+}
+
+void CInputRecorder::Stop()
+{
+	if (m_file != NULL)
+		fclose(m_file);
+	m_file = NULL;
+	m_replaying = false;
+	Reset();
+}
+
+bool CInputRecorder::IsRecording()
+{
+	return m_file != NULL && !m_replaying;
+}
+
+bool CInputRecorder::IsReplaying()
+{
+	return m_file != NULL && m_replaying;
+}
+
+void CInputRecorder::RecordFrame()
+{
+	if (!IsRecording())
+		return;
+
+	// Gather changed inputs
+	unsigned numChanged = 0;
+	m_frame.clear();
+	for (size_t i = 0; i < m_inputs.size(); i++)
+	{
+		UINT16 value = m_inputs[i]->value;
+		UINT16 offscreenValue = m_triggers[i] != NULL ? m_triggers[i]->offscreenValue : 0;
+		if (value == m_values[i] && offscreenValue == m_offscreenValues[i])
+			continue;
+		m_values[i] = value;
+		m_offscreenValues[i] = offscreenValue;
+		PutVarint(&m_frame, unsigned(i));
+		PutVarint(&m_frame, value);
+		if (m_hasOffscreen[i])
+			PutVarint(&m_frame, offscreenValue);
+		numChanged++;
+	}
+
+	// Write frame
+	vector<UINT8> count;
+	PutVarint(&count, numChanged);
+	fwrite(count.data(), 1, count.size(), m_file);
+	if (!m_frame.empty())
+		fwrite(m_frame.data(), 1, m_frame.size(), m_file);
+}
+
+bool CInputRecorder::ReplayFrame()
+{
+	if (!IsReplaying())
+		return false;
+
+	// Apply changes
+	unsigned numChanged;
+	bool ok = GetVarint(m_file, &numChanged);
+	for (unsigned n = 0; ok && n < numChanged; n++)
+	{
+		unsigned index, value, offscreenValue = 0;
+		ok = GetVarint(m_file, &index) && index < m_inputs.size() && GetVarint(m_file, &value);
+		if (ok && m_hasOffscreen[index])
+			ok = GetVarint(m_file, &offscreenValue);
+		if (ok)
+		{
+			m_values[index] = UINT16(value);
+			m_offscreenValues[index] = UINT16(offscreenValue);
+		}
+	}
+	if (!ok)
+	{
+		InfoLog("Input replay finished.");
+		Stop();
+		return false;
+	}
+
+	// Set all inputs, as though they had been polled
+	for (size_t i = 0; i < m_inputs.size(); i++)
+	{
+		if (m_inputs[i] == NULL)
+			continue;
+		m_inputs[i]->prevValue = m_inputs[i]->value;
+		m_inputs[i]->value = m_values[i];
+		if (m_triggers[i] != NULL)
+			m_triggers[i]->offscreenValue = m_offscreenValues[i];
+	}
+	return true;
+}
+
+CInputRecorder::CInputRecorder()
+	: m_file(NULL), m_replaying(false)
+{
+}
+
+CInputRecorder::~CInputRecorder()
+{
+	Stop();
+}
@@ -0,0 +1,101 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * InputRecorder.h
+ *
+ * Header file for CInputRecorder, which records the values of game inputs
+ * frame by frame and plays them back.
+ */
+
+#ifndef INCLUDED_INPUTRECORDER_H
+#define INCLUDED_INPUTRECORDER_H
+
+#include "Types.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class CInput;
+class CTriggerInput;
+
+/*
+ * Records the values of a set of inputs after each poll to a file, or feeds previously recorded values back into them
+ * in place of polling.  A recording names the save state (if any) that it was started from, so that replaying it from
+ * the same state reproduces the same gameplay.
+ */
+class CInputRecorder
+{
+private:
+	FILE *m_file;
+	bool m_replaying;
+
+	// Inputs being recorded or replayed and, for each input, the last value recorded
+	std::vector<CInput*> m_inputs;
+	std::vector<CTriggerInput*> m_triggers;		// trigger inputs also have an offscreen value (NULL for other inputs)
+	std::vector<bool> m_hasOffscreen;			// whether recorded input is a trigger (even if it could not be matched)
+	std::vector<UINT16> m_values;
+	std::vector<UINT16> m_offscreenValues;
+	std::vector<UINT8> m_frame;					// encoded frame being written
+
+	void Reset();
+
+	bool ReadHeader(const std::string &gameName, std::string *stateFile, const std::vector<CInput*> &inputs);
+
+public:
+	/*
+	 * Starts recording the given inputs to a new file.  Returns true if successful.
+	 */
+	bool StartRecording(const std::string &file, const std::string &gameName, const std::string &stateFile, const std::vector<CInput*> &inputs);
+
+	/*
+	 * Opens a recording for replay into the given inputs, which are matched up by id.  The save state that the recording
+	 * was started from is returned in stateFile (empty if none).  Returns true if successful.
+	 */
+	bool StartReplay(const std::string &file, const std::string &gameName, std::string *stateFile, const std::vector<CInput*> &inputs);
+
+	/*
+	 * Stops any recording or replay, closing the file.
+	 */
+	void Stop();
+
+	bool IsRecording();
+
+	bool IsReplaying();
+
+	/*
+	 * Writes the current values of the inputs as the next frame.
+	 */
+	void RecordFrame();
+
+	/*
+	 * Sets the inputs to the values of the next frame.  When the end of the recording is reached, replay stops and
+	 * false is returned.
+	 */
+	bool ReplayFrame();
+
+	CInputRecorder();
+
+	~CInputRecorder();
+};
+
+#endif	// INCLUDED_INPUTRECORDER_H
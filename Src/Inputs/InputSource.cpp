@@ -56,6 +56,11 @@ void CInputSource::Release()
 #endif
 }
 
+void CInputSource::Compile(CInputProgram &program)
+{
+	program.AddLeaf(this);
+}
+
 int CInputSource::Clamp(int val, int minVal, int maxVal)
 {
 	if      (val > maxVal) return maxVal;
@@ -31,6 +31,7 @@
 #include <string>
 
 class CInputSystem;
+class CInputProgram;
 struct ForceFeedbackCmd;
 
 /*
@@ -102,6 +103,11 @@ public:
 	 */
 	virtual bool GetValueAsAnalog(int &val, int minVal, int offVal, int maxVal) = 0;
 
+	/*
+	 * Appends this source to the given program (see CInputProgram).  By default the source is added as a leaf.
+	 */
+	virtual void Compile(CInputProgram &program);
+
 	/*
 	 * Sends a force feedback command to the input source.
 	 */
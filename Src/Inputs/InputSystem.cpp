@@ -1348,6 +1348,20 @@ EMousePart CInputSystem::GetMouseButton(int butNum)
   return (EMousePart)(MouseButtonLeft + butNum);  
 }
 
+void CInputSystem::UpdateWheelDir(short newDir, bool midFrame, short &wheelDir, short &frameDir)
+{
+  if (midFrame)
+  {
+    if (newDir != 0)
+      wheelDir = frameDir = newDir;
+  }
+  else
+  {
+    wheelDir = (newDir != 0 ? newDir : frameDir);
+    frameDir = 0;
+  }
+}
+
 bool CInputSystem::IsAxis(EJoyPart joyPart)
 {
   return joyPart >= JoyXAxis && joyPart <= JoyS2AxisNeg;
@@ -1739,7 +1753,7 @@ bool CInputSystem::ReadMapping(char *buffer, unsigned bufSize, bool fullAxisOnly
   
   // See which sources activated to begin with and from here on ignore these (this stops badly calibrated axes that are constantly "active"
   // from preventing the user from exiting read loop)
-  if (!Poll())
+  if (!Poll(false))
     goto Cancelled;
 
   CheckAllSources(readFlags, fullAxisOnly, mseCentered, badSources, badMapping, sources);
@@ -1748,7 +1762,7 @@ bool CInputSystem::ReadMapping(char *buffer, unsigned bufSize, bool fullAxisOnly
   for (;;)
   {
     // Poll inputs
-    if (!Poll())
+    if (!Poll(false))
       goto Cancelled;
 
     // Check if escape source was triggered
@@ -1757,7 +1771,7 @@ bool CInputSystem::ReadMapping(char *buffer, unsigned bufSize, bool fullAxisOnly
       // If so, wait until source no longer active and then exit
       while (escape->IsActive())
       {
-        if (!Poll())
+        if (!Poll(false))
           goto Cancelled;
         CThread::Sleep(1000/60);
       }
@@ -1872,7 +1886,7 @@ bool CInputSystem::DetectJoystickAxis(unsigned joyNum, unsigned &axisNum, const
   }
   for (;;)
   { 
-    if (!Poll())
+    if (!Poll(false))
       goto Cancelled;
     
     // Check if escape source was triggered
@@ -1881,7 +1895,7 @@ bool CInputSystem::DetectJoystickAxis(unsigned joyNum, unsigned &axisNum, const
       // If so, wait until source no longer active and then exit
       while (escape->IsActive())
       {
-        if (!Poll())
+        if (!Poll(false))
           goto Cancelled;
         CThread::Sleep(1000/60);
       }
@@ -1894,7 +1908,7 @@ bool CInputSystem::DetectJoystickAxis(unsigned joyNum, unsigned &axisNum, const
       // If so, wait until source no longer active and then exit
       while (confirm->IsActive())
       {
-        if (!Poll())
+        if (!Poll(false))
           goto Cancelled;
         CThread::Sleep(1000/60);
       }
@@ -2065,7 +2079,7 @@ Repeat:
     bool firstOut = true;
     for (unsigned frames = 0; frames < 3 * 60; frames++)
     { 
-      if (!Poll())
+      if (!Poll(false))
         goto Cancelled;
 
       // Check if escape source was triggered
@@ -2074,7 +2088,7 @@ Repeat:
         // If so, wait until source no longer active and then exit
         while (escape->IsActive())
         {
-          if (!Poll())
+          if (!Poll(false))
             goto Cancelled;
           CThread::Sleep(1000/60);
         }
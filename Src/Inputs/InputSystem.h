@@ -569,6 +569,14 @@ protected:
    */
   EMousePart GetMouseButton(int butNum);
 
+  /*
+   * Updates a mouse wheel direction (wheelDir) from the wheel movement seen by a poll (newDir).  Mid-frame polls only latch
+   * new movement into wheelDir and frameDir, so that a wheel movement is not cleared again a few milliseconds later.  The
+   * end-of-frame poll then reports any movement since the previous end-of-frame poll, as though no mid-frame polls had
+   * taken place, and clears frameDir.
+   */
+  void UpdateWheelDir(short newDir, bool midFrame, short &wheelDir, short &frameDir);
+
   /*
    * Returns true if the given EJoyPart is an axis.
    */
@@ -837,9 +845,11 @@ public:
   bool ReadMapping(char *buffer, unsigned bufSize, bool fullAxisOnly = false, unsigned readFlags = READ_ALL, const char *escapeMapping = "KEY_ESCAPE");
 
   /*
-   * Updates the current state of the input system (called by CInputs.Poll).
+   * Updates the current state of the input system (called by CInputs.Poll and CInputs.PollMidFrame).
+   * midFrame is true for the extra polls made while a frame is being emulated.  Relative state, such as the mouse wheel
+   * direction, must then stay latched until the next end-of-frame poll.
    */
-  virtual bool Poll() = 0;
+  virtual bool Poll(bool midFrame) = 0;
 
   virtual void GrabMouse();
 
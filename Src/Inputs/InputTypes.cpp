@@ -42,7 +42,7 @@ void CSwitchInput::Poll()
 	prevValue = value;
 
 	bool boolValue = !!value;
-	if (m_source != NULL && m_source->GetValueAsSwitch(boolValue))
+	if (m_program.GetValueAsSwitch(boolValue))
 		value = (boolValue ? m_onVal : m_offVal);
 	else
 		value = m_offVal;
@@ -77,7 +77,7 @@ void CAnalogInput::Poll()
 		return;
 	}
 	int intValue = value;
-	if (m_source->GetValueAsAnalog(intValue, m_minVal, m_minVal, m_maxVal))
+	if (m_program.GetValueAsAnalog(intValue, m_minVal, m_minVal, m_maxVal))
 		value = intValue;
 	else
 		value = m_minVal;
@@ -126,7 +126,7 @@ void CAxisInput::Poll()
 			if (m_negInput != NULL) value += (int)(m_negInput->ValueAsFraction() * (double)(m_minVal - m_offVal));
 		}
 	}
-	else if (m_source != NULL && m_source->GetValueAsAnalog(intValue, m_minVal, m_offVal, m_maxVal))
+	else if (m_program.GetValueAsAnalog(intValue, m_minVal, m_offVal, m_maxVal))
 		value = intValue;
 	else 
 		value = m_offVal;
@@ -155,6 +155,7 @@ CGearShift4Input::CGearShift4Input(const char *inputId, const char *inputLabel,
 {
 	// Initialize to gear 1
 	prevValue = value = 1;
+	Publish();
 }
 
 void CGearShift4Input::Poll()
@@ -177,7 +178,8 @@ void CGearShift4Input::Poll()
 CTriggerInput::CTriggerInput(const char *inputId, const char *inputLabel, unsigned inputGameFlags,
 	CSwitchInput *triggerInput, CSwitchInput *offscreenInput, UINT16 offVal, UINT16 onVal) :
 	CInput(inputId, inputLabel, INPUT_FLAGS_VIRTUAL, inputGameFlags),
-	m_triggerInput(triggerInput), m_offscreenInput(offscreenInput), m_autoTrigger(false), m_offscreenCount(0), m_offVal(offVal), m_onVal(onVal)
+	m_triggerInput(triggerInput), m_offscreenInput(offscreenInput), m_autoTrigger(false), m_offscreenCount(0), m_offVal(offVal), m_onVal(onVal),
+	m_publishedOffscreen(offVal)
 {
 	//
 }
@@ -231,3 +233,17 @@ void CTriggerInput::Poll()
 		offscreenValue = m_offscreenInput->value;
 	}
 }
+
+void CTriggerInput::PollMidFrame()
+{
+	if (m_autoTrigger && m_offscreenCount > 0)
+		prevValue = value;
+	else
+		Poll();
+}
+
+void CTriggerInput::Publish()
+{
+	CInput::Publish();
+	m_publishedOffscreen.store(offscreenValue, std::memory_order_relaxed);
+}
@@ -152,6 +152,9 @@ private:
 	bool m_autoTrigger;
 	int m_offscreenCount;
 
+	// Published offscreen value (see CInput::Publish())
+	std::atomic<UINT16> m_publishedOffscreen;
+
 public:
 	// Offscreen value
 	UINT16 offscreenValue;
@@ -167,6 +170,24 @@ public:
 	 * Polls (updates) the input, updating its trigger value and offscreen value from the switch inputs
 	 */
 	void Poll();
+
+	/*
+	 * Polls the input in between frames, leaving any auto-trigger sequence in progress (which is timed in frames) alone
+	 */
+	void PollMidFrame();
+
+	/*
+	 * Publishes both the trigger value and offscreen value
+	 */
+	void Publish();
+
+	/*
+	 * Returns the most recently published offscreen value.  May be called from any thread.
+	 */
+	UINT16 LatestOffscreenValue() const
+	{
+		return m_publishedOffscreen.load(std::memory_order_relaxed);
+	}
 };
 
 #endif	// INCLUDED_INPUTTYPES_H
\ No newline at end of file
@@ -36,7 +36,7 @@
 using namespace std;
 
 CInputs::CInputs(CInputSystem *system)
-  : m_system(system)
+  : m_system(system), m_midFrameGameFlags(0), m_quitRequested(false)
 {
 	// UI controls are hard coded here, everything else is initialized to NONE so that it can be loaded from
 	// the config file.
@@ -49,6 +49,7 @@ CInputs::CInputs(CInputSystem *system)
 	uiSaveState        = AddSwitchInput("UISaveState",        "Save State",            Game::INPUT_UI, "KEY_F5");
 	uiChangeSlot       = AddSwitchInput("UIChangeSlot",       "Change Save Slot",      Game::INPUT_UI, "KEY_F6");
 	uiLoadState        = AddSwitchInput("UILoadState",        "Load State",            Game::INPUT_UI, "KEY_F7");
+	uiRewind           = AddSwitchInput("UIRewind",           "Rewind (Hold)",         Game::INPUT_UI, "KEY_BACKSPACE");
 	uiMusicVolUp	     = AddSwitchInput("UIMusicVolUp",		    "Increase Music Volume", Game::INPUT_UI, "KEY_F10");
 	uiMusicVolDown	   = AddSwitchInput("UIMusicVolDown",	    "Decrease Music Volume", Game::INPUT_UI, "KEY_F9");
 	uiSoundVolUp	     = AddSwitchInput("UISoundVolUp",		    "Increase Sound Volume", Game::INPUT_UI, "KEY_F12");
@@ -58,6 +59,7 @@ CInputs::CInputs(CInputSystem *system)
 	uiToggleFrLimit    = AddSwitchInput("UIToggleFrameLimit", "Toggle Frame Limiting", Game::INPUT_UI, "KEY_ALT+KEY_T");
 	uiDumpInpState     = AddSwitchInput("UIDumpInputState",   "Dump Input State",      Game::INPUT_UI, "KEY_ALT+KEY_U");
 	uiDumpTimings      = AddSwitchInput("UIDumpTimings",      "Dump Frame Timings",    Game::INPUT_UI, "KEY_ALT+KEY_O");
+	uiShowStats        = AddSwitchInput("UIShowStats",        "Show Perf Counters",    Game::INPUT_UI, "KEY_ALT+KEY_S");
 #ifdef SUPERMODEL_DEBUGGER
 	uiEnterDebugger    = AddSwitchInput("UIEnterDebugger",    "Enter Debugger",        Game::INPUT_UI, "KEY_ALT+KEY_B");
 #endif
@@ -732,25 +734,91 @@ void CInputs::PrintInputs(const Game *game)
 	puts("");
 }
 
-bool CInputs::Poll(const Game *game, unsigned dispX, unsigned dispY, unsigned dispW, unsigned dispH)
+bool CInputs::Poll(const Game *game, unsigned dispX, unsigned dispY, unsigned dispW, unsigned dispH, bool frameRan)
 {
 	// Update the input system with the current display geometry
 	m_system->SetDisplayGeom(dispX, dispY, dispW, dispH);
 
 	// Poll the input system
-	if (!m_system->Poll())
+	if (!m_system->Poll(false) || m_quitRequested)
 		return false;
 
-	// Poll all UI inputs and all the inputs used by the current game, or all inputs if game is NULL
+	// Poll all UI inputs and all the inputs used by the current game, or all inputs if game is NULL (game inputs come
+	// from the recording instead when replaying).  While recording or replaying, game inputs only change between
+	// emulated frames so that the recording stays in step with emulation.
+	bool pollGameInputs = frameRan || !(m_recorder.IsRecording() || m_recorder.IsReplaying());
+	if (pollGameInputs && m_recorder.IsReplaying() && m_recorder.ReplayFrame())
+		pollGameInputs = false;
 	uint32_t gameFlags = game ? game->inputs : Game::INPUT_ALL;
 	for (vector<CInput*>::iterator it = m_inputs.begin(); it != m_inputs.end(); it++)
 	{
-		if ((*it)->IsUIInput() || ((*it)->gameFlags & gameFlags))
+		if ((*it)->IsUIInput() || (pollGameInputs && ((*it)->gameFlags & gameFlags)))
 			(*it)->Poll();
+		(*it)->Publish();
 	}
+	if (frameRan)
+		m_recorder.RecordFrame();
+	m_midFrameGameFlags = gameFlags;
 	return true;
 }
 
+void CInputs::PollMidFrame()
+{
+	if (m_midFrameGameFlags == 0 || m_quitRequested || m_recorder.IsRecording() || m_recorder.IsReplaying())
+		return;
+
+	if (!m_system->Poll(true))
+	{
+		m_quitRequested = true;
+		return;
+	}
+
+	for (vector<CInput*>::iterator it = m_inputs.begin(); it != m_inputs.end(); it++)
+	{
+		if (!(*it)->IsUIInput() && ((*it)->gameFlags & m_midFrameGameFlags))
+		{
+			(*it)->PollMidFrame();
+			(*it)->Publish();
+		}
+	}
+}
+
+vector<CInput*> CInputs::GetGameInputs(const Game &game)
+{
+	vector<CInput*> inputs;
+	for (vector<CInput*>::iterator it = m_inputs.begin(); it != m_inputs.end(); it++)
+	{
+		if (!(*it)->IsUIInput() && ((*it)->gameFlags & game.inputs))
+			inputs.push_back(*it);
+	}
+	return inputs;
+}
+
+bool CInputs::StartRecording(const std::string &file, const Game &game, const std::string &stateFile)
+{
+	return m_recorder.StartRecording(file, game.name, stateFile, GetGameInputs(game));
+}
+
+bool CInputs::StartReplay(const std::string &file, const Game &game, std::string *stateFile)
+{
+	return m_recorder.StartReplay(file, game.name, stateFile, GetGameInputs(game));
+}
+
+void CInputs::StopRecording()
+{
+	m_recorder.Stop();
+}
+
+bool CInputs::IsRecording()
+{
+	return m_recorder.IsRecording();
+}
+
+bool CInputs::IsReplaying()
+{
+	return m_recorder.IsReplaying();
+}
+
 void CInputs::DumpState(const Game *game)
 {
 	// Print header
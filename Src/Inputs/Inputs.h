@@ -30,6 +30,8 @@
 
 #include "Types.h"
 #include "Util/NewConfig.h"
+#include "InputRecorder.h"
+#include <string>
 #include <vector>
 
 class CInputSystem;
@@ -53,6 +55,20 @@ private:
   // Vector of all created inputs
   std::vector<CInput*> m_inputs;
 
+  // Records or replays game inputs
+  CInputRecorder m_recorder;
+
+  // Game flags of the inputs polled by PollMidFrame(), taken from the last call to Poll()
+  uint32_t m_midFrameGameFlags;
+
+  // Set when the input system reports a quit request during PollMidFrame() so that the next Poll() can return it
+  bool m_quitRequested;
+
+  /*
+   * Returns the non-UI inputs used by the given game.
+   */
+  std::vector<CInput*> GetGameInputs(const Game &game);
+
   /*
    * Adds a switch input (eg button) to this collection.
    */ 
@@ -96,6 +112,7 @@ public:
   CSwitchInput  *uiSaveState;
   CSwitchInput  *uiChangeSlot;
   CSwitchInput  *uiLoadState;
+  CSwitchInput  *uiRewind;
   CSwitchInput  *uiMusicVolUp;
   CSwitchInput  *uiMusicVolDown;
   CSwitchInput  *uiSoundVolUp;
@@ -105,6 +122,7 @@ public:
   CSwitchInput  *uiToggleFrLimit;
   CSwitchInput  *uiDumpInpState;
   CSwitchInput  *uiDumpTimings;
+  CSwitchInput  *uiShowStats;
 #ifdef SUPERMODEL_DEBUGGER
   CSwitchInput  *uiEnterDebugger;
 #endif
@@ -298,8 +316,46 @@ public:
   /*
    * Polls (updates) the inputs for the given game, or all inputs if game is NULL, updating their values from their respective input sources.
    * First the input system is polled (CInputSystem.Poll()) and then each input is polled (CInput.Poll()).
+   * frameRan must be false if no frame was emulated since the last poll (eg while paused), in which case nothing is
+   * recorded or replayed and, while doing either, game inputs are left as they are.
+   */
+  bool Poll(const Game *game, unsigned dispX, unsigned dispY, unsigned dispW, unsigned dispH, bool frameRan = true);
+
+  /*
+   * Polls the game inputs again while a frame is being emulated, so that the emulation sees input state that is
+   * fresher than the end of the previous frame.  UI inputs are left for the next call to Poll(), as is a quit request.
+   * Does nothing before the first call to Poll() or while recording or replaying (recordings are frame-exact).  Must be
+   * called from the same thread as Poll().
+   */
+  void PollMidFrame();
+
+  /*
+   * Starts recording the values of the given game's inputs to a file after every poll.  stateFile names the save state
+   * that emulation started from (if any).  Returns true if successful.
+   */
+  bool StartRecording(const std::string &file, const Game &game, const std::string &stateFile);
+
+  /*
+   * Starts replaying a recording made with StartRecording().  While replaying, game inputs take their values from the
+   * recording rather than from the input system; UI inputs are still polled.  The save state that the recording was
+   * started from is returned in stateFile.  Returns true if successful.
+   */
+  bool StartReplay(const std::string &file, const Game &game, std::string *stateFile);
+
+  /*
+   * Stops recording or replaying.
+   */
+  void StopRecording();
+
+  /*
+   * Returns true if inputs are being recorded.
+   */
+  bool IsRecording();
+
+  /*
+   * Returns true if a recording is being replayed.
    */
-  bool Poll(const Game *game, unsigned dispX, unsigned dispY, unsigned dispW, unsigned dispH);
+  bool IsReplaying();
 
   /*
    * Prints the current values of the inputs for the given game, or all inputs if game is NULL, to stdout for debugging purposes.
@@ -163,6 +163,14 @@ bool CMultiInputSource::GetValueAsAnalog(int &val, int minVal, int offVal, int m
 	}
 }
 
+void CMultiInputSource::Compile(CInputProgram &program)
+{
+	size_t node = program.BeginNode(m_isOr ? CInputProgram::OpOr : CInputProgram::OpAnd, type);
+	for (int i = 0; i < m_numSrcs; i++)
+		m_srcArray[i]->Compile(program);
+	program.EndNode(node);
+}
+
 bool CMultiInputSource::SendForceFeedbackCmd(ForceFeedbackCmd ffCmd)
 {
 	bool result = false;
@@ -217,4 +225,10 @@ bool CNegInputSource::GetValueAsAnalog(int &val, int minVal, int offVal, int max
 	}
 	val = maxVal;
 	return true;
+}
+void CNegInputSource::Compile(CInputProgram &program)
+{
+	size_t node = program.BeginNode(CInputProgram::OpNeg, type);
+	m_source->Compile(program);
+	program.EndNode(node);
 }
\ No newline at end of file
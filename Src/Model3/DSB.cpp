@@ -34,173 +34,13 @@
  *	 timing or interrupts.
  * - Check actual MPEG sample rate. So far, all games seem to use 32 KHz, which
  *   may be a hardware requirement, but if other sampling rates are allowable,
- *   the code here will fail (it is hard coded for 32 KHz).
+ *   the resampler must be reconfigured (it is hard coded for 32 KHz).
  * - Should we do some bounds checking on the MPEG start/end points?
  */
 
 #include "Supermodel.h"
 #include "Sound/MPEG/MpegAudio.h"
 
-/******************************************************************************
- Resampler
- 
- MPEG Layer 2 audio can be 32, 44.1, or 48 KHz. Here, an up-sampling algorithm
- is provided, which should work for any frequency less than 44.1 KHz and an 
- output frequency of 44.1 KHz. Down-sampling is not yet implemented, but would 
- work in a similar fashion. The chief difference is that the input index would
- sometimes advance by more than one for a single output sample and the
- fractions, nFrac and pFrac, would sometimes exceed 1.0.
- 
- Up-Sampling Description
- -----------------------
- 
- Linear interpolation is used to up-sample. Not as accurate as the Shannon
- reconstruction equation but it seems to work quite well.
- 
- 1. Linear Interpolation
- 
- Input samples for a given frame (here, this means 1/60Hz, not to be confused
- with an MPEG frame, which is shorter) are numbered 0 ... L-1 (L samples in 
- total). Output samples are 0 ... M-1.
- 
- For two adjacent input samples at times p ("previous") and n ("next"), in[p]
- and in[n], and output out[t] at time t, linear interpolation yields:
- 
- 		out[t] = (n-t)/(n-p) * in[p] + (t-p)/(n-p) * in[n]
- 
- Note that (n-p) = 1/fin (fin being the input sampling frequency).
- 
- Let pFrac = (n-t)/(n-p) and nFrac = (t-p)/(n-p). As t moves from p to n, pFrac
- moves from 1 to 0 and nFrac from 0 to 1, as we expect.
- 
- If we proceed one output sample at a time, we must add the time difference 
- between output samples, 1/fout, to t. Call this delta_t. If we divide delta_t
- by (n-p), we can add it directly to nFrac and subtract from pFrac. Therefore:
- 
- 	delta = (1/fout)/(n-p) = fin/fout
- 	
- What happens when nFrac exceeds 1.0 or pFrac goes below 0.0? That can't
- be allowed to happen -- it means that we've actually moved along the line into
- the region between the next set of samples. We use pFrac < 0 as the condition
- to update the input samples.
- 
- It so happens that when fin < fout, pFrac and nFrac will never exceed 1.0. So
- there is no need to check or mask the fixed point values when using them to
- interpolate samples.
- 
- 2. Input Buffer Overflows
- 
- For some low sampling rates, particularly those that are a factor of 2 or 4
- smaller, it is possible that the very last sample or two needed from the input
- stream will be beyond the end. Fetching two extra samples (which can introduce
- an update lag of two samples -- imperceptible and inconsequential) fixes this,
- and so we do it.
- 
- 3. Continuity Between Frames
- 
- The very last output sample will typically sit somewhere between two input
- samples. It is wrong to start the next frame by assuming everything is lined
- up again. The first sample of the next frame will often have to be interpol-
- ated with the last sample of the previous frame. To facilitate this, we check
- to see how many input samples remain unprocessed when up-sampling is finished,
- and then copy those to the beginning of the buffer. We then return the number
- of samples so that the buffer update function will know to skip them.
- 
- We also must maintain the state of pFrac and nFrac to resume interpolation 
- correctly. Therefore, these variables are persistent.
- 
- 4. Fixed Point Arithmetic
- 
- Fixed point arithmetic is used to track fractions. For such numbers, the low
- 8 bits represent a fraction (0x100 would be 1.0, 0x080 would be 0.5, etc.)
- and the upper bits are the integral portion.
-******************************************************************************/
- 
-void CDSBResampler::Reset(void)
-{
-	// Initial state of fractions (24.8 fixed point)
-	nFrac = 0<<8;	// fraction of next sample to use (0->1.0 as x moves p->n)
- 	pFrac = 1<<8;	// previous sample (1.0->0 as x moves p->n)
-}
-
-// Mixes 16-bit samples (sign extended in a and b)
-static inline INT16 MixAndClip(INT32 a, INT32 b)
-{
-	a += b;
-	if (a > 32767)
-		a = 32767;
-	else if (a < -32768)
-		a = -32768;
-	return (INT16) a;
-}
-
-// Mixes audio and returns number of samples copied back to start of buffer (ie. offset at which new samples should be written)
-int CDSBResampler::UpSampleAndMix(INT16 *outL, INT16 *outR, INT16 *inL, INT16 *inR, UINT8 volumeL, UINT8 volumeR, int sizeOut, int sizeIn, int outRate, int inRate)
-{
-	int 	delta = (inRate<<8)/outRate;	// (1/fout)/(1/fin)=fin/fout, 24.8 fixed point
-	int		outIdx = 0;
-	int		inIdx = 0;
-	INT32	leftSample, rightSample, leftSoundSample, rightSoundSample;
-	INT32	v[2], musicVol, soundVol;
-	
-	// Obtain program volume settings and convert to 24.8 fixed point (0-200 -> 0x00-0x200)
-	musicVol = m_config["MusicVolume"].ValueAs<int>();
-	soundVol = m_config["SoundVolume"].ValueAs<int>();
-	musicVol = (INT32) ((float) 0x100 * (float) musicVol / 100.0f);
-	soundVol = (INT32) ((float) 0x100 * (float) soundVol / 100.0f);
-	
-	// Scale volume from 0x00-0xFF -> 0x00-0x100 (24.8 fixed point)
-	v[0] = (INT16) ((float) 0x100 * (float) volumeL / 255.0f);
-	v[1] = (INT16) ((float) 0x100 * (float) volumeR / 255.0f);
-	
-	// Up-sample and mix!
-	while (outIdx < sizeOut)
-	{
-		// nFrac, pFrac will never exceed 1.0 (0x100) (only true if delta does not exceed 1)
-		leftSample	= ((int)inL[inIdx]*pFrac+(int)inL[inIdx+1]*nFrac) >> 8;	// left channel
-		rightSample	= ((int)inR[inIdx]*pFrac+(int)inR[inIdx+1]*nFrac) >> 8;	// right channel
-		
-		// Apply DSB volume and then overall music volume setting
-		leftSample = (leftSample*v[0]*musicVol) >> 16;		// multiplied by two 24.8 numbers, shift back by 16
-		rightSample = (rightSample*v[0]*musicVol) >> 16;
-		
-		// Apply sound volume setting
-		leftSoundSample = (outL[outIdx]*soundVol) >> 8;
-		rightSoundSample = (outR[outIdx]*soundVol) >> 8;
-		
-		// Mix and output
-		outL[outIdx] = MixAndClip(leftSoundSample, leftSample);
-		outR[outIdx] = MixAndClip(rightSoundSample, rightSample);
-		outIdx++;
-		
-		// Time step
-		pFrac -= delta;
-		nFrac += delta;
-		
-		// Time to move to next samples?
-		if (pFrac <= 0)	// when pFrac becomes 0, advance samples, reset pFrac to 1
-		{
-			pFrac += (1<<8);
-			nFrac -= (1<<8);
-			inIdx++;	// advance samples (for upsampling only; downsampling may advance by more than one -- add delta every loop iteration)
-			
-		}
-	}
-
-	// Copy remaining "active" input samples to start of buffer
-	int i = 0;
-	int j = inIdx;
-	while (j < sizeIn)
-	{
-		inL[i] = inL[j];
-		inR[i] = inR[j];
-		i++;
-		j++;
-	}
-	return i;	// first free position in input buffer to copy next MPEG update to
-}
-
-
 /******************************************************************************
  Digital Sound Board Type 1: Z80 CPU
 ******************************************************************************/
@@ -423,19 +263,15 @@ void CDSB1::SendCommand(UINT8 data)
 #endif
 }
 
-void CDSB1::RunFrame(INT16 *audioL, INT16 *audioR)
+void CDSB1::RunFrame(INT32 *mixL, INT32 *mixR, unsigned numSamples)
 {
-	int		cycles;
-	UINT8	v;
+	PROFILE_SCOPE("DSB");
+	int			cycles;
+	unsigned	numMPEG;
+	float		v;
 	
-	if (!m_config["EmulateDSB"].ValueAs<bool>())
-	{
-		// DSB code applies SCSP volume, too, so we must still mix
-		memset(mpegL, 0, (32000/60+2)*sizeof(INT16));
-		memset(mpegR, 0, (32000/60+2)*sizeof(INT16));
-		retainedSamples = Resampler.UpSampleAndMix(audioL, audioR, mpegL, mpegR, 0, 0, 44100/60, 32000/60+2, 44100, 32000);
+	if (!m_emulateDSB.Get())
 		return;
-	}
 	
 	// While FIFO not empty, fire interrupts, run for up to one frame
 	for (cycles = (4000000/60)/4; (cycles > 0) && (fifoIdxR != fifoIdxW);  )
@@ -450,19 +286,20 @@ void CDSB1::RunFrame(INT16 *audioL, INT16 *audioR)
 	
 	//printf("VOLUME=%02X STEREO=%02X\n", volume, stereo);
 	
-	// Convert volume from 0x00-0x7F -> 0x00-0xFF
-	v = (UINT8) ((float) 255.0f * (float) volume /127.0f);
+	// Apply DSB volume (0x00-0x7F) and then overall music volume setting (0-200%)
+	v = ((float) volume / 127.0f) * ((float) m_musicVolume.Get() / 100.0f);
 	
-	// Decode MPEG for this frame
-	MpegDec::DecodeAudio(&mpegL[retainedSamples], &mpegR[retainedSamples], 32000 / 60 - retainedSamples + 2);
-	retainedSamples = Resampler.UpSampleAndMix(audioL, audioR, mpegL, mpegR, v, v, 44100/60, 32000/60+2, 44100, 32000);
+	// Decode as much MPEG audio as needed to produce this frame and mix it in
+	numMPEG = Resampler.InputNeeded(numSamples);
+	MpegDec::DecodeAudio(mpegL, mpegR, numMPEG);
+	Resampler.Write(mpegL, mpegR, numMPEG);
+	Resampler.ReadAndMix(mixL, mixR, numSamples, v, v);
 }
 
 void CDSB1::Reset(void)
 {
 	MpegDec::Stop();
 	Resampler.Reset();
-	retainedSamples = 0;
 	
 	memset(fifo, 0, sizeof(fifo));
 	fifoIdxW = fifoIdxR = 0;
@@ -591,10 +428,14 @@ bool CDSB1::Init(const UINT8 *progROMPtr, const UINT8 *mpegROMPtr)
 	mpegL = (INT16 *) &memoryPool[DSB1_OFFSET_MPEG_LEFT];
 	mpegR = (INT16 *) &memoryPool[DSB1_OFFSET_MPEG_RIGHT];
 	
-	// Initialize Z80 CPU
+	// Initialize Z80 CPU (ROM and RAM are accessed directly, matching Read8() and Write8())
 	Z80.Init(this, Z80IRQCallback);
+	Z80.MapMemory(0x0000, 0x7FFF, progROM, NULL);
+	Z80.MapMemory(0x8000, 0xFFFF, ram, ram);
 	
-	retainedSamples = 0;
+	// MPEG audio is 32 KHz and must be converted to the output rate
+	Resampler.Configure(32000, m_config["AudioSampleRate"].ValueAs<unsigned>());
+	MpegDec::Configure(m_config["MPEGPrefetch"].ValueAs<bool>(), m_config["MPEGCacheSize"].ValueAs<unsigned>());
 		
 	return OKAY;
 }
@@ -606,7 +447,8 @@ CZ80 *CDSB1::GetZ80(void)
 
 CDSB1::CDSB1(const Util::Config::Node &config)
   : m_config(config),
-    Resampler(config)
+    m_emulateDSB(config["EmulateDSB"]),
+    m_musicVolume(config["MusicVolume"])
 {
 	progROM		= NULL;
 	mpegROM		= NULL;
@@ -627,6 +469,8 @@ CDSB1::CDSB1(const Util::Config::Node &config)
 
 CDSB1::~CDSB1(void)
 {	
+	MpegDec::Shutdown();
+	
 	if (memoryPool != NULL)
 	{
 		delete [] memoryPool;
@@ -992,16 +836,11 @@ void CDSB2::SendCommand(UINT8 data)
 }
 	
 
-void CDSB2::RunFrame(INT16 *audioL, INT16 *audioR)
+void CDSB2::RunFrame(INT32 *mixL, INT32 *mixR, unsigned numSamples)
 {
-	if (!m_config["EmulateDSB"].ValueAs<bool>())
-	{
-		// DSB code applies SCSP volume, too, so we must still mix
-		memset(mpegL, 0, (32000/60+2)*sizeof(INT16));
-		memset(mpegR, 0, (32000/60+2)*sizeof(INT16));
-		retainedSamples = Resampler.UpSampleAndMix(audioL, audioR, mpegL, mpegR, volume[0], volume[1], 44100/60, 32000/60+2, 44100, 32000);
+	PROFILE_SCOPE("DSB");
+	if (!m_emulateDSB.Get())
 		return;
-	}
 
 	M68KSetContext(&M68K);
 	//printf("DSB2 run frame PC=%06X\n", M68KGetPC());
@@ -1024,8 +863,9 @@ void CDSB2::RunFrame(INT16 *audioL, INT16 *audioR)
 	
 	M68KGetContext(&M68K);
 	
-	// Decode MPEG for this frame
-	MpegDec::DecodeAudio(&mpegL[retainedSamples], &mpegR[retainedSamples], 32000 / 60 - retainedSamples + 2);
+	// Decode as much MPEG audio as needed to produce this frame
+	unsigned numMPEG = Resampler.InputNeeded(numSamples);
+	MpegDec::DecodeAudio(mpegL, mpegR, numMPEG);
 	
 	INT16 *leftChannelSource = nullptr;
 	INT16 *rightChannelSource = nullptr;
@@ -1054,14 +894,19 @@ void CDSB2::RunFrame(INT16 *audioL, INT16 *audioR)
 		break;
 	}
 
-	retainedSamples = Resampler.UpSampleAndMix(audioL, audioR, leftChannelSource, rightChannelSource, volL, volR, 44100/60, 32000/60+2, 44100, 32000);
+	// Apply DSB volume (0x00-0xFF) and then overall music volume setting (0-200%)
+	float musicVol = (float) m_musicVolume.Get() / 100.0f;
+	float vL = ((float) volL / 255.0f) * musicVol;
+	float vR = ((float) volR / 255.0f) * musicVol;
+	
+	Resampler.Write(leftChannelSource, rightChannelSource, numMPEG);
+	Resampler.ReadAndMix(mixL, mixR, numSamples, vL, vR);
 }
 
 void CDSB2::Reset(void)
 {
 	MpegDec::Stop();
 	Resampler.Reset();
-	retainedSamples = 0;
 	
 	memset(fifo, 0, sizeof(fifo));
 	fifoIdxW = fifoIdxR = 0;
@@ -1217,7 +1062,9 @@ bool CDSB2::Init(const UINT8 *progROMPtr, const UINT8 *mpegROMPtr)
 	M68KSetIRQCallback(NULL);	// use default behavior (autovector, clear interrupt)
 	M68KGetContext(&M68K);
 
-	retainedSamples = 0;
+	// MPEG audio is 32 KHz and must be converted to the output rate
+	Resampler.Configure(32000, m_config["AudioSampleRate"].ValueAs<unsigned>());
+	MpegDec::Configure(m_config["MPEGPrefetch"].ValueAs<bool>(), m_config["MPEGCacheSize"].ValueAs<unsigned>());
 		
 	return OKAY;
 }
@@ -1229,7 +1076,8 @@ M68KCtx *CDSB2::GetM68K(void)
 
 CDSB2::CDSB2(const Util::Config::Node &config)
   : m_config(config),
-    Resampler(config)
+    m_emulateDSB(config["EmulateDSB"]),
+    m_musicVolume(config["MusicVolume"])
 {
 	progROM		= NULL;
 	mpegROM		= NULL;
@@ -1249,6 +1097,8 @@ CDSB2::CDSB2(const Util::Config::Node &config)
 
 CDSB2::~CDSB2(void)
 {	
+	MpegDec::Shutdown();
+	
 	if (memoryPool != NULL)
 	{
 		delete [] memoryPool;
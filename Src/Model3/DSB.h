@@ -34,47 +34,7 @@
 #include "Types.h"
 #include "CPU/Bus.h"
 #include "Util/NewConfig.h"
-
-
-/******************************************************************************
- Resampling
- 
- Used internally by the DSB's MPEG code. If this becomes sufficiently generic,
- it can be moved to Sound/. Not intended for general use for now.
-******************************************************************************/
-
-/*
- * CDSBResampler:
- *
- * Frame-by-frame resampler. Resamples one single frame of audio and maintains
- * continuity between frames by copying unprocessed input samples to the 
- * beginning of the buffer and retaining the internal interpolation state. 
- *
- * See DSB.cpp for a detailed description of how this works.
- *
- * NOTE: If the sampling frequencies change, it is probably best to call
- * Reset(). Whether the resampler will otherwise behave correctly and stay
- * within array bounds has not been verified.
- *
- * Designed for use at 60 Hz, for input frequencies of 11.025, 22.05, 16, and 
- * 32 KHz and 44.1 KHz output frequencies. Theoretically, it should be able to
- * operate on most output frequencies and input frequencies that are simply 
- * lower, but it has not been extensively verified.
- */
-class CDSBResampler
-{
-public:
-	int		UpSampleAndMix(INT16 *outL, INT16 *outR, INT16 *inL, INT16 *inR, UINT8 volumeL, UINT8 volumeR, int sizeOut, int sizeIn, int outRate, int inRate);
-	void	Reset(void);
-	CDSBResampler(const Util::Config::Node &config)
-	  : m_config(config)
-  {
-  }
-private:
-	const Util::Config::Node &m_config;
-	int	nFrac;
-	int	pFrac;
-};
+#include "Sound/Resampler.h"
 
 
 /******************************************************************************
@@ -98,16 +58,20 @@ public:
 	virtual void SendCommand(UINT8 data) = 0;
 	
 	/*
-	 * RunFrame(audioL, audioR):
+	 * RunFrame(mixL, mixR, numSamples):
 	 *
-	 * Runs one frame and updates the MPEG audio. Audio is mixed into the
-	 * supplied buffers (they are assumed to already contain audio data).
+	 * Runs one frame and updates the MPEG audio. The MPEG stream is resampled
+	 * to the output rate, scaled by the DSB and music volume settings, and
+	 * added into the supplied mix buffers (they are assumed to already contain
+	 * audio data).
 	 *
 	 * Parameters:
-	 *		audioL	Left audio channel, one frame (44 KHz, 1/60th second).
-	 *		audioR	Right audio channel.
+	 *		mixL		Left audio channel mix buffer, one frame (1/60th
+	 *					second at the output sample rate).
+	 *		mixR		Right audio channel mix buffer.
+	 *		numSamples	Number of samples per channel in the frame.
 	 */
-	virtual void RunFrame(INT16 *audioL, INT16 *audioR) = 0;
+	virtual void RunFrame(INT32 *mixL, INT32 *mixR, unsigned numSamples) = 0;
 	
 	/*
 	 * Reset(void):
@@ -180,7 +144,7 @@ public:
 	
 	// DSB interface (see CDSB definition)
 	void 	SendCommand(UINT8 data);
-	void 	RunFrame(INT16 *audioL, INT16 *audioR);
+	void 	RunFrame(INT32 *mixL, INT32 *mixR, unsigned numSamples);
 	void 	Reset(void);
 	void	SaveState(CBlockFile *StateFile);
 	void	LoadState(CBlockFile *StateFile);
@@ -195,10 +159,11 @@ public:
 	
 private:
   const Util::Config::Node &m_config;
+  Util::Config::Handle<bool> m_emulateDSB;    // settings read every frame
+  Util::Config::Handle<int> m_musicVolume;
 
-	// Resampler
-	CDSBResampler	Resampler;
-	int				retainedSamples;	// how many MPEG samples carried over from previous frame
+	// Resampler (MPEG rate -> output rate)
+	CResampler	Resampler;
 	
   // MPEG decode buffers (48KHz, 1/60th second + 2 extra padding samples)
 	INT16	*mpegL, *mpegR;
@@ -257,7 +222,7 @@ public:
 	
 	// DSB interface (see definition of CDSB)
 	void 	SendCommand(UINT8 data);
-	void 	RunFrame(INT16 *audioL, INT16 *audioR);
+	void 	RunFrame(INT32 *mixL, INT32 *mixR, unsigned numSamples);
 	void 	Reset(void);
 	void	SaveState(CBlockFile *StateFile);
 	void	LoadState(CBlockFile *StateFile);
@@ -272,13 +237,14 @@ public:
 	
 private:
 	const Util::Config::Node &m_config;
+	Util::Config::Handle<bool>	m_emulateDSB;	// settings read every frame
+	Util::Config::Handle<int>	m_musicVolume;
 
 	// Private helper functions
 	void	WriteMPEGFIFO(UINT8 byte);
 	
-	// Resampler
-	CDSBResampler	Resampler;
-	int				retainedSamples;	// how many MPEG samples carried over from previous frame
+	// Resampler (MPEG rate -> output rate)
+	CResampler	Resampler;
 	
 	// MPEG decode buffers (48KHz, 1/60th second + 2 extra padding samples)
 	INT16	*mpegL, *mpegR;
@@ -36,6 +36,10 @@
 
 #define RAM_SIZE 0x2000 // Z80 RAM
 
+// Assuming Z80 runs @ 4.0MHz
+// TODO - find out if Z80 frequency is correct
+#define FRAME_CYCLES (int)(4.0 * 1000000 / 60)
+
 bool CDriveBoard::IsAttached(void)
 {
   return m_attached && !m_tmpDisabled;
@@ -188,6 +192,9 @@ void CDriveBoard::LoadState(CBlockFile *SaveState)
     // Disable board if it was not attached
     m_tmpDisabled = true;
 
+  // Commands from before the state was loaded no longer apply
+  ClearCommands();
+
   if (m_attached)
   {
     if (m_tmpDisabled)
@@ -216,8 +223,19 @@ bool CDriveBoard::Init(const UINT8 *romPtr)
   }
   memset(m_ram, 0, RAM_SIZE);
 
-  // Initialize Z80
+  // Initialize Z80 (ROM and RAM are accessed directly, matching Read8() and Write8())
   m_z80.Init(this, NULL);
+  m_z80.MapMemory(0x0000, 0x8FFF, m_rom, NULL);
+  m_z80.MapMemory(0xE000, 0xFFFF, m_ram, m_ram);
+
+  // Create objects used to pass commands from main board to drive board thread
+  m_cmdLock = CThread::CreateMutex();
+  if (m_cmdLock == NULL)
+    return ErrorLog("Unable to create drive board command queue: %s", CThread::GetLastError());
+  m_cmdSync = CThread::CreateCondVar();
+  if (m_cmdSync == NULL)
+    return ErrorLog("Unable to create drive board command queue: %s", CThread::GetLastError());
+  ClearCommands();
 
   return OKAY;
 }
@@ -283,6 +301,12 @@ void CDriveBoard::Reset(void)
   m_attached = false;
 #endif
 
+  ClearCommands();
+
+  // Send effects from separate thread, unless running single-threaded
+  if (m_attached && m_config["MultiThreaded"].ValueAs<bool>())
+    StartFFBThread();
+
   // Stop any effects that may still be playing
   if (m_attached)
     SendStopAll();
@@ -298,7 +322,7 @@ UINT8 CDriveBoard::Read(void)
     return m_dataReceived;
 }
 
-void CDriveBoard::Write(UINT8 data)
+void CDriveBoard::Write(UINT8 data, float framePos)
 {
   //if (data >= 0x01 && data <= 0x0F ||
   //  data >= 0x20 && data <= 0x2F || 
@@ -310,12 +334,104 @@ void CDriveBoard::Write(UINT8 data)
     SimulateWrite(data);
   else
   {
-    m_dataSent = data;
-    if (data == 0xCB)
-      m_initialized = false;
+    int time = std::min<int>(std::max<int>((int)(framePos * FRAME_CYCLES), 0), FRAME_CYCLES - 1);
+
+    // Queue command for Z80 to pick up when it reaches the same time (if queue is full, oldest command is superseded anyway)
+    m_cmdLock->Lock();
+    if (m_cmdCount == CMD_QUEUE_SIZE)
+    {
+      m_cmdHead = (m_cmdHead + 1) % CMD_QUEUE_SIZE;
+      m_cmdCount--;
+    }
+    DriveCommand &cmd = m_cmdQueue[(m_cmdHead + m_cmdCount) % CMD_QUEUE_SIZE];
+    cmd.time = time;
+    cmd.data = data;
+    m_cmdCount++;
+    m_mainBoardTime = std::max(m_mainBoardTime, time);
+    m_cmdSync->Signal();
+    m_cmdLock->Unlock();
   }
 }
 
+void CDriveBoard::BeginFrame(void)
+{
+  if (m_simulated)
+    return;
+  m_cmdLock->Lock();
+  m_mainBoardTime = 0;
+  m_cmdLock->Unlock();
+}
+
+void CDriveBoard::SetMainBoardProgress(float framePos)
+{
+  if (m_simulated)
+    return;
+  int time = framePos >= 1.0f ? FRAME_CYCLES : std::min<int>(std::max<int>((int)(framePos * FRAME_CYCLES), 0), FRAME_CYCLES - 1);
+  m_cmdLock->Lock();
+  m_mainBoardTime = std::max(m_mainBoardTime, time);
+  m_cmdSync->Signal();
+  m_cmdLock->Unlock();
+}
+
+void CDriveBoard::ApplyCommand(UINT8 data)
+{
+  m_dataSent = data;
+  if (data == 0xCB)
+    m_initialized = false;
+}
+
+int CDriveBoard::ProcessCommands(int time, int limit)
+{
+  // Deliver all commands due by now and return the time up to which the Z80 can run before the next one is due. If no
+  // more commands are queued, must first wait for main board to get past the limit so that none can be missed.
+  m_cmdLock->Lock();
+  for (;;)
+  {
+    while (m_cmdCount > 0 && m_cmdQueue[m_cmdHead].time <= time)
+    {
+      ApplyCommand(m_cmdQueue[m_cmdHead].data);
+      m_cmdHead = (m_cmdHead + 1) % CMD_QUEUE_SIZE;
+      m_cmdCount--;
+    }
+    if (m_cmdCount > 0)
+    {
+      limit = std::min(limit, m_cmdQueue[m_cmdHead].time);
+      break;
+    }
+    if (m_mainBoardTime >= limit)
+      break;
+    m_cmdSync->Wait(m_cmdLock);
+  }
+  m_cmdLock->Unlock();
+  return limit;
+}
+
+void CDriveBoard::FinishCommands(void)
+{
+  // Wait for main board to finish frame and deliver any commands Z80 overran
+  m_cmdLock->Lock();
+  while (m_mainBoardTime < FRAME_CYCLES)
+    m_cmdSync->Wait(m_cmdLock);
+  while (m_cmdCount > 0)
+  {
+    ApplyCommand(m_cmdQueue[m_cmdHead].data);
+    m_cmdHead = (m_cmdHead + 1) % CMD_QUEUE_SIZE;
+    m_cmdCount--;
+  }
+  m_cmdLock->Unlock();
+}
+
+void CDriveBoard::ClearCommands(void)
+{
+  if (m_cmdLock == NULL)
+    return;
+  m_cmdLock->Lock();
+  m_cmdHead = 0;
+  m_cmdCount = 0;
+  m_mainBoardTime = FRAME_CYCLES;
+  m_cmdLock->Unlock();
+}
+
 UINT8 CDriveBoard::SimulateRead(void)
 {
   if (m_initialized)
@@ -327,7 +443,7 @@ UINT8 CDriveBoard::SimulateRead(void)
       case 0x2: return m_dip2;                    // DIP switch 2 value
       case 0x3: return m_wheelCenter;             // Wheel center
       case 0x4: return 0x80;                      // Cockpit banking center
-      case 0x5: return m_inputs->steering->value; // Wheel position
+      case 0x5: return m_inputs->steering->LatestValue(); // Wheel position
       case 0x6: return 0x80;                      // Cockpit banking position
       case 0x7: return m_echoVal;                 // Init status/echo test
       default:  return 0xFF;
@@ -406,7 +522,7 @@ void CDriveBoard::SimulateWrite(UINT8 cmd)
         case 2:  SendConstantForce(-20);                    break;  // 0x82 Roll wheel left
         case 3:  /* Ignore - no clutch */                   break;  // 0x83 Clutch on 
         case 4:  /* Ignore - no clutch */                   break;  // 0x84 Clutch off
-        case 5:  m_wheelCenter = m_inputs->steering->value; break;  // 0x85 Set wheel center position
+        case 5:  m_wheelCenter = m_inputs->steering->LatestValue(); break;  // 0x85 Set wheel center position
         case 6:  /* Ignore */                               break;  // 0x86 Set cockpit banking position
         case 7:  /* Ignore */                               break;  // 0x87 Lamp on/off
       }
@@ -459,16 +575,24 @@ void CDriveBoard::SimulateFrame(void)
 
 void CDriveBoard::EmulateFrame(void)
 {
-  // Assuming Z80 runs @ 4.0MHz and NMI triggers @ 60.0KHz
-  // TODO - find out if Z80 frequency is correct and exact frequency of NMI interrupts (just guesswork at the moment!)
-  int cycles     = (int)(4.0 * 1000000 / 60);
+  // Assuming NMI triggers @ 60.0KHz
+  // TODO - find out exact frequency of NMI interrupts (just guesswork at the moment!)
+  int time       = 0;
   int loopCycles = 10000;
-  while (cycles > 0)
+  while (time < FRAME_CYCLES)
   {
     if (m_allowInterrupts)
       m_z80.TriggerNMI();
-    cycles -= m_z80.Run(std::min<int>(loopCycles, cycles));
+    int loopEnd = time + std::min<int>(loopCycles, FRAME_CYCLES - time);
+
+    // Run in slices that end whenever a command from the main board is due
+    while (time < loopEnd)
+    {
+      int sliceEnd = ProcessCommands(time, loopEnd);
+      time += m_z80.Run(sliceEnd - time);
+    }
   }
+  FinishCommands();
 }
 
 UINT8 CDriveBoard::Read8(UINT32 addr)
@@ -517,7 +641,7 @@ UINT8 CDriveBoard::IORead8(UINT32 portNum)
             break;
           case 37: // Steering wheel for twin racing cabinets - TODO - check actual range of steering, suspect it is not really 0x00-0xFF
             if (m_initialized)
-              adcVal = (UINT8)m_inputs->steering->value;
+              adcVal = (UINT8)m_inputs->steering->LatestValue();
             else
               adcVal = 0x80; // If not initialized, return 0x80 so that wheel centering test does not fail
             break;
@@ -729,7 +853,7 @@ void CDriveBoard::SendStopAll(void)
 
   ForceFeedbackCmd ffCmd;
   ffCmd.id = FFStop;
-  m_inputs->steering->SendForceFeedbackCmd(ffCmd);
+  QueueForceFeedback(ffCmd);
 
   m_lastConstForce = 0;
   m_lastSelfCenter = 0;
@@ -763,7 +887,7 @@ void CDriveBoard::SendConstantForce(INT8 val)
   ForceFeedbackCmd ffCmd;
   ffCmd.id = FFConstantForce;     
   ffCmd.force = (float)val / (val >= 0 ? 127.0f : 128.0f);
-  m_inputs->steering->SendForceFeedbackCmd(ffCmd);
+  QueueForceFeedback(ffCmd);
 
   m_lastConstForce = val;
 }
@@ -782,7 +906,7 @@ void CDriveBoard::SendSelfCenter(UINT8 val)
   ForceFeedbackCmd ffCmd;
   ffCmd.id = FFSelfCenter;
   ffCmd.force = (float)val / 255.0f;
-  m_inputs->steering->SendForceFeedbackCmd(ffCmd);
+  QueueForceFeedback(ffCmd);
 
   m_lastSelfCenter = val;
 }
@@ -801,7 +925,7 @@ void CDriveBoard::SendFriction(UINT8 val)
   ForceFeedbackCmd ffCmd;
   ffCmd.id = FFFriction;
   ffCmd.force = (float)val / 255.0f;
-  m_inputs->steering->SendForceFeedbackCmd(ffCmd);
+  QueueForceFeedback(ffCmd);
 
   m_lastFriction = val;
 }
@@ -820,11 +944,129 @@ void CDriveBoard::SendVibrate(UINT8 val)
   ForceFeedbackCmd ffCmd;
   ffCmd.id = FFVibrate;
   ffCmd.force = (float)val / 255.0f;
-  m_inputs->steering->SendForceFeedbackCmd(ffCmd);
+  QueueForceFeedback(ffCmd);
 
   m_lastVibrate = val;
 }
 
+void CDriveBoard::QueueForceFeedback(const ForceFeedbackCmd &ffCmd)
+{
+  if (m_ffbThread == NULL)
+  {
+    m_inputs->steering->SendForceFeedbackCmd(ffCmd);
+    return;
+  }
+
+  m_ffbLock->Lock();
+  bool merged = false;
+  if (ffCmd.id == FFStop)
+    m_ffbCount = 0; // stopping supersedes any effects not yet sent
+  else
+  {
+    // Only latest value of an effect matters, so update it if still pending
+    for (unsigned i = 0; i < m_ffbCount && !merged; i++)
+    {
+      ForceFeedbackCmd &pending = m_ffbQueue[(m_ffbHead + i) % FFB_QUEUE_SIZE];
+      if (pending.id == ffCmd.id)
+      {
+        pending = ffCmd;
+        merged = true;
+      }
+    }
+  }
+  if (!merged)
+  {
+    if (m_ffbCount == FFB_QUEUE_SIZE)
+    {
+      m_ffbHead = (m_ffbHead + 1) % FFB_QUEUE_SIZE;
+      m_ffbCount--;
+    }
+    m_ffbQueue[(m_ffbHead + m_ffbCount) % FFB_QUEUE_SIZE] = ffCmd;
+    m_ffbCount++;
+    m_ffbSync->Signal();
+  }
+  m_ffbLock->Unlock();
+}
+
+bool CDriveBoard::StartFFBThread(void)
+{
+  if (m_ffbThread != NULL)
+    return true;
+
+  m_ffbHead = 0;
+  m_ffbCount = 0;
+  m_ffbQuit = false;
+  m_ffbLock = CThread::CreateMutex();
+  if (m_ffbLock == NULL)
+    goto ThreadError;
+  m_ffbSync = CThread::CreateCondVar();
+  if (m_ffbSync == NULL)
+    goto ThreadError;
+  m_ffbThread = CThread::CreateThread("DriveBoardFFB", StartFFBOutputThread, this);
+  if (m_ffbThread == NULL)
+    goto ThreadError;
+  return true;
+
+ThreadError:
+  ErrorLog("Unable to create force feedback thread: %s\nSending force feedback from drive board thread instead.\n", CThread::GetLastError());
+  StopFFBThread();
+  return false;
+}
+
+void CDriveBoard::StopFFBThread(void)
+{
+  if (m_ffbThread != NULL)
+  {
+    m_ffbLock->Lock();
+    m_ffbQuit = true;
+    m_ffbSync->Signal();
+    m_ffbLock->Unlock();
+    m_ffbThread->Wait();
+    delete m_ffbThread;
+    m_ffbThread = NULL;
+  }
+  if (m_ffbSync != NULL)
+  {
+    delete m_ffbSync;
+    m_ffbSync = NULL;
+  }
+  if (m_ffbLock != NULL)
+  {
+    delete m_ffbLock;
+    m_ffbLock = NULL;
+  }
+}
+
+int CDriveBoard::StartFFBOutputThread(void *data)
+{
+  // Call method on CDriveBoard to run force feedback thread
+  CDriveBoard *driveBoard = (CDriveBoard*)data;
+  return driveBoard->RunFFBThread();
+}
+
+int CDriveBoard::RunFFBThread(void)
+{
+  m_ffbLock->Lock();
+  for (;;)
+  {
+    while (m_ffbCount == 0 && !m_ffbQuit)
+      m_ffbSync->Wait(m_ffbLock);
+    if (m_ffbCount == 0)
+      break;  // quitting and all effects sent
+
+    ForceFeedbackCmd ffCmd = m_ffbQueue[m_ffbHead];
+    m_ffbHead = (m_ffbHead + 1) % FFB_QUEUE_SIZE;
+    m_ffbCount--;
+
+    // Send effect to device outside of lock so that drive board is never held up
+    m_ffbLock->Unlock();
+    m_inputs->steering->SendForceFeedbackCmd(ffCmd);
+    m_ffbLock->Lock();
+  }
+  m_ffbLock->Unlock();
+  return 0;
+}
+
 CDriveBoard::CDriveBoard(const Util::Config::Node &config) 
   : m_config(config),
     m_attached(false),
@@ -835,13 +1077,36 @@ CDriveBoard::CDriveBoard(const Util::Config::Node &config)
     m_rom(NULL),
     m_ram(NULL),
     m_inputs(NULL),
-    m_outputs(NULL)
+    m_outputs(NULL),
+    m_cmdHead(0),
+    m_cmdCount(0),
+    m_mainBoardTime(FRAME_CYCLES),
+    m_cmdLock(NULL),
+    m_cmdSync(NULL),
+    m_ffbHead(0),
+    m_ffbCount(0),
+    m_ffbQuit(false),
+    m_ffbThread(NULL),
+    m_ffbLock(NULL),
+    m_ffbSync(NULL)
 {
   DebugLog("Built Drive Board\n");
 }
 
 CDriveBoard::~CDriveBoard(void)
 { 
+  StopFFBThread();
+  if (m_cmdSync != NULL)
+  {
+    delete m_cmdSync;
+    m_cmdSync = NULL;
+  }
+  if (m_cmdLock != NULL)
+  {
+    delete m_cmdLock;
+    m_cmdLock = NULL;
+  }
+
   if (m_ram != NULL)
   {
     delete[] m_ram;
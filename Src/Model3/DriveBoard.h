@@ -186,19 +186,46 @@ public:
   UINT8 Read(void);
 
   /*
-   * Write(data):
+   * Write(data, framePos):
    *
-   * Writes data to the drive board.
+   * Writes data to the drive board. Commands are queued and delivered to
+   * the drive board Z80 when it reaches the same point in the frame.
    *
    * Parameters:
-   *    data  Data to send.
+   *    data      Data to send.
+   *    framePos  Fraction of the current frame (0.0-1.0) that the main
+   *              board had completed when the data was sent.
    */
-  void Write(UINT8 data);
+  void Write(UINT8 data, float framePos);
+
+  /*
+   * BeginFrame(void):
+   *
+   * Marks the start of a new frame. Must be called before either the main
+   * board or the drive board starts emulating the frame.
+   */
+  void BeginFrame(void);
+
+  /*
+   * SetMainBoardProgress(framePos):
+   *
+   * Informs the drive board how far the main board has got through the
+   * current frame. When running on its own thread, the drive board does not
+   * emulate past this point so that it never misses commands sent by the
+   * main board.
+   *
+   * Parameters:
+   *    framePos  Fraction of the current frame completed by the main board
+   *              (0.0-1.0). 1.0 indicates the main board has finished the
+   *              frame.
+   */
+  void SetMainBoardProgress(float framePos);
 
   /*
    * RunFrame(void):
    *
-   * Emulates a single frame's worth of time on the drive board.
+   * Emulates a single frame's worth of time on the drive board, interleaved
+   * with the commands sent by the main board during the frame.
    */
   void RunFrame(void);
 
@@ -303,6 +330,30 @@ private:
   UINT8 m_lastFriction;   // Last friction command sent
   UINT8 m_lastVibrate;    // Last vibrate command sent
 
+  // Commands sent by main board, in order, time stamped with Z80 cycle within frame
+  struct DriveCommand
+  {
+    int time;
+    UINT8 data;
+  };
+  static const unsigned CMD_QUEUE_SIZE = 256;
+  DriveCommand m_cmdQueue[CMD_QUEUE_SIZE];
+  unsigned m_cmdHead;     // Oldest queued command
+  unsigned m_cmdCount;    // Number of queued commands
+  int m_mainBoardTime;    // Z80 cycle within frame that main board has reached
+  CMutex *m_cmdLock;      // Protects command queue and main board time
+  CCondVar *m_cmdSync;    // Signalled when main board sends command or makes progress
+
+  // Force feedback output thread (effects are sent from here so that slow devices do not stall emulation)
+  static const unsigned FFB_QUEUE_SIZE = 16;
+  ForceFeedbackCmd m_ffbQueue[FFB_QUEUE_SIZE];
+  unsigned m_ffbHead;     // Oldest pending effect
+  unsigned m_ffbCount;    // Number of pending effects
+  bool m_ffbQuit;         // True if output thread should exit
+  CThread *m_ffbThread;
+  CMutex *m_ffbLock;
+  CCondVar *m_ffbSync;    // Signalled when effect is queued or thread should exit
+
   UINT8 SimulateRead(void);
 
   void SimulateWrite(UINT8 data);
@@ -311,6 +362,24 @@ private:
 
   void EmulateFrame(void);
 
+  void ApplyCommand(UINT8 data);
+
+  int ProcessCommands(int time, int limit);
+
+  void FinishCommands(void);
+
+  void ClearCommands(void);
+
+  bool StartFFBThread(void);
+
+  void StopFFBThread(void);
+
+  static int StartFFBOutputThread(void *data);
+
+  int RunFFBThread(void);
+
+  void QueueForceFeedback(const ForceFeedbackCmd &ffCmd);
+
   void ProcessEncoderCmd(void);
 
   void SendStopAll(void);
@@ -208,6 +208,7 @@
 #include "ROMSet.h"
 #include "Util/Format.h"
 #include "Util/ByteSwap.h"
+#include "Model3/ROMCache.h"
 #include <functional>
 #include <set>
 #include <iostream>
@@ -235,17 +236,17 @@ UINT8 CModel3::ReadInputs(unsigned reg)
 
     if ((inputBank&1) == 0)
     {
-      data &= ~(Inputs->coin[0]->value);        // Coin 1
-      data &= ~(Inputs->coin[1]->value<<1);     // Coin 2
-      data &= ~(Inputs->test[0]->value<<2);     // Test A
-      data &= ~(Inputs->service[0]->value<<3);  // Service A
-      data &= ~(Inputs->start[0]->value<<4);    // Start 1
-      data &= ~(Inputs->start[1]->value<<5);    // Start 2
+      data &= ~(Inputs->coin[0]->LatestValue());        // Coin 1
+      data &= ~(Inputs->coin[1]->LatestValue()<<1);     // Coin 2
+      data &= ~(Inputs->test[0]->LatestValue()<<2);     // Test A
+      data &= ~(Inputs->service[0]->LatestValue()<<3);  // Service A
+      data &= ~(Inputs->start[0]->LatestValue()<<4);    // Start 1
+      data &= ~(Inputs->start[1]->LatestValue()<<5);    // Start 2
     }
     else
     {
-      data &= ~(Inputs->service[1]->value<<6);  // Service B
-      data &= ~(Inputs->test[1]->value<<7);     // Test B
+      data &= ~(Inputs->service[1]->LatestValue()<<6);  // Service B
+      data &= ~(Inputs->test[1]->LatestValue()<<7);     // Test B
       data = (data&0xDF)|(EEPROM.Read()<<5);    // bank 1 contains EEPROM data bit
     }
 
@@ -253,10 +254,10 @@ UINT8 CModel3::ReadInputs(unsigned reg)
     {
       if ((inputBank&1) == 0)
       {
-        data &= ~(Inputs->skiPollLeft->value<<5);
-        data &= ~(Inputs->skiSelect1->value<<6);
-        data &= ~(Inputs->skiSelect2->value<<7);
-        data &= ~(Inputs->skiSelect3->value<<4);
+        data &= ~(Inputs->skiPollLeft->LatestValue()<<5);
+        data &= ~(Inputs->skiSelect1->LatestValue()<<6);
+        data &= ~(Inputs->skiSelect2->LatestValue()<<7);
+        data &= ~(Inputs->skiSelect3->LatestValue()<<4);
       }
     }
 
@@ -268,66 +269,66 @@ UINT8 CModel3::ReadInputs(unsigned reg)
 
     if ((m_game.inputs & Game::INPUT_SKI))
     {
-      data &= ~(Inputs->skiPollRight->value<<0);
+      data &= ~(Inputs->skiPollRight->LatestValue()<<0);
     }
 
     if ((m_game.inputs & Game::INPUT_JOYSTICK1))
     {
-      data &= ~(Inputs->up[0]->value<<5);     // P1 Up
-      data &= ~(Inputs->down[0]->value<<4);   // P1 Down
-      data &= ~(Inputs->left[0]->value<<7);   // P1 Left
-      data &= ~(Inputs->right[0]->value<<6);  // P1 Right
+      data &= ~(Inputs->up[0]->LatestValue()<<5);     // P1 Up
+      data &= ~(Inputs->down[0]->LatestValue()<<4);   // P1 Down
+      data &= ~(Inputs->left[0]->LatestValue()<<7);   // P1 Left
+      data &= ~(Inputs->right[0]->LatestValue()<<6);  // P1 Right
     }
 
     if ((m_game.inputs & Game::INPUT_FIGHTING))
     {
-      data &= ~(Inputs->escape[0]->value<<3); // P1 Escape
-      data &= ~(Inputs->guard[0]->value<<2);  // P1 Guard
-      data &= ~(Inputs->kick[0]->value<<1);   // P1 Kick
-      data &= ~(Inputs->punch[0]->value<<0);  // P1 Punch
+      data &= ~(Inputs->escape[0]->LatestValue()<<3); // P1 Escape
+      data &= ~(Inputs->guard[0]->LatestValue()<<2);  // P1 Guard
+      data &= ~(Inputs->kick[0]->LatestValue()<<1);   // P1 Kick
+      data &= ~(Inputs->punch[0]->LatestValue()<<0);  // P1 Punch
     }
     
     if ((m_game.inputs & Game::INPUT_SPIKEOUT))
     {
-      data &= ~(Inputs->shift->value<<2);     // Shift
-      data &= ~(Inputs->beat->value<<0);      // Beat
-      data &= ~(Inputs->charge->value<<1);    // Charge
-      data &= ~(Inputs->jump->value<<3);      // Jump
+      data &= ~(Inputs->shift->LatestValue()<<2);     // Shift
+      data &= ~(Inputs->beat->LatestValue()<<0);      // Beat
+      data &= ~(Inputs->charge->LatestValue()<<1);    // Charge
+      data &= ~(Inputs->jump->LatestValue()<<3);      // Jump
     }
     
     if ((m_game.inputs & Game::INPUT_SOCCER))
     {
-      data &= ~(Inputs->shortPass[0]->value<<2);  // P1 Short Pass
-      data &= ~(Inputs->longPass[0]->value<<0);   // P1 Long Pass
-      data &= ~(Inputs->shoot[0]->value<<1);      // P1 Shoot
+      data &= ~(Inputs->shortPass[0]->LatestValue()<<2);  // P1 Short Pass
+      data &= ~(Inputs->longPass[0]->LatestValue()<<0);   // P1 Long Pass
+      data &= ~(Inputs->shoot[0]->LatestValue()<<1);      // P1 Shoot
     }
 
     if ((m_game.inputs & Game::INPUT_VR4))
     {
-      data &= ~(Inputs->vr[0]->value<<0); // VR1 Red
-      data &= ~(Inputs->vr[1]->value<<1); // VR2 Blue
-      data &= ~(Inputs->vr[2]->value<<2); // VR3 Yellow
-      data &= ~(Inputs->vr[3]->value<<3); // VR4 Green
+      data &= ~(Inputs->vr[0]->LatestValue()<<0); // VR1 Red
+      data &= ~(Inputs->vr[1]->LatestValue()<<1); // VR2 Blue
+      data &= ~(Inputs->vr[2]->LatestValue()<<2); // VR3 Yellow
+      data &= ~(Inputs->vr[3]->LatestValue()<<3); // VR4 Green
     }
   
     if ((m_game.inputs & Game::INPUT_VIEWCHANGE))
     {
       // Harley is wired slightly differently
       if ((m_game.inputs & Game::INPUT_HARLEY))
-        data &= ~(Inputs->viewChange->value<<1);  // View change
+        data &= ~(Inputs->viewChange->LatestValue()<<1);  // View change
       else
-        data &= ~(Inputs->viewChange->value<<0);  // View change
+        data &= ~(Inputs->viewChange->LatestValue()<<0);  // View change
     }
     
     if ((m_game.inputs & Game::INPUT_SHIFT4))
     {
-      if (Inputs->gearShift4->value == 2)       // Shift 2
+      if (Inputs->gearShift4->LatestValue() == 2)       // Shift 2
         data &= ~0x60;
-      else if (Inputs->gearShift4->value == 4)  // Shift 4
+      else if (Inputs->gearShift4->LatestValue() == 4)  // Shift 4
         data &= ~0x20;
-      if (Inputs->gearShift4->value == 1)       // Shift 1
+      if (Inputs->gearShift4->LatestValue() == 1)       // Shift 1
         data &= ~0x50;
-      else if (Inputs->gearShift4->value == 3)  // Shift 3
+      else if (Inputs->gearShift4->LatestValue() == 3)  // Shift 3
         data &= ~0x10;
     }
 
@@ -336,35 +337,35 @@ UINT8 CModel3::ReadInputs(unsigned reg)
       // Harley is wired slightly differently
       if ((m_game.inputs & Game::INPUT_HARLEY))
       {
-        if (Inputs->gearShiftUp->value)         // Shift up 
+        if (Inputs->gearShiftUp->LatestValue())         // Shift up 
           data &= ~0x20;
-        else if (Inputs->gearShiftDown->value)  // Shift down
+        else if (Inputs->gearShiftDown->LatestValue())  // Shift down
           data &= ~0x10;
       }
       else
       {
-        if (Inputs->gearShiftUp->value)         // Shift up
+        if (Inputs->gearShiftUp->LatestValue())         // Shift up
           data &= ~0x50;
-        else if (Inputs->gearShiftDown->value)  // Shift down
+        else if (Inputs->gearShiftDown->LatestValue())  // Shift down
           data &= ~0x60;
       }
     }
     
     if ((m_game.inputs & Game::INPUT_HANDBRAKE))
-      data &= ~(Inputs->handBrake->value<<1);   // Hand brake
+      data &= ~(Inputs->handBrake->LatestValue()<<1);   // Hand brake
     
     if ((m_game.inputs & Game::INPUT_HARLEY))
-      data &= ~(Inputs->musicSelect->value<<0); // Music select
+      data &= ~(Inputs->musicSelect->LatestValue()<<0); // Music select
     
     if ((m_game.inputs & Game::INPUT_GUN1))
-      data &= ~(Inputs->trigger[0]->value<<0);  // P1 Trigger
+      data &= ~(Inputs->trigger[0]->LatestValue()<<0);  // P1 Trigger
     
     if ((m_game.inputs & Game::INPUT_ANALOG_JOYSTICK))
     {
-      data &= ~(Inputs->analogJoyTrigger1->value<<5); // Trigger 1
-      data &= ~(Inputs->analogJoyTrigger2->value<<4); // Trigger 2
-      data &= ~(Inputs->analogJoyEvent1->value<<0);   // Event Button 1
-      data &= ~(Inputs->analogJoyEvent2->value<<1);   // Event Button 2
+      data &= ~(Inputs->analogJoyTrigger1->LatestValue()<<5); // Trigger 1
+      data &= ~(Inputs->analogJoyTrigger2->LatestValue()<<4); // Trigger 2
+      data &= ~(Inputs->analogJoyEvent1->LatestValue()<<0);   // Event Button 1
+      data &= ~(Inputs->analogJoyEvent2->LatestValue()<<1);   // Event Button 2
     }
     
     if ((m_game.inputs & Game::INPUT_TWIN_JOYSTICKS)) // First twin joystick
@@ -374,14 +375,14 @@ UINT8 CModel3::ReadInputs(unsigned reg)
        */
        
       // Shot trigger and Turbo
-      data &= ~(Inputs->twinJoyShot1->value<<0);
-      data &= ~(Inputs->twinJoyTurbo1->value<<1);
+      data &= ~(Inputs->twinJoyShot1->LatestValue()<<0);
+      data &= ~(Inputs->twinJoyTurbo1->LatestValue()<<1);
       
       // Stick
-      data &= ~(Inputs->twinJoyLeft1->value<<7);
-      data &= ~(Inputs->twinJoyRight1->value<<6);
-      data &= ~(Inputs->twinJoyUp1->value<<5);
-      data &= ~(Inputs->twinJoyDown1->value<<4);
+      data &= ~(Inputs->twinJoyLeft1->LatestValue()<<7);
+      data &= ~(Inputs->twinJoyRight1->LatestValue()<<6);
+      data &= ~(Inputs->twinJoyUp1->LatestValue()<<5);
+      data &= ~(Inputs->twinJoyDown1->LatestValue()<<4);
       
       /*
        * Next, process twin joystick macro inputs (higher level inputs
@@ -396,13 +397,13 @@ UINT8 CModel3::ReadInputs(unsigned reg)
        * Forward:     1U 2U
        * Reverse:     1D 2D
        */
-      if (Inputs->twinJoyTurnLeft->value)
+      if (Inputs->twinJoyTurnLeft->LatestValue())
         data &= ~0x10;
-      else if (Inputs->twinJoyTurnRight->value)
+      else if (Inputs->twinJoyTurnRight->LatestValue())
         data &= ~0x20;
-      else if (Inputs->twinJoyForward->value)
+      else if (Inputs->twinJoyForward->LatestValue())
         data &= ~0x20;
-      else if (Inputs->twinJoyReverse->value)
+      else if (Inputs->twinJoyReverse->LatestValue())
         data &= ~0x10;
         
       /*
@@ -413,29 +414,29 @@ UINT8 CModel3::ReadInputs(unsigned reg)
        * Jump:          1L 2R
        * Crouch:        1R 2L
        */
-      if (Inputs->twinJoyStrafeLeft->value)
+      if (Inputs->twinJoyStrafeLeft->LatestValue())
         data &= ~0x80;
-      else if (Inputs->twinJoyStrafeRight->value)
+      else if (Inputs->twinJoyStrafeRight->LatestValue())
         data &= ~0x40;
-      else if (Inputs->twinJoyJump->value)
+      else if (Inputs->twinJoyJump->LatestValue())
         data &= ~0x80;
-      else if (Inputs->twinJoyCrouch->value)
+      else if (Inputs->twinJoyCrouch->LatestValue())
         data &= ~0x40;
     }
 
     if ((m_game.inputs & Game::INPUT_ANALOG_GUN1))
     {
-      data &= ~(Inputs->analogTriggerLeft[0]->value<<0);
-      data &= ~(Inputs->analogTriggerRight[0]->value<<1);
+      data &= ~(Inputs->analogTriggerLeft[0]->LatestValue()<<0);
+      data &= ~(Inputs->analogTriggerRight[0]->LatestValue()<<1);
     }
 
     if ((m_game.inputs & Game::INPUT_MAGTRUCK))
-      data &= ~(Inputs->magicalPedal1->value << 0);
+      data &= ~(Inputs->magicalPedal1->LatestValue() << 0);
 
     if ((m_game.inputs & Game::INPUT_FISHING))
     {
-      data &= ~(Inputs->fishingCast->value << 0);
-      data &= ~(Inputs->fishingSelect->value << 1);
+      data &= ~(Inputs->fishingCast->LatestValue() << 0);
+      data &= ~(Inputs->fishingSelect->LatestValue() << 1);
     }
     return data;
 
@@ -448,68 +449,68 @@ UINT8 CModel3::ReadInputs(unsigned reg)
     
     if ((m_game.inputs & Game::INPUT_JOYSTICK2))
     {
-      data &= ~(Inputs->up[1]->value<<5);     // P2 Up
-      data &= ~(Inputs->down[1]->value<<4);   // P2 Down
-      data &= ~(Inputs->left[1]->value<<7);   // P2 Left
-      data &= ~(Inputs->right[1]->value<<6);  // P2 Right
+      data &= ~(Inputs->up[1]->LatestValue()<<5);     // P2 Up
+      data &= ~(Inputs->down[1]->LatestValue()<<4);   // P2 Down
+      data &= ~(Inputs->left[1]->LatestValue()<<7);   // P2 Left
+      data &= ~(Inputs->right[1]->LatestValue()<<6);  // P2 Right
     }
 
     if ((m_game.inputs & Game::INPUT_FIGHTING))
     {
-      data &= ~(Inputs->escape[1]->value<<3); // P2 Escape
-      data &= ~(Inputs->guard[1]->value<<2);  // P2 Guard
-      data &= ~(Inputs->kick[1]->value<<1);   // P2 Kick
-      data &= ~(Inputs->punch[1]->value<<0);  // P2 Punch
+      data &= ~(Inputs->escape[1]->LatestValue()<<3); // P2 Escape
+      data &= ~(Inputs->guard[1]->LatestValue()<<2);  // P2 Guard
+      data &= ~(Inputs->kick[1]->LatestValue()<<1);   // P2 Kick
+      data &= ~(Inputs->punch[1]->LatestValue()<<0);  // P2 Punch
     }
     
     if ((m_game.inputs & Game::INPUT_SOCCER))
     {
-      data &= ~(Inputs->shortPass[1]->value<<2);  // P2 Short Pass
-      data &= ~(Inputs->longPass[1]->value<<0);   // P2 Long Pass
-      data &= ~(Inputs->shoot[1]->value<<1);      // P2 Shoot
+      data &= ~(Inputs->shortPass[1]->LatestValue()<<2);  // P2 Short Pass
+      data &= ~(Inputs->longPass[1]->LatestValue()<<0);   // P2 Long Pass
+      data &= ~(Inputs->shoot[1]->LatestValue()<<1);      // P2 Shoot
     }
     
     if ((m_game.inputs & Game::INPUT_TWIN_JOYSTICKS)) // Second twin joystick (see register 0x08 for comments)
     {
             
-      data &= ~(Inputs->twinJoyShot2->value<<0);
-      data &= ~(Inputs->twinJoyTurbo2->value<<1);
+      data &= ~(Inputs->twinJoyShot2->LatestValue()<<0);
+      data &= ~(Inputs->twinJoyTurbo2->LatestValue()<<1);
       
-      data &= ~(Inputs->twinJoyLeft2->value<<7);
-      data &= ~(Inputs->twinJoyRight2->value<<6);
-      data &= ~(Inputs->twinJoyUp2->value<<5);
-      data &= ~(Inputs->twinJoyDown2->value<<4);
+      data &= ~(Inputs->twinJoyLeft2->LatestValue()<<7);
+      data &= ~(Inputs->twinJoyRight2->LatestValue()<<6);
+      data &= ~(Inputs->twinJoyUp2->LatestValue()<<5);
+      data &= ~(Inputs->twinJoyDown2->LatestValue()<<4);
 
-      if (Inputs->twinJoyTurnLeft->value)
+      if (Inputs->twinJoyTurnLeft->LatestValue())
         data &= ~0x20;
-      else if (Inputs->twinJoyTurnRight->value)
+      else if (Inputs->twinJoyTurnRight->LatestValue())
         data &= ~0x10;
-      else if (Inputs->twinJoyForward->value)
+      else if (Inputs->twinJoyForward->LatestValue())
         data &= ~0x20;
-      else if (Inputs->twinJoyReverse->value)
+      else if (Inputs->twinJoyReverse->LatestValue())
         data &= ~0x10;
       
-      if (Inputs->twinJoyStrafeLeft->value)
+      if (Inputs->twinJoyStrafeLeft->LatestValue())
         data &= ~0x80;
-      else if (Inputs->twinJoyStrafeRight->value)
+      else if (Inputs->twinJoyStrafeRight->LatestValue())
         data &= ~0x40;
-      else if (Inputs->twinJoyJump->value)
+      else if (Inputs->twinJoyJump->LatestValue())
         data &= ~0x40;
-      else if (Inputs->twinJoyCrouch->value)
+      else if (Inputs->twinJoyCrouch->LatestValue())
         data &= ~0x80;
     }
     
     if ((m_game.inputs & Game::INPUT_GUN2))
-      data &= ~(Inputs->trigger[1]->value<<0);  // P2 Trigger
+      data &= ~(Inputs->trigger[1]->LatestValue()<<0);  // P2 Trigger
     
     if ((m_game.inputs & Game::INPUT_ANALOG_GUN2))
     {
-      data &= ~(Inputs->analogTriggerLeft[1]->value<<0);
-      data &= ~(Inputs->analogTriggerRight[1]->value<<1);
+      data &= ~(Inputs->analogTriggerLeft[1]->LatestValue()<<0);
+      data &= ~(Inputs->analogTriggerRight[1]->LatestValue()<<1);
     }
 
     if ((m_game.inputs & Game::INPUT_MAGTRUCK))
-      data &= ~(Inputs->magicalPedal2->value << 0);
+      data &= ~(Inputs->magicalPedal2->LatestValue() << 0);
 
     return data;
 
@@ -533,25 +534,25 @@ UINT8 CModel3::ReadInputs(unsigned reg)
     memset(adc, 0, sizeof(adc));
     if ((m_game.inputs & Game::INPUT_VEHICLE))
     {
-      adc[0] = (UINT8)Inputs->steering->value;
-      adc[1] = (UINT8)Inputs->accelerator->value;
-      adc[2] = (UINT8)Inputs->brake->value;
+      adc[0] = (UINT8)Inputs->steering->LatestValue();
+      adc[1] = (UINT8)Inputs->accelerator->LatestValue();
+      adc[2] = (UINT8)Inputs->brake->LatestValue();
       if ((m_game.inputs & Game::INPUT_HARLEY))
-        adc[3] = (UINT8)Inputs->rearBrake->value;
+        adc[3] = (UINT8)Inputs->rearBrake->LatestValue();
     }
 
     if ((m_game.inputs & Game::INPUT_ANALOG_JOYSTICK))
     {
-      adc[0] = (UINT8)Inputs->analogJoyY->value;
-      adc[1] = (UINT8)Inputs->analogJoyX->value;
+      adc[0] = (UINT8)Inputs->analogJoyY->LatestValue();
+      adc[1] = (UINT8)Inputs->analogJoyX->LatestValue();
     }
 
     if (m_game.inputs & (Game::INPUT_ANALOG_GUN1 | Game::INPUT_ANALOG_GUN2))
     { 
-      adc[0] = (UINT8)Inputs->analogGunX[0]->value;
-      adc[2] = (UINT8)Inputs->analogGunY[0]->value;
-      adc[1] = (UINT8)Inputs->analogGunX[1]->value;
-      adc[3] = (UINT8)Inputs->analogGunY[1]->value;
+      adc[0] = (UINT8)Inputs->analogGunX[0]->LatestValue();
+      adc[2] = (UINT8)Inputs->analogGunY[0]->LatestValue();
+      adc[1] = (UINT8)Inputs->analogGunX[1]->LatestValue();
+      adc[3] = (UINT8)Inputs->analogGunY[1]->LatestValue();
 
   	  // Unclear why this is necessary or how to cleanly fix it, so I'm
   	  // disabling it but leaving it here for future reference. The proper fix is
@@ -560,32 +561,32 @@ UINT8 CModel3::ReadInputs(unsigned reg)
   	  // all analog_gun games require axis inversion to be playable).
 	  if (m_game.name == "lostwsga" || m_game.name == "lostwsgo")
 	  { // to do, not a string compare
-        adc[0] =       (UINT8)Inputs->analogGunX[0]->value; // order is different for some reason in lost world
-        adc[1] = 255 - (UINT8)Inputs->analogGunY[0]->value; // why are values inverted? is this the wrong place to fix this
-        adc[2] =       (UINT8)Inputs->analogGunX[1]->value;
-        adc[3] = 255 - (UINT8)Inputs->analogGunY[1]->value;
+        adc[0] =       (UINT8)Inputs->analogGunX[0]->LatestValue(); // order is different for some reason in lost world
+        adc[1] = 255 - (UINT8)Inputs->analogGunY[0]->LatestValue(); // why are values inverted? is this the wrong place to fix this
+        adc[2] =       (UINT8)Inputs->analogGunX[1]->LatestValue();
+        adc[3] = 255 - (UINT8)Inputs->analogGunY[1]->LatestValue();
       }
     }
     
     if ((m_game.inputs & Game::INPUT_SKI))
     {
-      adc[0] = (UINT8)Inputs->skiY->value;
-      adc[1] = (UINT8)Inputs->skiX->value;
+      adc[0] = (UINT8)Inputs->skiY->LatestValue();
+      adc[1] = (UINT8)Inputs->skiX->LatestValue();
     }
 
     if ((m_game.inputs & Game::INPUT_MAGTRUCK))
     {
-      adc[0] = uint8_t(Inputs->magicalLever1->value);
-      adc[1] = uint8_t(Inputs->magicalLever2->value);
+      adc[0] = uint8_t(Inputs->magicalLever1->LatestValue());
+      adc[1] = uint8_t(Inputs->magicalLever2->LatestValue());
     }
       
     if ((m_game.inputs & Game::INPUT_FISHING))
     {
-      adc[0] = uint8_t(Inputs->fishingRodY->value);
-      adc[1] = uint8_t(Inputs->fishingRodX->value);
-      adc[3] = uint8_t(Inputs->fishingReel->value);
-      adc[5] = uint8_t(Inputs->fishingStickX->value);
-      adc[4] = uint8_t(Inputs->fishingStickY->value);
+      adc[0] = uint8_t(Inputs->fishingRodY->LatestValue());
+      adc[1] = uint8_t(Inputs->fishingRodX->LatestValue());
+      adc[3] = uint8_t(Inputs->fishingReel->LatestValue());
+      adc[5] = uint8_t(Inputs->fishingStickX->LatestValue());
+      adc[4] = uint8_t(Inputs->fishingStickY->LatestValue());
     }
 
     // Read out appropriate channel
@@ -611,7 +612,7 @@ void CModel3::WriteInputs(unsigned reg, UINT8 data)
 
   case 0x10:  // Drive board
     if (DriveBoard.IsAttached())
-      DriveBoard.Write(data);
+      DriveBoard.Write(data, GetMainBoardFramePos());
     if (NULL != Outputs) // TODO - check gameInputs
       Outputs->SetValue(OutputRawDrive, data);
     break;
@@ -643,31 +644,31 @@ void CModel3::WriteInputs(unsigned reg, UINT8 data)
         switch (gunReg)
         {
         case 0: // Player 1 gun Y (low 8 bits)
-          serialFIFO2 = Inputs->gunY[0]->value&0xFF;
+          serialFIFO2 = Inputs->gunY[0]->LatestValue()&0xFF;
           break;
         case 1: // Player 1 gun Y (high 2 bits)
-          serialFIFO2 = (Inputs->gunY[0]->value>>8)&3;
+          serialFIFO2 = (Inputs->gunY[0]->LatestValue()>>8)&3;
           break;
         case 2: // Player 1 gun X (low 8 bits)
-          serialFIFO2 = Inputs->gunX[0]->value&0xFF;
+          serialFIFO2 = Inputs->gunX[0]->LatestValue()&0xFF;
           break;
         case 3: // Player 1 gun X (high 2 bits)
-          serialFIFO2 = (Inputs->gunX[0]->value>>8)&3;
+          serialFIFO2 = (Inputs->gunX[0]->LatestValue()>>8)&3;
           break;
         case 4: // Player 2 gun Y (low 8 bits)
-          serialFIFO2 = Inputs->gunY[1]->value&0xFF;
+          serialFIFO2 = Inputs->gunY[1]->LatestValue()&0xFF;
           break;
         case 5: // Player 2 gun Y (high 2 bits)
-          serialFIFO2 = (Inputs->gunY[1]->value>>8)&3;
+          serialFIFO2 = (Inputs->gunY[1]->LatestValue()>>8)&3;
           break;
         case 6: // Player 2 gun X (low 8 bits)
-          serialFIFO2 = Inputs->gunX[1]->value&0xFF;
+          serialFIFO2 = Inputs->gunX[1]->LatestValue()&0xFF;
           break;
         case 7: // Player 2 gun X (high 2 bits)
-          serialFIFO2 = (Inputs->gunX[1]->value>>8)&3;
+          serialFIFO2 = (Inputs->gunX[1]->LatestValue()>>8)&3;
           break;
         case 8: // Off-screen indicator (bit 0 = player 1, bit 1 = player 2, set indicates off screen)
-          serialFIFO2 = (Inputs->trigger[1]->offscreenValue<<1)|Inputs->trigger[0]->offscreenValue;
+          serialFIFO2 = (Inputs->trigger[1]->LatestOffscreenValue()<<1)|Inputs->trigger[0]->LatestOffscreenValue();
           break;
         default:
           DebugLog("Unknown gun register: %X\n", gunReg);
@@ -894,6 +895,8 @@ void CModel3::WriteSystemRegister(unsigned reg, UINT8 data)
  */
 UINT8 CModel3::Read8(UINT32 addr)
 {
+  Util::PerfCounters::CountRead(addr);
+
   // RAM (most frequently accessed)
   if (addr<0x00800000)
     return ram[addr^3];
@@ -971,7 +974,7 @@ UINT8 CModel3::Read8(UINT32 addr)
     }
 #endif
 #ifdef NET_BOARD
-  if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_config["EmulateNet"].ValueAs<bool>()))) // check for Step 1.0
+  if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_emulateNet.Get()))) // check for Step 1.0
   {
     switch ((addr & 0x3ffff) >> 16)
     {
@@ -983,7 +986,7 @@ UINT8 CModel3::Read8(UINT32 addr)
       if (addr > 0xc00101ff)
       {
         printf("R8 ATTENTION OUT OF RANGE\n");
-        MessageBox(NULL, "Out of Range", NULL, MB_OK);
+        ErrorLog("Model 3: Out of Range");
       }
       printf("R8 ioreg @%x=%x\n", (addr & 0x1FF), netBuffer[0x10000 + ((addr & 0x1FF) / 2)]);
       return netBuffer[0x10000 + ((addr & 0x1FF) / 2)];
@@ -993,7 +996,7 @@ UINT8 CModel3::Read8(UINT32 addr)
       if (addr > 0xc002ffff)
       {
         printf("R8 ATTENTION OUT OF RANGE\n");
-        MessageBox(NULL, "Out of Range", NULL, MB_OK);
+        ErrorLog("Model 3: Out of Range");
       }
       //printf("R8 netram @%x=%x\n", (addr & 0x1FFFF), netRAM[addr & 0x1ffff]);
       return netRAM[((addr & 0x1FFFF) / 2)];
@@ -1003,7 +1006,7 @@ UINT8 CModel3::Read8(UINT32 addr)
     
     default:
       printf("R8 ATTENTION OUT OF RANGE\n");
-      MessageBox(NULL, "Out of Range", NULL, MB_OK);
+      ErrorLog("Model 3: Out of Range");
       break;
     }
   }
@@ -1027,6 +1030,8 @@ UINT8 CModel3::Read8(UINT32 addr)
 
 UINT16 CModel3::Read16(UINT32 addr)
 {
+  Util::PerfCounters::CountRead(addr);
+
   UINT16  data;
   
   if ((addr&1))
@@ -1129,7 +1134,7 @@ UINT16 CModel3::Read16(UINT32 addr)
   default:
 #ifdef NET_BOARD
     printf("CMODEL3 : unknown R16 : %x (%x)\n", addr, addr >> 24);
-    MessageBox(NULL, "CMODEL3 : Unknown R16", NULL, MB_OK);
+    ErrorLog("CModel3: Unknown R16");
 #endif
     break;
   }
@@ -1140,6 +1145,8 @@ UINT16 CModel3::Read16(UINT32 addr)
 
 UINT32 CModel3::Read32(UINT32 addr)
 {
+  Util::PerfCounters::CountRead(addr);
+
   UINT32  data;
 
   if ((addr&3))
@@ -1274,7 +1281,7 @@ UINT32 CModel3::Read32(UINT32 addr)
       break;
 #endif
 #ifdef NET_BOARD
-    if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_config["EmulateNet"].ValueAs<bool>()))) // check for Step 1.0
+    if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_emulateNet.Get()))) // check for Step 1.0
     {
       UINT32 result;
       
@@ -1367,6 +1374,8 @@ UINT64 CModel3::Read64(UINT32 addr)
  */
 void CModel3::Write8(UINT32 addr, UINT8 data)
 {
+  Util::PerfCounters::CountWrite(addr);
+
   // RAM (most frequently accessed)
   if (addr < 0x00800000)
   {
@@ -1450,7 +1459,7 @@ void CModel3::Write8(UINT32 addr, UINT8 data)
       goto Unknown8;
 #endif
 #ifdef NET_BOARD
-    if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_config["EmulateNet"].ValueAs<bool>())))
+    if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_emulateNet.Get())))
     {
       //printf("CModel 3 : write8 %x<-%x\n", addr, data);
 
@@ -1495,7 +1504,7 @@ void CModel3::Write8(UINT32 addr, UINT8 data)
       {
         printf("Network code copy ending\n");
         NetBoard.CodeReady = true;
-        NetBoard.Reset();
+        NetBoard.RequestReset();
       }
 
       break;
@@ -1520,6 +1529,8 @@ void CModel3::Write8(UINT32 addr, UINT8 data)
 
 void CModel3::Write16(UINT32 addr, UINT16 data)
 {
+  Util::PerfCounters::CountWrite(addr);
+
   if ((addr&1))
   {
     Write8(addr+0,data>>8);
@@ -1614,6 +1625,8 @@ void CModel3::Write16(UINT32 addr, UINT16 data)
 
 void CModel3::Write32(UINT32 addr, UINT32 data)
 {
+  Util::PerfCounters::CountWrite(addr);
+
   if ((addr&3))
   {
     Write16(addr+0,data>>16);
@@ -1792,7 +1805,7 @@ void CModel3::Write32(UINT32 addr, UINT32 data)
       goto Unknown32;
 #endif
 #ifdef NET_BOARD
-    if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_config["EmulateNet"].ValueAs<bool>()))) // assuming there is no scsi card for step>1.0 because same address for network card (right or wrong ??)
+    if (m_game.stepping != "1.0" && (NetBoard.IsAttached() && (m_emulateNet.Get()))) // assuming there is no scsi card for step>1.0 because same address for network card (right or wrong ??)
     {
       switch ((addr & 0x3ffff) >> 16)
       {
@@ -1835,14 +1848,14 @@ void CModel3::Write32(UINT32 addr, UINT32 data)
       {
         printf("Network pause\n");
         NetBoard.CodeReady = false;
-        NetBoard.Reset();
+        NetBoard.RequestReset();
       }
 
       if ((*(UINT16 *)&netBuffer[(0xc0010088 & 0x3FFFF)] == FLIPENDIAN16(0x0080)) && NetBoard.CodeReady == false) // 88=110/2
       {
         printf("Network code copy ending\n");
         NetBoard.CodeReady = true;
-        NetBoard.Reset();
+        NetBoard.RequestReset();
       }
 
       break;
@@ -1984,46 +1997,85 @@ void CModel3::ClearNVRAM(void)
 
 void CModel3::RunFrame(void)
 {
+  PROFILE_SCOPE("Frame");
   UINT32 start = CThread::GetTicks();
 
   // See if currently running multi-threaded
   if (m_multiThreaded)
   {
+    // While the PPC main board runs in its own thread, this thread polls game inputs periodically so that the game
+    // reads the latest input state rather than the state at the end of the previous frame
+    bool pollInputs = m_gpuMultiThreaded && m_inputPollInterval > 0 && Inputs != NULL;
+
     // If so, check all threads are up and running
     if (!StartThreads())
       goto ThreadError;
 
-    // Wake threads for PPC main board (if multi-threading GPU), sound board (if sync'd) and drive board (if attached) so they can process a frame
+    // Drive board must not run ahead of commands sent by PPC main board during this frame
+    if (DriveBoard.IsAttached())
+      DriveBoard.BeginFrame();
+
+#ifdef NET_BOARD
+    // Net board runs alongside the PPC main board, starting from the CommRAM contents and IRQ it was left at the end of the previous frame
+    runNetBrdThread = IsNetBoardActive();
+#endif
+
+    // Wake threads for PPC main board (if multi-threading GPU), sound board (if sync'd), drive board (if attached) and net board (if active) so they can process a frame
     if ((m_gpuMultiThreaded       && !ppcBrdThreadSync->Post()) || 
         (syncSndBrdThread         && !sndBrdThreadSync->Post()) || 
-        (DriveBoard.IsAttached()  && !drvBrdThreadSync->Post()))
+        (DriveBoard.IsAttached()  && !drvBrdThreadSync->Post()) ||
+        (runNetBrdThread          && !netBrdThreadSync->Post()))
       goto ThreadError;
 
     // If not multi-threading GPU, then run PPC main board for a frame and sync GPUs now in this thread
     if (!m_gpuMultiThreaded)
     {
       RunMainBoardFrame();
+#ifdef NET_BOARD
+      if (IsNetBoardActive())
+        SignalNetBoardIRQ();
+#endif
       SyncGPUs();
     }
 
     // Render frame
+    if (pollInputs)
+      Inputs->PollMidFrame();
     RenderFrame();
 
     // Enter notify wait critical section
     if (!notifyLock->Lock())
       goto ThreadError;
 
-    // Wait for PPC main board, sound board and drive board threads to finish their work (if they are running and haven't finished already)
+    // Wait for PPC main board, sound board, drive board and net board threads to finish their work (if they are running and haven't finished already)
     while ((m_gpuMultiThreaded      && !ppcBrdThreadDone) || 
            (syncSndBrdThread        && !sndBrdThreadDone) || 
-           (DriveBoard.IsAttached() && !drvBrdThreadDone))
+           (DriveBoard.IsAttached() && !drvBrdThreadDone) ||
+           (runNetBrdThread         && !netBrdThreadDone))
     {
-      if (!notifySync->Wait(notifyLock))
+      if (pollInputs)
+      {
+        // Poll inputs outside of critical section each time the wait times out
+        bool timedOut;
+        if (!notifySync->Wait(notifyLock, m_inputPollInterval, &timedOut))
+          goto ThreadError;
+        if (timedOut)
+        {
+          if (!notifyLock->Unlock())
+            goto ThreadError;
+          Inputs->PollMidFrame();
+          if (!notifyLock->Lock())
+            goto ThreadError;
+        }
+      }
+      else if (!notifySync->Wait(notifyLock))
         goto ThreadError;
     }
     ppcBrdThreadDone = false;
     sndBrdThreadDone = false;
     drvBrdThreadDone = false;
+    netBrdThreadDone = false;
+    runNetBrdThread = false;
 
     // Leave notify wait critical section
     if (!notifyLock->Unlock())
@@ -2032,13 +2084,12 @@ void CModel3::RunFrame(void)
     // If multi-threading GPU, then sync GPUs last while PPC main board thread is waiting
     if (m_gpuMultiThreaded)
       SyncGPUs();
-
-    /*if (NetBoard.IsAttached())
-      RunNetBoardFrame();*/
   }
   else
   {
     // If not multi-threaded, then just process and render a single frame for PPC main board, sound board and drive board in turn in this thread
+    if (DriveBoard.IsAttached())
+      DriveBoard.BeginFrame();
     RunMainBoardFrame();
     SyncGPUs();
     RenderFrame();
@@ -2046,15 +2097,9 @@ void CModel3::RunFrame(void)
     if (DriveBoard.IsAttached())
       RunDriveBoardFrame();
 #ifdef NET_BOARD
-    if (NetBoard.IsAttached() && (m_config["EmulateNet"].ValueAs<bool>()) && ((*(UINT16 *)&netBuffer[(0xc00100C0 & 0x3FFFF)] == 0xFFFF) || (netBuffer[(0xc00100C0 & 0x3FFFF)] == 0xFF) || (*(UINT16 *)&netBuffer[(0xc00100C0 & 0x3FFFF)] == 0x0001)) && (NetBoard.CodeReady == true))
+    if (IsNetBoardActive())
     {
-      // ppc irq network needed ? no effect, is it really active/needed ? 
-      //RunNetBoardFrame();
-      IRQ.Assert(0x10);
-      ppc_execute(200); // give PowerPC time to acknowledge IRQ
-      //RunNetBoardFrame();
-      IRQ.Deassert(0x10);
-      ppc_execute(200); // acknowledge that IRQ was deasserted (TODO: is this really needed?)
+      SignalNetBoardIRQ();
       RunNetBoardFrame();
       // Hum hum, if runnetboardframe is called at 1st place or between ppc irq assert/deassert, spikout freezes just after the gate with net error
       // if runnetboardframe is called after ppc irq assert/deassert, spikout works
@@ -2073,16 +2118,20 @@ ThreadError:
 
 void CModel3::RunMainBoardFrame(void)
 {
+	PROFILE_SCOPE("PPC main board");
 	UINT32 start = CThread::GetTicks();
 
 	// Compute display and VBlank timings
-	unsigned ppcCycles		= m_config["PowerPCFrequency"].ValueAs<unsigned>() * 1000000;
+	unsigned ppcCycles		= m_ppcFrequency.Get() * 1000000;
 	unsigned frameCycles	= ppcCycles / 60;
 	unsigned gapCycles		= (unsigned)((float)frameCycles * 2.5f / 100.0f);	// we need a gap between asserting irq2 & irq 0x40
 	unsigned offsetCycles = (unsigned)((float)frameCycles * 33.f / 100.0f);
 	unsigned dispCycles		= frameCycles - gapCycles - offsetCycles;
 	unsigned statusCycles = (unsigned)((float)frameCycles * (0.005f));
 
+	ppcFrameStart = ppc_total_cycles();
+	ppcFrameCycles = frameCycles;
+
 	// we think a frame looks like this on the model 2
 	//                         66% of frame
 	// [irq2------------------ping_pong_flips------]
@@ -2105,8 +2154,12 @@ void CModel3::RunMainBoardFrame(void)
 		GPU.BeginVBlank(statusCycles);	// Games poll the ping_pong at startup. Values aren't 100% accurate so we stretch the frame a bit to ensure writes happen in the correct frame
 
 		ppc_execute(offsetCycles);
+		if (DriveBoard.IsAttached())
+			DriveBoard.SetMainBoardProgress(GetMainBoardFramePos());
 		IRQ.Assert(0x02);								// start at 33% of the frame
 		ppc_execute(gapCycles);					// need a gap between asserting irqs
+		if (DriveBoard.IsAttached())
+			DriveBoard.SetMainBoardProgress(GetMainBoardFramePos());
 
 		/*
 		* Sound:
@@ -2142,30 +2195,60 @@ void CModel3::RunMainBoardFrame(void)
 		}
 
 		IRQ.Assert(0x0D);
+		if (DriveBoard.IsAttached())
+			DriveBoard.SetMainBoardProgress(GetMainBoardFramePos());
 
 		// End VBlank
 		GPU.EndVBlank();
 		TileGen.EndVBlank();
 	}
 
-	// Run the PowerPC for the active display part of the frame
-	ppc_execute(dispCycles);
+	// Run the PowerPC for the active display part of the frame.  With a drive board attached, this is done in slices so
+	// that a drive board running on its own thread can follow the main board through the frame rather than stalling
+	// until the end of it.
+	if (DriveBoard.IsAttached())
+	{
+		const unsigned numSlices = 8;
+		for (unsigned i = 0; i < numSlices; i++)
+		{
+			ppc_execute(dispCycles / numSlices + (i == 0 ? dispCycles % numSlices : 0));
+			DriveBoard.SetMainBoardProgress(GetMainBoardFramePos());
+		}
+	}
+	else
+		ppc_execute(dispCycles);
+
+	// Let drive board run to end of frame
+	if (DriveBoard.IsAttached())
+		DriveBoard.SetMainBoardProgress(1.0f);
+
+	Util::PerfCounters::Add(Util::PerfCounters::PPCInstructions, ppc_total_cycles() - ppcFrameStart);
 
 	timings.ppcTicks = CThread::GetTicks() - start;
 }
 
+float CModel3::GetMainBoardFramePos(void)
+{
+	if (ppcFrameCycles == 0)
+		return 0.0f;
+	return (float)(ppc_total_cycles() - ppcFrameStart) / (float)ppcFrameCycles;
+}
+
 void CModel3::SyncGPUs(void)
 {
+  PROFILE_SCOPE("Sync GPUs");
   UINT32 start = CThread::GetTicks();
 
   timings.syncSize = GPU.SyncSnapshots() + TileGen.SyncSnapshots();
   gpusReady = true;
+  Util::PerfCounters::Add(Util::PerfCounters::SnapshotBytes, timings.syncSize);
 
   timings.syncTicks = CThread::GetTicks() - start;
 }
 
 void CModel3::RenderFrame(void)
 {
+  PROFILE_SCOPE("Render");
   UINT32 start = CThread::GetTicks();
 
   // Call OSD video callbacks
@@ -2189,6 +2272,7 @@ void CModel3::RenderFrame(void)
 
 bool CModel3::RunSoundBoardFrame(void)
 {
+  PROFILE_SCOPE("Sound board");
   UINT32 start = CThread::GetTicks();
   bool bufferFull = SoundBoard.RunFrame();
   timings.sndTicks = CThread::GetTicks() - start;
@@ -2197,6 +2281,7 @@ bool CModel3::RunSoundBoardFrame(void)
 
 void CModel3::RunDriveBoardFrame(void)
 {
+  PROFILE_SCOPE("Drive board");
   UINT32 start = CThread::GetTicks();
   DriveBoard.RunFrame();
   timings.drvTicks = CThread::GetTicks() - start;
@@ -2205,7 +2290,24 @@ void CModel3::RunDriveBoardFrame(void)
 #ifdef NET_BOARD
 void CModel3::RunNetBoardFrame(void)
 {
+  PROFILE_SCOPE("Net board");
+  UINT32 start = CThread::GetTicks();
   NetBoard.RunFrame();
+  timings.netTicks = CThread::GetTicks() - start;
+}
+
+bool CModel3::IsNetBoardActive(void)
+{
+  return NetBoard.IsAttached() && (m_emulateNet.Get()) && ((*(UINT16 *)&netBuffer[(0xc00100C0 & 0x3FFFF)] == 0xFFFF) || (netBuffer[(0xc00100C0 & 0x3FFFF)] == 0xFF) || (*(UINT16 *)&netBuffer[(0xc00100C0 & 0x3FFFF)] == 0x0001)) && (NetBoard.CodeReady == true);
+}
+
+void CModel3::SignalNetBoardIRQ(void)
+{
+  // ppc irq network needed ? no effect, is it really active/needed ? 
+  IRQ.Assert(0x10);
+  ppc_execute(200); // give PowerPC time to acknowledge IRQ
+  IRQ.Deassert(0x10);
+  ppc_execute(200); // acknowledge that IRQ was deasserted (TODO: is this really needed?)
 }
 #endif
 
@@ -2236,6 +2338,14 @@ bool CModel3::StartThreads(void)
     if (drvBrdThreadSync == NULL)
       goto ThreadError;
   }
+#ifdef NET_BOARD
+  if (NetBoard.IsAttached())
+  {
+    netBrdThreadSync = CThread::CreateSemaphore(0);
+    if (netBrdThreadSync == NULL)
+      goto ThreadError;
+  }
+#endif
   notifyLock = CThread::CreateMutex();
   if (notifyLock == NULL)
     goto ThreadError;
@@ -2271,6 +2381,16 @@ bool CModel3::StartThreads(void)
       goto ThreadError;
   }
 
+#ifdef NET_BOARD
+  // Create net board thread, if net board is attached
+  if (NetBoard.IsAttached())
+  {
+    netBrdThread = CThread::CreateThread("NetBoard", StartNetBoardThread, this);
+    if (netBrdThread == NULL)
+      goto ThreadError;
+  }
+#endif
+
   // Set audio callback if sound board thread is unsync'd
   if (!syncSndBrdThread)
   {
@@ -2298,7 +2418,7 @@ bool CModel3::PauseThreads(void)
 
   // Let threads know that they should pause and wait for all of them to do so
   pauseThreads = true;
-  while (ppcBrdThreadRunning || sndBrdThreadRunning || drvBrdThreadRunning)
+  while (ppcBrdThreadRunning || sndBrdThreadRunning || drvBrdThreadRunning || netBrdThreadRunning)
   {
     if (!notifySync->Wait(notifyLock))
       goto ThreadError;
@@ -2353,7 +2473,7 @@ bool CModel3::StopThreads(void)
 
   // Let threads know that they should pause and wait for all of them to do so
   pauseThreads = true;
-  while (ppcBrdThreadRunning || sndBrdThreadRunning || drvBrdThreadRunning)
+  while (ppcBrdThreadRunning || sndBrdThreadRunning || drvBrdThreadRunning || netBrdThreadRunning)
   {
     if (!notifySync->Wait(notifyLock))
       goto ThreadError;
@@ -2390,6 +2510,11 @@ bool CModel3::StopThreads(void)
     if (drvBrdThreadSync->Post())
       drvBrdThread->Wait();
   }
+  if (netBrdThread != NULL)
+  {
+    if (netBrdThreadSync->Post())
+      netBrdThread->Wait();
+  }
 
   // Delete all thread and synchronization objects
   DeleteThreadObjects();
@@ -2404,7 +2529,7 @@ ThreadError:
 
 void CModel3::DeleteThreadObjects(void)
 {
-  // Delete PPC main board, sound board and drive board threads
+  // Delete PPC main board, sound board, drive board and net board threads
   if (ppcBrdThread != NULL)
   {
     delete ppcBrdThread;
@@ -2420,6 +2545,11 @@ void CModel3::DeleteThreadObjects(void)
     delete drvBrdThread;
     drvBrdThread = NULL;
   }
+  if (netBrdThread != NULL)
+  {
+    delete netBrdThread;
+    netBrdThread = NULL;
+  }
 
 
   // Delete synchronization objects
@@ -2438,6 +2568,11 @@ void CModel3::DeleteThreadObjects(void)
     delete drvBrdThreadSync;
     drvBrdThreadSync = NULL;
   }
+  if (netBrdThreadSync != NULL)
+  {
+    delete netBrdThreadSync;
+    netBrdThreadSync = NULL;
+  }
 
 
   if (sndBrdNotifyLock != NULL)
@@ -2509,9 +2644,19 @@ int CModel3::StartDriveBoardThread(void *data)
   CModel3 *model3 = (CModel3*)data;
   return model3->RunDriveBoardThread();
 }
+
+#ifdef NET_BOARD
+int CModel3::StartNetBoardThread(void *data)
+{
+  // Call method on CModel3 to run net board thread
+  CModel3 *model3 = (CModel3*)data;
+  return model3->RunNetBoardThread();
+}
+#endif
 
 int CModel3::RunMainBoardThread(void)
 {
+  PROFILE_THREAD("PPC main board");
   for (;;)
   {
     bool wait = true;
@@ -2544,6 +2689,10 @@ int CModel3::RunMainBoardThread(void)
 
     // Process a single frame for PPC main board
     RunMainBoardFrame();
+#ifdef NET_BOARD
+    if (IsNetBoardActive())
+      SignalNetBoardIRQ();
+#endif
 
     // Enter notify critical section
     if (!notifyLock->Lock())
@@ -2613,6 +2762,7 @@ ThreadError:
 
 int CModel3::RunSoundBoardThread(void)
 {
+  PROFILE_THREAD("Sound board");
   for (;;)
   {
     bool wait = true;
@@ -2697,6 +2847,7 @@ ThreadError:
 
 int CModel3::RunSoundBoardThreadSyncd(void)
 {
+  PROFILE_THREAD("Sound board");
   for (;;)
   {
     bool wait = true;
@@ -2753,6 +2904,7 @@ ThreadError:
 
 int CModel3::RunDriveBoardThread(void)
 {
+  PROFILE_THREAD("Drive board");
   for (;;)
   {
     bool wait = true; 
@@ -2806,6 +2958,65 @@ ThreadError:
   m_multiThreaded = false;
   return 1;
 }
+
+#ifdef NET_BOARD
+int CModel3::RunNetBoardThread(void)
+{
+  PROFILE_THREAD("Net board");
+  for (;;)
+  {
+    bool wait = true; 
+    bool exit = false;
+    while (wait && !exit)
+    {
+      // Wait on net board thread semaphore
+      if (!netBrdThreadSync->Wait())
+        goto ThreadError;
+
+      // Enter notify critical section
+      if (!notifyLock->Lock())
+        goto ThreadError;
+
+      // Check threads are not being stopped or paused
+      if (stopThreads)
+        exit = true;
+      else if (!pauseThreads)
+      {
+        wait = false;
+        netBrdThreadRunning = true;
+      }
+  
+      // Leave notify critical section
+      if (!notifyLock->Unlock())
+        goto ThreadError;
+    }
+    if (exit)
+      return 0;
+
+    // Process a single frame for net board
+    RunNetBoardFrame();
+
+    // Enter notify critical section
+    if (!notifyLock->Lock())
+      goto ThreadError;
+
+    // Let other threads know processing has finished
+    netBrdThreadRunning = false;
+    netBrdThreadDone = true;
+    if (!notifySync->SignalAll())
+      goto ThreadError;
+
+    // Leave notify critical section
+    if (!notifyLock->Unlock())
+      goto ThreadError;
+  }
+
+ThreadError:
+  ErrorLog("Threading error in RunNetBoardThread: %s\nSwitching back to single-threaded mode.\n", CThread::GetLastError());
+  m_multiThreaded = false;
+  return 1;
+}
+#endif
 
 void CModel3::Reset(void)
 {
@@ -2817,6 +3028,8 @@ void CModel3::Reset(void)
   
   // Reset security device
   securityPtr = 0;
+  ppcFrameStart = 0;
+  ppcFrameCycles = 0;
   m_securityFirstRead = true;
   
   // Reset inputs
@@ -2884,11 +3097,25 @@ void CModel3::Reset(void)
 #define MEMORY_POOL_SIZE    (0x800000 + 0x800000 + 0x8000000 + 0x4000000 + 0x20000 + 0x20000 + 0x80000 + 0x1000000 + 0x20000 + 0x1000000 + 0x10000)
 #endif
 #ifdef NET_BOARD
-#define OFFSET_NETBUFFER    0xC000000 // not really 128kb (64kb buffer 0000-ffff + i/o 10000-101ff)
-#define OFFSET_NETRAM       0xC020000 // 128 KB (c0020000-c003ffff)
+#define OFFSET_NETBUFFER    0xF0F0000 // not really 128kb (64kb buffer 0000-ffff + i/o 10000-101ff)
+#define OFFSET_NETRAM       0xF110000 // 128 KB (c0020000-c003ffff)
 #define MEMORY_POOL_SIZE    (0x800000 + 0x800000 + 0x8000000 + 0x4000000 + 0x20000 + 0x20000 + 0x80000 + 0x1000000 + 0x20000 + 0x1000000 + 0x10000 + 0x40000)
 							//8MB		8MB			128MB		64MB		128KB		128KB	512KB		16MB		128KB	16MB		64KB		256KB
+static_assert(OFFSET_NETBUFFER >= OFFSET_DRIVEROM + 0x10000 && OFFSET_NETRAM + 0x20000 <= MEMORY_POOL_SIZE, "Net board regions must follow drive board ROM");
 #endif
+// High halves of banked CROM, VROM, and sample ROM may be mapped onto their low halves (see CopyROMs()), so nothing else
+// may be placed inside those regions
+static_assert(OFFSET_CROMxx + 0x8000000 <= OFFSET_VROM, "Banked CROM overlaps VROM");
+static_assert(OFFSET_VROM + 0x4000000 <= OFFSET_BACKUPRAM, "VROM overlaps backup RAM");
+static_assert(OFFSET_SAMPLEROM + 0x1000000 <= OFFSET_DSBPROGROM, "Sample ROM overlaps DSB program ROM");
+static_assert(OFFSET_DRIVEROM + 0x10000 <= MEMORY_POOL_SIZE, "Memory pool too small");
+// Parts of the pool holding ROM images, which are stored in the ROM cache
+static const std::vector<ROMCache::Segment> s_romCacheSegments =
+{
+  { OFFSET_CROM,    OFFSET_BACKUPRAM - OFFSET_CROM },               // CROM and VROM
+  { OFFSET_SOUNDROM, OFFSET_DRIVEROM + 0x10000 - OFFSET_SOUNDROM }  // sound, DSB, and drive board ROMs
+};
+
 // 64-bit magic number used to detect loading of optional ROMs
 #define MAGIC_NUMBER  0x4C444D5245505553ULL
 
@@ -2896,12 +3123,14 @@ const Game &CModel3::GetGame() const
 {
   return m_game;
 }
+
+bool CModel3::IsROMCacheValid(const Game &game, const ROMSet &rom_set)
+{
+  return ROMCache::IsValid(ROMCache::GetFilePath(game.name), rom_set.fingerprint, s_romCacheSegments);
+}
   
-// Stepping-dependent parameters (MPC10x type, etc.) are initialized here
-bool CModel3::LoadGame(const Game &game, const ROMSet &rom_set)
+void CModel3::CopyROMs(const Game &game, const ROMSet &rom_set)
 {
-  m_game = Game();
- 
   /*
    * Copy in ROM data with mirroring as necessary for the following cases:
    *
@@ -2910,18 +3139,27 @@ bool CModel3::LoadGame(const Game &game, const ROMSet &rom_set)
    *  - Fixed CROM: 8MB. If < 8MB, loaded only in high part of space and low
    *    part is a mirror of (banked) CROM0.
    *  - Sample ROM: 16MB. If <= 8MB, mirror to high 8MB.
+   *
+   * Where the memory pool supports it, the high halves are mapped onto the
+   * same physical pages as the low halves rather than being copied.
    */
+  bool vromMirrored = false;
   if (rom_set.get_rom("vrom").size <= 32*0x100000)
   {
-    rom_set.get_rom("vrom").CopyTo(&vrom[0], 32*100000);
-    rom_set.get_rom("vrom").CopyTo(&vrom[32*0x100000], 32*0x100000);
+    vromMirrored = OKAY == m_memoryPool.Mirror(OFFSET_VROM + 32*0x100000, OFFSET_VROM, 32*0x100000);
+    rom_set.get_rom("vrom").CopyTo(&vrom[0], 32*0x100000);
+    if (!vromMirrored)
+      rom_set.get_rom("vrom").CopyTo(&vrom[32*0x100000], 32*0x100000);
   }
   else
     rom_set.get_rom("vrom").CopyTo(vrom, 64*0x100000);
+  bool bankedCROMMirrored = false;
   if (rom_set.get_rom("banked_crom").size <= 64*0x100000)
   {
+    bankedCROMMirrored = OKAY == m_memoryPool.Mirror(OFFSET_CROMxx + 64*0x100000, OFFSET_CROMxx, 64*0x100000);
     rom_set.get_rom("banked_crom").CopyTo(&crom[8*0x100000 + 0], 64*0x100000);
-    rom_set.get_rom("banked_crom").CopyTo(&crom[8*0x100000 + 64*0x100000], 64*0x100000);
+    if (!bankedCROMMirrored)
+      rom_set.get_rom("banked_crom").CopyTo(&crom[8*0x100000 + 64*0x100000], 64*0x100000);
   }
   else
     rom_set.get_rom("banked_crom").CopyTo(&crom[8*0x100000 + 0], 128*0x100000);
@@ -2929,22 +3167,55 @@ bool CModel3::LoadGame(const Game &game, const ROMSet &rom_set)
   rom_set.get_rom("crom").CopyTo(&crom[8*0x100000 - crom_size], crom_size);
   if (crom_size < 8*0x100000)
     rom_set.get_rom("banked_crom").CopyTo(&crom[0], 8*0x100000 - crom_size);
+  bool samplesMirrored = false;
   if (rom_set.get_rom("sound_samples").size <= 8*0x100000)
   {
+    samplesMirrored = OKAY == m_memoryPool.Mirror(OFFSET_SAMPLEROM + 8*0x100000, OFFSET_SAMPLEROM, 8*0x100000);
     rom_set.get_rom("sound_samples").CopyTo(&sampleROM[0], 8*0x100000);
-    rom_set.get_rom("sound_samples").CopyTo(&sampleROM[8*0x100000], 8*0x100000);
+    if (!samplesMirrored)
+      rom_set.get_rom("sound_samples").CopyTo(&sampleROM[8*0x100000], 8*0x100000);
   }
   else
     rom_set.get_rom("sound_samples").CopyTo(sampleROM, 16*0x100000);
+  if (vromMirrored || bankedCROMMirrored || samplesMirrored)
+    DebugLog("Mirrored ROM regions:%s%s%s\n", vromMirrored ? " VROM" : "", bankedCROMMirrored ? " CROM" : "", samplesMirrored ? " samples" : "");
   rom_set.get_rom("sound_program").CopyTo(soundROM, 512*1024);
   rom_set.get_rom("mpeg_program").CopyTo(dsbROM, 128*1024);
   rom_set.get_rom("mpeg_music").CopyTo(mpegROM, 16*0x100000);
   rom_set.get_rom("driveboard_program").CopyTo(driveROM, 64*1024);
 
-  // Convert PowerPC and 68K ROMs to little endian words 
-  Util::FlipEndian32(crom, 8*0x100000 + 128*0x100000);
+  // Convert PowerPC and 68K ROMs to little endian words (mirrors only once)
+  Util::FlipEndian32(crom, 8*0x100000 + (bankedCROMMirrored ? 64 : 128)*0x100000);
   Util::FlipEndian16(soundROM, 512*1024);
-  Util::FlipEndian16(sampleROM, 16*0x100000);
+  Util::FlipEndian16(sampleROM, (samplesMirrored ? 8 : 16)*0x100000);
+  if (rom_set.get_rom("mpeg_program").size && game.mpeg_board == "DSB2")
+    Util::FlipEndian16(dsbROM, 128*1024); // 68K program needs to be byte swapped
+}
+
+// Stepping-dependent parameters (MPC10x type, etc.) are initialized here
+bool CModel3::LoadGame(const Game &game, const ROMSet &rom_set)
+{
+  m_game = Game();
+
+  // Map in the pre-processed ROM images if they are cached
+  std::string romCachePath = ROMCache::GetFilePath(game.name);
+  bool useROMCache = m_config["ROMCache"].ValueAs<bool>();
+  bool romsCached = false;
+  if (useROMCache || !rom_set.data_loaded)
+  {
+    romsCached = OKAY == ROMCache::Load(memoryPool, romCachePath, rom_set.fingerprint, s_romCacheSegments);
+    if (romsCached)
+      InfoLog("Loaded ROM images from '%s'.", romCachePath.c_str());
+    else if (!rom_set.data_loaded)
+      return ErrorLog("Unable to load ROM images from '%s'.", romCachePath.c_str());
+  }
+  if (!romsCached)
+    CopyROMs(game, rom_set);
+  if (useROMCache && !romsCached)
+  {
+    if (OKAY == ROMCache::Save(romCachePath, rom_set.fingerprint, memoryPool, s_romCacheSegments))
+      InfoLog("Created ROM cache '%s'.", romCachePath.c_str());
+  }
 
   // Configure CPU and PCI bridge
   PPC_CONFIG  ppc_config;
@@ -3019,7 +3290,6 @@ bool CModel3::LoadGame(const Game &game, const ROMSet &rom_set)
     }
     else if (game.mpeg_board == "DSB2")
     {
-      Util::FlipEndian16(dsbROM, 128*1024); // 68K program needs to be byte swapped
       DSB = new(std::nothrow) CDSB2(m_config);
       if (NULL == DSB)
         return ErrorLog("Insufficient memory for Digital Sound Board object."); 
@@ -3105,11 +3375,13 @@ bool CModel3::Init(void)
 {
   float memSizeMB = (float)MEMORY_POOL_SIZE/(float)0x100000;
   
-  // Allocate all memory for ROMs and PPC RAM
-  memoryPool = new(std::nothrow) UINT8[MEMORY_POOL_SIZE];
-  if (NULL == memoryPool)
+  // Allocate all memory for ROMs and PPC RAM. The pool is zeroed and pages
+  // only take up physical memory once touched.
+  if (m_memoryPool.Allocate(MEMORY_POOL_SIZE))
     return ErrorLog("Insufficient memory for Model 3 object (needs %1.1f MB).", memSizeMB);
-  memset(memoryPool, 0, MEMORY_POOL_SIZE);
+  memoryPool = m_memoryPool.GetBase();
+  if (m_config["HugePages"].ValueAs<bool>())
+    m_memoryPool.AdviseHugePages(OFFSET_RAM, OFFSET_VROM - OFFSET_RAM);  // PPC RAM and CROM see the most accesses
     
   // Set up pointers
   ram = &memoryPool[OFFSET_RAM];
@@ -3177,6 +3449,9 @@ CModel3::CModel3(const Util::Config::Node &config)
   : m_config(config),
     m_multiThreaded(config["MultiThreaded"].ValueAs<bool>()),
     m_gpuMultiThreaded(config["GPUMultiThreaded"].ValueAs<bool>()),
+    m_inputPollInterval(config["InputPollInterval"].ValueAs<unsigned>()),
+    m_ppcFrequency(config["PowerPCFrequency"]),
+    m_emulateNet(config["EmulateNet"]),
     TileGen(config),
     GPU(config),
     SoundBoard(config),
@@ -3217,6 +3492,7 @@ CModel3::CModel3(const Util::Config::Node &config)
   ppcBrdThread = NULL;
   sndBrdThread = NULL; 
   drvBrdThread = NULL;
+  netBrdThread = NULL;
 
   ppcBrdThreadRunning = false;
   ppcBrdThreadDone = false;
@@ -3224,11 +3500,15 @@ CModel3::CModel3(const Util::Config::Node &config)
   sndBrdThreadDone = false;
   drvBrdThreadRunning = false;
   drvBrdThreadDone = false;
+  runNetBrdThread = false;
+  netBrdThreadRunning = false;
+  netBrdThreadDone = false;
 
-  syncSndBrdThread = false;
+  syncSndBrdThread = !config["AudioPullMode"].ValueAs<bool>();
   ppcBrdThreadSync = NULL;
   sndBrdThreadSync = NULL;
   drvBrdThreadSync = NULL;
+  netBrdThreadSync = NULL;
 
   notifyLock = NULL;
   notifySync = NULL;
@@ -3270,11 +3550,8 @@ CModel3::~CModel3(void)
   StopThreads();
   
   // Free memory
-  if (memoryPool != NULL)
-  {
-    delete [] memoryPool;
-    memoryPool = NULL;
-  }
+  m_memoryPool.Free();
+  memoryPool = NULL;
   
   if (DSB != NULL)
   {
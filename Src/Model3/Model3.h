@@ -32,6 +32,7 @@
 #include "Model3/JTAG.h"
 #include "Model3/Crypto.h"
 #include "Util/NewConfig.h"
+#include "Util/MemoryPool.h"
 
 /*
  * FrameTimings
@@ -101,7 +102,10 @@ public:
    * LoadGame(game, rom_set):
    *
    * Loads a game, copying in the provided ROMs and setting the hardware
-   * stepping.
+   * stepping. If ROM data was not loaded (rom_set.data_loaded is false) or
+   * the ROMCache option is set, the ROM images are taken from the game's ROM
+   * cache when it is valid. Otherwise, with ROMCache set, the cache is
+   * (re)built from the processed ROMs.
    *
    * Parameters:
    *    game      Game information.
@@ -112,6 +116,21 @@ public:
    */
   bool LoadGame(const Game &game, const ROMSet &rom_set);
 
+  /*
+   * IsROMCacheValid(game, rom_set):
+   *
+   * Checks whether a ROM cache exists for the given ROM set, in which case
+   * LoadGame() does not need the ROM data itself.
+   *
+   * Parameters:
+   *    game      Game information.
+   *    rom_set   ROM set (only the fingerprint is required).
+   *
+   * Returns:
+   *    True if the cache can be used.
+   */
+  static bool IsROMCacheValid(const Game &game, const ROMSet &rom_set);
+
   /*
    * GetSoundBoard(void):
    * 
@@ -188,13 +207,17 @@ private:
   void      SetCROMBank(unsigned idx);
   UINT8     ReadSystemRegister(unsigned reg);
   void      WriteSystemRegister(unsigned reg, UINT8 data);
+  void      CopyROMs(const Game &game, const ROMSet &rom_set);
 
   void RunMainBoardFrame(void);                       // Runs PPC main board for a frame
+  float GetMainBoardFramePos(void);                   // Returns how far PPC main board is through current frame (0.0 to 1.0)
   void SyncGPUs(void);                                // Sync's up GPUs in preparation for rendering - must be called when PPC is not running
   bool RunSoundBoardFrame(void);                      // Runs sound board for a frame
   void RunDriveBoardFrame(void);                      // Runs drive board for a frame
 #ifdef NET_BOARD
   void RunNetBoardFrame(void);						  // Runs net board for a frame
+  bool IsNetBoardActive(void);                        // True once the main board has loaded and started the net board program
+  void SignalNetBoardIRQ(void);                       // Lets the PPC main board service the net board IRQ at the end of its frame
 #endif
 
   bool    StartThreads(void);                         // Starts all threads
@@ -205,6 +228,9 @@ private:
   static int StartSoundBoardThread(void *data);       // Callback to start sound board thread (unsync'd)
   static int StartSoundBoardThreadSyncd(void *data);  // Callback to start sound board thread (sync'd)
   static int StartDriveBoardThread(void *data);       // Callback to start drive board thread
+#ifdef NET_BOARD
+  static int StartNetBoardThread(void *data);         // Callback to start net board thread
+#endif
 
   static void AudioCallback(void *data);              // Audio buffer callback
   
@@ -213,11 +239,17 @@ private:
   int     RunSoundBoardThread(void);                  // Runs sound board thread (not sync'd in step with render thread, ie running at full speed)
   int     RunSoundBoardThreadSyncd(void);             // Runs sound board thread (sync'd in step with render thread)
   int     RunDriveBoardThread(void);                  // Runs drive board thread (sync'd in step with render thread)
+#ifdef NET_BOARD
+  int     RunNetBoardThread(void);                    // Runs net board thread (sync'd in step with render thread)
+#endif
 
   // Runtime configuration
   const Util::Config::Node &m_config;
   bool m_multiThreaded;
   bool m_gpuMultiThreaded;
+  unsigned m_inputPollInterval;                   // milliseconds between input polls while waiting for a frame (0 disables)
+  Util::Config::Handle<unsigned> m_ppcFrequency;  // settings read every frame
+  Util::Config::Handle<bool> m_emulateNet;
 
   // Game and hardware information
   Game m_game;
@@ -236,7 +268,8 @@ private:
   UINT8   midiCtrlPort; // controls MIDI (SCSP) IRQ behavior
   
   // Emulated core Model 3 memory regions
-  UINT8   *memoryPool;  // single allocated region for all ROM and system RAM
+  Util::MemoryPool m_memoryPool;  // single allocated region for all ROM and system RAM
+  UINT8   *memoryPool;            // base of m_memoryPool
   UINT8   *ram;         // 8 MB PowerPC RAM
   UINT8   *crom;        // 8+128 MB CROM (fixed CROM first, then 64MB of banked CROMs -- Daytona2 might need extra?)
   UINT8   *vrom;        // 64 MB VROM (video ROM, visible only to Real3D)
@@ -263,6 +296,8 @@ private:
   
   // PowerPC
   PPC_FETCH_REGION  PPCFetchRegions[3];
+  UINT64    ppcFrameStart;  // PowerPC cycle count at start of current frame (for time stamping drive board commands)
+  unsigned  ppcFrameCycles; // PowerPC cycles per frame
 
   // Multiple threading
   bool        gpusReady;           // True if GPUs are ready to render
@@ -273,6 +308,7 @@ private:
   CThread     *ppcBrdThread;       // PPC main board thread
   CThread     *sndBrdThread;       // Sound board thread
   CThread     *drvBrdThread;       // Drive board thread
+  CThread     *netBrdThread;       // Net board thread
   bool        ppcBrdThreadRunning; // Flag to indicate PPC main board thread is currently processing
   bool        ppcBrdThreadDone;    // Flag to indicate PPC main board thread has finished processing
   bool        sndBrdThreadRunning; // Flag to indicate sound board thread is currently processing
@@ -280,6 +316,9 @@ private:
   bool        sndBrdWakeNotify;    // Flag to indicate that sound board thread has been woken by audio callback (when not sync'd with render thread)
   bool        drvBrdThreadRunning; // Flag to indicate drive board thread is currently processing
   bool        drvBrdThreadDone;    // Flag to indicate drive board thread has finished processing
+  bool        runNetBrdThread;     // Flag to indicate net board thread was woken for the current frame
+  bool        netBrdThreadRunning; // Flag to indicate net board thread is currently processing
+  bool        netBrdThreadDone;    // Flag to indicate net board thread has finished processing
 
   // Thread synchronization objects
   CSemaphore  *ppcBrdThreadSync;
@@ -287,6 +326,7 @@ private:
   CMutex      *sndBrdNotifyLock;
   CCondVar    *sndBrdNotifySync;
   CSemaphore  *drvBrdThreadSync;
+  CSemaphore  *netBrdThreadSync;
   CMutex      *notifyLock;
   CCondVar    *notifySync;  
   
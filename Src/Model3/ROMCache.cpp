@@ -0,0 +1,213 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * ROMCache.cpp
+ *
+ * Pre-processed ROM image cache.
+ *
+ * File Format
+ * -----------
+ *
+ * The file begins with a header occupying the first SEGMENT_ALIGNMENT bytes:
+ *
+ *    Offset  Size  Description
+ *    ------  ----  -----------
+ *    0       16    Magic string "Supermodel ROMs" (NUL-terminated)
+ *    16      4     Format version
+ *    20      4     Number of segments, N
+ *    24      8     ROM set fingerprint (see GameLoader)
+ *    32      8*N   Pool offset and size of each segment (32 bits each)
+ *
+ * Segment data follows in the same order, each segment starting on a
+ * SEGMENT_ALIGNMENT boundary so that it can be mapped directly. All values
+ * are in native byte order; the cache is not meant to be portable.
+ *
+ * The file is written to a temporary name and then renamed so that a partial
+ * cache is never picked up.
+ */
+
+#include "Supermodel.h"
+#include "Model3/ROMCache.h"
+#include "Util/Format.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef SUPERMODEL_WIN32
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ROMCache
+{
+  static const char     MAGIC[16] = "Supermodel ROMs";
+  static const uint32_t VERSION = 1;
+  static const size_t   MAX_SEGMENTS = (SEGMENT_ALIGNMENT - 32) / 8;
+
+  struct Header
+  {
+    char      magic[16];
+    uint32_t  version;
+    uint32_t  num_segments;
+    uint64_t  fingerprint;
+  };
+
+  static std::vector<uint8_t> BuildHeader(uint64_t fingerprint, const std::vector<Segment> &segments)
+  {
+    std::vector<uint8_t> header(SEGMENT_ALIGNMENT, 0);
+    Header h;
+    memcpy(h.magic, MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.num_segments = uint32_t(segments.size());
+    h.fingerprint = fingerprint;
+    memcpy(&header[0], &h, sizeof(h));
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+      memcpy(&header[sizeof(h) + i * 8 + 0], &segments[i].offset, 4);
+      memcpy(&header[sizeof(h) + i * 8 + 4], &segments[i].size, 4);
+    }
+    return header;
+  }
+
+  // Header must match exactly what would be written for this ROM set today
+  static bool CheckHeader(FILE *fp, uint64_t fingerprint, const std::vector<Segment> &segments)
+  {
+    std::vector<uint8_t> expected = BuildHeader(fingerprint, segments);
+    std::vector<uint8_t> actual(expected.size());
+    if (fseek(fp, 0, SEEK_SET) != 0 || fread(actual.data(), 1, actual.size(), fp) != actual.size())
+      return false;
+    return actual == expected;
+  }
+
+  std::string GetFilePath(const std::string &game_name)
+  {
+    return Util::Format() << "ROMCache/" << game_name << ".bin";
+  }
+
+  bool IsValid(const std::string &file_path, uint64_t fingerprint, const std::vector<Segment> &segments)
+  {
+    FILE *fp = fopen(file_path.c_str(), "rb");
+    if (NULL == fp)
+      return false;
+    bool valid = CheckHeader(fp, fingerprint, segments);
+    if (valid)
+    {
+      // Make sure no data was truncated
+      size_t expected_size = SEGMENT_ALIGNMENT;
+      for (auto &segment: segments)
+        expected_size += segment.size;
+      valid = fseek(fp, 0, SEEK_END) == 0 && size_t(ftell(fp)) == expected_size;
+    }
+    fclose(fp);
+    return valid;
+  }
+
+  bool Load(uint8_t *pool, const std::string &file_path, uint64_t fingerprint, const std::vector<Segment> &segments)
+  {
+    if (segments.size() > MAX_SEGMENTS || !IsValid(file_path, fingerprint, segments))
+      return FAIL;
+
+#ifndef SUPERMODEL_WIN32
+    // Map each segment over the pool. Pages are shared with the page cache
+    // until written, so nothing is actually read until it is touched.
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size > 0 && (SEGMENT_ALIGNMENT % page_size) == 0 && (uintptr_t(pool) % page_size) == 0)
+    {
+      int fd = open(file_path.c_str(), O_RDONLY);
+      if (fd >= 0)
+      {
+        off_t file_offset = SEGMENT_ALIGNMENT;
+        bool mapped = true;
+        for (auto &segment: segments)
+        {
+          void *addr = mmap(pool + segment.offset, segment.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, file_offset);
+          if (addr == MAP_FAILED)
+          {
+            // Pages may have been replaced, so fall through and read everything in
+            mapped = false;
+            if (mmap(pool + segment.offset, segment.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+            {
+              close(fd);
+              return ErrorLog("Unable to restore memory after failing to map '%s'.", file_path.c_str());
+            }
+            break;
+          }
+          file_offset += segment.size;
+        }
+        close(fd);
+        if (mapped)
+          return OKAY;
+      }
+    }
+#endif
+
+    FILE *fp = fopen(file_path.c_str(), "rb");
+    if (NULL == fp)
+      return FAIL;
+    bool error = fseek(fp, SEGMENT_ALIGNMENT, SEEK_SET) != 0;
+    for (size_t i = 0; i < segments.size() && !error; i++)
+      error = fread(pool + segments[i].offset, 1, segments[i].size, fp) != segments[i].size;
+    fclose(fp);
+    if (error)
+      return ErrorLog("Unable to read ROM cache '%s'.", file_path.c_str());
+    return OKAY;
+  }
+
+  bool Save(const std::string &file_path, uint64_t fingerprint, const uint8_t *pool, const std::vector<Segment> &segments)
+  {
+    if (segments.size() > MAX_SEGMENTS)
+      return FAIL;
+
+    // Cache directory is created on demand
+#ifdef SUPERMODEL_WIN32
+    _mkdir("ROMCache");
+#else
+    mkdir("ROMCache", 0777);
+#endif
+
+    std::string temp_path = file_path + ".tmp";
+    FILE *fp = fopen(temp_path.c_str(), "wb");
+    if (NULL == fp)
+      return ErrorLog("Unable to create ROM cache '%s'.", temp_path.c_str());
+    std::vector<uint8_t> header = BuildHeader(fingerprint, segments);
+    bool error = fwrite(header.data(), 1, header.size(), fp) != header.size();
+    for (size_t i = 0; i < segments.size() && !error; i++)
+      error = fwrite(pool + segments[i].offset, 1, segments[i].size, fp) != segments[i].size;
+    error |= fclose(fp) != 0;
+    if (!error)
+    {
+      remove(file_path.c_str());  // rename() will not replace an existing file on Windows
+      error = rename(temp_path.c_str(), file_path.c_str()) != 0;
+    }
+    if (error)
+    {
+      remove(temp_path.c_str());
+      return ErrorLog("Unable to write ROM cache '%s'.", file_path.c_str());
+    }
+    return OKAY;
+  }
+} // ROMCache
@@ -0,0 +1,89 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * ROMCache.h
+ *
+ * Header file for the pre-processed ROM image cache. The cache holds the ROM
+ * portions of the Model 3 memory pool exactly as they appear after loading
+ * (mirrored, byte swapped, and patched) so that subsequent launches can map
+ * them in directly instead of inflating and converting the ROM set.
+ */
+
+#ifndef INCLUDED_ROMCACHE_H
+#define INCLUDED_ROMCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ROMCache
+{
+  // Range of the memory pool stored in the cache (offset and size must be
+  // multiples of SEGMENT_ALIGNMENT)
+  struct Segment
+  {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  static const uint32_t SEGMENT_ALIGNMENT = 0x10000;
+
+  /*
+   * GetFilePath(game_name):
+   *
+   * Returns the path of the cache file for a game.
+   */
+  std::string GetFilePath(const std::string &game_name);
+
+  /*
+   * IsValid(file_path, fingerprint, segments):
+   *
+   * Returns true if the cache file exists and was created from a ROM set with
+   * the given fingerprint and for the same memory layout.
+   */
+  bool IsValid(const std::string &file_path, uint64_t fingerprint, const std::vector<Segment> &segments);
+
+  /*
+   * Load(pool, file_path, fingerprint, segments):
+   *
+   * Loads the cached segments into the memory pool. Where supported, the file
+   * is mapped copy-on-write directly over the pool (which must then be page
+   * aligned), otherwise it is read in.
+   *
+   * Returns:
+   *    OKAY if successful, FAIL if the cache is missing, stale, or unreadable.
+   */
+  bool Load(uint8_t *pool, const std::string &file_path, uint64_t fingerprint, const std::vector<Segment> &segments);
+
+  /*
+   * Save(file_path, fingerprint, pool, segments):
+   *
+   * Writes the segments of the memory pool to a new cache file.
+   *
+   * Returns:
+   *    OKAY if successful, FAIL otherwise.
+   */
+  bool Save(const std::string &file_path, uint64_t fingerprint, const uint8_t *pool, const std::vector<Segment> &segments);
+} // ROMCache
+
+#endif  // INCLUDED_ROMCACHE_H
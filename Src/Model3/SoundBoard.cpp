@@ -335,10 +335,20 @@ void CSoundBoard::WriteMIDIPort(UINT8 data)
 		DSB->SendCommand(data);
 }
 
+// Clips a mixed sample to 16 bits
+static inline INT16 ClipSample(INT32 s)
+{
+	if (s > 32767)
+		return 32767;
+	else if (s < -32768)
+		return -32768;
+	return (INT16) s;
+}
+
 bool CSoundBoard::RunFrame(void)
 {
 	// Run sound board first to generate SCSP audio
-	if (m_config["EmulateSound"].ValueAs<bool>())
+	if (m_emulateSound.Get())
 	{
 		M68KSetContext(&M68K);
 		SCSP_Update();
@@ -350,21 +360,37 @@ bool CSoundBoard::RunFrame(void)
 		memset(audioR, 0, 44100/60*sizeof(INT16));
 	}
 	
+	// Resample SCSP audio (44.1 KHz) to output rate. DSB code applies SCSP volume, too.
+	float soundVol = 1.0f;
+	if (NULL != DSB)
+		soundVol = (float) m_soundVolume.Get() / 100.0f;
+	memset(mixL, 0, outputSamples*sizeof(INT32));
+	memset(mixR, 0, outputSamples*sizeof(INT32));
+	Resampler.Write(audioL, audioR, 44100/60);
+	Resampler.ReadAndMix(mixL, mixR, outputSamples, soundVol, soundVol);
+	
 	// Run DSB and mix with existing audio
 	if (NULL != DSB)
-		DSB->RunFrame(audioL, audioR);
+		DSB->RunFrame(mixL, mixR, outputSamples);
+	
+	// Clip final mix to 16 bits
+	for (unsigned i = 0; i < outputSamples; i++)
+	{
+		outputL[i] = ClipSample(mixL[i]);
+		outputR[i] = ClipSample(mixR[i]);
+	}
 
 	// Output the audio buffers
-	bool bufferFull = OutputAudio(44100/60, audioL, audioR, m_config["FlipStereo"].ValueAs<bool>());
+	bool bufferFull = OutputAudio(outputSamples, outputL, outputR, m_flipStereo.Get());
 
 #ifdef SUPERMODEL_LOG_AUDIO
 	// Output to binary file
 	INT16	s;
-	for (int i = 0; i < 44100/60; i++)
+	for (unsigned i = 0; i < outputSamples; i++)
 	{	
-		s = audioL[i];
+		s = outputL[i];
 		fwrite(&s, sizeof(INT16), 1, soundFP);	// left channel
-		s = audioR[i];
+		s = outputR[i];
 		fwrite(&s, sizeof(INT16), 1, soundFP);	// right channel
 	}
 #endif // SUPERMODEL_LOG_AUDIO
@@ -382,6 +408,7 @@ void CSoundBoard::Reset(void)
 	M68KReset();
 	//printf("SBrd PC=%06X\n", M68KGetPC());
 	M68KGetContext(&M68K);
+	Resampler.Reset();
 	if (NULL != DSB)
 		DSB->Reset();
 	DebugLog("Sound Board Reset\n");
@@ -444,7 +471,11 @@ void CSoundBoard::AttachDSB(CDSB *DSBPtr)
 #define OFFSET_RAM2			0x100000	// 1 MB SCSP2 RAM
 #define OFFSET_AUDIO_LEFT	0x200000	// 1470 bytes (16 bits, 44.1 KHz, 1/60th second) left audio channel
 #define OFFSET_AUDIO_RIGHT	0x2005BE	// 1470 bytes right audio channel
-#define MEMORY_POOL_SIZE	(0x100000 + 0x100000 + 0x5BE + 0x5BE)
+#define OFFSET_MIX_LEFT		0x200B7C	// 12800 bytes (32 bits, 192 KHz max., 1/60th second) left mix buffer
+#define OFFSET_MIX_RIGHT	0x203D7C	// 12800 bytes right mix buffer
+#define OFFSET_OUTPUT_LEFT	0x206F7C	// 6400 bytes (16 bits, 192 KHz max., 1/60th second) left output channel
+#define OFFSET_OUTPUT_RIGHT	0x20887C	// 6400 bytes right output channel
+#define MEMORY_POOL_SIZE	(0x100000 + 0x100000 + 0x5BE + 0x5BE + 0x3200 + 0x3200 + 0x1900 + 0x1900)
 
 bool CSoundBoard::Init(const UINT8 *soundROMPtr, const UINT8 *sampleROMPtr)
 {
@@ -467,6 +498,15 @@ bool CSoundBoard::Init(const UINT8 *soundROMPtr, const UINT8 *sampleROMPtr)
 	ram2 = &memoryPool[OFFSET_RAM2];
 	audioL = (INT16 *) &memoryPool[OFFSET_AUDIO_LEFT];
 	audioR = (INT16 *) &memoryPool[OFFSET_AUDIO_RIGHT];
+	mixL = (INT32 *) &memoryPool[OFFSET_MIX_LEFT];
+	mixR = (INT32 *) &memoryPool[OFFSET_MIX_RIGHT];
+	outputL = (INT16 *) &memoryPool[OFFSET_OUTPUT_LEFT];
+	outputR = (INT16 *) &memoryPool[OFFSET_OUTPUT_RIGHT];
+	
+	// Set up resampling of SCSP audio to output rate
+	unsigned outputRate = m_config["AudioSampleRate"].ValueAs<unsigned>();
+	outputSamples = outputRate / 60;
+	Resampler.Configure(44100, outputRate);
 	
 	// Initialize 68K core
 	M68KSetContext(&M68K);
@@ -504,7 +544,10 @@ CDSB *CSoundBoard::GetDSB(void)
 }
 
 CSoundBoard::CSoundBoard(const Util::Config::Node &config)
-  : m_config(config)
+  : m_config(config),
+    m_emulateSound(config["EmulateSound"]),
+    m_soundVolume(config["SoundVolume"]),
+    m_flipStereo(config["FlipStereo"])
 {
 	DSB = NULL;
 	memoryPool = NULL;
@@ -512,6 +555,11 @@ CSoundBoard::CSoundBoard(const Util::Config::Node &config)
 	ram2 = NULL;
 	audioL = NULL;
 	audioR = NULL;
+	mixL = NULL;
+	mixR = NULL;
+	outputL = NULL;
+	outputR = NULL;
+	outputSamples = 44100/60;
 	soundROM = NULL;
 	sampleROM = NULL;
 	
@@ -551,6 +599,10 @@ CSoundBoard::~CSoundBoard(void)
 	ram2 = NULL;
 	audioL = NULL;
 	audioR = NULL;
+	mixL = NULL;
+	mixR = NULL;
+	outputL = NULL;
+	outputR = NULL;
 	soundROM = NULL;
 	sampleROM = NULL;
 	
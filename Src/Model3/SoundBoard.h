@@ -31,6 +31,7 @@
 #include "Types.h"
 #include "CPU/Bus.h"
 #include "Model3/DSB.h"
+#include "Sound/Resampler.h"
 #include "OSD/Thread.h"
 
 /*
@@ -185,6 +186,9 @@ private:
 	
 	// Config
 	const Util::Config::Node &m_config;
+	Util::Config::Handle<bool>	m_emulateSound;	// settings read every frame
+	Util::Config::Handle<int>	m_soundVolume;
+	Util::Config::Handle<bool>	m_flipStereo;
 
 	// Digital Sound Board
 	CDSB		*DSB;
@@ -203,7 +207,11 @@ private:
 	UINT8	ctrlReg;			// control register: ROM banking
 	
 	// Audio
-	INT16	*audioL, *audioR;	// left and right audio channels (1/60th second, 44.1 KHz)
+	INT16		*audioL, *audioR;	// left and right audio channels (1/60th second, 44.1 KHz)
+	INT32		*mixL, *mixR;		// final mix of SCSP and DSB audio (1/60th second, output rate)
+	INT16		*outputL, *outputR;	// final mix clipped to 16 bits
+	unsigned	outputSamples;		// samples per channel per frame at output rate
+	CResampler	Resampler;			// SCSP audio (44.1 KHz) -> output rate
 };
 
 
@@ -69,6 +69,10 @@
 // port_in = 1972
 // port_out = 1970
 // addr_out = "127.0.0.1"
+//
+// when all cabs run on the same machine, add NetTransport = "shm" to each to pass
+// frames through shared memory instead of UDP (ports then only name the links and
+// addr_out is ignored)
 
 //#define NET_DEBUG
 
@@ -77,8 +81,8 @@
 #include "Util/Format.h"
 #include "Util/ByteSwap.h"
 #include <thread>
-#include "UDPSend.h"
-#include "UDPReceive.h"
+#include "NetTransport.h"
+#include "ShmTransport.h"
 
 // few macros to make debugging a bit less painful
 // if NET_DEBUG is defined, printf works normally, otherwise it's compiled to nothing (ie removed)
@@ -98,6 +102,9 @@
 	#define SAFE_ARRAY_DELETE(x) delete[] x; x = NULL;
 #endif
 
+// CommRAM is the Model 3 net buffer region (0xc0000000-0xc001ffff); received frames must not run past it
+#define COMMRAM_SIZE 0x20000
+
 using namespace SMUDP;
 
 static int(*Runnet68kCB)(int cycles);
@@ -151,7 +158,7 @@ UINT8 CNetBoard::Read8(UINT32 a)
 		if (a > 0x0ffff) 
 		{
 			printf("OUT OF RANGE RAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		return RAM[a];
@@ -161,7 +168,7 @@ UINT8 CNetBoard::Read8(UINT32 a)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ctrlrw[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		switch (a & 0xff)
@@ -173,7 +180,7 @@ UINT8 CNetBoard::Read8(UINT32 a)
 
 		default:
 			printf("unknown 400(%x)\n", a & 0xff);
-			MessageBox(NULL, "Unknown R8 CTRLRW", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown R8 CTRLRW");
 			//MessageBeep(MB_ICONWARNING);
 			return ctrlrw[a&0xff];
 			break;
@@ -186,7 +193,7 @@ UINT8 CNetBoard::Read8(UINT32 a)
 		if ((a & 0x3ffff) > 0xffff)
 		{
 			printf("OUT OF RANGE CommRAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		return CommRAM[a & 0xffff];
@@ -196,7 +203,7 @@ UINT8 CNetBoard::Read8(UINT32 a)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ioreg[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		
@@ -237,7 +244,7 @@ UINT8 CNetBoard::Read8(UINT32 a)
 		default:
 			printf("unknown c00(%x)\n", a & 0xff);
 			//MessageBeep(MB_ICONWARNING);
-			MessageBox(NULL, "Unknown R8 IOREG", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown R8 IOREG");
 			return ioreg[a&0xff];
 			break;
 
@@ -247,7 +254,7 @@ UINT8 CNetBoard::Read8(UINT32 a)
 	default:
 		printf("NetBoard 68K: Unknown R8 (%02X) addr=%x\n", (a >> 16) & 0xF,a&0x0fffff);
 		//MessageBeep(MB_ICONWARNING);
-		MessageBox(NULL, "Unknown R8", NULL, MB_OK);
+		ErrorLog("Net Board: Unknown R8");
 		break;
 	}
 
@@ -265,7 +272,7 @@ UINT16 CNetBoard::Read16(UINT32 a)
 		{
 			printf("OUT OF RANGE RAM[%x]\n", a);
 			//MessageBeep(MB_ICONWARNING);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 		}
 		result = *(UINT16 *)&RAM[a];
 		return result;
@@ -276,7 +283,7 @@ UINT16 CNetBoard::Read16(UINT32 a)
 		{
 			printf("OUT OF RANGE ctrlrw[%x]\n", a);
 			//MessageBeep(MB_ICONWARNING);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 		}
 				
 		switch (a & 0xff)
@@ -290,7 +297,7 @@ UINT16 CNetBoard::Read16(UINT32 a)
 		default:
 			result = *(UINT16 *)&ctrlrw[a & 0xff];
 			printf("unknown 400(%x)\n", a & 0xff);
-			MessageBox(NULL, "Unknown R16 CTRLRW", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown R16 CTRLRW");
 			//MessageBeep(MB_ICONWARNING);
 			return result;
 			break;
@@ -303,7 +310,7 @@ UINT16 CNetBoard::Read16(UINT32 a)
 		{
 			printf("OUT OF RANGE CommRAM[%x]\n", a);
 			//MessageBeep(MB_ICONWARNING);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 		}
 		result = *(UINT16 *)&CommRAM[a & 0xffff];
 		return result;
@@ -313,7 +320,7 @@ UINT16 CNetBoard::Read16(UINT32 a)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ioreg[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 				
@@ -332,7 +339,7 @@ UINT16 CNetBoard::Read16(UINT32 a)
 		default:
 			result = *(UINT16 *)&ioreg[a & 0xff];
 			printf("unknown c00(%x)\n", a & 0xff);
-			MessageBox(NULL, "Unknown R16 IOREG", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown R16 IOREG");
 			//MessageBeep(MB_ICONWARNING);
 			return result;
 		}
@@ -340,7 +347,7 @@ UINT16 CNetBoard::Read16(UINT32 a)
 	default:
 		printf("NetBoard 68K: Unknown R16 %02X addr=%x\n", (a >> 16) & 0xF,a&0x0fffff);
 		//MessageBeep(MB_ICONWARNING);
-		MessageBox(NULL, "Unknown R16", NULL, MB_OK);
+		ErrorLog("Net Board: Unknown R16");
 		break;
 	}
 
@@ -360,7 +367,7 @@ UINT32 CNetBoard::Read32(UINT32 a)
 		{
 			printf("OUT OF RANGE RAM[%x]\n", a);
 			//MessageBeep(MB_ICONWARNING);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 		}
 		//printf("Netboard R32\tRAM[%x]=%x\n", a,(hi << 16) | lo);
 		result = (hi << 16) | lo;
@@ -372,7 +379,7 @@ UINT32 CNetBoard::Read32(UINT32 a)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ctrlrw[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		printf("Netboard R32\tctrlrw[%x]=%x\n", a, (hi << 16) | lo);
@@ -385,7 +392,7 @@ UINT32 CNetBoard::Read32(UINT32 a)
 		if ((a & 0x3ffff) > 0xffff)
 		{
 			printf("OUT OF RANGE CommRAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		//if (((a & 0xffff) > 0 && (a & 0xffff) < 0xff) || ((a & 0xffff) > 0xefff && (a & 0xffff) < 0xffff)) printf("Netboard R32\tCommRAM[%x] = %x\n", a & 0xffff, (hi << 16) | lo);
@@ -398,7 +405,7 @@ UINT32 CNetBoard::Read32(UINT32 a)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ioreg[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		printf("Netboard R32\tioreg[%x]=%x\n", a, (hi << 16) | lo);
@@ -408,13 +415,38 @@ UINT32 CNetBoard::Read32(UINT32 a)
 	default:
 		printf("NetBoard 68K: Unknown R32 (%02X) a=%x\n", (a >> 16) & 0xF, a & 0xffff);
 		//MessageBeep(MB_ICONWARNING);
-		MessageBox(NULL, "Unknown R32", NULL, MB_OK);
+		ErrorLog("Net Board: Unknown R32");
 		break;
 	}
 
 	return 0;
 }
 
+// A lagging peer must not stall the main board, so the wait for each frame is
+// bounded. When a deadline is missed, the frame may still arrive later; it is
+// then stale, so any frames queued behind it are skipped to catch up.
+void CNetBoard::ReceiveFrame(UINT16 offset)
+{
+	UINT8 *dest = CommRAM + offset;
+	int maxLength = COMMRAM_SIZE - offset;
+
+	if (transport->Receive(dest, maxLength, frameDeadline.Get()) == INetTransport::RECEIVE_TIMEOUT)
+	{
+		if (lateFrames < MAX_LATE_FRAMES)
+			lateFrames++;
+		Util::PerfCounters::Add(Util::PerfCounters::NetFramesMissed);
+		DebugLog("Net Board: no frame from peer within %u ms.\n", frameDeadline.Get());
+		return;
+	}
+	Util::PerfCounters::Add(Util::PerfCounters::NetFramesReceived);
+
+	while (lateFrames > 0 && transport->Receive(dest, maxLength, 0) != INetTransport::RECEIVE_TIMEOUT)
+	{
+		lateFrames--;
+		Util::PerfCounters::Add(Util::PerfCounters::NetFramesLate);
+	}
+}
+
 void CNetBoard::Write8(UINT32 a, UINT8 d)
 {
 	switch ((a >> 16) & 0xF)
@@ -425,7 +457,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 		{
 			printf("OUT OF RANGE RAM[%x]\n", a);
 			//MessageBeep(MB_ICONWARNING);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 		}
 		RAM[a] = d;
 		break;
@@ -435,7 +467,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ctrlrw[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 
@@ -467,7 +499,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 		default:
 			printf("unknown 400(%x)\n", a & 0xff);
 			ctrlrw[a & 0xff] = d;
-			MessageBox(NULL, "Unknown W8 CTRLRW", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown W8 CTRLRW");
 			//MessageBeep(MB_ICONWARNING);
 			break;
 
@@ -480,7 +512,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 		if ((a & 0x3ffff) > 0xffff)
 		{
 			printf("OUT OF RANGE CommRAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		CommRAM[a & 0xffff] = d;
@@ -491,7 +523,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ioreg[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 
@@ -602,16 +634,14 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 					//printf("-> nb recu : %x\n", recv_data.size());
 					//memcpy(CommRAM + recv_offset, recv_data.data(), recv_data.size());
 					//DPRINTF("receive enable off=%x size=%x\n", recv_offset, recv_size);
-					UINT16 s = 0;
-					std::vector <uint8_t> recv_data;
+					// link is being set up, nothing can proceed without the peer
+					int s = 0;
 					do
 					{
-						recv_data = udpReceive.ReadData(500);
-						DPRINTF("-> nb recu : %x\n", recv_data.size());
-						s = recv_data.size();
+						s = transport->Receive(CommRAM + recv_offset, COMMRAM_SIZE - recv_offset, 500);
+						DPRINTF("-> nb recu : %x\n", s);
 						DPRINTF("receive enable off=%x size=%x\n", recv_offset, recv_size);
-					} while (s == 0);
-					memcpy(CommRAM + recv_offset, recv_data.data(), recv_data.size());
+					} while (s == INetTransport::RECEIVE_TIMEOUT);
 				}
 				else
 				{
@@ -629,9 +659,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 
 					//printf("receive enable off=%x size=%x slot=%x\n", recv_offset, recv_size, slot);
 
-					auto recv_data = udpReceive.ReadData(5000);
-					DPRINTF("-> nb recu : %x\n", recv_data.size());
-					memcpy(CommRAM + recv_offset, recv_data.data(), recv_data.size());
+					ReceiveFrame(recv_offset);
 				}
 
 				#ifdef NET_DEBUG
@@ -708,7 +736,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 				//if (send_offset > 0x1000)
 				if (send_size < 0x0011)	// must find a better condition
 				{
-					udpSend.SendAsync(addr_out.data(), port_out, send_size, (const char*)CommRAM + send_offset, 1000);
+					transport->Send(CommRAM + send_offset, send_size, 1000);
 
 					DPRINTF("send enable off=%x size=%x\n", send_offset, send_size);
 				}
@@ -738,7 +766,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 					}
 					send_offset = (send_offset << 8) | (send_offset >> 8);
 
-					udpSend.SendAsync(addr_out.data(), port_out, send_size, (const char*)CommRAM + send_offset, 1000);
+					transport->Send(CommRAM + send_offset, send_size, 1000);
 
 					DPRINTF("send enable off=%x size=%x slot=%x\n", send_offset, send_size, slot);
 				}
@@ -927,7 +955,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 		default:
 			printf("unknown c00(%x)\n", a & 0xff);
 			ioreg[a & 0xff] = d;
-			MessageBox(NULL, "Unknown W8 IOREG", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown W8 IOREG");
 			//MessageBeep(MB_ICONWARNING);
 			break;
 
@@ -938,7 +966,7 @@ void CNetBoard::Write8(UINT32 a, UINT8 d)
 
 	default:
 		printf("NetBoard 68K: Unknown W8 (%x) %06X<-%02X\n", (a >> 16) & 0xF, a, d);
-		MessageBox(NULL, "Unknown W8", NULL, MB_OK); 
+		ErrorLog("Net Board: Unknown W8"); 
 		//MessageBeep(MB_ICONWARNING);
 		break;
 	}
@@ -953,7 +981,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 		if (a > 0x0ffff)
 		{
 			printf("OUT OF RANGE RAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		*(UINT16 *)&RAM[a] = d;
@@ -964,7 +992,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ctrlrw[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 
@@ -1021,7 +1049,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 		default:
 			*(UINT16 *)&ctrlrw[a & 0xff] = d;
 			printf("unknown 400(%x)\n", a & 0xff);
-			MessageBox(NULL, "Unknown W16 CTRLRW", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown W16 CTRLRW");
 			//MessageBeep(MB_ICONWARNING);
 			break;
 
@@ -1033,7 +1061,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 		if ((a & 0x3ffff) > 0xffff)
 		{
 			printf("OUT OF RANGE CommRAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK); 
+			ErrorLog("Net Board: Out of Range"); 
 			//MessageBeep(MB_ICONWARNING);
 		}
 		*(UINT16 *)&CommRAM[a & 0xffff] = d;
@@ -1044,7 +1072,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ioreg[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		
@@ -1074,7 +1102,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 			{
 				DPRINTF("d=%x\n", d);
 				*(UINT16 *)&ioreg[a & 0xff] = d;
-				//MessageBox(NULL, "d > 1", NULL, MB_OK);
+				//ErrorLog("Net Board: d > 1");
 				//MessageBeep(MB_ICONWARNING);
 			}
 			
@@ -1093,7 +1121,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 
 		default:
 			printf("unknown c00(%x)\n", a & 0xff);
-			MessageBox(NULL, "Unknown W16 IOREG", NULL, MB_OK);
+			ErrorLog("Net Board: Unknown W16 IOREG");
 			//MessageBeep(MB_ICONWARNING);
 			break;
 
@@ -1104,7 +1132,7 @@ void CNetBoard::Write16(UINT32 a, UINT16 d)
 
 	default:
 		printf("NetBoard 68K: Unknown W16 (%x) %06X<-%04X\n", (a >> 16) & 0xF,a, d);
-		MessageBox(NULL, "Unknown W16", NULL, MB_OK); 
+		ErrorLog("Net Board: Unknown W16"); 
 		//MessageBeep(MB_ICONWARNING);
 		break;
 	}
@@ -1119,7 +1147,7 @@ void CNetBoard::Write32(UINT32 a, UINT32 d)
 		if (a > 0x0ffff)
 		{
 			printf("OUT OF RANGE RAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		*(UINT16 *)&RAM[a] = (d >> 16);
@@ -1131,7 +1159,7 @@ void CNetBoard::Write32(UINT32 a, UINT32 d)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ctrlrw[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		*(UINT16 *)&ctrlrw[a] = (d >> 16);
@@ -1143,7 +1171,7 @@ void CNetBoard::Write32(UINT32 a, UINT32 d)
 		if ((a & 0x3ffff) > 0xffff)
 		{
 			printf("OUT OF RANGE CommRAM[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 
@@ -1156,7 +1184,7 @@ void CNetBoard::Write32(UINT32 a, UINT32 d)
 		if ((a & 0xfff) > 0xff)
 		{
 			printf("OUT OF RANGE ioreg[%x]\n", a);
-			MessageBox(NULL, "Out of Range", NULL, MB_OK);
+			ErrorLog("Net Board: Out of Range");
 			//MessageBeep(MB_ICONWARNING);
 		}
 		*(UINT16 *)&ioreg[a] = (d >> 16);
@@ -1168,7 +1196,7 @@ void CNetBoard::Write32(UINT32 a, UINT32 d)
 
 	default:
 		printf("NetBoard 68K: Unknown W32 (%x) %08X<-%08X\n", (a >> 16) & 0xF,a, d);
-		MessageBox(NULL, "Unknown W32", NULL, MB_OK); 
+		ErrorLog("Net Board: Unknown W32"); 
 		//MessageBeep(MB_ICONWARNING);
 		break;
 	}
@@ -1247,13 +1275,31 @@ bool CNetBoard::Init(UINT8 * netRAMPtr, UINT8 *netBufferPtr)
 	port_in = m_config["port_in"].ValueAs<unsigned>();
 	port_out = m_config["port_out"].ValueAs<unsigned>();
 	addr_out = m_config["addr_out"].ValueAs<std::string>();
-	udpReceive.Bind(port_in);
+
+	// instances on the same host can bypass the network stack
+	std::string transportName = m_config["NetTransport"].ValueAsDefault<std::string>("udp");
+	transport.reset();
+	if (transportName == "shm")
+	{
+		std::unique_ptr<SMUDP::ShmTransport> shm(new SMUDP::ShmTransport());
+		if (shm->Open(port_in, port_out) == OKAY)
+			transport = std::move(shm);
+		else
+			ErrorLog("Unable to open shared memory net link, using UDP instead.");
+	}
+	else if (transportName != "udp")
+		ErrorLog("Unknown NetTransport '%s', using UDP.", transportName.c_str());
+	if (!transport)
+		transport.reset(new SMUDP::UDPTransport(addr_out, port_in, port_out));
 
 	return OKAY;
 }
 
-CNetBoard::CNetBoard(const Util::Config::Node &config) : m_config(config)
+CNetBoard::CNetBoard(const Util::Config::Node &config)
+	: m_config(config),
+	  frameDeadline(config["NetFrameDeadline"])
 {
+	lateFrames	= 0;
 	memoryPool	= NULL;
 	bank		= NULL;
 	ct			= NULL;
@@ -1266,6 +1312,7 @@ CNetBoard::CNetBoard(const Util::Config::Node &config) : m_config(config)
 	ctrlrw		= NULL;
 
 	CodeReady	= false;
+	resetPending = false;
 	test_irq	= 0;
 
 	int5		= false;
@@ -1302,6 +1349,11 @@ void CNetBoard::LoadState(CBlockFile * SaveState)
 
 bool CNetBoard::RunFrame(void)
 {
+	if (resetPending.exchange(false))
+	{
+		Reset();
+	}
+
 	if (!CodeReady)
 	{
 		return true;
@@ -1349,6 +1401,11 @@ bool CNetBoard::RunFrame(void)
 	return true;
 }
 
+void CNetBoard::RequestReset(void)
+{
+	resetPending = true;
+}
+
 void CNetBoard::Reset(void)
 {
 	/*********************************************************************************************/
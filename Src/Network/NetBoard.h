@@ -4,11 +4,10 @@
 #include "Types.h"
 #include "CPU/Bus.h"
 #include "OSD/Thread.h"
-#include <winsock2.h>
-#include <ws2tcpip.h>
 #include <thread>
-#include "UDPSend.h"
-#include "UDPReceive.h"
+#include <memory>
+#include <atomic>
+#include "NetTransport.h"
 
 //#define NET_BUF_SIZE 32800 // 16384 not enough
 
@@ -30,10 +29,14 @@ public:
 	bool RunFrame(void);
 	void Reset(void);
 
+	// Called from the main board, which may be running on another thread. The
+	// reset is carried out at the start of the next net board frame.
+	void RequestReset(void);
+
 	// Returns a reference to the 68K CPU context
 	M68KCtx *GetM68K(void);
 	bool IsAttached(void);
-	bool CodeReady;
+	std::atomic<bool> CodeReady;	// set by main board once the 68K program is loaded
 
 	bool Init(UINT8 *netRAMPtr, UINT8 *netBufferPtr);
 	
@@ -72,8 +75,16 @@ private:
 	UINT16 port_out = 0;
 	std::string addr_out = "";
 
-	SMUDP::UDPSend udpSend;
-	SMUDP::UDPReceive udpReceive;
+	std::unique_ptr<SMUDP::INetTransport> transport;	// UDP or shared memory, chosen by NetTransport setting
+
+	// Frames are taken from the transport's receive queue. If none arrives within
+	// the deadline, emulation carries on with the old CommRAM contents.
+	static const unsigned MAX_LATE_FRAMES = 8;
+	Util::Config::Handle<unsigned> frameDeadline;	// ms
+	unsigned lateFrames;	// missed frames that may still turn up
+
+	std::atomic<bool> resetPending;
+	void ReceiveFrame(UINT16 offset);
 
 	//game info
 	Game Gameinfo;
@@ -0,0 +1,66 @@
+#ifndef _NETTRANSPORT_H_
+#define _NETTRANSPORT_H_
+
+#include "Types.h"
+#include "UDPSend.h"
+#include "UDPReceive.h"
+#include <string>
+#include <cstring>
+
+namespace SMUDP
+{
+	// Link between the net boards of two instances. Each instance receives on
+	// one link (port_in) and sends on another (port_out), so a ring of
+	// cabinets is formed by chaining the ports.
+	class INetTransport
+	{
+	public:
+		// Returned by Receive() when no frame arrives in time (an empty frame
+		// is a valid frame)
+		static const int RECEIVE_TIMEOUT = -1;
+
+		virtual ~INetTransport() {}
+
+		// Sends one frame, waiting up to timeout ms for the peer to accept it
+		virtual bool Send(const void *data, int length, int timeout) = 0;
+
+		// Copies the next frame into dest (at most maxLength bytes) and returns
+		// its length, or RECEIVE_TIMEOUT if none arrives within timeout ms
+		virtual int Receive(void *dest, int maxLength, int timeout) = 0;
+	};
+
+	// Frames are fragmented into UDP packets and reassembled by the receiver
+	class UDPTransport : public INetTransport
+	{
+	public:
+		UDPTransport(const std::string& address, UINT16 portIn, UINT16 portOut)
+			: m_address(address), m_portOut(portOut)
+		{
+			m_receive.Bind(portIn);
+		}
+
+		bool Send(const void *data, int length, int timeout)
+		{
+			return m_send.SendAsync(m_address.c_str(), m_portOut, length, data, timeout);
+		}
+
+		int Receive(void *dest, int maxLength, int timeout)
+		{
+			auto frame = m_receive.ReadData(timeout);
+			if (frame == nullptr) {
+				return RECEIVE_TIMEOUT;
+			}
+			int length = frame->size() < (size_t)maxLength ? (int)frame->size() : maxLength;
+			memcpy(dest, frame->data(), length);
+			return length;
+		}
+
+	private:
+		std::string	m_address;
+		UINT16		m_portOut;
+		UDPSend		m_send;
+		UDPReceive	m_receive;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "Supermodel.h"
+#include "ShmTransport.h"
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+
+#ifdef SUPERMODEL_WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <climits>
+#include <ctime>
+#endif
+#endif
+
+namespace SMUDP
+{
+
+// How long a waiting reader polls the ring before going to sleep. A frame
+// written within this window is picked up without any system call.
+static const int SPIN_MICROSECONDS = 200;
+
+static inline UINT32 RecordSize(UINT32 length)
+{
+	return (sizeof(UINT32) + length + 7) & ~7u;
+}
+
+#ifndef SUPERMODEL_WIN32
+static bool ProcessAlive(INT32 pid)
+{
+	return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+#endif
+
+ShmRing::ShmRing()
+{
+	m_header	= nullptr;
+	m_data		= nullptr;
+	m_mapping	= nullptr;
+	m_reader	= false;
+#ifdef SUPERMODEL_WIN32
+	m_handle	= nullptr;
+#else
+	m_name[0]	= '\0';
+#endif
+}
+
+ShmRing::~ShmRing()
+{
+	Close();
+}
+
+bool ShmRing::Open(UINT16 port, bool reader)
+{
+	Close();
+
+	char name[64];
+
+#ifdef SUPERMODEL_WIN32
+	sprintf(name, "Local\\supermodel-net-%u", port);
+
+	// Pages of a new mapping are zero filled
+	HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)SEGMENT_SIZE, name);
+	if (handle == NULL) {
+		return ErrorLog("Unable to create shared memory link '%s'.", name);
+	}
+
+	void *mapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, SEGMENT_SIZE);
+	if (mapping == NULL) {
+		CloseHandle(handle);
+		return ErrorLog("Unable to map shared memory link '%s'.", name);
+	}
+
+	m_handle = handle;
+#else
+	sprintf(name, "/supermodel-net-%u", port);
+
+	// The segment is removed by the last side to close it. One left behind
+	// by a crash is reinitialized below. Extending it with ftruncate() zero
+	// fills it.
+	int fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+	if (fd < 0) {
+		return ErrorLog("Unable to create shared memory link '%s'.", name);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (st.st_size < (off_t)SEGMENT_SIZE && ftruncate(fd, SEGMENT_SIZE) != 0)) {
+		close(fd);
+		return ErrorLog("Unable to size shared memory link '%s'.", name);
+	}
+
+	void *mapping = mmap(NULL, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		return ErrorLog("Unable to map shared memory link '%s'.", name);
+	}
+#endif
+
+	m_mapping	= mapping;
+	m_header	= (Header*)mapping;
+	m_data		= (UINT8*)mapping + (SEGMENT_SIZE - DATA_SIZE);
+
+	UINT32 magic = 0;
+	if (!m_header->magic.compare_exchange_strong(magic, MAGIC) && magic != MAGIC) {
+		Close();
+		return ErrorLog("Shared memory link '%s' is in use by an incompatible version.", name);
+	}
+
+#ifndef SUPERMODEL_WIN32
+	std::atomic<INT32>& self	= reader ? m_header->readerPID : m_header->writerPID;
+	std::atomic<INT32>& peer	= reader ? m_header->writerPID : m_header->readerPID;
+
+	INT32 previous = self.load();
+	if (ProcessAlive(previous) && previous != (INT32)getpid()) {
+		Close();
+		return ErrorLog("Shared memory link '%s' already has a %s (process %d).", name, reader ? "reader" : "writer", previous);
+	}
+
+	// With nobody attached, whatever is in the ring is left over from a
+	// session that did not close it (a crash), so start again from empty
+	if (!ProcessAlive(peer.load())) {
+		peer					= 0;
+		m_header->head			= 0;
+		m_header->tail			= 0;
+		m_header->readerWaiting	= 0;
+		m_header->writerWaiting	= 0;
+	}
+	self = (INT32)getpid();
+
+	strcpy(m_name, name);
+#endif
+	m_reader = reader;
+
+	if (reader) {
+		m_header->tail = m_header->head.load();
+		m_header->spaceSignal++;
+		WakeSignal(m_header->spaceSignal);
+	}
+
+	return OKAY;
+}
+
+void ShmRing::Close()
+{
+	if (m_mapping == nullptr) {
+		return;
+	}
+
+#ifdef SUPERMODEL_WIN32
+	UnmapViewOfFile(m_mapping);
+	CloseHandle((HANDLE)m_handle);
+	m_handle = nullptr;
+#else
+	// Only an attached side has its name recorded
+	if (m_name[0] != '\0') {
+		std::atomic<INT32>& self	= m_reader ? m_header->readerPID : m_header->writerPID;
+		std::atomic<INT32>& peer	= m_reader ? m_header->writerPID : m_header->readerPID;
+		self = 0;
+		if (!ProcessAlive(peer.load())) {
+			shm_unlink(m_name);
+		}
+		m_name[0] = '\0';
+	}
+	munmap(m_mapping, SEGMENT_SIZE);
+#endif
+
+	m_mapping	= nullptr;
+	m_header	= nullptr;
+	m_data		= nullptr;
+}
+
+void ShmRing::WaitSignal(std::atomic<UINT32>& signal, UINT32 value, int timeout)
+{
+#if defined(__linux__)
+	// Not FUTEX_PRIVATE_FLAG: the waker is another process
+	struct timespec ts;
+	ts.tv_sec	= timeout / 1000;
+	ts.tv_nsec	= (timeout % 1000) * 1000000L;
+	syscall(SYS_futex, reinterpret_cast<UINT32*>(&signal), FUTEX_WAIT, value, &ts, NULL, 0);
+#else
+	// No cross-process wait on an address here, so poll
+	if (signal.load() == value && timeout > 0) {
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+#endif
+}
+
+void ShmRing::WakeSignal(std::atomic<UINT32>& signal)
+{
+#if defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<UINT32*>(&signal), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+	(void)signal;
+#endif
+}
+
+bool ShmRing::Write(const void *data, int length, int timeout)
+{
+	if (m_header == nullptr || length < 0 || RecordSize(length) > DATA_SIZE / 2) {
+		return false;
+	}
+
+	UINT32 size		= RecordSize(length);
+	UINT64 head		= m_header->head.load(std::memory_order_relaxed);
+	UINT32 offset	= (UINT32)(head & (DATA_SIZE - 1));
+	UINT32 padding	= (size <= DATA_SIZE - offset) ? 0 : DATA_SIZE - offset;
+
+	// Wait for the reader to make room
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+	while (DATA_SIZE - (head - m_header->tail.load()) < padding + size) {
+
+		auto now = std::chrono::steady_clock::now();
+		if (now >= deadline) {
+			return false;
+		}
+
+		UINT32 signal = m_header->spaceSignal.load();
+		m_header->writerWaiting = 1;
+		if (DATA_SIZE - (head - m_header->tail.load()) < padding + size) {
+			int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+			WaitSignal(m_header->spaceSignal, signal, remaining);
+		}
+		m_header->writerWaiting = 0;
+	}
+
+	// A record never wraps; the rest of the ring is skipped instead
+	if (padding) {
+		UINT32 marker = PADDING;
+		memcpy(m_data + offset, &marker, sizeof(UINT32));
+		head	+= padding;
+		offset	= 0;
+	}
+
+	UINT32 len = (UINT32)length;
+	memcpy(m_data + offset, &len, sizeof(UINT32));
+	memcpy(m_data + offset + sizeof(UINT32), data, length);
+
+	m_header->head = head + size;
+	m_header->dataSignal++;
+	if (m_header->readerWaiting.load()) {
+		WakeSignal(m_header->dataSignal);
+	}
+
+	return true;
+}
+
+int ShmRing::Read(void *dest, int maxLength, int timeout)
+{
+	if (m_header == nullptr) {
+		return INetTransport::RECEIVE_TIMEOUT;
+	}
+
+	UINT64 tail		= m_header->tail.load(std::memory_order_relaxed);
+	auto start		= std::chrono::steady_clock::now();
+	auto spinEnd	= start + std::chrono::microseconds(SPIN_MICROSECONDS);
+	auto deadline	= start + std::chrono::milliseconds(timeout);
+
+	while (m_header->head.load() == tail) {
+
+		auto now = std::chrono::steady_clock::now();
+		if (now >= deadline) {
+			return INetTransport::RECEIVE_TIMEOUT;
+		}
+		if (now < spinEnd) {
+			std::this_thread::yield();	// lets the writer run if it shares our core
+			continue;
+		}
+
+		UINT32 signal = m_header->dataSignal.load();
+		m_header->readerWaiting = 1;
+		if (m_header->head.load() == tail) {
+			int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+			WaitSignal(m_header->dataSignal, signal, remaining);
+		}
+		m_header->readerWaiting = 0;
+	}
+
+	UINT32 offset = (UINT32)(tail & (DATA_SIZE - 1));
+	UINT32 len;
+	memcpy(&len, m_data + offset, sizeof(UINT32));
+
+	// Padding is always followed by the record it made room for
+	if (len == PADDING) {
+		tail	+= DATA_SIZE - offset;
+		offset	= 0;
+		memcpy(&len, m_data, sizeof(UINT32));
+	}
+
+	UINT32 copy = len < (UINT32)maxLength ? len : (UINT32)maxLength;
+	memcpy(dest, m_data + offset + sizeof(UINT32), copy);
+
+	m_header->tail = tail + RecordSize(len);
+	m_header->spaceSignal++;
+	if (m_header->writerWaiting.load()) {
+		WakeSignal(m_header->spaceSignal);
+	}
+
+	return (int)copy;
+}
+
+bool ShmTransport::Open(UINT16 portIn, UINT16 portOut)
+{
+	if (m_in.Open(portIn, true) != OKAY || m_out.Open(portOut, false) != OKAY) {
+		return FAIL;
+	}
+	return OKAY;
+}
+
+bool ShmTransport::Send(const void *data, int length, int timeout)
+{
+	return m_out.Write(data, length, timeout);
+}
+
+int ShmTransport::Receive(void *dest, int maxLength, int timeout)
+{
+	return m_in.Read(dest, maxLength, timeout);
+}
+
+}
@@ -0,0 +1,84 @@
+#ifndef _SHMTRANSPORT_H_
+#define _SHMTRANSPORT_H_
+
+#include "NetTransport.h"
+#include <atomic>
+
+namespace SMUDP
+{
+	// Frame ring in a named shared memory segment, one per link direction
+	// ("supermodel-net-<port>"). There is exactly one writer and one reader
+	// per ring, so head and tail are plain atomics; frames are copied straight
+	// in and out of the ring without fragmentation. A reader with nothing to
+	// read spins briefly and then sleeps on a futex which the writer wakes.
+	class ShmRing
+	{
+	public:
+		ShmRing();
+		~ShmRing();
+
+		// Creates or attaches to the ring for the given port. The reader
+		// discards any frames left over from a previous session, and a ring
+		// left behind by processes that have exited is reinitialized.
+		bool Open(UINT16 port, bool reader);
+
+		// Detaches from the ring; the last side to leave removes it
+		void Close();
+
+		bool Write(const void *data, int length, int timeout);
+
+		// Returns the frame length, or INetTransport::RECEIVE_TIMEOUT
+		int Read(void *dest, int maxLength, int timeout);
+
+	private:
+		static const UINT32 MAGIC		= 0x4D334E32;		// "M3N2"
+		static const UINT32 DATA_SIZE	= 1024 * 1024;		// bytes, power of 2
+		static const UINT32 PADDING		= 0xFFFFFFFF;		// record length marking unused space at end of ring
+
+		// Counters live on separate cache lines so that the two sides do not
+		// contend; zero-filled memory is a valid empty ring
+		struct Header
+		{
+			std::atomic<UINT32>	magic;
+			std::atomic<INT32>	readerPID;					// attached processes, 0 if none
+			std::atomic<INT32>	writerPID;
+			alignas(64) std::atomic<UINT64>	head;			// bytes written, advanced by writer
+			std::atomic<UINT32>	dataSignal;					// futex word, bumped after each write
+			std::atomic<UINT32>	readerWaiting;
+			alignas(64) std::atomic<UINT64>	tail;			// bytes consumed, advanced by reader
+			std::atomic<UINT32>	spaceSignal;				// futex word, bumped after each read
+			std::atomic<UINT32>	writerWaiting;
+		};
+
+		static const size_t SEGMENT_SIZE = (sizeof(Header) + 63) / 64 * 64 + DATA_SIZE;
+
+		// Waits until *signal changes from value or timeout ms elapse
+		static void WaitSignal(std::atomic<UINT32>& signal, UINT32 value, int timeout);
+		static void WakeSignal(std::atomic<UINT32>& signal);
+
+		Header	*m_header;
+		UINT8	*m_data;
+		void	*m_mapping;
+		bool	m_reader;
+#ifdef SUPERMODEL_WIN32
+		void	*m_handle;
+#else
+		char	m_name[64];
+#endif
+	};
+
+	class ShmTransport : public INetTransport
+	{
+	public:
+		bool Open(UINT16 portIn, UINT16 portOut);
+
+		bool Send(const void *data, int length, int timeout);
+		int Receive(void *dest, int maxLength, int timeout);
+
+	private:
+		ShmRing m_in;
+		ShmRing m_out;
+	};
+}
+
+#endif
\ No newline at end of file
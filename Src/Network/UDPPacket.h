@@ -1,6 +1,9 @@
 #ifndef _UDP_H_
 #define _UDP_H_
 
+#include "Types.h"
+#include <cstddef>
+
 namespace SMUDP
 {
 	struct Packet
@@ -13,7 +16,8 @@ namespace SMUDP
 		UINT16 totalIDs;
 		UINT16 flags;
 		UINT16 length;
-		UCHAR  data[BUFFER_SIZE_UDP];
+		UINT32 sequence;		// frame number, echoed in replies
+		UINT8  data[BUFFER_SIZE_UDP];
 
 		Packet() {
 			Init();
@@ -31,9 +35,10 @@ namespace SMUDP
 			totalIDs	= 0;
 			flags		= 0;
 			length		= 0;
+			sequence	= 0;
 		}
 
-		UINT32 CalcCRC() {
+		void CalcCRC() {
 			crc = CalcCRCVal();
 		}
 
@@ -41,7 +46,7 @@ namespace SMUDP
 
 			UINT32 val = 0;
 
-			for (int i = 0; i < _countof(data); i++) {
+			for (size_t i = 0; i < sizeof(data); i++) {
 				val += data[i];		// crude but will catch the odd off by one error
 			}
 
@@ -65,7 +70,7 @@ namespace SMUDP
 		}
 
 		int HeaderSize() {
-			return 12;
+			return 16;
 		}
 
 		int Size() {
@@ -76,7 +81,15 @@ namespace SMUDP
 		operator const char*()	{ return (char*)this; }
 	};
 
-	typedef char PacketReply;
+	// Acknowledges a single packet. The sender only counts replies for the
+	// frame it is sending, so late replies to a frame that timed out cannot be
+	// mistaken for acknowledgements of the next one.
+	struct PacketReply
+	{
+		UINT32 sequence;
+		UINT16 currentID;
+		UINT16 reserved;
+	};
 }
 
 #endif
\ No newline at end of file
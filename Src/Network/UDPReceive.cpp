@@ -1,58 +1,108 @@
-#include <winsock2.h>
-#include <windows.h>
 #include "UDPReceive.h"
 #include "UDPPacket.h"
+#include <chrono>
 
 namespace SMUDP
 {
 
+static const int POLL_INTERVAL = 100;	// ms between checks for thread exit
+
 UDPReceive::UDPReceive()
+	: m_head(0),
+	  m_tail(0),
+	  m_quit(false)
 {
-	m_socket	= socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);		// create the socket
-	m_readEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
-
-	WSAEventSelect(m_socket, m_readEvent, FD_READ);
+	m_socket = OpenSocket();		// create the socket
 }
 
 UDPReceive::~UDPReceive()
 {
-	closesocket(m_socket);
-	CloseHandle(m_readEvent);
+	m_quit = true;
+
+	if (m_receiveThread.joinable()) {
+		m_receiveThread.join();
+	}
+
+	CloseSocket(m_socket);
 }
 
 bool UDPReceive::Bind(UINT16 port)
 {
 	//===========================
 	int			err;
-	SOCKADDR_IN serverInfo = {};
+	sockaddr_in serverInfo = {};
 	//===========================
 
 	serverInfo.sin_family		= AF_INET;			// address family Internet
-	serverInfo.sin_port			= htons(port);		// set servers port number
-	serverInfo.sin_addr.s_addr	= INADDR_ANY;		// set servers IP
+	serverInfo.sin_port			= htons(port);		// set server's port number
+	serverInfo.sin_addr.s_addr	= INADDR_ANY;		// set server's IP
 
-	err = bind(m_socket, (LPSOCKADDR)&serverInfo, sizeof(struct sockaddr));
+	err = bind(m_socket, (sockaddr*)&serverInfo, sizeof(serverInfo));
+
+	if (err == 0 && !m_receiveThread.joinable()) {
+		m_receiveThread = std::thread(&UDPReceive::ReceiveThread, this);
+	}
 
 	return (err == 0);
 }
 
-std::vector<UINT8>& UDPReceive::ReadData(int timeout)
+std::vector<UINT8>* UDPReceive::ReadData(int timeout)
 {
-	m_data.clear();
+	unsigned tail = m_tail.load(std::memory_order_relaxed);
 
-	while (true) {
+	if (m_head.load(std::memory_order_acquire) == tail) {
 
-		//========
-		DWORD res;
-		//========
+		std::unique_lock<std::mutex> lock(m_waitMutex);
 
-		res = WaitForSingleObject(m_readEvent, timeout);
+		auto ready = [&] { return m_head.load(std::memory_order_acquire) != tail; };
+
+		if (!m_frameReady.wait_for(lock, std::chrono::milliseconds(timeout), ready)) {
+			return nullptr;		// timeout
+		}
+	}
+
+	m_data.swap(m_frames[tail % QUEUE_SIZE]);
+	m_tail.store(tail + 1, std::memory_order_release);
+
+	return &m_data;
+}
+
+void UDPReceive::PushFrame(std::vector<UINT8>& frame)
+{
+	unsigned head = m_head.load(std::memory_order_relaxed);
+
+	if (head - m_tail.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+		frame.clear();			// reader has fallen behind, drop frame
+		return;
+	}
 
-		if (res == WAIT_OBJECT_0) {
+	m_frames[head % QUEUE_SIZE].swap(frame);
+	frame.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(m_waitMutex);		// make sure a waiting reader cannot miss the wakeup
+		m_head.store(head + 1, std::memory_order_release);
+	}
+
+	m_frameReady.notify_one();
+}
+
+void UDPReceive::ReceiveThread()
+{
+	std::vector<UINT8> frame;
+
+	while (!m_quit) {
+
+		if (!WaitForSocket(m_socket, false, POLL_INTERVAL)) {
+			continue;
+		}
+
+		// drain everything that has arrived
+		while (true) {
 
 			//=========================
 			int				result;
-			int				slen;
+			SockLen			slen;
 			sockaddr_in		si_other;
 			Packet			packet;
 			//=========================
@@ -61,29 +111,28 @@ std::vector<UINT8>& UDPReceive::ReadData(int timeout)
 
 			result = recvfrom(m_socket, packet, sizeof(packet), 0, (struct sockaddr *) &si_other, &slen);
 
-			if (result == SOCKET_ERROR) {
-				auto error = WSAGetLastError();	// clear error code
-				m_data.clear();			
-				break;	
+			if (result < packet.HeaderSize() || packet.Size() > result) {
+				if (result < 0) {
+					break;		// would block (or error), go back to waiting
+				}
+				continue;		// runt packet
 			}
 
-			// copy data to array
-			m_data.insert(m_data.end(), packet.data, packet.data + packet.length);
+			PacketReply r = { packet.sequence, packet.currentID, 0 };
+			sendto(m_socket, &r, sizeof(r), 0, (struct sockaddr *)&si_other, sizeof(si_other));
+
+			if (packet.currentID == 0) {
+				frame.clear();	// start of a new frame, discard any incomplete one
+			}
 
-			PacketReply r = 1;
-			result = sendto(m_socket, &r, sizeof(r), 0, (struct sockaddr *)&si_other, sizeof(SOCKADDR_IN));
+			// copy data to array
+			frame.insert(frame.end(), packet.data, packet.data + packet.length);
 
 			if (packet.currentID + 1 == packet.totalIDs) {
-				break;			// reached the end
+				PushFrame(frame);	// reached the end
 			}
 		}
-		else {
-			m_data.clear();		// reset any memory because we have failed
-			break;				// timeout
-		}
 	}
-
-	return m_data;
 }
 
 }
@@ -2,11 +2,20 @@
 #define _UDP_RECEIVE_H_
 
 #include "UDPPacket.h"
+#include "UDPSocket.h"
 #include "WinSockWrap.h"
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 namespace SMUDP
 {
+	// Packets are received, acknowledged and reassembled into frames on a
+	// background thread. Completed frames are passed to ReadData() through a
+	// single-producer/single-consumer queue; if the queue is full, the newest
+	// frame is dropped.
 	class UDPReceive
 	{
 	public:
@@ -15,15 +24,30 @@ namespace SMUDP
 
 		bool Bind(UINT16 port);
 
-		std::vector<UINT8>& ReadData(int timeout);
+		// Returns the next complete frame, or nullptr if none arrives within timeout ms
+		std::vector<UINT8>* ReadData(int timeout);
 
 	private:
 
+		static const unsigned QUEUE_SIZE = 16;		// frames
+
+		void ReceiveThread();
+		void PushFrame(std::vector<UINT8>& frame);
+
 		std::vector<UINT8> m_data;
-		SOCKET		m_socket;
-		HANDLE		m_readEvent;
 		WinSockWrap	m_winSockWrap;
+		Socket		m_socket;
+
+		// frame queue
+		std::vector<UINT8>		m_frames[QUEUE_SIZE];
+		std::atomic<unsigned>	m_head;		// written by receive thread
+		std::atomic<unsigned>	m_tail;		// written by ReadData()
+		std::mutex				m_waitMutex;
+		std::condition_variable	m_frameReady;
+
+		std::atomic<bool>	m_quit;
+		std::thread			m_receiveThread;
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -1,46 +1,44 @@
-#include <winsock2.h>
-#include <windows.h>
 #include "UDPSend.h"
-#include <WS2tcpip.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <stdio.h>
 
-#ifdef __GNUC__
-extern "C" {
-	WINSOCK_API_LINKAGE  INT WSAAPI inet_pton(INT Family, PCSTR pszAddrString, PVOID pAddrBuf);
-}
+#if defined(__linux__)
+#define UDP_SENDMMSG
 #endif
 
 namespace SMUDP
 {
 
 UDPSend::UDPSend()
+	: m_exit(false),
+	  m_dataReady(false),
+	  m_sendComplete(true),		// start off ready
+	  m_port(0),
+	  m_timeout(0),
+	  m_sequence(0)
 {
-	m_socket		= socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);		// create the socket
-	m_event			= CreateEvent(NULL, FALSE, FALSE, NULL);
-	m_exitEvent		= CreateEvent(NULL, FALSE, FALSE, NULL);
-	m_dataReady		= CreateEvent(NULL, FALSE, FALSE, NULL);			
-	m_sendComplete	= CreateEvent(NULL, FALSE, TRUE, NULL);			// start off ready
-
-	m_sendThread = std::thread(&UDPSend::SendThread, this);
-
-	WSAEventSelect(m_socket, m_event, FD_READ | FD_WRITE);
+	m_socket		= OpenSocket();		// create the socket
+	m_sendThread	= std::thread(&UDPSend::SendThread, this);
 }
 
 UDPSend::~UDPSend()
 {
-	SetEvent(m_exitEvent);		// trigger thread to exit
-	m_sendThread.join();		// block until thread has exited
-	CloseHandle(m_exitEvent);	// clean up the rest of the resources
-	CloseHandle(m_dataReady);
-	CloseHandle(m_sendComplete);
-
-	closesocket(m_socket);
-	CloseHandle(m_event);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_exit = true;				// trigger thread to exit
+	}
+	m_cond.notify_all();
+	m_sendThread.join();			// block until thread has exited
+
+	CloseSocket(m_socket);
 }
 
 bool UDPSend::SendAsync(const char* address, int port, int length, const void *data, int timeout)
 {
-	WaitForSingleObject(m_sendComplete, INFINITE);	// block until previous sends have completed, don't want overlapping
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cond.wait(lock, [this] { return m_sendComplete; });	// block until previous sends have completed, don't want overlapping
 
 	m_data.clear();
 	m_data.insert(m_data.end(), (UINT8*)data, (UINT8*)data + length);
@@ -49,139 +47,182 @@ bool UDPSend::SendAsync(const char* address, int port, int length, const void *d
 	m_port		= port;
 	m_timeout	= timeout;
 
-	SetEvent(m_dataReady);
+	m_sendComplete	= false;
+	m_dataReady		= true;
+	m_cond.notify_all();
 
 	return true;
 }
 
 void UDPSend::SendThread()
 {
-	HANDLE events[2];
-
-	events[0] = m_exitEvent;
-	events[1] = m_dataReady;
+	std::unique_lock<std::mutex> lock(m_mutex);
 
 	while (true) {
 
-		auto result = WaitForMultipleObjects(_countof(events), events, FALSE, INFINITE);
+		m_cond.wait(lock, [this] { return m_exit || m_dataReady; });
 
-		if (result == WAIT_OBJECT_0) {					// exit event triggered
-			break;	
-		}
-		else if (result == (WAIT_OBJECT_0 + 1)) {		// data ready
-			Send(m_address.c_str(), m_port, (int)m_data.size(), m_data.data(), m_timeout);
-			SetEvent(m_sendComplete);
+		if (m_exit) {				// exit event triggered
+			break;
 		}
+
+		m_dataReady = false;
+
+		// SendAsync() cannot touch the data until the send completes, so it is safe to unlock
+		lock.unlock();
+		Send(m_address.c_str(), m_port, (int)m_data.size(), m_data.data(), m_timeout);
+		lock.lock();
+
+		m_sendComplete = true;
+		m_cond.notify_all();
 	}
 }
 
 bool UDPSend::Send(const char* ip, int port, int length, const void *data, int timeout)
 {
-	UINT8* pData = (UINT8*)data;
+	const UINT8* pData = (const UINT8*)data;
+
+	sockaddr_in address;
+	if (!MakeAddress(ip, port, &address)) {
+		return false;
+	}
 
+	// split the frame into packets
 	Packet packet;
 	packet.CalcTotalIDs(length);
 
-	SOCKADDR_IN address = {};
-	address.sin_family	= AF_INET;			// address family Internet
-	address.sin_port	= htons(port);		// set servers port number
-	inet_pton(AF_INET, ip, &address.sin_addr);
+	UINT32 sequence = ++m_sequence;
 
-	while (length > 0) {
+	m_packets.resize(packet.totalIDs);
 
-		packet.flags = 0;	// reset the flags (not used currently)
+	for (auto &p : m_packets) {
 
-		if (length > packet.BUFFER_SIZE_UDP) {
-			packet.length = packet.BUFFER_SIZE_UDP;
-		}
-		else {
-			packet.length = length;
-		}
+		p.Init();
+		p.currentID	= packet.currentID++;
+		p.totalIDs	= packet.totalIDs;
+		p.sequence	= sequence;
+		p.length	= (UINT16)(length > (int)packet.BUFFER_SIZE_UDP ? packet.BUFFER_SIZE_UDP : length);
+
+		memcpy(p.data, pData, p.length);
+
+		length -= p.length;
+		pData += p.length;
+	}
+
+	// replies left over from a frame that timed out would otherwise be read
+	// first, and must not hold up this one
+	DiscardReplies();
 
-		memcpy(packet.data, pData, packet.length);
+	// send a batch at a time and wait for it to be acknowledged
+	for (size_t i = 0; i < m_packets.size(); i += BATCH_SIZE) {
 
-		int sent = SendDataPacket(packet, m_socket, address, m_event);
+		int count = (int)std::min<size_t>(BATCH_SIZE, m_packets.size() - i);
 
-		if (sent == SOCKET_ERROR) {
+		if (!SendBatch(&m_packets[i], count, address)) {
 			return false;		// send failure
 		}
 
-		if (!ProcessReply(m_socket, m_event, timeout)) {
+		if (!ProcessReplies(&m_packets[i], count, timeout)) {
 			return false;		// reply failure
 		}
-
-		length -= packet.length;
-		pData += packet.length;
-
-		packet.currentID++;
 	}
 
 	return true;
 }
 
-bool UDPSend::WaitForEvent(SOCKET s, HANDLE hEvent, long nEvents, int timeout)
+bool UDPSend::SendBatch(Packet *packets, int count, const sockaddr_in& address)
 {
-	//========
-	DWORD res;
-	//========
+	int sent = 0;
 
-	res = WaitForSingleObject(hEvent, timeout);
+	while (sent < count) {
 
-	if (res == WAIT_OBJECT_0) {
+#ifdef UDP_SENDMMSG
+		mmsghdr	msgs[BATCH_SIZE];
+		iovec	iovs[BATCH_SIZE];
+		int		n = count - sent;
 
-		WSANETWORKEVENTS events = {};
-		WSAEnumNetworkEvents(s, hEvent, &events);
+		memset(msgs, 0, sizeof(msgs[0]) * n);
 
-		if (events.lNetworkEvents & nEvents) {
-			return true;
+		for (int i = 0; i < n; i++) {
+			iovs[i].iov_base				= (char*)packets[sent + i];
+			iovs[i].iov_len					= packets[sent + i].Size();
+			msgs[i].msg_hdr.msg_iov			= &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen		= 1;
+			msgs[i].msg_hdr.msg_name		= (void*)&address;
+			msgs[i].msg_hdr.msg_namelen		= sizeof(address);
 		}
-	}
 
-	return false;
-}
-
-int UDPSend::SendDataPacket(Packet &p, SOCKET s, SOCKADDR_IN& address, HANDLE events)
-{
-	while (true) {
-
-		int sent = sendto(s, p, p.Size(), 0, (struct sockaddr *)&address, sizeof(SOCKADDR_IN));
-
-		if (sent == SOCKET_ERROR) {
+		int result = sendmmsg(m_socket, msgs, n, 0);
+#else
+		int result = sendto(m_socket, packets[sent], packets[sent].Size(), 0, (const struct sockaddr *)&address, sizeof(address));
+		if (result >= 0) {
+			result = 1;
+		}
+#endif
 
-			int error = WSAGetLastError();	// clear error code
+		if (result < 0) {
 
-			if (error == WSAEWOULDBLOCK) {
-				WaitForEvent(s, events, FD_WRITE, INFINITE);		// wait until write event is triggered
+			if (WouldBlock()) {
+				WaitForSocket(m_socket, true, -1);		// wait until socket is writable
 				continue;
 			}
 
-			return sent;	// send failure
+			return false;	// send failure
 		}
 
-		return p.Size();
+		sent += result;
 	}
+
+	return true;
 }
 
-bool UDPSend::ProcessReply(SOCKET s, HANDLE event, int timeout)
+bool UDPSend::ProcessReplies(const Packet *packets, int count, int timeout)
 {
-	//=================
-	int			result;
-	PacketReply	rp;
-	//=================
-
-	if (WaitForEvent(s, event, FD_READ, timeout)) {
+	bool acked[BATCH_SIZE] = {};
+	int remaining = count;
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
 
-		result = recv(s, &rp, sizeof(rp), 0);
+	while (remaining > 0) {
 
-		if (result == SOCKET_ERROR) {
-			auto error = WSAGetLastError();	// clear error code
-			return false;
+		int wait = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+		if (wait < 0 || !WaitForSocket(m_socket, false, wait)) {
+			return false;	// timeout
 		}
 
-		return true;
+		// read all replies that have arrived, ignoring any not for this batch
+		while (remaining > 0) {
+
+			PacketReply rp;
+
+			int result = recv(m_socket, (char*)&rp, sizeof(rp), 0);
+
+			if (result < 0) {
+				if (WouldBlock()) {
+					break;
+				}
+				return false;
+			}
+
+			if (result != (int)sizeof(rp) || rp.sequence != packets[0].sequence) {
+				continue;	// runt or stale reply
+			}
+
+			int index = (int)rp.currentID - (int)packets[0].currentID;
+			if (index >= 0 && index < count && !acked[index]) {
+				acked[index] = true;
+				remaining--;
+			}
+		}
 	}
 
-	return false;
+	return true;
 }
 
-}
\ No newline at end of file
+void UDPSend::DiscardReplies()
+{
+	PacketReply rp;
+	while (recv(m_socket, (char*)&rp, sizeof(rp), 0) >= 0) {
+	}
+}
+
+}
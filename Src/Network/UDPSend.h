@@ -2,12 +2,21 @@
 #define _UDPSEND_H_
 
 #include "UDPPacket.h"
+#include "UDPSocket.h"
 #include "WinSockWrap.h"
 #include <vector>
+#include <string>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace SMUDP
 {
+	// Frames are split into packets which are sent in batches of up to
+	// BATCH_SIZE (with a single sendmmsg() call where available). Each packet
+	// is acknowledged by the receiver and a batch must be fully acknowledged
+	// before the next one is sent. Replies carry the frame sequence number and
+	// packet ID so that only those for the batch in flight are counted.
 	class UDPSend
 	{
 	public:
@@ -19,26 +28,31 @@ namespace SMUDP
 
 	private:
 
-		bool WaitForEvent(SOCKET s, HANDLE hEvent, long nEvents, int timeout);
-		bool ProcessReply(SOCKET s, HANDLE event, int timeout);
-		int SendDataPacket(Packet& p, SOCKET s, SOCKADDR_IN& address, HANDLE events);
-		
-		SOCKET m_socket;
-		HANDLE m_event;
+		static const int BATCH_SIZE = 32;
+
+		bool SendBatch(Packet *packets, int count, const sockaddr_in& address);
+		bool ProcessReplies(const Packet *packets, int count, int timeout);
+		void DiscardReplies();
+
 		WinSockWrap m_winsockWrap;
+		Socket m_socket;
 
 		// async
 		void SendThread();
 
-		HANDLE m_exitEvent;
-		HANDLE m_dataReady;
-		HANDLE m_sendComplete;
+		std::mutex m_mutex;
+		std::condition_variable m_cond;
+		bool m_exit;
+		bool m_dataReady;
+		bool m_sendComplete;
 		int m_port;
 		int m_timeout;
+		UINT32 m_sequence;
 		std::string m_address;
 		std::vector<UINT8> m_data;
+		std::vector<Packet> m_packets;
 		std::thread m_sendThread;
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
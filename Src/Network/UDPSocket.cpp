@@ -0,0 +1,94 @@
+#include "UDPSocket.h"
+#include <cstring>
+
+#if defined(SUPERMODEL_WIN32) && defined(__GNUC__)
+extern "C" {
+	WINSOCK_API_LINKAGE  INT WSAAPI inet_pton(INT Family, PCSTR pszAddrString, PVOID pAddrBuf);
+}
+#endif
+
+namespace SMUDP
+{
+
+static const int SOCKET_BUFFER_SIZE = 1024 * 1024;
+
+Socket OpenSocket()
+{
+	Socket s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (s == INVALID_SOCKET_HANDLE) {
+		return s;
+	}
+
+	int size = SOCKET_BUFFER_SIZE;
+	setsockopt(s, SOL_SOCKET, SO_RCVBUF, (const char*)&size, sizeof(size));
+	setsockopt(s, SOL_SOCKET, SO_SNDBUF, (const char*)&size, sizeof(size));
+
+#ifdef SUPERMODEL_WIN32
+	u_long nonBlocking = 1;
+	ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+	fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+	return s;
+}
+
+void CloseSocket(Socket s)
+{
+	if (s == INVALID_SOCKET_HANDLE) {
+		return;
+	}
+
+#ifdef SUPERMODEL_WIN32
+	closesocket(s);
+#else
+	close(s);
+#endif
+}
+
+bool WouldBlock()
+{
+#ifdef SUPERMODEL_WIN32
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+bool WaitForSocket(Socket s, bool write, int timeout)
+{
+#ifdef SUPERMODEL_WIN32
+	fd_set set;
+	FD_ZERO(&set);
+	FD_SET(s, &set);
+
+	timeval tv;
+	tv.tv_sec	= timeout / 1000;
+	tv.tv_usec	= (timeout % 1000) * 1000;
+
+	int result = select(0, write ? NULL : &set, write ? &set : NULL, NULL, timeout < 0 ? NULL : &tv);
+	return result > 0;
+#else
+	pollfd fd = {};
+	fd.fd		= s;
+	fd.events	= write ? POLLOUT : POLLIN;
+
+	int result;
+	do {
+		result = poll(&fd, 1, timeout);
+	} while (result < 0 && errno == EINTR);
+
+	return result > 0;
+#endif
+}
+
+bool MakeAddress(const char *ip, int port, sockaddr_in *address)
+{
+	memset(address, 0, sizeof(*address));
+	address->sin_family	= AF_INET;				// address family Internet
+	address->sin_port	= htons((unsigned short)port);	// set server's port number
+	return inet_pton(AF_INET, ip, &address->sin_addr) == 1;
+}
+
+}
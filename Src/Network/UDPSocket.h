@@ -0,0 +1,49 @@
+#ifndef _UDPSOCKET_H_
+#define _UDPSOCKET_H_
+
+// Thin portability layer over WinSock and BSD sockets for the net board link
+
+#ifdef SUPERMODEL_WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace SMUDP
+{
+#ifdef SUPERMODEL_WIN32
+	typedef SOCKET		Socket;
+	typedef int			SockLen;
+	static const Socket	INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+#else
+	typedef int			Socket;
+	typedef socklen_t	SockLen;
+	static const Socket	INVALID_SOCKET_HANDLE = -1;
+#endif
+
+	// Creates a non-blocking UDP socket with enlarged buffers so that a whole
+	// batch of fragments can be in flight
+	Socket OpenSocket();
+
+	void CloseSocket(Socket s);
+
+	// True if the last socket call failed only because it would have blocked
+	bool WouldBlock();
+
+	// Waits up to timeout milliseconds (negative waits forever) for the socket
+	// to become readable or writable. Returns true if it did.
+	bool WaitForSocket(Socket s, bool write, int timeout);
+
+	// Fills in an IPv4 address. Returns false if the address is not valid.
+	bool MakeAddress(const char *ip, int port, sockaddr_in *address);
+}
+
+#endif
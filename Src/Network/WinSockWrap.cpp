@@ -1,28 +1,35 @@
 #include "WinSockWrap.h"
+
+#ifdef SUPERMODEL_WIN32
 #include <winsock2.h>
 #include <windows.h>
 
 #pragma comment(lib, "ws2_32.lib")
+#endif
 
 WinSockWrap::WinSockWrap()
 {
+	m_count = 0;
+
+#ifdef SUPERMODEL_WIN32
 	//==============
 	WSADATA	wsaData;
 	int		err;
 	//==============
 
-	m_count = 0;
-
 	err = WSAStartup(MAKEWORD(2, 2), &wsaData);	// don't really need to care for checking supported version, we should be good from win95 onwards
 
 	if (err == 0) {
 		m_count++;
 	}
+#endif
 }
 
 WinSockWrap::~WinSockWrap()
 {
+#ifdef SUPERMODEL_WIN32
 	if (m_count) {
 		WSACleanup();
 	}
+#endif
 }
\ No newline at end of file
@@ -28,6 +28,8 @@
 #ifndef INCLUDED_AUDIO_H
 #define INCLUDED_AUDIO_H
 
+#include "Util/NewConfig.h"
+
 typedef void (*AudioCallbackFPtr)(void *data);
 
 extern void SetAudioCallback(AudioCallbackFPtr callback, void *data);
@@ -35,16 +37,18 @@ extern void SetAudioCallback(AudioCallbackFPtr callback, void *data);
 extern void SetAudioEnabled(bool enabled);
 
 /*
- * OpenAudio()
+ * OpenAudio(config)
  *
- * Initializes the audio system.
+ * Initializes the audio system. The minimum latency and whether it is adjusted
+ * dynamically are taken from the AudioLatency and DynamicAudioLatency settings.
  */
-extern bool OpenAudio();
+extern bool OpenAudio(const Util::Config::Node &config);
 
 /*
  * OutputAudio(unsigned numSamples, *INT16 leftBuffer, *INT16 rightBuffer)
  *
  * Sends a chunk of two-channel audio with the given number of samples to the audio system.
+ * Returns true if the audio buffer has reached its target fill level (or overflowed).
  */
 extern bool OutputAudio(unsigned numSamples, INT16 *leftBuffer, INT16 *rightBuffer, bool flipStereo);
 
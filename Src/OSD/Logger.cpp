@@ -1,4 +1,7 @@
 #include "OSD/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
 
 // Logger object is used to redirect log messages appropriately
 static CLogger *s_Logger = NULL;
@@ -43,3 +46,337 @@ bool ErrorLog(const char *fmt, ...)
   va_end(vl);
   return FAIL;
 }
+
+
+/******************************************************************************
+ CFileLogger
+******************************************************************************/
+
+/*
+ * Each logging thread owns a single-producer/single-consumer ring of
+ * variable-length records. A record is a RecordHeader followed by the
+ * message text (not NUL-terminated), padded to a multiple of RECORD_ALIGN.
+ * A record never wraps: if it does not fit before the end of the ring, a
+ * padding record fills the remainder and the record starts at the beginning.
+ * head and tail count bytes written and consumed since the ring was created.
+ */
+
+struct RecordHeader
+{
+  uint64_t  sequence;
+  uint32_t  level;
+  uint32_t  length;
+};
+
+static const size_t   RING_SIZE = 256 * 1024;
+static const size_t   RECORD_ALIGN = sizeof(RecordHeader);
+static const uint32_t PADDING = 0xFFFFFFFF;
+
+static size_t RecordSize(size_t length)
+{
+  return (sizeof(RecordHeader) + length + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+struct CFileLogger::ThreadBuffer
+{
+  std::vector<char>     data;
+  std::atomic<uint64_t> head;         // written by logging thread
+  std::atomic<uint64_t> tail;         // written by writer thread
+  std::atomic<uint64_t> dropped;      // messages that did not fit
+  std::atomic<bool>     owned;        // true while a thread is logging to it
+  uint64_t              droppedReported = 0;
+
+  bool Write(uint64_t sequence, CFileLogger::Level level, const char *text, size_t length)
+  {
+    size_t need = RecordSize(length);
+    uint64_t h = head.load(std::memory_order_relaxed);
+    uint64_t t = tail.load(std::memory_order_acquire);
+    size_t offset = size_t(h % RING_SIZE);
+    size_t toEnd = RING_SIZE - offset;
+    size_t total = need <= toEnd ? need : toEnd + need;
+    if (h + total - t > RING_SIZE)
+    {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (need > toEnd)
+    {
+      RecordHeader pad = { 0, 0, PADDING };
+      memcpy(&data[offset], &pad, sizeof(pad));
+      h += toEnd;
+      offset = 0;
+    }
+    RecordHeader header = { sequence, uint32_t(level), uint32_t(length) };
+    memcpy(&data[offset], &header, sizeof(header));
+    memcpy(&data[offset + sizeof(header)], text, length);
+    head.store(h + need, std::memory_order_release);
+    return true;
+  }
+
+  ThreadBuffer()
+    : data(RING_SIZE),
+      head(0),
+      tail(0),
+      dropped(0),
+      owned(true)
+  {
+  }
+};
+
+/*
+ * A thread's claim on a ThreadBuffer. The buffer is released when the thread
+ * exits (or logs to a new logger) so that another thread can reuse it; any
+ * messages still in it are drained as usual. The shared_ptr keeps the buffer
+ * alive if the logger is destroyed before the thread exits.
+ */
+struct CFileLogger::ThreadBufferOwner
+{
+  unsigned loggerID = 0;
+  std::shared_ptr<ThreadBuffer> buffer;
+
+  void Release()
+  {
+    if (buffer)
+      buffer->owned.store(false, std::memory_order_release);
+    buffer.reset();
+  }
+
+  ~ThreadBufferOwner()
+  {
+    Release();
+  }
+};
+
+static std::atomic<unsigned> s_nextLoggerID(1);
+
+void CFileLogger::DebugLog(const char *fmt, va_list vl)
+{
+  Log(LEVEL_DEBUG, fmt, vl);
+}
+
+void CFileLogger::InfoLog(const char *fmt, va_list vl)
+{
+  Log(LEVEL_INFO, fmt, vl);
+}
+
+void CFileLogger::ErrorLog(const char *fmt, va_list vl)
+{
+  Log(LEVEL_ERROR, fmt, vl);
+}
+
+void CFileLogger::SetLevel(Level level)
+{
+  m_level.store(level, std::memory_order_relaxed);
+}
+
+void CFileLogger::Log(Level level, const char *fmt, va_list vl)
+{
+  if (int(level) < m_level.load(std::memory_order_relaxed))
+    return;
+
+  char string[MAX_MESSAGE_LENGTH];
+  int length = vsnprintf(string, sizeof(string), fmt, vl);
+  if (length < 0)
+    return;
+  length = std::min<int>(length, sizeof(string) - 1);
+
+  if (level == LEVEL_ERROR)
+    fprintf(stderr, "Error: %s\n", string);
+
+  GetThreadBuffer()->Write(m_sequence.fetch_add(1, std::memory_order_relaxed), level, string, length);
+  if (level == LEVEL_ERROR)
+    m_wake.notify_one();
+}
+
+CFileLogger::ThreadBuffer *CFileLogger::GetThreadBuffer(void)
+{
+  thread_local ThreadBufferOwner owner;
+  if (owner.loggerID != m_id)
+  {
+    owner.Release();
+    owner.buffer = ClaimThreadBuffer();
+    owner.loggerID = m_id;
+  }
+  return owner.buffer.get();
+}
+
+std::shared_ptr<CFileLogger::ThreadBuffer> CFileLogger::ClaimThreadBuffer(void)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // Reuse the buffer of a thread that has exited. Claiming it with acquire
+  // ordering makes the previous owner's writes to head visible to us.
+  for (auto &buffer: m_buffers)
+  {
+    bool owned = false;
+    if (buffer->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+      return buffer;
+  }
+
+  m_buffers.emplace_back(std::make_shared<ThreadBuffer>());
+  return m_buffers.back();
+}
+
+void CFileLogger::WriterThread(void)
+{
+  std::unique_lock<std::mutex> lock(m_writerMutex);
+  while (!m_quit)
+  {
+    m_wake.wait_for(lock, std::chrono::milliseconds(20));
+    Drain();
+  }
+  Drain();
+}
+
+// Must be called with m_writerMutex held
+void CFileLogger::Drain(void)
+{
+  struct Message
+  {
+    uint64_t    sequence;
+    Level       level;
+    std::string text;
+  };
+  std::vector<Message> messages;
+  uint64_t dropped = 0;
+
+  std::vector<ThreadBuffer *> buffers;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &buffer: m_buffers)
+      buffers.push_back(buffer.get());
+  }
+
+  for (ThreadBuffer *buffer: buffers)
+  {
+    uint64_t h = buffer->head.load(std::memory_order_acquire);
+    uint64_t t = buffer->tail.load(std::memory_order_relaxed);
+    while (t < h)
+    {
+      size_t offset = size_t(t % RING_SIZE);
+      RecordHeader header;
+      memcpy(&header, &buffer->data[offset], sizeof(header));
+      if (header.length == PADDING)
+      {
+        t += RING_SIZE - offset;
+        continue;
+      }
+      messages.push_back({ header.sequence, Level(header.level), std::string(&buffer->data[offset + sizeof(header)], header.length) });
+      t += RecordSize(header.length);
+    }
+    buffer->tail.store(t, std::memory_order_release);
+    uint64_t d = buffer->dropped.load(std::memory_order_relaxed);
+    dropped += d - buffer->droppedReported;
+    buffer->droppedReported = d;
+  }
+
+  if (messages.empty() && dropped == 0)
+    return;
+
+  // Merge the threads' messages back into the order they were logged
+  std::sort(messages.begin(), messages.end(), [](const Message &a, const Message &b) { return a.sequence < b.sequence; });
+
+  OpenFiles();
+  bool debugEnabled = m_level.load(std::memory_order_relaxed) <= LEVEL_DEBUG;
+  if (debugEnabled && NULL == m_debugFp)
+    m_debugFp = fopen(m_debugLogFile, "a");
+  for (auto &message: messages)
+  {
+    const char *text = message.text.c_str();
+    switch (message.level)
+    {
+    case LEVEL_DEBUG:
+      if (m_debugFp)
+        fputs(text, m_debugFp);
+      break;
+    case LEVEL_INFO:
+      if (m_errorFp)
+        fprintf(m_errorFp, "%s\n", text);
+      if (debugEnabled && m_debugFp)
+        fprintf(m_debugFp, "Info: %s\n", text);
+      break;
+    case LEVEL_ERROR:
+      if (m_errorFp)
+        fprintf(m_errorFp, "%s\n", text);
+      if (debugEnabled && m_debugFp)
+        fprintf(m_debugFp, "Error: %s\n", text);
+      break;
+    }
+  }
+  if (dropped && m_errorFp)
+    fprintf(m_errorFp, "(%llu log messages dropped)\n", (unsigned long long) dropped);
+
+  if (m_debugFp)
+    fflush(m_debugFp);
+  if (m_errorFp)
+    fflush(m_errorFp);
+}
+
+void CFileLogger::OpenFiles(void)
+{
+  if (NULL == m_errorFp)
+    m_errorFp = fopen(m_errorLogFile, "a");
+}
+
+void CFileLogger::CloseFiles(void)
+{
+  if (m_debugFp)
+    fclose(m_debugFp);
+  if (m_errorFp)
+    fclose(m_errorFp);
+  m_debugFp = NULL;
+  m_errorFp = NULL;
+}
+
+void CFileLogger::ClearLogs(void)
+{
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  Drain();
+  CloseFiles();
+#ifdef DEBUG
+  ClearLog(m_debugLogFile, "Supermodel v" SUPERMODEL_VERSION " Debug Log");
+#endif // DEBUG
+  ClearLog(m_errorLogFile, "Supermodel v" SUPERMODEL_VERSION " Error Log");
+}
+
+void CFileLogger::ClearLog(const char *file, const char *title)
+{
+  FILE *fp = fopen(file, "w");
+  if (NULL != fp)
+  {
+    unsigned  i;
+    fprintf(fp, "%s\n", title);
+    for (i = 0; i < strlen(title); i++)
+      fputc('-', fp);
+    fprintf(fp, "\n\n");
+    fclose(fp);
+  }
+}
+
+CFileLogger::CFileLogger(const char *debugLogFile, const char *errorLogFile)
+  : m_debugLogFile(debugLogFile),
+    m_errorLogFile(errorLogFile),
+    m_id(s_nextLoggerID++),
+#ifdef DEBUG
+    m_level(LEVEL_DEBUG),
+#else
+    m_level(LEVEL_INFO),
+#endif
+    m_sequence(0),
+    m_quit(false),
+    m_debugFp(NULL),
+    m_errorFp(NULL)
+{
+  m_thread = std::thread(&CFileLogger::WriterThread, this);
+}
+
+CFileLogger::~CFileLogger(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    m_quit = true;
+  }
+  m_wake.notify_one();
+  m_thread.join();
+  CloseFiles();
+}
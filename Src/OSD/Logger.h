@@ -34,6 +34,13 @@
 #include <cstdio>
 #include <cstdarg>
 #include <cstring>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 
 /******************************************************************************
@@ -121,81 +128,45 @@ public:
 /*
  * CFileLogger:
  *  
- * Default logger that logs to debug and error log files. Files are opened and
- * closed for each message in order to preserve contents in case of program
- * crash.
+ * Default logger that logs to debug and error log files. Messages below the
+ * current log level are discarded before they are formatted. The rest are
+ * formatted into a ring buffer belonging to the calling thread, so logging
+ * never blocks on file I/O or on other threads, and a background thread
+ * writes them out (in the order they were logged) through persistent file
+ * handles, flushing after each batch. If a thread logs faster than the
+ * background thread can keep up, messages that do not fit in its buffer are
+ * dropped and the number dropped is noted in the log.
+ *
+ * Errors are also printed to stderr immediately.
  */ 
 class CFileLogger : public CLogger
 {
 public:
-	
-	void DebugLog(const char *fmt, va_list vl)
-	{	
-#ifdef DEBUG
-		char	string[1024];
-		FILE 	*fp;
-
-		fp = fopen(m_debugLogFile, "a");
-		if (NULL != fp)
-		{
-			vsprintf(string, fmt, vl);
-			fprintf(fp, string);
-			fclose(fp);
-		}
-#endif // DEBUG
-	}
-
-	void InfoLog(const char *fmt, va_list vl)
+	enum Level
 	{
-		char	string[4096];
-		FILE 	*fp;
-
-		vsprintf(string, fmt, vl);
-		
-		fp = fopen(m_errorLogFile, "a");
-		if (NULL != fp)
-		{
-			fprintf(fp, "%s\n", string);
-			fclose(fp);
-		}
-	
-		CLogger::DebugLog("Info: ");
-		CLogger::DebugLog(string);
-		CLogger::DebugLog("\n");
-	}
+		LEVEL_DEBUG = 0,
+		LEVEL_INFO,
+		LEVEL_ERROR
+	};
 
-	void ErrorLog(const char *fmt, va_list vl)
-	{
-		char	string[4096];
-		FILE 	*fp;
+	void DebugLog(const char *fmt, va_list vl);
+	void InfoLog(const char *fmt, va_list vl);
+	void ErrorLog(const char *fmt, va_list vl);
 
-		vsprintf(string, fmt, vl);
-		fprintf(stderr, "Error: %s\n", string);
-		
-		fp = fopen(m_errorLogFile, "a");
-		if (NULL != fp)
-		{
-			fprintf(fp, "%s\n", string);
-			fclose(fp);
-		}
-		
-		CLogger::DebugLog("Error: ");
-		CLogger::DebugLog(string);
-		CLogger::DebugLog("\n");
-	}
+	/*
+	 * SetLevel(level):
+	 *
+	 * Sets the lowest level of message that is logged. The default is
+	 * LEVEL_DEBUG in debug builds and LEVEL_INFO otherwise.
+	 */
+	void SetLevel(Level level);
 
 	/*
 	 * ClearLogs():
 	 *
 	 * Clears all log files.
 	 */
-	void ClearLogs(void)
-	{
-#ifdef DEBUG
-		ClearLog(m_debugLogFile, "Supermodel v" SUPERMODEL_VERSION " Debug Log");
-#endif // DEBUG
-		ClearLog(m_errorLogFile, "Supermodel v" SUPERMODEL_VERSION " Error Log");	
-	}
+	void ClearLogs(void);
 	
 	/*
 	 * ClearLog(file, title):
@@ -206,33 +177,50 @@ public:
 	 *		file	File name.
 	 *		title	A string that is written to the file after it is cleared.
 	 */
-	void ClearLog(const char *file, const char *title)
-	{
-		FILE *fp = fopen(file, "w");
-		if (NULL != fp)
-		{
-			unsigned	i;
-			fprintf(fp, "%s\n", title);
-			for (i = 0; i < strlen(title); i++)
-				fputc('-', fp);
-			fprintf(fp, "\n\n");
-			fclose(fp);
-		}
-	}
+	void ClearLog(const char *file, const char *title);
 	
 	/*
 	 * CFileLogger(debugLogFile, errorLogFile):
 	 *
-	 * Constructor. Specifies debug and error log files to use.
+	 * Constructor. Specifies debug and error log files to use and starts the
+	 * background writer thread.
 	 */
-	CFileLogger(const char *debugLogFile, const char *errorLogFile) : 
-		m_debugLogFile(debugLogFile), m_errorLogFile(errorLogFile)
-	{
-	}
+	CFileLogger(const char *debugLogFile, const char *errorLogFile);
+	~CFileLogger(void);
 
 private:
-	const char *m_debugLogFile;
-	const char *m_errorLogFile;
+	struct ThreadBuffer;
+	struct ThreadBufferOwner;
+
+	static const size_t	MAX_MESSAGE_LENGTH = 4096;
+
+	void Log(Level level, const char *fmt, va_list vl);
+	ThreadBuffer *GetThreadBuffer(void);
+	std::shared_ptr<ThreadBuffer> ClaimThreadBuffer(void);
+	void WriterThread(void);
+	void Drain(void);
+	void OpenFiles(void);
+	void CloseFiles(void);
+
+	const char	*m_debugLogFile;
+	const char	*m_errorLogFile;
+	unsigned	m_id;		// distinguishes this logger's buffers from those of destroyed loggers
+	std::atomic<int>		m_level;
+	std::atomic<uint64_t>	m_sequence;
+
+	// Thread buffers are registered under m_mutex and shared with the thread
+	// that owns them. When that thread exits, its buffer is handed on to the
+	// next thread that starts logging rather than freed.
+	std::mutex				m_mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>>	m_buffers;
+
+	// Writer thread
+	std::thread				m_thread;
+	std::mutex				m_writerMutex;	// held while draining and writing
+	std::condition_variable	m_wake;
+	bool					m_quit;
+	FILE					*m_debugFp;
+	FILE					*m_errorFp;
 };
 
 
@@ -37,36 +37,53 @@
 
 #include <cmath>
 #include <algorithm>
+#include <atomic>
 
-// Model3 audio output is 44.1KHz 2-channel sound and frame rate is 60fps
-#define SAMPLE_RATE 44100
+// Model3 audio output is 2-channel sound (resampled to the configured output rate) and frame rate is 60fps
 #define NUM_CHANNELS 2
 #define SUPERMODEL_FPS 60
+#define MAX_SAMPLE_RATE 192000
 
 #define BYTES_PER_SAMPLE (NUM_CHANNELS * sizeof(INT16))
-#define SAMPLES_PER_FRAME (SAMPLE_RATE / SUPERMODEL_FPS)
+#define SAMPLES_PER_FRAME (sampleRate / SUPERMODEL_FPS)
+#define MAX_SAMPLES_PER_FRAME (MAX_SAMPLE_RATE / SUPERMODEL_FPS)
 #define BYTES_PER_FRAME (SAMPLES_PER_FRAME * BYTES_PER_SAMPLE) 
 
-#define MAX_LATENCY 100
+#define MAX_LATENCY 500             // Maximum latency (in milliseconds) that dynamic latency targeting can raise buffer fill level to
+#define LATENCY_WINDOW_MS 1000      // Length of window (in milliseconds) over which consumption is measured before lowering latency
 
 static bool enabled = true;         // True if sound output is enabled
-static unsigned latency = 20;       // Audio latency to use (ie size of audio buffer) as percentage of max buffer size
-static bool underRunLoop = true;    // True if should loop back to beginning of buffer on under-run, otherwise sound is just skipped
+static unsigned sampleRate = 44100; // Output sample rate in Hz
+static unsigned latency = 50;       // Minimum audio latency to use (ie target fill level of audio buffer) in milliseconds
+static bool dynamicLatency = true;  // True if target latency should be adjusted according to measured consumption by audio callback
 
 static unsigned playSamples = 512;  // Size (in samples) of callback play buffer
 
-static UINT32 audioBufferSize = 0;  // Size (in bytes) of audio buffer
+static UINT32 audioBufferSize = 0;  // Size (in bytes) of audio buffer (always a power of 2)
 static INT8	*audioBuffer = NULL;    // Audio buffer
 
-static UINT32 writePos = 0;         // Current position at which writing into buffer
-static UINT32 playPos = 0;          // Current position at which playing data in buffer via callback
+/*
+ * The audio buffer is a single-producer, single-consumer ring. OutputAudio()
+ * (sound board thread) is the only writer of writePos and PlayCallback() (SDL
+ * audio thread) is the only writer of playPos. Both are free-running byte
+ * counters that are masked with (audioBufferSize - 1) to index the buffer, so
+ * their difference is always the number of bytes waiting to be played and no
+ * lock needs to be taken between the two threads.
+ */
+static std::atomic<UINT32> writePos(0); // Total number of bytes written into buffer
+static std::atomic<UINT32> playPos(0);  // Total number of bytes played from buffer via callback
+
+static UINT32 minTargetFill = 0;          // Lowest target fill level (in bytes), from configured latency
+static UINT32 maxTargetFill = 0;          // Highest target fill level (in bytes)
+static std::atomic<UINT32> targetFill(0); // Current target fill level (in bytes), ie effective latency
 
-static bool writeWrapped = false;   // True if write position has wrapped around at end of buffer but play position has not done so yet
+static UINT32 windowBytes = 0;      // Number of bytes consumed by callback in current measurement window
+static UINT32 windowLowFill = 0;    // Lowest fill level seen by callback in current measurement window
 
-static unsigned underRuns = 0;      // Number of buffer under-runs that have occured
-static unsigned overRuns = 0;       // Number of buffer over-runs that have occured
+static std::atomic<unsigned> underRuns(0);  // Number of buffer under-runs that have occured
+static std::atomic<unsigned> overRuns(0);   // Number of buffer over-runs that have occured
 
-static AudioCallbackFPtr callback = NULL; // Pointer to audio callback that is called when audio buffer is less than half empty
+static AudioCallbackFPtr callback = NULL; // Pointer to audio callback that is called when audio buffer is below its target fill level
 static void *callbackData = NULL;         // Pointer to data to be passed to audio callback when it is called
 
 void SetAudioCallback(AudioCallbackFPtr newCallback, void *newData)
@@ -85,108 +102,88 @@ void SetAudioEnabled(bool newEnabled)
 	enabled = newEnabled;
 }
 
-static void PlayCallback(void *data, Uint8 *stream, int len)
+static UINT32 MillisecondsToBytes(unsigned ms)
 {
-	//printf("PlayCallback(%d) [writePos = %u, writeWrapped = %s, playPos = %u, audioBufferSize = %u]\n", 
-	//	len, writePos, (writeWrapped ? "true" : "false"), playPos, audioBufferSize);
-	
-	// Get current write position and adjust it if write has wrapped but play position has not
-	UINT32 adjWritePos = writePos;
-	if (writeWrapped)
-		adjWritePos += audioBufferSize;
+	return (UINT32)((UINT64)sampleRate * ms / 1000) * BYTES_PER_SAMPLE;
+}
 
-	// Check if play position overlaps write position (ie buffer under-run)
-	if (playPos + len > adjWritePos)
+static void UpdateTargetFill(UINT32 fill, UINT32 len, bool underRun)
+{
+	// Called from audio callback only, which is the sole writer of target fill level
+	UINT32 target = targetFill.load(std::memory_order_relaxed);
+	if (underRun)
 	{
-		underRuns++;
-
-		//printf("Audio buffer under-run #%u in PlayCallback(%d) [writePos = %u, writeWrapped = %s, playPos = %u, audioBufferSize = %u]\n",
-		//	underRuns, len, writePos, (writeWrapped ? "true" : "false"), playPos, audioBufferSize);
-		
-		// See what action to take on under-run
-		if (underRunLoop)
-		{
-			// If loop, then move play position back to beginning of data in buffer
-			playPos = adjWritePos + BYTES_PER_FRAME;
-
-			// Check if play position has moved past end of buffer
-			if (playPos >= audioBufferSize)
-				// If so, wrap it around to beginning again (but keep write wrapped flag as before)
-				playPos -= audioBufferSize;
-			else 
-				// Otherwise, set write wrapped flag as will now appear as if write has wrapped but play position has not
-				writeWrapped = true;
-		}
-		else
+		// Data did not arrive in time so raise latency by a frame straight away
+		target = std::min<UINT32>(target + BYTES_PER_FRAME, maxTargetFill);
+		windowBytes = 0;
+		windowLowFill = audioBufferSize;
+	}
+	else
+	{
+		// Track lowest fill level over the measurement window
+		windowLowFill = std::min<UINT32>(windowLowFill, fill - len);
+		windowBytes += len;
+		if (windowBytes >= MillisecondsToBytes(LATENCY_WINDOW_MS))
 		{
-			// Otherwise, just copy silence to audio output stream and exit
-			memset(stream, 0, len);
-			return;
+			// If buffer never dropped below a frame's worth of data then latency can be lowered by half the unused margin
+			if (windowLowFill > BYTES_PER_FRAME)
+			{
+				UINT32 excess = (windowLowFill - BYTES_PER_FRAME) / 2;
+				excess -= excess % BYTES_PER_SAMPLE;
+				target = std::max<UINT32>(minTargetFill, target - std::min<UINT32>(target, excess));
+			}
+			windowBytes = 0;
+			windowLowFill = audioBufferSize;
 		}
 	}
-	
-	INT8* src1;
-	INT8* src2;
-	UINT32 len1;
-	UINT32 len2;
+	targetFill.store(target, std::memory_order_relaxed);
+}
 
-	// Check if play region extends past end of buffer
-	if (playPos + len > audioBufferSize)
-	{
-		// If so, split play region into two
-		src1 = audioBuffer + playPos;
-		src2 = audioBuffer;
-		len1 = audioBufferSize - playPos;
-		len2 = len - len1;
-	}
-	else
+static void PlayCallback(void *data, Uint8 *stream, int len)
+{
+	// Get amount of data available in buffer (acquire ensures writes to buffer by OutputAudio are visible)
+	UINT32 readPos = playPos.load(std::memory_order_relaxed);
+	UINT32 fill = writePos.load(std::memory_order_acquire) - readPos;
+	
+	// Check if there is not enough data to satisfy request (ie buffer under-run)
+	bool underRun = fill < (UINT32)len;
+	UINT32 numBytes = underRun ? fill : len;
+	if (underRun)
 	{
-		// Otherwise, just copy whole region
-		src1 = audioBuffer + playPos;
-		src2 = 0;
-		len1 = len;
-		len2 = 0;
+		underRuns++;
+		Util::PerfCounters::Add(Util::PerfCounters::AudioUnderruns);
 	}
 
+	// Check if play region extends past end of buffer
+	UINT32 offset = readPos & (audioBufferSize - 1);
+	UINT32 len1 = std::min<UINT32>(numBytes, audioBufferSize - offset);
+	UINT32 len2 = numBytes - len1;
+
 	// Check if audio is enabled
 	if (enabled)
 	{
-		// If so, copy play region into audio output stream
-		memcpy(stream, src1, len1);
-		
-		// Also, if not looping on under-runs then blank region out
-		if (!underRunLoop)
-			memset(src1, 0, len1);
-
+		// If so, copy play region into audio output stream (in two parts if it was split)
+		memcpy(stream, audioBuffer + offset, len1);
 		if (len2)
-		{
-			// If region was split into two, copy second half into audio output stream as well
-			memcpy(stream + len1, src2, len2);
-
-			// Also, if not looping on under-runs then blank region out
-			if (!underRunLoop)
-				memset(src2, 0, len2);
-		}
+			memcpy(stream + len1, audioBuffer, len2);
 	}
 	else
 		// Otherwise, just copy silence to audio output stream
-		memset(stream, 0, len);
+		memset(stream, 0, numBytes);
 
-	// Move play position forward for next time
-	playPos += len;
+	// On under-run, pad remainder of audio output stream with silence
+	if (underRun)
+		memset(stream + numBytes, 0, len - numBytes);
 
-	bool bufferFull = adjWritePos + 2 * BYTES_PER_FRAME > playPos + audioBufferSize;
+	// Move play position forward, handing region back to OutputAudio (release ensures copy above has completed first)
+	playPos.store(readPos + numBytes, std::memory_order_release);
 
-	// Check if play position has moved past end of buffer
-	if (playPos >= audioBufferSize)
-	{
-		// If so, wrap it around to beginning again and reset write wrapped flag
-		playPos -= audioBufferSize;
-		writeWrapped = false;
-	}
+	// Adjust target latency based on consumption
+	if (dynamicLatency)
+		UpdateTargetFill(fill, numBytes, underRun);
 
-	// If buffer is not full then call audio callback
-	if (callback && !bufferFull)
+	// If buffer is now below its target fill level then call audio callback (pull mode)
+	if (callback && fill - numBytes < targetFill.load(std::memory_order_relaxed))
 		callback(callbackData);
 }
 
@@ -228,8 +225,13 @@ static void LogAudioInfo(SDL_AudioSpec *fmt)
 }
 */
 
-bool OpenAudio()
+bool OpenAudio(const Util::Config::Node &config)
 {
+	// Fetch output rate and latency settings
+	sampleRate = std::min<unsigned>(config["AudioSampleRate"].ValueAs<unsigned>(), MAX_SAMPLE_RATE);
+	latency = config["AudioLatency"].ValueAs<unsigned>();
+	dynamicLatency = config["DynamicAudioLatency"].ValueAs<bool>();
+
 	// Initialize SDL audio sub-system
 	if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0)
 		return ErrorLog("Unable to initialize SDL audio sub-system: %s\n", SDL_GetError());
@@ -237,7 +239,7 @@ bool OpenAudio()
 	// Set up audio specification
 	SDL_AudioSpec fmt;
 	memset(&fmt, 0, sizeof(SDL_AudioSpec));
-	fmt.freq = SAMPLE_RATE;
+	fmt.freq = sampleRate;
 	fmt.channels = NUM_CHANNELS;
 	fmt.format = AUDIO_S16SYS;
 	fmt.samples = playSamples;
@@ -245,12 +247,16 @@ bool OpenAudio()
 	
 	// Force SDL to use the format we requested; it will convert if necessary
 	if (SDL_OpenAudio(&fmt, nullptr) < 0)
-		return ErrorLog("Unable to open 44.1KHz 2-channel audio with SDL: %s\n", SDL_GetError());
+		return ErrorLog("Unable to open %u Hz 2-channel audio with SDL: %s\n", sampleRate, SDL_GetError());
 
-	// Create audio buffer
-	audioBufferSize = SAMPLE_RATE * BYTES_PER_SAMPLE * latency / MAX_LATENCY;
-	int minBufferSize = 3 * BYTES_PER_FRAME;
-	audioBufferSize = std::max<int>(minBufferSize, audioBufferSize);
+	// Work out range of target fill levels: at least one callback's worth of data plus a frame must always be buffered
+	minTargetFill = std::max<UINT32>(MillisecondsToBytes(latency), playSamples * BYTES_PER_SAMPLE + BYTES_PER_FRAME);
+	maxTargetFill = std::max<UINT32>(MillisecondsToBytes(MAX_LATENCY), minTargetFill);
+
+	// Create audio buffer, rounded up to a power of 2 so that ring positions can be masked and with room for two frames above max fill level
+	audioBufferSize = 1;
+	while (audioBufferSize < maxTargetFill + 2 * BYTES_PER_FRAME)
+		audioBufferSize <<= 1;
 	audioBuffer = new(std::nothrow) INT8[audioBufferSize];
 	if (audioBuffer == NULL)
 	{
@@ -259,10 +265,12 @@ bool OpenAudio()
 	}
 	memset(audioBuffer, 0, sizeof(INT8) * audioBufferSize);
 	
-	// Set initial play position to be beginning of buffer and initial write position to be half-way into buffer
+	// Set initial play position to be beginning of buffer and pre-fill buffer with silence up to target fill level
+	targetFill = minTargetFill;
 	playPos = 0;
-	writePos = std::min<int>(audioBufferSize - BYTES_PER_FRAME, (BYTES_PER_FRAME + audioBufferSize) / 2);
-	writeWrapped = false;
+	writePos = minTargetFill;
+	windowBytes = 0;
+	windowLowFill = audioBufferSize;
 
 	// Reset counters
 	underRuns = 0;
@@ -275,150 +283,45 @@ bool OpenAudio()
 
 bool OutputAudio(unsigned numSamples, INT16 *leftBuffer, INT16 *rightBuffer, bool flipStereo)
 {
-	//printf("OutputAudio(%u) [writePos = %u, writeWrapped = %s, playPos = %u, audioBufferSize = %u]\n",
-	//	numSamples, writePos, (writeWrapped ? "true" : "false"), playPos, audioBufferSize);
-
-	UINT32 bytesRemaining;
-	UINT32 bytesToCopy;
-	INT16 *src;
-
 	// Number of samples should never be more than max number of samples per frame
 	if (numSamples > SAMPLES_PER_FRAME)
 		numSamples = SAMPLES_PER_FRAME;
 
 	// Mix together left and right channels into single chunk of data
-	INT16 mixBuffer[NUM_CHANNELS * SAMPLES_PER_FRAME];
+	INT16 mixBuffer[NUM_CHANNELS * MAX_SAMPLES_PER_FRAME];
 	MixChannels(numSamples, leftBuffer, rightBuffer, mixBuffer, flipStereo);
 	
-	// Lock SDL audio callback so that it doesn't interfere with following code
-	SDL_LockAudio();
-	
 	// Calculate number of bytes for current sound chunk
 	UINT32 numBytes = numSamples * BYTES_PER_SAMPLE;
-	
-	// Get end of current play region (writing must occur past this point)
-	UINT32 playEndPos = playPos + BYTES_PER_FRAME;
-	
-	// Undo any wrap-around of the write position that may have occured to create following ordering: playPos < playEndPos < writePos
-	if (playEndPos > writePos && writeWrapped)
-		writePos += audioBufferSize;
-
-	// Check if play region has caught up with write position and now overlaps it (ie buffer under-run)
-	if (playEndPos > writePos)
-	{
-		underRuns++;
-
-		//printf("Audio buffer under-run #%u in OutputAudio(%u) [writePos = %u, writeWrapped = %s, playPos = %u, audioBufferSize = %u, numBytes = %u]\n",
-		//	underRuns, numSamples, writePos, (writeWrapped ? "true" : "false"), playPos, audioBufferSize, numBytes);
-		
-		// See what action to take on under-run
-		if (underRunLoop)
-		{
-			// If loop, then move play position back to beginning of data in buffer
-			playPos = writePos + numBytes + BYTES_PER_FRAME;
-			
-			// Check if play position has moved past end of buffer
-			if (playPos >= audioBufferSize)
-				// If so, wrap it around to beginning again (but keep write wrapped flag as before)
-				playPos -= audioBufferSize;
-			else 
-			{
-				// Otherwise, set write wrapped flag as will now appear as if write has wrapped but play position has not
-				writeWrapped = true;
-				writePos += audioBufferSize;
-			}
-		}
-		else
-		{
-			// Otherwise, bump write position forward in chunks until it is past end of play region
-			do
-			{
-				writePos += numBytes;
-			}
-			while (playEndPos > writePos);
-		}
-	}
 
-	// Check if write position has caught up with play region and now overlaps it (ie buffer over-run)
-	bool overRun = writePos + numBytes > playPos + audioBufferSize;
-	
-	bool bufferFull = writePos + 2 * BYTES_PER_FRAME > playPos + audioBufferSize;
-
-	// Move write position back to within buffer
-	if (writePos >= audioBufferSize)
-		writePos -= audioBufferSize;
+	// Get amount of data already in buffer (acquire ensures callback has finished reading region before it is overwritten)
+	UINT32 pos = writePos.load(std::memory_order_relaxed);
+	UINT32 fill = pos - playPos.load(std::memory_order_acquire);
 
-	// Handle buffer over-run
-	if (overRun)
+	// Check if chunk will not fit into free space in buffer (ie buffer over-run)
+	if (fill + numBytes > audioBufferSize)
 	{
 		overRuns++;
 
-		//printf("Audio buffer over-run #%u in OutputAudio(%u) [writePos = %u, writeWrapped = %s, playPos = %u, audioBufferSize = %u, numBytes = %u]\n",
-		//	overRuns, numSamples, writePos, (writeWrapped ? "true" : "false"), playPos, audioBufferSize, numBytes);
-		
-		bufferFull = true;
-
 		// Discard current chunk of data
-		goto Finish;
+		return true;
 	}
 
-	src = mixBuffer;
-	INT8 *dst1;
-	INT8 *dst2;
-	UINT32 len1;
-	UINT32 len2;
-
 	// Check if write region extends past end of buffer
-	if (writePos + numBytes > audioBufferSize)
-	{
-		// If so, split write region into two
-		dst1 = audioBuffer + writePos;
-		dst2 = audioBuffer;
-		len1 = audioBufferSize - writePos;
-		len2 = numBytes - len1;
-	}
-	else
-	{
-		// Otherwise, just copy whole region
-		dst1 = audioBuffer + writePos;
-		dst2 = 0;
-		len1 = numBytes;
-		len2 = 0;
-	}
+	UINT32 offset = pos & (audioBufferSize - 1);
+	UINT32 len1 = std::min<UINT32>(numBytes, audioBufferSize - offset);
+	UINT32 len2 = numBytes - len1;
 
-	// Copy chunk to write position in buffer
-	bytesRemaining = numBytes;
-	bytesToCopy = (bytesRemaining > len1 ? len1 : bytesRemaining);
-	memcpy(dst1, src, bytesToCopy);
+	// Copy chunk to write position in buffer (in two parts if it was split)
+	memcpy(audioBuffer + offset, mixBuffer, len1);
+	if (len2)
+		memcpy(audioBuffer, (UINT8*)mixBuffer + len1, len2);
 
-	// Adjust for number of bytes copied
-	bytesRemaining -= bytesToCopy;
-	src = (INT16*)((UINT8*)src + bytesToCopy);
-
-	if (bytesRemaining)
-	{
-		// If write region was split into two, copy second half of chunk into buffer as well
-		bytesToCopy = (bytesRemaining > len2 ? len2 : bytesRemaining);
-		memcpy(dst2, src, bytesToCopy);
-	}
-
-	// Move write position forward for next time
-	writePos += numBytes;
-
-	// Check if write position has moved past end of buffer
-	if (writePos >= audioBufferSize)
-	{
-		// If so, wrap it around to beginning again and set write wrapped flag
-		writePos -= audioBufferSize;
-		writeWrapped = true;
-	}
-
-Finish:
-	// Unlock SDL audio callback
-	SDL_UnlockAudio();
+	// Move write position forward, handing chunk over to callback (release ensures copy above has completed first)
+	writePos.store(pos + numBytes, std::memory_order_release);
 
-	// Return whether buffer is half full
-	return bufferFull;
+	// Return whether buffer has reached its target fill level
+	return fill + numBytes >= targetFill.load(std::memory_order_relaxed);
 }
 
 void CloseAudio()
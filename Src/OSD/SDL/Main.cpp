@@ -68,10 +68,16 @@
 #include "Util/NewConfig.h"
 #include "Util/ConfigBuilders.h"
 #include "GameLoader.h"
+#include "Benchmark.h"
+#include "FramePacer.h"
+#include "RewindBuffer.h"
+#include "StateWriter.h"
 #include "SDLInputSystem.h"
 #ifdef SUPERMODEL_WIN32
 #include "DirectInputSystem.h"
 #include "WinOutputs.h"
+#else
+#include "ShmOutputs.h"
 #endif
 
 #include <iostream>
@@ -207,7 +213,7 @@ static bool CreateGLScreen(const std::string &caption, bool focusWindow, unsigne
   SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER,1);
   
   // Set video mode
-  s_window = SDL_CreateWindow(caption.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, *xResPtr, *yResPtr, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | (fullScreen ? SDL_WINDOW_FULLSCREEN : 0));
+  s_window = SDL_CreateWindow(caption.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, *xResPtr, *yResPtr, SDL_WINDOW_OPENGL | (s_runtime_config["Benchmark"].ValueAsDefault<unsigned>(0) ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN) | (fullScreen ? SDL_WINDOW_FULLSCREEN : 0));
   if (nullptr == s_window)
   {
     ErrorLog("Unable to create an OpenGL display: %s\n", SDL_GetError());
@@ -553,22 +559,24 @@ static void TestPolygonHeaderBits(IEmulator *Emu)
  including terminating \0).
  
  Different subsystems output their own blocks.
+
+ Save states are serialized into memory while the emulator is paused and are
+ then compressed and written out in the background. Uncompressed save states
+ from earlier versions can still be loaded.
 ******************************************************************************/
 
 static const int STATE_FILE_VERSION = 3;  // save state file version
 static const int NVRAM_FILE_VERSION = 0;  // NVRAM file version
 static unsigned s_saveSlot = 0;           // save state slot #
+static CStateWriter s_stateWriter;        // writes save states in the background
 
 static void SaveState(IEmulator *Model3)
 {
-  CBlockFile  SaveState;
+  CBlockFile            SaveState;
+  std::vector<uint8_t>  state;
   
   std::string file_path = Util::Format() << "Saves/" << Model3->GetGame().name << ".st" << s_saveSlot;
-  if (OKAY != SaveState.Create(file_path, "Supermodel Save State", "Supermodel Version " SUPERMODEL_VERSION))
-  {
-    ErrorLog("Unable to save state to '%s'.", file_path.c_str());
-    return;
-  }
+  SaveState.Create(&state, "Supermodel Save State", "Supermodel Version " SUPERMODEL_VERSION);
   
   // Write file format version and ROM set ID to header block 
   int32_t fileVersion = STATE_FILE_VERSION;
@@ -578,8 +586,21 @@ static void SaveState(IEmulator *Model3)
   // Save state
   Model3->SaveState(&SaveState);
   SaveState.Close();
-  printf("Saved state to '%s'.\n", file_path.c_str());
-  DebugLog("Saved state to '%s'.\n", file_path.c_str());
+  
+  // Compress and write out in the background
+  s_stateWriter.Write(file_path, &state);
+}
+
+/*
+ * Input recordings hold only the inputs for each frame, so they cannot follow
+ * emulation to a different state (reset, state load, or rewind).
+ */
+static void StopInputRecording(CInputs *Inputs, const char *reason)
+{
+  if (!Inputs->IsRecording() && !Inputs->IsReplaying())
+    return;
+  printf("Input %s stopped by %s.\n", Inputs->IsRecording() ? "recording" : "replay", reason);
+  Inputs->StopRecording();
 }
 
 static void LoadState(IEmulator *Model3, std::string file_path = std::string())
@@ -590,6 +611,9 @@ static void LoadState(IEmulator *Model3, std::string file_path = std::string())
   if (file_path.empty())
     file_path = Util::Format() << "Saves/" << Model3->GetGame().name << ".st" << s_saveSlot;
   
+  // Any save state being written may be the one requested
+  s_stateWriter.Wait();
+  
   // Open and check to make sure format is correct
   if (OKAY != SaveState.Load(file_path))
   {
@@ -794,30 +818,41 @@ static void UpdateCrosshairs(uint32_t currentInputs, CInputs *Inputs, unsigned c
 
 static CInputs *videoInputs = NULL;
 static uint32_t currentInputs = 0;
+static bool renderingEnabled = true;  // may be disabled when benchmarking
 
 bool BeginFrameVideo()
 {
-  return true;
+  return renderingEnabled;
 }
 
 void EndFrameVideo()
 {
+  if (!renderingEnabled)
+    return;
+
   // Show crosshairs for light gun games
   if (videoInputs)
-    UpdateCrosshairs(currentInputs, videoInputs, s_runtime_config["Crosshairs"].ValueAs<unsigned>());
+  {
+    static const Util::Config::Handle<unsigned> crosshairs(s_runtime_config["Crosshairs"]);
+    UpdateCrosshairs(currentInputs, videoInputs, crosshairs.Get());
+  }
 
   // Swap the buffers
   SDL_GL_SwapWindow(s_window);
 }
 
-static void SuperSleep(UINT32 time)
+/*
+ * IsVSyncLocked(refreshRate):
+ *
+ * Returns true if buffer swaps are synchronized to a display refreshing at
+ * (within 1 Hz of) the given rate, in which case they pace the main loop.
+ */
+static bool IsVSyncLocked(double refreshRate)
 {
-  UINT32 start = SDL_GetTicks();
-  UINT32 tics  = start;
-
-  while (start + time > tics) {
-    tics = SDL_GetTicks();
-  }
+  SDL_DisplayMode mode;
+  if (!s_runtime_config["VSync"].ValueAs<bool>() || SDL_GetWindowDisplayMode(s_window, &mode) != 0 || mode.refresh_rate <= 0)
+    return false;
+  return std::fabs(double(mode.refresh_rate) - refreshRate) <= 1.0;
 }
 
 /******************************************************************************
@@ -833,12 +868,26 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
 {         
 #endif // SUPERMODEL_DEBUGGER
   std::string initialState = s_runtime_config["InitStateFile"].ValueAs<std::string>();
+  std::string recordFile = s_runtime_config["InputRecordFile"].ValueAs<std::string>();
+  std::string replayFile = s_runtime_config["InputReplayFile"].ValueAs<std::string>();
+  CRewindBuffer rewind(s_runtime_config);
+  CBenchmark  benchmark(s_runtime_config);
+  CFramePacer pacer(s_runtime_config["RefreshRate"].ValueAs<double>());
+  Util::Config::Handle<bool> throttle(s_runtime_config["Throttle"]);
+  Util::Config::Handle<bool> showFrameRate(s_runtime_config["ShowFrameRate"]);
+  PROFILE_THREAD("Main");
   unsigned    prevFPSTicks;
   unsigned    fpsFramesElapsed;
   bool        gameHasLightguns = false;
   bool        quit = false;
   bool        paused = false;
   bool        dumpTimings = false;
+  bool        showStats = false;
+  unsigned    statsInterval = s_runtime_config["StatsInterval"].ValueAs<unsigned>();
+  unsigned    prevStatsTicks;
+  unsigned    prevStatsLogTicks;
+  Util::PerfCounters::Snapshot prevStats;
+  Util::PerfCounters::Snapshot prevStatsLog;
 
   // Initialize and load ROMs
   if (OKAY != Model3->Init())
@@ -867,9 +916,12 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
   // Info log GL information 
   PrintGLInfo(false, true, false);
   
-  // Initialize audio system
-  if (OKAY != OpenAudio())
+  // Initialize audio system (benchmarks run silently)
+  if (OKAY != OpenAudio(s_runtime_config))
     return 1;
+  if (benchmark.IsEnabled())
+    SetAudioEnabled(false);
+  renderingEnabled = !benchmark.IsEnabled() || s_runtime_config["BenchmarkRender"].ValueAs<bool>();
 
   // Hide mouse if fullscreen, enable crosshairs for gun games
   Inputs->GetInputSystem()->SetMouseVisibility(!s_runtime_config["FullScreen"].ValueAs<bool>());
@@ -900,10 +952,24 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
   // Reset emulator
   Model3->Reset();
   
+  // Replay inputs from the save state they were recorded from, unless another was given
+  if (!replayFile.empty())
+  {
+    std::string recordedState;
+    if (!Inputs->StartReplay(replayFile, game, &recordedState))
+      goto QuitError;
+    if (initialState.empty())
+      initialState = recordedState;
+  }
+  
   // Load initial save state if requested
   if (initialState.length() > 0)
     LoadState(Model3, initialState);
   
+  // Record inputs from here on
+  if (!recordFile.empty() && !Inputs->StartRecording(recordFile, game, initialState))
+    goto QuitError;
+  
 #ifdef SUPERMODEL_DEBUGGER
   // If debugger was supplied, set it as logger and attach it to system
   oldLogger = GetLogger();
@@ -920,6 +986,11 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
   quit = false;
   paused = false;
   dumpTimings = false;
+  pacer.SetVSyncLocked(IsVSyncLocked(pacer.GetRefreshRate()));
+  pacer.Reset();
+  Util::PerfCounters::SetEnabled(statsInterval > 0);
+  Util::PerfCounters::Take(&prevStatsLog);
+  prevStatsLogTicks = prevFPSTicks;
 #ifdef DEBUG
   if (dynamic_cast<CModel3GraphicsState *>(Model3))
   {
@@ -929,7 +1000,8 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
 #endif
   while (!quit)
   {
-    auto startTime = SDL_GetTicks();
+    PROFILE_SCOPE("Main loop");
+    Uint64 startCounter = SDL_GetPerformanceCounter();
 
     // Render if paused, otherwise run a frame
     if (paused)
@@ -938,7 +1010,7 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
       Model3->RunFrame();
     
     // Poll the inputs
-    if (!Inputs->Poll(&game, xOffset, yOffset, xRes, yRes))
+    if (!Inputs->Poll(&game, xOffset, yOffset, xRes, yRes, !paused))
       quit = true;
     
 #ifdef SUPERMODEL_DEBUGGER
@@ -979,6 +1051,8 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
 
       // Reset emulator
       Model3->Reset();
+      StopInputRecording(Inputs, "reset");
+      rewind.Clear();  // snapshots taken before the reset no longer apply
       
 #ifdef SUPERMODEL_DEBUGGER
       // If debugger was supplied, reset it too
@@ -1036,6 +1110,10 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
       if (OKAY != ResizeGLScreen(&xOffset,&yOffset,&xRes,&yRes,&totalXRes,&totalYRes,!stretch,fullscreen))
         goto QuitError;
 
+      // The display mode may have changed, so decide again whether vsync paces frames
+      pacer.SetVSyncLocked(IsVSyncLocked(pacer.GetRefreshRate()));
+      pacer.Reset();
+
       // Recreate renderers and attach to the emulator
       Render2D = new CRender2D(s_runtime_config);
       Render3D = s_runtime_config["New3DEngine"].ValueAs<bool>() ? ((IRender3D *) new New3D::CNew3D(s_runtime_config, Model3->GetGame().name)) : ((IRender3D *) new Legacy3D::CLegacy3D(s_runtime_config));
@@ -1081,6 +1159,8 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
 
       // Load game state
       LoadState(Model3);
+      StopInputRecording(Inputs, "state load");
+      rewind.Clear();
             
 #ifdef SUPERMODEL_DEBUGGER
       // If debugger was supplied, reset it after loading state
@@ -1159,6 +1239,16 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
       dumpTimings = !dumpTimings;
     }
 #endif
+    else if (Inputs->uiShowStats->Pressed())
+    {
+      // Toggle performance counters in window title
+      showStats = !showStats;
+      Util::PerfCounters::SetEnabled(showStats || statsInterval > 0);
+      Util::PerfCounters::Take(&prevStats);
+      prevStatsTicks = SDL_GetTicks();
+      if (!showStats)
+        SDL_SetWindowTitle(s_window, baseTitleStr);
+    }
     else if (Inputs->uiSelectCrosshairs->Pressed() && gameHasLightguns)
     {
       int crosshairs = (s_runtime_config["Crosshairs"].ValueAs<unsigned>() + 1) & 3;
@@ -1182,6 +1272,7 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
       // Toggle frame limiting
       s_runtime_config.Get("Throttle").SetValue(!s_runtime_config["Throttle"].ValueAs<bool>());
       printf("Frame limiting: %s\n", s_runtime_config["Throttle"].ValueAs<bool>() ? "On" : "Off");
+      pacer.Reset();
     }
 #ifdef SUPERMODEL_DEBUGGER
       else if (Debugger != NULL && Inputs->uiEnterDebugger->Pressed())
@@ -1191,11 +1282,36 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
       }
     }
 #endif // SUPERMODEL_DEBUGGER
+
+    // Step back through snapshots while rewind is held, otherwise take them periodically
+    if (rewind.IsEnabled() && !paused)
+    {
+      if (Inputs->uiRewind->value)
+      {
+        Model3->PauseThreads();
+        bool rewound = OKAY == rewind.Rewind(Model3);
+        Model3->ResumeThreads();
+        if (rewound)
+          StopInputRecording(Inputs, "rewind");
+#ifdef SUPERMODEL_DEBUGGER
+        if (rewound && Debugger != NULL)
+          Debugger->Reset();
+#else
+        (void) rewound;
+#endif // SUPERMODEL_DEBUGGER
+      }
+      else if (rewind.CaptureDue())
+      {
+        Model3->PauseThreads();
+        rewind.Capture(Model3);
+        Model3->ResumeThreads();
+      }
+    }
     
     
     // Frame rate and limiting
     unsigned currentFPSTicks = SDL_GetTicks();
-    if (s_runtime_config["ShowFrameRate"].ValueAs<bool>())
+    if (showFrameRate.Get() && !showStats)
     {
       ++fpsFramesElapsed;
       if((currentFPSTicks-prevFPSTicks) >= 1000)  // update FPS every 1 second (each tick is 1 ms)
@@ -1207,16 +1323,8 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
       }
     }
     
-    if (paused || s_runtime_config["Throttle"].ValueAs<bool>())
-    {
-        UINT32 endTime    = SDL_GetTicks();
-        UINT32 diff     = endTime - startTime;
-        UINT32 frameTime  = (UINT32)(1000 / 60.f);    // 60 fps, we could roll with 57.5? that would be a jerk fest on 60hz screens though
-
-        if (diff < frameTime) {
-            SuperSleep(frameTime - diff);
-        }
-    }
+    if (!benchmark.IsEnabled() && (paused || throttle.Get()))
+      pacer.Wait();
 
     if (dumpTimings && !paused)
     {
@@ -1224,10 +1332,56 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
       if (M)
         M->DumpTimings();
     }
+
+    // Performance counters (window title every second, log at the requested interval)
+    if (Util::PerfCounters::IsEnabled() && !paused)
+    {
+      Util::PerfCounters::Add(Util::PerfCounters::Frames);
+      if (showStats && (currentFPSTicks - prevStatsTicks) >= 1000)
+      {
+        Util::PerfCounters::Snapshot stats;
+        Util::PerfCounters::Take(&stats);
+        std::string summary = Util::PerfCounters::Summarize(prevStats, stats, (currentFPSTicks - prevStatsTicks) / 1000.0, false);
+        SDL_SetWindowTitle(s_window, (std::string(baseTitleStr) + " - " + summary).c_str());
+        prevStats = stats;
+        prevStatsTicks = currentFPSTicks;
+      }
+      if (statsInterval > 0 && (currentFPSTicks - prevStatsLogTicks) >= statsInterval * 1000)
+      {
+        Util::PerfCounters::Snapshot stats;
+        Util::PerfCounters::Take(&stats);
+        InfoLog("Stats: %s", Util::PerfCounters::Summarize(prevStatsLog, stats, (currentFPSTicks - prevStatsLogTicks) / 1000.0, true).c_str());
+        prevStatsLog = stats;
+        prevStatsLogTicks = currentFPSTicks;
+      }
+    }
+
+    // Record frame timings and stop after the requested number of frames
+    if (benchmark.IsEnabled() && !paused)
+    {
+      CModel3 *M = dynamic_cast<CModel3 *>(Model3);
+      double frameMicroseconds = double(SDL_GetPerformanceCounter() - startCounter) * 1e6 / double(SDL_GetPerformanceFrequency());
+      benchmark.AddFrame(M ? M->GetTimings() : FrameTimings(), frameMicroseconds);
+      if (benchmark.IsFinished())
+        quit = true;
+    }
   }
 
   // Make sure all threads are paused before shutting down
   Model3->PauseThreads();   
+  Inputs->StopRecording();
+  
+  if (benchmark.IsEnabled())
+    benchmark.WriteReport(game.name);
+  
+#ifdef SUPERMODEL_PROFILER
+  // Export profile of the last few seconds
+  {
+    std::string traceFile = s_runtime_config["ProfileTraceFile"].ValueAs<std::string>();
+    if (!traceFile.empty() && Util::Profiler::WriteChromeTrace(traceFile))
+      ErrorLog("Unable to write profiler trace to '%s'.", traceFile.c_str());
+  }
+#endif // SUPERMODEL_PROFILER
   
 #ifdef SUPERMODEL_DEBUGGER
   // If debugger was supplied, detach it from system and restore old logger
@@ -1238,8 +1392,9 @@ int Supermodel(const Game &game, ROMSet *rom_set, IEmulator *Model3, CInputs *In
   }
 #endif // SUPERMODEL_DEBUGGER
   
-  // Save NVRAM
+  // Save NVRAM and finish writing any save state
   SaveNVRAM(Model3);
+  s_stateWriter.Wait();
   
   // Close audio
   CloseAudio();
@@ -1355,11 +1510,26 @@ static Util::Config::Node DefaultConfig()
 {
   Util::Config::Node config("Global");
   config.Set("GameXMLFile", s_gameXMLFilePath);
+  config.Set("LogLevel", "");
   config.Set("InitStateFile", "");
+  config.Set("InputRecordFile", "");
+  config.Set("InputReplayFile", "");
+  config.Set("RewindBufferSize", "0");
+  config.Set("RewindInterval", "5");
+  config.Set("Benchmark", "0");
+  config.Set("BenchmarkOutput", "");
+  config.Set("BenchmarkRender", true);
+#ifdef SUPERMODEL_PROFILER
+  config.Set("ProfileTraceFile", "");
+#endif
+  config.Set("StatsInterval", "0");
   // CModel3
   config.Set("MultiThreaded", true);
   config.Set("GPUMultiThreaded", true);
   config.Set("PowerPCFrequency", "50");
+  config.Set("ROMCache", false);
+  config.Set("HugePages", false);
+  config.Set("AudioPullMode", true);
   // 2D and 3D graphics engines
   config.Set("MultiTexture", false);
   config.Set("VertexShader", "");
@@ -1375,6 +1545,8 @@ static Util::Config::Node DefaultConfig()
   config.Set("EmulateDSB", true);
   config.Set("SoundVolume", "100");
   config.Set("MusicVolume", "100");
+  config.Set("MPEGPrefetch", true);
+  config.Set("MPEGCacheSize", "0");
   // CDriveBoard
 #ifdef SUPERMODEL_WIN32
   config.Set("ForceFeedback", false);
@@ -1389,9 +1561,13 @@ static Util::Config::Node DefaultConfig()
   config.Set("Stretch", false);
   config.Set("VSync", true);
   config.Set("Throttle", true);
+  config.Set("RefreshRate", "60");
   config.Set("ShowFrameRate", false);
   config.Set("Crosshairs", int(0));
   config.Set("FlipStereo", false);
+  config.Set("AudioSampleRate", "44100");
+  config.Set("AudioLatency", "50");
+  config.Set("DynamicAudioLatency", true);
 #ifdef SUPERMODEL_WIN32
   config.Set("InputSystem", "dinput");
   // DirectInput ForceFeedback
@@ -1404,14 +1580,20 @@ static Util::Config::Node DefaultConfig()
   config.Set("XInputConstForceThreshold", "30");
   config.Set("XInputConstForceMax", "100");
   config.Set("XInputVibrateMax", "100");
+#else
+  config.Set("InputSystem", "sdl");
+#endif
+  config.Set("InputPollInterval", "1");
 #ifdef NET_BOARD
   // NetBoard
   config.Set("EmulateNet", false);
-#endif
-#else
-  config.Set("InputSystem", "sdl");
+  config.Set("NetTransport", "udp");
+  config.Set("NetFrameDeadline", "50");
 #endif
   config.Set("Outputs", "none");
+#ifndef SUPERMODEL_WIN32
+  config.Set("OutputsName", "supermodel-outputs");
+#endif
   return config;
 }
 
@@ -1432,6 +1614,8 @@ static void Help(void)
   puts("  -?, -h, -help, --help   Print this help text");
   puts("  -print-games            List supported games and quit");
   printf("  -game-xml-file=<file>   ROM set definition file [Default: %s]\n", s_gameXMLFilePath);
+  puts("  -log-level=<level>      Lowest level of message to log: debug, info, or error");
+  puts("                          [Default: info, or debug in debug builds]");
   puts("");
   puts("Core Options:");
   printf("  -ppc-frequency=<freq>   PowerPC frequency in MHz [Default: %d]\n", defaultConfig["PowerPCFrequency"].ValueAs<unsigned>());
@@ -1439,6 +1623,12 @@ static void Help(void)
   puts("  -gpu-multi-threaded     Run graphics rendering in separate thread [Default]");
   puts("  -no-gpu-thread          Run graphics rendering in main thread");
   puts("  -load-state=<file>      Load save state after starting");
+  puts("  -rewind-buffer=<mb>     Memory for rewind snapshots, in megabytes (0 disables");
+  puts("                          rewinding) [Default: 0]");
+  printf("  -rewind-interval=<n>    Frames between rewind snapshots [Default: %d]\n", defaultConfig["RewindInterval"].ValueAs<unsigned>());
+  puts("  -rom-cache              Keep pre-processed ROM images in ROMCache/ and map");
+  puts("                          them in on subsequent launches");
+  puts("  -huge-pages             Request huge pages for PowerPC RAM and CROM");
   puts("");
   puts("Video Options:");
   puts("  -res=<x>,<y>            Resolution [Default: 496,384]");
@@ -1446,7 +1636,9 @@ static void Help(void)
   puts("  -fullscreen             Full screen mode");
   puts("  -wide-screen            Expand 3D field of view to screen width");
   puts("  -stretch                Fit viewport to resolution, ignoring aspect ratio");
-  puts("  -no-throttle            Disable 60 Hz frame rate lock");
+  puts("  -no-throttle            Disable frame rate lock");
+  puts("  -refresh-rate=<hz>      Frame rate to lock to [Default: 60]. Use 57.524 for");
+  puts("                          the actual Model 3 rate");
   puts("  -vsync                  Lock to vertical refresh rate [Default]");
   puts("  -no-vsync               Do not lock to vertical refresh rate");
   puts("  -show-fps               Display frame rate in window title bar");
@@ -1473,11 +1665,25 @@ static void Help(void)
   puts("  -flip-stereo            Swap left and right audio channels");
   puts("  -no-sound               Disable sound board emulation (sound effects)");
   puts("  -no-dsb                 Disable Digital Sound Board (MPEG music)");
+  puts("  -no-mpeg-prefetch       Decode MPEG music on sound board thread instead of");
+  puts("                          ahead of time on a separate thread");
+  puts("  -mpeg-cache=<mb>        Memory for caching decoded looping music tracks, in");
+  printf("                          MB (0 to disable) [Default: %d]\n", defaultConfig["MPEGCacheSize"].ValueAs<unsigned>());
+  puts("  -audio-sample-rate=<hz> Audio output sample rate, a multiple of 60 Hz");
+  printf("                          between 16000 and 192000 [Default: %d]\n", defaultConfig["AudioSampleRate"].ValueAs<unsigned>());
+  printf("  -audio-latency=<ms>     Minimum audio buffering latency in milliseconds [Default: %d]\n", defaultConfig["AudioLatency"].ValueAs<unsigned>());
+  puts("  -no-dynamic-latency     Keep latency fixed instead of adapting it to playback");
+  puts("  -no-audio-pull          Run sound board in step with video frames rather than");
+  puts("                          on demand of the audio device");
   puts("");
 #ifdef NET_BOARD
   puts("Net Options:");
   puts("  -no-net                 Disable net board emulation (default)");
-  puts("  -net                    Enable net board emulation (not working ATM - need -no-threads)");
+  puts("  -net                    Enable net board emulation (not working ATM)");
+  puts("  -net-transport=<t>      Link to other instances through 'udp' (default) or,");
+  puts("                          on the same machine, shared memory ('shm')");
+  puts("  -net-deadline=<ms>      Longest wait for a frame from the linked cabinet");
+  printf("                          before continuing without it [Default: %d]\n", defaultConfig["NetFrameDeadline"].ValueAs<unsigned>());
   puts("");
 #endif
   puts("Input Options:");
@@ -1487,10 +1693,38 @@ static void Help(void)
   puts("  -config-inputs          Configure keyboards, mice, and game controllers");
 #ifdef SUPERMODEL_WIN32
   printf("  -input-system=<s>       Input system [Default: %s]\n", defaultConfig["InputSystem"].ValueAs<std::string>().c_str());
-  printf("  -outputs=<s>            Outputs [Default: %s]\n", defaultConfig["Outputs"].ValueAs<std::string>().c_str());
+  printf("  -outputs=<s>            Outputs: none or win [Default: %s]\n", defaultConfig["Outputs"].ValueAs<std::string>().c_str());
+#else
+  printf("  -outputs=<s>            Outputs: none or shm (shared memory table)\n");
+  printf("                          [Default: %s]\n", defaultConfig["Outputs"].ValueAs<std::string>().c_str());
+  puts("  -outputs-name=<s>       Shared memory table name, unique to each instance");
+  printf("                          [Default: %s]\n", defaultConfig["OutputsName"].ValueAs<std::string>().c_str());
 #endif
   puts("  -print-inputs           Prints current input configuration");
+  puts("  -input-poll=<ms>        Interval at which game inputs are polled during a frame");
+  printf("                          (0 polls once per frame) [Default: %d]\n", defaultConfig["InputPollInterval"].ValueAs<unsigned>());
+  puts("  -record-inputs=<file>   Record game inputs, starting from reset or from the");
+  puts("                          state given by -load-state");
+  puts("  -replay-inputs=<file>   Replay recorded game inputs (and load the save state");
+  puts("                          they were recorded from unless -load-state is given)");
+  puts("");
+  puts("Benchmark Options:");
+  puts("  -benchmark=<n>          Run <n> frames as fast as possible without sound or");
+  puts("                          a visible window, then report frame time statistics");
+  puts("                          as JSON and quit");
+  puts("  -benchmark-output=<file> Write benchmark report to a file instead of stdout");
+  puts("  -benchmark-no-render    Skip 3D and tile map rendering while benchmarking");
+  puts("");
+  puts("Performance Counters:");
+  puts("  -stats-interval=<s>     Log performance counters every <s> seconds, or 0 to");
+  puts("                          disable [Default: 0]. Alt+S shows them in the");
+  puts("                          window title instead");
   puts("");
+#ifdef SUPERMODEL_PROFILER
+  puts("Profiler Options:");
+  puts("  -profile-trace=<file>   Write Chrome trace of most recent events on exit");
+  puts("");
+#endif // SUPERMODEL_PROFILER
 #ifdef SUPERMODEL_DEBUGGER
   puts("Debug Options:");
   puts("  -disable-debugger       Completely disable debugger functionality");
@@ -1521,8 +1755,12 @@ static ParsedCommandLine ParseCommandLine(int argc, char **argv)
   const std::map<std::string, std::string> valued_options
   { // -option=value
     { "-game-xml-file",         "GameXMLFile"             },
+    { "-log-level",             "LogLevel"                },
     { "-load-state",            "InitStateFile"           },
+    { "-record-inputs",         "InputRecordFile"         },
+    { "-replay-inputs",         "InputReplayFile"         },
     { "-ppc-frequency",         "PowerPCFrequency"        },
+    { "-refresh-rate",          "RefreshRate"             },
     { "-crosshairs",            "Crosshairs"              },
     { "-vert-shader",           "VertexShader"            },
     { "-frag-shader",           "FragmentShader"          },
@@ -1533,8 +1771,27 @@ static ParsedCommandLine ParseCommandLine(int argc, char **argv)
     { "-sound-volume",          "SoundVolume"             },
     { "-music-volume",          "MusicVolume"             },
     { "-balance",               "Balance"                 },
+    { "-audio-sample-rate",     "AudioSampleRate"         },
+    { "-audio-latency",         "AudioLatency"            },
+    { "-rewind-buffer",         "RewindBufferSize"        },
+    { "-rewind-interval",       "RewindInterval"          },
+    { "-benchmark",             "Benchmark"               },
+    { "-benchmark-output",      "BenchmarkOutput"         },
+#ifdef SUPERMODEL_PROFILER
+    { "-profile-trace",         "ProfileTraceFile"        },
+#endif
+    { "-stats-interval",        "StatsInterval"           },
+    { "-mpeg-cache",            "MPEGCacheSize"           },
+#ifdef NET_BOARD
+    { "-net-transport",         "NetTransport"            },
+    { "-net-deadline",          "NetFrameDeadline"        },
+#endif
     { "-input-system",          "InputSystem"             },
-    { "-outputs",               "Outputs"                 }
+    { "-input-poll",            "InputPollInterval"       },
+    { "-outputs",               "Outputs"                 },
+#ifndef SUPERMODEL_WIN32
+    { "-outputs-name",          "OutputsName"             },
+#endif
   };
   const std::map<std::string, std::pair<std::string, bool>> bool_options
   { // -option
@@ -1542,6 +1799,10 @@ static ParsedCommandLine ParseCommandLine(int argc, char **argv)
     { "-no-threads",          { "MultiThreaded",    false } },
     { "-gpu-multi-threaded",  { "GPUMultiThreaded", true } },
     { "-no-gpu-thread",       { "GPUMultiThreaded", false } },
+    { "-rom-cache",           { "ROMCache",         true } },
+    { "-no-rom-cache",        { "ROMCache",         false } },
+    { "-huge-pages",          { "HugePages",        true } },
+    { "-no-huge-pages",       { "HugePages",        false } },
     { "-window",              { "FullScreen",       false } },
     { "-fullscreen",          { "FullScreen",       true } },
     { "-no-wide-screen",      { "WideScreen",       false } },
@@ -1565,6 +1826,14 @@ static ParsedCommandLine ParseCommandLine(int argc, char **argv)
     { "-no-sound",            { "EmulateSound",     false } },
     { "-dsb",                 { "EmulateDSB",       true } },
     { "-no-dsb",              { "EmulateDSB",       false } },
+    { "-mpeg-prefetch",       { "MPEGPrefetch",     true } },
+    { "-no-mpeg-prefetch",    { "MPEGPrefetch",     false } },
+    { "-dynamic-latency",     { "DynamicAudioLatency", true } },
+    { "-no-dynamic-latency",  { "DynamicAudioLatency", false } },
+    { "-audio-pull",          { "AudioPullMode",    true } },
+    { "-no-audio-pull",       { "AudioPullMode",    false } },
+    { "-benchmark-render",    { "BenchmarkRender",  true } },
+    { "-benchmark-no-render", { "BenchmarkRender",  false } },
 #ifdef NET_BOARD
   { "-net",                   { "EmulateNet",       true } },
   { "-no-net",                { "EmulateNet",       false } },
@@ -1742,7 +2011,10 @@ int main(int argc, char **argv)
         PrintGameList(xml_file, loader.GetGames());
         return 0;
       }
-      if (loader.Load(&game, &rom_set, *cmd_line.rom_files.begin()))
+      // ROM data need not be inflated if its processed image is cached
+      bool useROMCache = config3["ROMCache"].ValueAs<bool>();
+      auto romsCached = [useROMCache](const Game &game, const ROMSet &rom_set) { return useROMCache && CModel3::IsROMCacheValid(game, rom_set); };
+      if (loader.Load(&game, &rom_set, *cmd_line.rom_files.begin(), romsCached))
         return 1;
       Util::Config::MergeINISections(&config4, config3, fileConfig[game.name]);   // apply game-specific config
     }
@@ -1750,6 +2022,34 @@ int main(int argc, char **argv)
       config4 = config3;
     Util::Config::MergeINISections(&s_runtime_config, config4, cmd_line.config);  // apply command line overrides once more
   }
+  {
+    std::string logLevel = s_runtime_config["LogLevel"].ValueAs<std::string>();
+    if (logLevel == "debug")
+      Logger.SetLevel(CFileLogger::LEVEL_DEBUG);
+    else if (logLevel == "info")
+      Logger.SetLevel(CFileLogger::LEVEL_INFO);
+    else if (logLevel == "error")
+      Logger.SetLevel(CFileLogger::LEVEL_ERROR);
+    else if (!logLevel.empty())
+      ErrorLog("Invalid log level '%s'. Must be debug, info, or error.", logLevel.c_str());
+  }
+  {
+    // Output rate must yield a whole number of samples per frame
+    unsigned sampleRate = s_runtime_config["AudioSampleRate"].ValueAs<unsigned>();
+    if (sampleRate < 16000 || sampleRate > 192000 || (sampleRate % 60) != 0)
+    {
+      ErrorLog("Audio sample rate must be a multiple of 60 Hz between 16000 and 192000. Using 44100.");
+      s_runtime_config.Get("AudioSampleRate").SetValue(44100);
+    }
+  }
+  if (s_runtime_config["Benchmark"].ValueAs<unsigned>() > 0)
+  {
+    // Run unthrottled and keep the sound board in step with video frames
+    // rather than with the audio device, so that runs are repeatable
+    s_runtime_config.Get("Throttle").SetValue(false);
+    s_runtime_config.Get("VSync").SetValue(false);
+    s_runtime_config.Get("AudioPullMode").SetValue(false);
+  }
   LogConfig(s_runtime_config);
   std::string selectedInputSystem = s_runtime_config["InputSystem"].ValueAs<std::string>();
 
@@ -1832,13 +2132,17 @@ int main(int argc, char **argv)
     goto Exit;
 
   // Create outputs 
-#ifdef SUPERMODEL_WIN32
   {
     std::string outputs = s_runtime_config["Outputs"].ValueAs<std::string>();
     if (outputs == "none")
       Outputs = NULL;
+#ifdef SUPERMODEL_WIN32
     else if (outputs == "win")
       Outputs = new CWinOutputs();
+#else
+    else if (outputs == "shm")
+      Outputs = new CShmOutputs(s_runtime_config["OutputsName"].ValueAs<std::string>());
+#endif // SUPERMODEL_WIN32
     else
     {
       ErrorLog("Unknown outputs: %s\n", outputs.c_str());
@@ -1846,7 +2150,6 @@ int main(int argc, char **argv)
       goto Exit;
     }
   }
-#endif // SUPERMODEL_WIN32
 
   // Initialize outputs
   if (Outputs != NULL && !Outputs->Initialize())
@@ -172,6 +172,8 @@ CSDLInputSystem::CSDLInputSystem()
     m_mouseX(0),
     m_mouseY(0),
     m_mouseZ(0),
+    m_mouseWheelDir(0),
+    m_frameWheelDir(0),
     m_mouseButtons(0)
 {
   //
@@ -373,10 +375,10 @@ const JoyDetails *CSDLInputSystem::GetJoyDetails(int joyNum)
   return &m_joyDetails[joyNum];
 }
 
-bool CSDLInputSystem::Poll()
+bool CSDLInputSystem::Poll(bool midFrame)
 {
-  // Reset mouse wheel direction
-  m_mouseWheelDir = 0;
+  // Direction of any mouse wheel movement since last poll
+  short wheelDir = 0;
 
   // Poll for event from SDL
   SDL_Event e;
@@ -392,16 +394,17 @@ bool CSDLInputSystem::Poll()
 			if (e.button.y > 0)
 			{
 				m_mouseZ += 5;
-				m_mouseWheelDir = 1;
+				wheelDir = 1;
 			}
 			else if (e.button.y < 0)
 			{
 				m_mouseZ -= 5;
-				m_mouseWheelDir = -1;
+				wheelDir = -1;
 			}
 			break;
 		}
   }
+  UpdateWheelDir(wheelDir, midFrame, m_mouseWheelDir, m_frameWheelDir);
 
   // Get key state from SDL
   m_keyState = SDL_GetKeyboardState(nullptr);
@@ -72,6 +72,7 @@ private:
 	int m_mouseY;
 	int m_mouseZ;
 	short m_mouseWheelDir;
+	short m_frameWheelDir;
 	Uint8 m_mouseButtons;
 
 	/* 
@@ -130,7 +131,7 @@ public:
 
 	const JoyDetails *GetJoyDetails(int joyNum);
 
-	bool Poll();
+	bool Poll(bool midFrame);
 
 	void SetMouseVisibility(bool visible);
 };
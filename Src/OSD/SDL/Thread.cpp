@@ -159,6 +159,13 @@ bool CCondVar::Wait(CMutex *mutex)
 	return SDL_CondWait((SDL_cond*)m_impl, (SDL_mutex*)mutex->m_impl) == 0;
 }
 
+bool CCondVar::Wait(CMutex *mutex, UINT32 ms, bool *timedOut)
+{
+	int result = SDL_CondWaitTimeout((SDL_cond*)m_impl, (SDL_mutex*)mutex->m_impl, ms);
+	*timedOut = result == SDL_MUTEX_TIMEDOUT;
+	return result >= 0;
+}
+
 bool CCondVar::Signal()
 {
 	return SDL_CondSignal((SDL_cond*)m_impl) == 0;
@@ -189,6 +189,13 @@ public:
 	 */
 	bool Wait(CMutex *mutex);
 
+	/*
+	 * Wait
+	 *
+	 * As above but gives up after the given number of milliseconds, in which case timedOut is set to true.
+	 */
+	bool Wait(CMutex *mutex, UINT32 ms, bool *timedOut);
+
 	/*
 	 * Signal
 	 *
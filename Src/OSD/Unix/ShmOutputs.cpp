@@ -0,0 +1,150 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+ 
+/*
+ * ShmOutputs.cpp
+ */
+
+#include "Supermodel.h"
+#include "OSD/Unix/ShmOutputs.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+CShmOutputs::CShmOutputs(const std::string &name)
+	: m_name("/" + name),
+	  m_table(NULL)
+{
+	//
+}
+
+CShmOutputs::~CShmOutputs()
+{
+	// The table is left in place so that readers need not reopen it when the
+	// emulator is restarted; they can tell it has exited from pid
+	if (m_table)
+	{
+		BeginUpdate();
+		m_table->pid = 0;
+		EndUpdate();
+		munmap(m_table, sizeof(SharedOutputTable));
+	}
+}
+
+bool CShmOutputs::Initialize()
+{
+	const char *name = m_name.c_str();
+	int fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+	if (fd < 0)
+	{
+		ErrorLog("Unable to create shared memory outputs table '%s'.", name);
+		return false;
+	}
+	if (ftruncate(fd, sizeof(SharedOutputTable)) != 0)
+	{
+		close(fd);
+		ErrorLog("Unable to size shared memory outputs table '%s'.", name);
+		return false;
+	}
+	void *mapping = mmap(NULL, sizeof(SharedOutputTable), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		ErrorLog("Unable to map shared memory outputs table '%s'.", name);
+		return false;
+	}
+
+	// Refuse to take over a table that another running instance is publishing to
+	SharedOutputTable *table = (SharedOutputTable *)mapping;
+	pid_t owner = table->magic == SharedOutputTable::MAGIC ? table->pid : 0;
+	if (owner > 0 && owner != getpid() && (kill(owner, 0) == 0 || errno == EPERM))
+	{
+		munmap(mapping, sizeof(SharedOutputTable));
+		ErrorLog("Shared memory outputs table '%s' is in use by process %d. Use -outputs-name to choose another.", name, (int)owner);
+		return false;
+	}
+	m_table = table;
+
+	// Readers may still have the table mapped from a previous run, so it is
+	// reinitialized as an update (completing any left unfinished by a crash)
+	if (m_table->sequence.load() & 1)
+		m_table->sequence++;
+	BeginUpdate();
+	m_table->magic = SharedOutputTable::MAGIC;
+	m_table->version = SharedOutputTable::VERSION;
+	m_table->numOutputs = NUM_OUTPUTS;
+	m_table->pid = getpid();
+	memset(m_table->game, 0, sizeof(m_table->game));
+	for (unsigned i = 0; i < SharedOutputTable::MAX_OUTPUTS; i++)
+		m_table->values[i].store(0, std::memory_order_relaxed);
+	EndUpdate();
+	return true;
+}
+
+void CShmOutputs::Attached()
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+	BeginUpdate();
+	strncpy(m_table->game, GetGame().name.c_str(), sizeof(m_table->game) - 1);
+	EndUpdate();
+}
+
+void CShmOutputs::SendOutput(EOutputs output, UINT8 prevValue, UINT8 value)
+{
+	std::lock_guard<std::mutex> lock(m_writeLock);
+	BeginUpdate();
+	m_table->values[output].store(value, std::memory_order_relaxed);
+	EndUpdate();
+}
+
+void CShmOutputs::BeginUpdate()
+{
+	UINT32 seq = m_table->sequence.load(std::memory_order_relaxed);
+	m_table->sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+void CShmOutputs::EndUpdate()
+{
+	// Sequentially consistent so that a reader setting notifyRequested either
+	// sees the new sequence or is seen by the check below
+	UINT32 seq = m_table->sequence.load(std::memory_order_relaxed);
+	m_table->sequence.store(seq + 1);
+	m_table->updates.fetch_add(1, std::memory_order_relaxed);
+
+	// Only wake readers that asked for it (not FUTEX_PRIVATE_FLAG: they are
+	// other processes). Elsewhere, readers poll.
+#ifdef __linux__
+	if (m_table->notifyRequested.load() && m_table->notifyRequested.exchange(0))
+		syscall(SYS_futex, reinterpret_cast<UINT32 *>(&m_table->sequence), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
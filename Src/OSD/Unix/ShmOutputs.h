@@ -0,0 +1,130 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+ 
+/*
+ * ShmOutputs.h
+ *
+ * Implementation of COutputs that publishes the outputs in a shared memory
+ * table for external cabinet I/O programs.
+ */
+
+#ifndef INCLUDED_SHMOUTPUTS_H
+#define INCLUDED_SHMOUTPUTS_H
+
+#include "OSD/Outputs.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+/*
+ * Shared memory table layout, mapped from /dev/shm/<name> (supermodel-outputs
+ * by default, see -outputs-name).
+ *
+ * The table is protected by a sequence lock: the emulator increments
+ * sequence before and after each update, so it is odd while an update is in
+ * progress. Readers copy what they need between two reads of sequence and
+ * retry if the values differ or are odd:
+ *
+ *		do {
+ *			seq = table->sequence;			// acquire
+ *			copy values
+ *		} while ((seq & 1) || seq != table->sequence);
+ *
+ * On Linux, readers that do not want to poll can sleep on sequence itself
+ * as a process-shared futex: set notifyRequested, re-read sequence, then
+ * FUTEX_WAIT on it with the value read (not FUTEX_PRIVATE_FLAG). The emulator
+ * only issues FUTEX_WAKE when notifyRequested was set, so updates cost no
+ * system calls while nobody is waiting.
+ */
+struct SharedOutputTable
+{
+	static const UINT32 MAGIC = 0x544F4D53;	// "SMOT"
+	static const UINT32 VERSION = 2;			// layout version
+	static const unsigned MAX_OUTPUTS = 64;
+
+	UINT32				magic;
+	UINT32				version;
+	UINT32				numOutputs;			// valid entries in values[]
+	INT32				pid;				// emulator process, 0 once it has exited
+	std::atomic<UINT32>	notifyRequested;	// set by readers, cleared by emulator when it wakes them
+	std::atomic<UINT32>	sequence;			// sequence lock and futex word
+	std::atomic<UINT64>	updates;			// number of updates published
+	char				game[64];			// short name of running game (NUL-terminated)
+	std::atomic<UINT8>	values[MAX_OUTPUTS];	// indexed by EOutputs
+};
+
+static_assert(NUM_OUTPUTS <= SharedOutputTable::MAX_OUTPUTS, "SharedOutputTable::values[] is too small for EOutputs");
+
+// Atomics shared with another process must not fall back on a lock private to this one
+static_assert(ATOMIC_CHAR_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory outputs require lock-free atomics");
+static_assert(sizeof(std::atomic<UINT32>) == sizeof(UINT32), "Futex word must be a plain 32-bit integer");
+
+class CShmOutputs : public COutputs
+{
+public:
+	/*
+	 * CShmOutputs(name):
+	 * ~CShmOutputs():
+	 *
+	 * Constructor and destructor.
+	 *
+	 * Parameters:
+	 *		name	Name of the shared memory object (without the leading '/').
+	 *				Separate instances must use different names.
+	 */
+	CShmOutputs(const std::string &name);
+
+	virtual ~CShmOutputs();
+
+	/*
+	 * Initialize():
+	 *
+	 * Creates and maps the shared memory table.
+	 */
+	bool Initialize();
+
+	/*
+	 * Attached():
+	 *
+	 * Publishes the name of the running game.
+	 */
+	void Attached();
+
+protected:
+	/*
+	 * SendOutput():
+	 *
+	 * Stores the new value in the table.
+	 */
+	void SendOutput(EOutputs output, UINT8 prevValue, UINT8 value);
+
+private:
+	std::string			m_name;
+	SharedOutputTable	*m_table;
+	std::mutex			m_writeLock;	// outputs are set from both the emulation and main threads
+
+	void BeginUpdate();
+	void EndUpdate();
+};
+
+#endif	// INCLUDED_SHMOUTPUTS_H
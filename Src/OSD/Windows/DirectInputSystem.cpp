@@ -776,28 +776,19 @@ void CDirectInputSystem::ActivateKeyboardsAndMice()
 	}
 }
 
-void CDirectInputSystem::PollKeyboardsAndMice()
+void CDirectInputSystem::PollKeyboardsAndMice(bool midFrame)
 {
 	if (m_useRawInput)
 	{
 		// For RawInput, only thing to do is update wheelDir from wheelData for each mouse state.  Everything else is updated via WM events.
 		for (vector<RawMseState>::iterator it = m_rawMseStates.begin(); it != m_rawMseStates.end(); it++)
 		{
-			if (it->wheelDelta != 0)
-			{
-				it->wheelDir = (it->wheelDelta > 0 ? 1 : -1);
-				it->wheelDelta = 0;
-			}
-			else
-				it->wheelDir = 0;
+			UpdateWheelDir(it->wheelDelta != 0 ? (it->wheelDelta > 0 ? 1 : -1) : 0, midFrame, it->wheelDir, it->frameWheelDir);
+			it->wheelDelta = 0;
 		}
-		if (m_combRawMseState.wheelDelta != 0)
-		{
-			m_combRawMseState.wheelDir = (m_combRawMseState.wheelDelta > 0 ? 1 : -1);
-			m_combRawMseState.wheelDelta = 0;
-		}
-		else
-			m_combRawMseState.wheelDir = 0;
+		SHORT combWheelDir = (m_combRawMseState.wheelDelta != 0 ? (m_combRawMseState.wheelDelta > 0 ? 1 : -1) : 0);
+		UpdateWheelDir(combWheelDir, midFrame, m_combRawMseState.wheelDir, m_combRawMseState.frameWheelDir);
+		m_combRawMseState.wheelDelta = 0;
 		return;
 	}
 
@@ -837,15 +828,15 @@ void CDirectInputSystem::PollKeyboardsAndMice()
 		m_di8Mouse->GetDeviceState(sizeof(mseState), &mseState);
 		m_diMseState.x = CInputSource::Clamp(m_diMseState.x + mseState.lX, m_dispX, m_dispX + m_dispW);
 		m_diMseState.y = CInputSource::Clamp(m_diMseState.y + mseState.lY, m_dispY, m_dispY + m_dispH);
+		SHORT wheelDir = 0;
 		if (mseState.lZ != 0)
 		{
 			// Z-axis is clamped to range -100 to 100 (DirectInput returns +120 & -120 for wheel delta which are scaled to +5 & -5)
 			LONG wheelDelta = 5 * mseState.lZ / 120;
 			m_diMseState.z = CInputSource::Clamp(m_diMseState.z + wheelDelta, -100, 100);
-			m_diMseState.wheelDir = (wheelDelta > 0 ? 1 : -1);
+			wheelDir = (wheelDelta > 0 ? 1 : -1);
 		}
-		else
-			m_diMseState.wheelDir = 0;
+		UpdateWheelDir(wheelDir, midFrame, m_diMseState.wheelDir, m_diMseState.frameWheelDir);
 		memcpy(&m_diMseState.buttons, mseState.rgbButtons, sizeof(m_diMseState.buttons));
 	}
 }
@@ -2043,7 +2034,7 @@ const JoyDetails *CDirectInputSystem::GetJoyDetails(int joyNum)
 	return &m_joyDetails[joyNum];
 }
 
-bool CDirectInputSystem::Poll()
+bool CDirectInputSystem::Poll(bool midFrame)
 {
 	// See if keyboard, mice and joysticks have been activated yet
 	if (!m_activated)
@@ -2116,7 +2107,7 @@ bool CDirectInputSystem::Poll()
 	}
 
 	// Poll keyboards, mice and joysticks
-	PollKeyboardsAndMice();
+	PollKeyboardsAndMice(midFrame);
 	PollJoysticks();
 
 	return true;
@@ -65,6 +65,7 @@ struct RawMseState
 	LONG z;
 	LONG wheelDelta;
 	SHORT wheelDir;
+	SHORT frameWheelDir;
 	USHORT buttons;
 };
 
@@ -74,6 +75,7 @@ struct DIMseState
 	LONG y;
 	LONG z;
 	SHORT wheelDir;
+	SHORT frameWheelDir;
 	BYTE buttons[5];
 };
 
@@ -175,7 +177,7 @@ private:
 
 	void ActivateKeyboardsAndMice();
 
-	void PollKeyboardsAndMice();
+	void PollKeyboardsAndMice(bool midFrame);
 
 	void CloseKeyboardsAndMice();
 
@@ -254,7 +256,7 @@ public:
 
 	const JoyDetails *GetJoyDetails(int joyNum);
 
-	bool Poll();
+	bool Poll(bool midFrame);
 
 	void GrabMouse();
 
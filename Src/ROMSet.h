@@ -33,6 +33,8 @@ struct ROM
 struct ROMSet
 {
   std::map<std::string, ROM> rom_by_region;
+  uint64_t fingerprint = 0; // hash of ROM contents (CRCs), layout, and patches
+  bool data_loaded = false; // false if only region sizes were loaded
   
   ROM get_rom(const std::string &region) const;
 };
@@ -0,0 +1,226 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * RewindBuffer.cpp
+ *
+ * In-memory save state ring. Implementation of the CRewindBuffer class.
+ *
+ * Delta Format
+ * ------------
+ *
+ * Snapshots are compared as arrays of 64-bit words (the shorter one being
+ * zero-extended). A delta is a sequence of runs, each consisting of:
+ *
+ *    skip    (varint)  Number of words that are identical.
+ *    count   (varint)  Number of words that differ.
+ *    words   ...       XOR of the differing words (count * 8 bytes).
+ *
+ * XOR'ing a delta into a snapshot yields its predecessor, so the ring can be
+ * walked backwards from the most recent (complete) snapshot.
+ */
+
+#include "Supermodel.h"
+#include "RewindBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+static const char REWIND_STATE_BLOCK[] = "Supermodel Rewind State";
+
+static inline uint64_t LoadWord(const uint8_t *p)
+{
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+static inline void StoreWord(uint8_t *p, uint64_t word)
+{
+  memcpy(p, &word, sizeof(word));
+}
+
+static void PutVarint(std::vector<uint8_t> *out, size_t value)
+{
+  while (value >= 0x80)
+  {
+    out->push_back(uint8_t(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(uint8_t(value));
+}
+
+static size_t GetVarint(const uint8_t **p)
+{
+  size_t value = 0;
+  unsigned shift = 0;
+  uint8_t byte;
+  do
+  {
+    byte = *(*p)++;
+    value |= size_t(byte & 0x7F) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return value;
+}
+
+static inline size_t PaddedSize(size_t size)
+{
+  return (size + 7) & ~size_t(7);
+}
+
+void CRewindBuffer::EncodeDelta(Delta *delta, std::vector<uint8_t> *prev, size_t prevSize, std::vector<uint8_t> *next)
+{
+  // Compare over the longer of the two, zero-extending the other
+  size_t nextPadded = next->size();
+  size_t numWords = std::max(prev->size(), next->size()) / 8;
+  prev->resize(numWords * 8);
+  next->resize(numWords * 8);
+
+  delta->size = uint32_t(prevSize);
+  delta->numWords = numWords;
+  delta->data.clear();
+  const uint8_t *a = prev->data();
+  const uint8_t *b = next->data();
+  size_t i = 0;
+  while (i < numWords)
+  {
+    size_t skipStart = i;
+    while (i < numWords && LoadWord(&a[i * 8]) == LoadWord(&b[i * 8]))
+      i++;
+    size_t diffStart = i;
+    while (i < numWords && LoadWord(&a[i * 8]) != LoadWord(&b[i * 8]))
+      i++;
+    PutVarint(&delta->data, diffStart - skipStart);
+    PutVarint(&delta->data, i - diffStart);
+    size_t offset = delta->data.size();
+    delta->data.resize(offset + (i - diffStart) * 8);
+    for (size_t j = diffStart; j < i; j++, offset += 8)
+      StoreWord(&delta->data[offset], LoadWord(&a[j * 8]) ^ LoadWord(&b[j * 8]));
+  }
+  delta->data.shrink_to_fit();
+
+  next->resize(nextPadded);
+}
+
+void CRewindBuffer::ApplyDelta(std::vector<uint8_t> *state, const Delta &delta)
+{
+  state->resize(delta.numWords * 8);
+  uint8_t *s = state->data();
+  const uint8_t *p = delta.data.data();
+  const uint8_t *end = p + delta.data.size();
+  size_t i = 0;
+  while (p < end)
+  {
+    i += GetVarint(&p);
+    size_t count = GetVarint(&p);
+    for (size_t j = 0; j < count; j++, i++, p += 8)
+      StoreWord(&s[i * 8], LoadWord(&s[i * 8]) ^ LoadWord(p));
+  }
+  state->resize(PaddedSize(delta.size));
+}
+
+void CRewindBuffer::TrimToBudget(void)
+{
+  while (!m_deltas.empty() && m_deltaBytes + m_current.size() > m_budget)
+  {
+    m_deltaBytes -= m_deltas.front().data.size();
+    m_deltas.pop_front();
+  }
+}
+
+bool CRewindBuffer::IsEnabled(void) const
+{
+  return m_budget != 0;
+}
+
+bool CRewindBuffer::CaptureDue(void)
+{
+  if (!IsEnabled())
+    return false;
+  if (++m_frameCounter < m_interval)
+    return false;
+  m_frameCounter = 0;
+  return true;
+}
+
+void CRewindBuffer::Capture(IEmulator *emulator)
+{
+  CBlockFile state;
+  state.Create(&m_scratch, REWIND_STATE_BLOCK, "Supermodel Version " SUPERMODEL_VERSION);
+  emulator->SaveState(&state);
+  state.Close();
+  size_t size = m_scratch.size();
+  m_scratch.resize(PaddedSize(size));
+
+  // Previous snapshot is kept as a delta against this one
+  if (m_currentSize)
+  {
+    Delta delta;
+    EncodeDelta(&delta, &m_current, m_currentSize, &m_scratch);
+    m_deltaBytes += delta.data.size();
+    m_deltas.push_back(std::move(delta));
+  }
+  m_current.swap(m_scratch);
+  m_currentSize = size;
+  TrimToBudget();
+}
+
+bool CRewindBuffer::Rewind(IEmulator *emulator)
+{
+  if (!m_currentSize)
+    return FAIL;
+  CBlockFile state;
+  state.Load(m_current.data(), m_currentSize);
+  if (OKAY != state.FindBlock(REWIND_STATE_BLOCK))
+    return FAIL;
+  emulator->LoadState(&state);
+  state.Close();
+
+  // Step back to the previous snapshot
+  if (!m_deltas.empty())
+  {
+    ApplyDelta(&m_current, m_deltas.back());
+    m_currentSize = m_deltas.back().size;
+    m_deltaBytes -= m_deltas.back().data.size();
+    m_deltas.pop_back();
+  }
+  m_frameCounter = 0;
+  return OKAY;
+}
+
+void CRewindBuffer::Clear(void)
+{
+  m_deltas.clear();
+  m_deltaBytes = 0;
+  m_current.clear();
+  m_currentSize = 0;
+  m_frameCounter = 0;
+}
+
+CRewindBuffer::CRewindBuffer(const Util::Config::Node &config)
+  : m_budget(size_t(config["RewindBufferSize"].ValueAsDefault<unsigned>(0)) * 0x100000),
+    m_interval(std::max(1u, config["RewindInterval"].ValueAsDefault<unsigned>(5))),
+    m_frameCounter(0),
+    m_deltaBytes(0),
+    m_currentSize(0)
+{
+}
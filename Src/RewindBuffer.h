@@ -0,0 +1,136 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * RewindBuffer.h
+ *
+ * Header file for the in-memory save state ring used to rewind emulation.
+ */
+
+#ifndef INCLUDED_REWINDBUFFER_H
+#define INCLUDED_REWINDBUFFER_H
+
+#include "Util/NewConfig.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class IEmulator;
+
+/*
+ * CRewindBuffer:
+ *
+ * Captures a save state into memory every few frames. Only the most recent
+ * snapshot is kept whole; each older one is stored as the difference (XOR)
+ * between it and its successor with runs of unchanged 64-bit words removed.
+ * Since most of the machine state (RAM, culling RAM, texture RAM, etc.)
+ * changes little between snapshots, deltas are small and quick to produce.
+ * The oldest deltas are discarded to stay within the memory budget.
+ *
+ * The emulator's threads must be paused while capturing or rewinding.
+ */
+class CRewindBuffer
+{
+public:
+  /*
+   * IsEnabled(void):
+   *
+   * Returns:
+   *    True if rewinding is enabled (a non-zero memory budget was set).
+   */
+  bool IsEnabled(void) const;
+
+  /*
+   * CaptureDue(void):
+   *
+   * Call once per emulated frame.
+   *
+   * Returns:
+   *    True if a snapshot should be captured this frame.
+   */
+  bool CaptureDue(void);
+
+  /*
+   * Capture(emulator):
+   *
+   * Snapshots the emulator state.
+   *
+   * Parameters:
+   *    emulator  Emulator to snapshot.
+   */
+  void Capture(IEmulator *emulator);
+
+  /*
+   * Rewind(emulator):
+   *
+   * Restores the most recent snapshot and steps back so that the next call
+   * restores the one before it. Once the oldest snapshot is reached, it is
+   * restored each time.
+   *
+   * Parameters:
+   *    emulator  Emulator to restore.
+   *
+   * Returns:
+   *    OKAY if a state was restored, FAIL if there are no snapshots.
+   */
+  bool Rewind(IEmulator *emulator);
+
+  /*
+   * Clear(void):
+   *
+   * Discards all snapshots.
+   */
+  void Clear(void);
+
+  /*
+   * CRewindBuffer(config):
+   *
+   * Constructor. Memory budget (RewindBufferSize, in MB) and capture interval
+   * (RewindInterval, in frames) are taken from the config.
+   */
+  CRewindBuffer(const Util::Config::Node &config);
+
+private:
+  // Difference between a snapshot and its successor
+  struct Delta
+  {
+    uint32_t              size;       // size of snapshot in bytes
+    size_t                numWords;   // number of 64-bit words covered by data
+    std::vector<uint8_t>  data;       // runs of unchanged and XOR'ed words
+  };
+
+  static void EncodeDelta(Delta *delta, std::vector<uint8_t> *prev, size_t prevSize, std::vector<uint8_t> *next);
+  static void ApplyDelta(std::vector<uint8_t> *state, const Delta &delta);
+  void        TrimToBudget(void);
+
+  size_t                m_budget;         // maximum memory used by snapshots (bytes)
+  unsigned              m_interval;       // frames between snapshots
+  unsigned              m_frameCounter;
+  std::deque<Delta>     m_deltas;         // oldest first
+  size_t                m_deltaBytes;     // total size of all delta data
+  std::vector<uint8_t>  m_current;        // most recent snapshot (padded to whole words)
+  size_t                m_currentSize;    // size of most recent snapshot in bytes (0 if none)
+  std::vector<uint8_t>  m_scratch;        // buffer that new snapshots are written to
+};
+
+
+#endif  // INCLUDED_REWINDBUFFER_H
@@ -1,6 +1,58 @@
+#include "Supermodel.h"
 #define MINIMP3_IMPLEMENTATION
 #include "Pkgs/minimp3.h"
 #include "MpegAudio.h"
+#include <list>
+#include <vector>
+#include <algorithm>
+
+/*
+ * Decoding is organized around whole MPEG frames. The decoder proper (Decoder)
+ * turns the frame at the current stream position into a block of PCM (Frame)
+ * and advances the position, handling the end of the stream and looping. The
+ * player side (DecodeAudio) copies PCM out of the current frame and fetches the
+ * next one when it runs dry.
+ *
+ * Without prefetching, frames are decoded on demand by the calling thread. With
+ * prefetching, a worker thread runs ahead of playback and fills a bounded ring
+ * of frames. The worker owns the decoder while it is decoding a frame; the
+ * control functions (SetMemory, UpdateMemory, SetPosition) wait for it to
+ * finish, reposition the decoder, and discard frames that were decoded ahead
+ * under the old settings. GetPosition() always reports the position of the
+ * frame being played, not that of the worker, so the DSB programs (which poll
+ * it) and save states see exactly what they would without prefetching.
+ *
+ * Looping tracks can also be kept fully decoded in a cache keyed by their
+ * location in MPEG ROM. A track is recorded the first time it is played from
+ * its loop start all the way to the end and is served from the cache on every
+ * subsequent pass.
+ */
+
+#define RING_FRAMES	16		// frames decoded ahead by worker (about 0.5 seconds at 32 KHz)
+#define FRAME_SAMPLES	(MINIMP3_MAX_SAMPLES_PER_FRAME / 2)
+
+struct Frame
+{
+	int					numSamples;		// stereo samples in frame
+	int					posAfter;		// stream position after this frame (reported by GetPosition() while it plays)
+	int16_t				left[FRAME_SAMPLES];
+	int16_t				right[FRAME_SAMPLES];
+};
+
+struct CachedTrack
+{
+	const uint8_t*		buffer;			// key: location and length of looping stream
+	int					size;
+	std::vector<int>	framePos;		// stream position of each frame
+	std::vector<int>	posAfter;		// stream position after each frame
+	std::vector<int>	pcmOffset;		// offset of each frame's samples in PCM buffers
+	std::vector<int16_t> left, right;	// decoded track
+
+	size_t Bytes() const
+	{
+		return (left.size() + right.size()) * sizeof(int16_t);
+	}
+};
 
 struct Decoder
 {
@@ -9,25 +61,354 @@ struct Decoder
 	const uint8_t*		buffer;
 	int					size, pos;
 	bool				loop;
-	bool				stopped;
-	int					numSamples;
-	int					pcmPos;
+	bool				ended;			// reached end of non-looping stream
 	short				pcm[MINIMP3_MAX_SAMPLES_PER_FRAME];
+	CachedTrack*		recording;		// track being recorded into cache (if any)
 };
 
 static Decoder dec = { 0 };
 
+// Player state
+static Frame			cur;			// frame being played
+static int				curPos;			// next sample of frame to play
+static int				position;		// stream position reported by GetPosition()
+static bool				loaded;
+static bool				stopped;
+
+// Track cache
+static std::list<CachedTrack*>	cache;	// most recently used first
+static size_t			cacheBytes;
+static size_t			cacheMaxBytes;	// 0 if disabled
+
+// Prefetch worker
+static CThread*			workerThread;
+static CMutex*			ringMutex;
+static CCondVar*		workerCond;		// signalled when worker may have something to do
+static CCondVar*		readyCond;		// signalled when worker has finished decoding a frame
+static Frame			ring[RING_FRAMES];
+static int				ringRead, ringCount;
+static bool				decoding;		// worker owns decoder
+static bool				quit;
+
+/******************************************************************************
+ Track Cache
+******************************************************************************/
+
+static void AbortRecording()
+{
+	delete dec.recording;
+	dec.recording = nullptr;
+}
+
+static void ClearCache()
+{
+	AbortRecording();
+	for (CachedTrack *track : cache)
+		delete track;
+	cache.clear();
+	cacheBytes = 0;
+}
+
+static CachedTrack *FindTrack(const uint8_t *buffer, int size)
+{
+	for (auto it = cache.begin(); it != cache.end(); ++it) {
+		if ((*it)->buffer == buffer && (*it)->size == size) {
+			cache.splice(cache.begin(), cache, it);
+			return cache.front();
+		}
+	}
+	return nullptr;
+}
+
+static void CommitRecording()
+{
+	CachedTrack *track = dec.recording;
+	dec.recording = nullptr;
+
+	// Evict least recently used tracks to make room
+	while (cacheBytes + track->Bytes() > cacheMaxBytes) {
+		cacheBytes -= cache.back()->Bytes();
+		delete cache.back();
+		cache.pop_back();
+	}
+
+	cache.push_front(track);
+	cacheBytes += track->Bytes();
+}
+
+static void RecordFrame(int framePos, const Frame *f)
+{
+	CachedTrack *track = dec.recording;
+	track->framePos.push_back(framePos);
+	track->posAfter.push_back(f->posAfter);
+	track->pcmOffset.push_back((int)track->left.size());
+	track->left.insert(track->left.end(), f->left, f->left + f->numSamples);
+	track->right.insert(track->right.end(), f->right, f->right + f->numSamples);
+
+	// Give up on tracks that will never fit
+	if (track->Bytes() > cacheMaxBytes)
+		AbortRecording();
+}
+
+static bool ServeFromCache(Frame *f)
+{
+	if (!cacheMaxBytes || !dec.loop)
+		return false;
+
+	CachedTrack *track = FindTrack(dec.buffer, dec.size);
+	if (!track)
+		return false;
+
+	auto it = std::lower_bound(track->framePos.begin(), track->framePos.end(), dec.pos);
+	if (it == track->framePos.end() || *it != dec.pos)
+		return false;	// not on a frame boundary of the recorded track
+
+	size_t i		= it - track->framePos.begin();
+	size_t end		= (i + 1 < track->pcmOffset.size()) ? track->pcmOffset[i + 1] : track->left.size();
+	f->numSamples	= (int)(end - track->pcmOffset[i]);
+	memcpy(f->left, &track->left[track->pcmOffset[i]], f->numSamples * sizeof(int16_t));
+	memcpy(f->right, &track->right[track->pcmOffset[i]], f->numSamples * sizeof(int16_t));
+	dec.pos			= track->posAfter[i];
+	f->posAfter		= dec.pos;
+	return true;
+}
+
+/******************************************************************************
+ Decoder
+******************************************************************************/
+
+static bool EndOfBuffer()
+{
+	return dec.pos >= dec.size - HDR_SIZE;
+}
+
+// Decodes the frame at the current position. Returns false if the stream has ended.
+static bool DecodeFrame(Frame *f)
+{
+	if (dec.ended || !dec.buffer)
+		return false;
+
+	if (ServeFromCache(f))
+		return true;
+
+	// Start recording a looping track when playing from its beginning
+	if (cacheMaxBytes && dec.loop && dec.pos == 0 && !dec.recording && !FindTrack(dec.buffer, dec.size)) {
+		dec.recording = new CachedTrack();
+		dec.recording->buffer = dec.buffer;
+		dec.recording->size = dec.size;
+	}
+
+	int framePos = dec.pos;
+	int numSamples = 0;
+	dec.info.frame_bytes = 0;
+	if (dec.pos >= 0 && dec.pos < dec.size) {
+		numSamples = mp3dec_decode_frame(
+			&dec.mp3d,
+			dec.buffer + dec.pos,
+			dec.size - dec.pos,
+			dec.pcm,
+			&dec.info);
+	}
+
+	if (dec.info.frame_bytes == 0) {
+		// no more valid frames in buffer
+		AbortRecording();
+		if (dec.loop && dec.pos != 0) {
+			dec.pos = 0;
+			return DecodeFrame(f);
+		}
+		dec.ended = true;
+		return false;
+	}
+
+	int numChans = dec.info.channels;
+	for (int i = 0; i < numSamples; i++) {
+		f->left[i]	= dec.pcm[i * numChans];
+		f->right[i]	= dec.pcm[i * numChans + numChans - 1];
+	}
+	f->numSamples = numSamples;
+
+	dec.pos += dec.info.frame_bytes;
+
+	// check end of buffer handling
+	bool wrapped = false;
+	if (EndOfBuffer()) {
+		if (dec.loop) {
+			dec.pos = 0;
+			wrapped = true;
+		}
+		else {
+			dec.ended = true;
+		}
+	}
+	f->posAfter = dec.pos;
+
+	if (dec.recording)
+		RecordFrame(framePos, f);
+	if (dec.recording) {
+		if (wrapped)
+			CommitRecording();
+		else if (dec.ended)
+			AbortRecording();
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ Prefetch Worker
+******************************************************************************/
+
+static int WorkerThread(void *data)
+{
+	ringMutex->Lock();
+	while (!quit) {
+		if (ringCount == RING_FRAMES || dec.ended || !dec.buffer) {
+			workerCond->Wait(ringMutex);
+			continue;
+		}
+
+		// Decode next frame outside of lock (control functions wait for us)
+		Frame *f = &ring[(ringRead + ringCount) % RING_FRAMES];
+		decoding = true;
+		ringMutex->Unlock();
+		bool ok = DecodeFrame(f);
+		ringMutex->Lock();
+		decoding = false;
+		if (ok)
+			ringCount++;
+		readyCond->SignalAll();
+	}
+	ringMutex->Unlock();
+	return 0;
+}
+
+// Takes ownership of decoder from worker (if running)
+static void BeginControl()
+{
+	if (!workerThread)
+		return;
+	ringMutex->Lock();
+	while (decoding)
+		readyCond->Wait(ringMutex);
+}
+
+// Discards frames decoded ahead and hands decoder back to worker
+static void EndControl(bool flush)
+{
+	if (!workerThread)
+		return;
+	if (flush)
+		ringCount = 0;
+	workerCond->Signal();
+	ringMutex->Unlock();
+}
+
+// Fetches next frame to play. Returns false if the stream has ended.
+static bool NextFrame(Frame *f)
+{
+	if (!workerThread)
+		return DecodeFrame(f);
+
+	ringMutex->Lock();
+	while (ringCount == 0 && (decoding || (!dec.ended && dec.buffer)))
+		readyCond->Wait(ringMutex);
+	bool ok = ringCount > 0;
+	if (ok) {
+		const Frame *src = &ring[ringRead];
+		f->numSamples	= src->numSamples;
+		f->posAfter		= src->posAfter;
+		memcpy(f->left, src->left, src->numSamples * sizeof(int16_t));
+		memcpy(f->right, src->right, src->numSamples * sizeof(int16_t));
+		ringRead = (ringRead + 1) % RING_FRAMES;
+		ringCount--;
+		workerCond->Signal();
+	}
+	ringMutex->Unlock();
+	return ok;
+}
+
+/******************************************************************************
+ Interface
+******************************************************************************/
+
+void MpegDec::Configure(bool prefetch, unsigned cacheSizeMB)
+{
+	Shutdown();
+
+	cacheMaxBytes = (size_t)cacheSizeMB * 0x100000;
+
+	if (!prefetch)
+		return;
+
+	ringRead = ringCount = 0;
+	decoding = false;
+	quit = false;
+	ringMutex = CThread::CreateMutex();
+	if (ringMutex == NULL)
+		goto ThreadError;
+	workerCond = CThread::CreateCondVar();
+	if (workerCond == NULL)
+		goto ThreadError;
+	readyCond = CThread::CreateCondVar();
+	if (readyCond == NULL)
+		goto ThreadError;
+	workerThread = CThread::CreateThread("MPEGDecoder", WorkerThread, NULL);
+	if (workerThread == NULL)
+		goto ThreadError;
+	return;
+
+ThreadError:
+	ErrorLog("Unable to create MPEG decoder thread: %s\nDecoding MPEG audio on sound board thread instead.\n", CThread::GetLastError());
+	Shutdown();
+}
+
+void MpegDec::Shutdown()
+{
+	if (workerThread) {
+		ringMutex->Lock();
+		quit = true;
+		workerCond->Signal();
+		ringMutex->Unlock();
+		workerThread->Wait();
+		delete workerThread;
+		workerThread = NULL;
+	}
+	delete readyCond;
+	delete workerCond;
+	delete ringMutex;
+	readyCond = NULL;
+	workerCond = NULL;
+	ringMutex = NULL;
+	ringRead = ringCount = 0;
+
+	ClearCache();
+	dec.buffer	= nullptr;
+	dec.ended	= false;
+	cur.numSamples = 0;
+	curPos		= 0;
+	position	= 0;
+	loaded		= false;
+	stopped		= false;
+}
+
 void MpegDec::SetMemory(const uint8_t *data, int length, bool loop)
 {
+	BeginControl();
 	mp3dec_init(&dec.mp3d);
-
+	AbortRecording();
 	dec.buffer		= data;
 	dec.size		= length;
 	dec.pos			= 0;
-	dec.numSamples	= 0;
-	dec.pcmPos		= 0;
 	dec.loop		= loop;
-	dec.stopped		= false;
+	dec.ended		= false;
+	EndControl(true);
+
+	cur.numSamples	= 0;
+	curPos			= 0;
+	position		= 0;
+	loaded			= data != nullptr;
+	stopped			= false;
 }
 
 void MpegDec::UpdateMemory(const uint8_t* data, int length, bool loop)
@@ -40,33 +421,36 @@ void MpegDec::UpdateMemory(const uint8_t* data, int length, bool loop)
 		diff = -(int)(dec.buffer - data);
 	}
 
-	dec.buffer	= data;
-	dec.size	= length;
-	dec.pos		= dec.pos - diff;		// update position relative to our new start location
-	dec.loop	= loop;
+	position = position - diff;		// update position relative to our new start location
+
+	BeginControl();
+	bool changed = diff != 0 || length != dec.size || loop != dec.loop;
+	if (changed) {
+		AbortRecording();
+		dec.buffer	= data;
+		dec.size	= length;
+		dec.pos		= position;		// resume decoding from frame being played
+		dec.loop	= loop;
+		dec.ended	= false;
+	}
+	EndControl(changed);
+	loaded = data != nullptr;
 }
 
 int MpegDec::GetPosition()
 {
-	return (int)dec.pos;
+	return position;
 }
 
 void MpegDec::SetPosition(int pos)
 {
-	dec.pos = pos;
-}
+	BeginControl();
+	AbortRecording();
+	dec.pos		= pos;
+	dec.ended	= false;
+	EndControl(true);
 
-static void FlushBuffer(int16_t*& left, int16_t*& right, int& numStereoSamples)
-{
-	int numChans = dec.info.channels;
-
-	int &i = dec.pcmPos;
-
-	for (; i < (dec.numSamples * numChans) && numStereoSamples; i += numChans) {
-		*left++ = dec.pcm[i];
-		*right++ = dec.pcm[i + numChans - 1];
-		numStereoSamples--;
-	}
+	position = pos;
 }
 
 // might need to copy some silence to end the buffer if we aren't looping
@@ -80,57 +464,41 @@ static void EndWithSilence(int16_t*& left, int16_t*& right, int& numStereoSample
 	}
 }
 
-static bool EndOfBuffer()
-{
-	return dec.pos >= dec.size - HDR_SIZE;
-}
-
 void MpegDec::Stop()
 {
-	dec.stopped = true;
+	stopped = true;
 }
 
 bool MpegDec::IsLoaded()
 {
-	return dec.buffer != nullptr;
+	return loaded;
 }
 
 void MpegDec::DecodeAudio(int16_t* left, int16_t* right, int numStereoSamples)
 {
 	// if we are stopped return silence
-	if (dec.stopped || !dec.buffer) {
+	if (stopped || !loaded) {
 		EndWithSilence(left, right, numStereoSamples);
 	}
 
-	// copy any left over samples first
-	FlushBuffer(left, right, numStereoSamples);
-
 	while (numStereoSamples) {
 
-		dec.numSamples = mp3dec_decode_frame(
-			&dec.mp3d,
-			dec.buffer + dec.pos,
-			dec.size - dec.pos,
-			dec.pcm,
-			&dec.info);
-
-		dec.pos += dec.info.frame_bytes;
-		dec.pcmPos = 0;	// reset pos
-
-		FlushBuffer(left, right, numStereoSamples);
-
-		// check end of buffer handling
-		if (EndOfBuffer()) {
-			if (dec.loop) {
-				dec.pos = 0;
-			}
-			else {
+		// fetch next frame once all samples of current one have been played
+		if (curPos >= cur.numSamples) {
+			if (!NextFrame(&cur)) {
 				EndWithSilence(left, right, numStereoSamples);
+				break;
 			}
+			curPos = 0;
+			position = cur.posAfter;
 		}
 
+		int n = std::min(numStereoSamples, cur.numSamples - curPos);
+		memcpy(left, &cur.left[curPos], n * sizeof(int16_t));
+		memcpy(right, &cur.right[curPos], n * sizeof(int16_t));
+		left += n;
+		right += n;
+		curPos += n;
+		numStereoSamples -= n;
 	}
-
 }
-
-
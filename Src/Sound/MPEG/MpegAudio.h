@@ -5,6 +5,10 @@
 
 namespace MpegDec
 {
+	// Selects whether frames are decoded ahead on a worker thread and how much
+	// memory (in MB, 0 to disable) may be used to cache decoded looping tracks
+	void	Configure(bool prefetch, unsigned cacheSizeMB);
+	void	Shutdown();
 	void	SetMemory(const uint8_t *data, int length, bool loop);
 	void	UpdateMemory(const uint8_t *data, int length, bool loop);
 	int		GetPosition();
@@ -0,0 +1,246 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * Resampler.cpp
+ *
+ * Polyphase windowed-sinc resampler.
+ *
+ * Description
+ * -----------
+ *
+ * Converting from fin to fout is equivalent to up-sampling by L, low-pass
+ * filtering, and down-sampling by M, where L/M = fout/fin reduced to lowest
+ * terms. Only one in every M of the up-sampled outputs is ever needed, and of
+ * the filter taps only those landing on original (non-zero) input samples
+ * contribute, so the filter is split into L "phases" of NUM_TAPS taps. Each
+ * output sample is then the dot product of one phase with NUM_TAPS consecutive
+ * input samples. After each output, the phase advances by M and every time it
+ * wraps past L, the input window moves forward by one sample.
+ *
+ * The prototype filter is a sinc with its cut-off just below the lower of the
+ * two Nyquist frequencies, shaped by a Kaiser window. Each phase is normalized
+ * to unity DC gain so that the phases agree exactly on constant signals.
+ *
+ * When fin == fout, the single phase is a unit impulse and input is copied
+ * directly (with the same delay as the filtered path).
+ *
+ * The dot products are computed four taps at a time with SSE when available.
+ */
+
+#include "Supermodel.h"
+#include "Sound/Resampler.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define RESAMPLER_SSE
+#include <xmmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Cut-off as a fraction of the lower Nyquist frequency and Kaiser window shape
+#define CUTOFF		0.90
+#define KAISER_BETA	7.0
+
+static unsigned GCD(unsigned a, unsigned b)
+{
+	while (b != 0)
+	{
+		unsigned t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+// Zeroth-order modified Bessel function of the first kind (series expansion)
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	double halfX = x / 2.0;
+	for (int k = 1; k < 32; k++)
+	{
+		term *= halfX / k;
+		sum += term * term;
+		if (term * term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+void CResampler::Configure(unsigned inRate, unsigned outRate)
+{
+	unsigned gcd = GCD(inRate, outRate);
+	m_upFactor = outRate / gcd;
+	m_downFactor = inRate / gcd;
+
+	// Build filter bank. Tap k of phase p sits at time (NUM_TAPS/2 - 1 + p/L - k), in input samples, from the output sample.
+	m_coeffs.resize(m_upFactor * NUM_TAPS);
+	double cutoff = (outRate < inRate ? (double)outRate / (double)inRate : 1.0) * CUTOFF;
+	if (inRate == outRate)
+		cutoff = 1.0;
+	double i0Beta = BesselI0(KAISER_BETA);
+	for (unsigned p = 0; p < m_upFactor; p++)
+	{
+		float *phase = &m_coeffs[p * NUM_TAPS];
+		double sum = 0.0;
+		for (unsigned k = 0; k < NUM_TAPS; k++)
+		{
+			double t = (double)(NUM_TAPS/2 - 1) + (double)p / (double)m_upFactor - (double)k;
+			double x = M_PI * cutoff * t;
+			double sinc = (fabs(x) < 1e-9) ? 1.0 : sin(x) / x;
+			double r = t / (double)(NUM_TAPS/2);
+			double window = (fabs(r) >= 1.0) ? 0.0 : BesselI0(KAISER_BETA * sqrt(1.0 - r * r)) / i0Beta;
+			double h = sinc * window;
+			phase[k] = (float)h;
+			sum += h;
+		}
+		for (unsigned k = 0; k < NUM_TAPS; k++)
+			phase[k] = (float)(phase[k] / sum);
+	}
+
+	Reset();
+}
+
+void CResampler::Reset(void)
+{
+	// Queue NUM_TAPS-1 samples of silence so that the first output has a complete filter history
+	m_phase = 0;
+	m_readIdx = 0;
+	m_writeIdx = NUM_TAPS - 1;
+	if (m_inL.size() < m_writeIdx)
+	{
+		m_inL.resize(m_writeIdx);
+		m_inR.resize(m_writeIdx);
+	}
+	std::fill(m_inL.begin(), m_inL.begin() + m_writeIdx, 0.0f);
+	std::fill(m_inR.begin(), m_inR.begin() + m_writeIdx, 0.0f);
+}
+
+unsigned CResampler::InputNeeded(unsigned numOut) const
+{
+	if (numOut == 0)
+		return 0;
+
+	// Input window of last output sample must lie entirely within queued input
+	UINT64 lastIdx = m_readIdx + ((UINT64)m_phase + (UINT64)(numOut - 1) * m_downFactor) / m_upFactor;
+	UINT64 needed = lastIdx + NUM_TAPS;
+	return needed > m_writeIdx ? (unsigned)(needed - m_writeIdx) : 0;
+}
+
+void CResampler::Write(const INT16 *inL, const INT16 *inR, unsigned numIn)
+{
+	if (m_writeIdx + numIn > m_inL.size())
+	{
+		m_inL.resize(m_writeIdx + numIn);
+		m_inR.resize(m_writeIdx + numIn);
+	}
+	float *dstL = &m_inL[m_writeIdx];
+	float *dstR = &m_inR[m_writeIdx];
+	for (unsigned i = 0; i < numIn; i++)
+	{
+		dstL[i] = (float)inL[i];
+		dstR[i] = (float)inR[i];
+	}
+	m_writeIdx += numIn;
+}
+
+void CResampler::ReadAndMix(INT32 *mixL, INT32 *mixR, unsigned numOut, float gainL, float gainR)
+{
+	const float *inL = m_inL.data();
+	const float *inR = m_inR.data();
+	unsigned i = 0;
+
+	if (m_upFactor == 1 && m_downFactor == 1)
+	{
+		// Same rate: copy through with the same delay as the filter (centre tap)
+		for (; i < numOut && m_readIdx + NUM_TAPS <= m_writeIdx; i++, m_readIdx++)
+		{
+			mixL[i] += (INT32)lrintf(inL[m_readIdx + NUM_TAPS/2 - 1] * gainL);
+			mixR[i] += (INT32)lrintf(inR[m_readIdx + NUM_TAPS/2 - 1] * gainR);
+		}
+	}
+	else
+	{
+		for (; i < numOut && m_readIdx + NUM_TAPS <= m_writeIdx; i++)
+		{
+			const float *h = &m_coeffs[m_phase * NUM_TAPS];
+			const float *xL = &inL[m_readIdx];
+			const float *xR = &inR[m_readIdx];
+			float sumL, sumR;
+#ifdef RESAMPLER_SSE
+			__m128 accL = _mm_setzero_ps();
+			__m128 accR = _mm_setzero_ps();
+			for (unsigned k = 0; k < NUM_TAPS; k += 4)
+			{
+				__m128 c = _mm_loadu_ps(&h[k]);
+				accL = _mm_add_ps(accL, _mm_mul_ps(c, _mm_loadu_ps(&xL[k])));
+				accR = _mm_add_ps(accR, _mm_mul_ps(c, _mm_loadu_ps(&xR[k])));
+			}
+			// Horizontal sums: interleave partial sums of both channels and add pairwise
+			__m128 lo = _mm_unpacklo_ps(accL, accR);	// L0 R0 L1 R1
+			__m128 hi = _mm_unpackhi_ps(accL, accR);	// L2 R2 L3 R3
+			__m128 sum = _mm_add_ps(lo, hi);
+			sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+			float result[4];
+			_mm_storeu_ps(result, sum);
+			sumL = result[0];
+			sumR = result[1];
+#else
+			sumL = 0.0f;
+			sumR = 0.0f;
+			for (unsigned k = 0; k < NUM_TAPS; k++)
+			{
+				sumL += h[k] * xL[k];
+				sumR += h[k] * xR[k];
+			}
+#endif
+			mixL[i] += (INT32)lrintf(sumL * gainL);
+			mixR[i] += (INT32)lrintf(sumR * gainR);
+
+			// Advance phase and, each time it wraps, the input window
+			m_phase += m_downFactor;
+			while (m_phase >= m_upFactor)
+			{
+				m_phase -= m_upFactor;
+				m_readIdx++;
+			}
+		}
+	}
+
+	// Move unprocessed input (history of next output onwards) back to start of buffer
+	unsigned remaining = m_writeIdx - m_readIdx;
+	std::copy(m_inL.begin() + m_readIdx, m_inL.begin() + m_writeIdx, m_inL.begin());
+	std::copy(m_inR.begin() + m_readIdx, m_inR.begin() + m_writeIdx, m_inR.begin());
+	m_readIdx = 0;
+	m_writeIdx = remaining;
+}
+
+CResampler::CResampler(void)
+{
+	Configure(44100, 44100);
+}
@@ -0,0 +1,122 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * Resampler.h
+ *
+ * Header file for the polyphase windowed-sinc resampler used to convert the
+ * sound board (SCSP) and Digital Sound Board (MPEG) streams to the audio
+ * output sample rate.
+ */
+
+#ifndef INCLUDED_RESAMPLER_H
+#define INCLUDED_RESAMPLER_H
+
+#include "Types.h"
+#include <vector>
+
+/*
+ * CResampler:
+ *
+ * Streaming stereo resampler. Input samples are queued with Write() and
+ * output is produced frame by frame with ReadAndMix(), which scales the
+ * resampled signal and adds it into 32-bit mix buffers so that several
+ * streams can be combined before the final mix is clipped to 16 bits.
+ *
+ * The ratio between input and output rates is reduced to a fraction L/M and
+ * a bank of L filter phases, each NUM_TAPS long, is precomputed from a
+ * Kaiser-windowed sinc. Unprocessed input (including the filter history) is
+ * retained between frames so that there are no discontinuities.
+ */
+class CResampler
+{
+public:
+	/*
+	 * Configure(inRate, outRate):
+	 *
+	 * Builds the filter bank for the given conversion and resets the stream.
+	 *
+	 * Parameters:
+	 *		inRate	Input sampling frequency in Hz.
+	 *		outRate	Output sampling frequency in Hz.
+	 */
+	void Configure(unsigned inRate, unsigned outRate);
+
+	/*
+	 * Reset(void):
+	 *
+	 * Discards all queued input and restarts the stream with silence.
+	 */
+	void Reset(void);
+
+	/*
+	 * InputNeeded(numOut):
+	 *
+	 * Returns the number of input samples that must still be written before
+	 * numOut output samples can be produced.
+	 */
+	unsigned InputNeeded(unsigned numOut) const;
+
+	/*
+	 * Write(inL, inR, numIn):
+	 *
+	 * Queues input samples.
+	 *
+	 * Parameters:
+	 *		inL		Left channel input.
+	 *		inR		Right channel input.
+	 *		numIn	Number of samples in each channel.
+	 */
+	void Write(const INT16 *inL, const INT16 *inR, unsigned numIn);
+
+	/*
+	 * ReadAndMix(mixL, mixR, numOut, gainL, gainR):
+	 *
+	 * Produces output samples, scales them and adds them into the mix
+	 * buffers. If not enough input has been queued, the remaining output is
+	 * treated as silence.
+	 *
+	 * Parameters:
+	 *		mixL	Left channel mix buffer.
+	 *		mixR	Right channel mix buffer.
+	 *		numOut	Number of samples to produce in each channel.
+	 *		gainL	Gain applied to left channel (1.0 is unity).
+	 *		gainR	Gain applied to right channel.
+	 */
+	void ReadAndMix(INT32 *mixL, INT32 *mixR, unsigned numOut, float gainL, float gainR);
+
+	CResampler(void);
+
+private:
+	static const unsigned NUM_TAPS = 32;	// filter length per phase (multiple of 4 for SIMD)
+
+	unsigned			m_upFactor;			// L: number of filter phases
+	unsigned			m_downFactor;		// M: phase increment per output sample
+	unsigned			m_phase;			// current filter phase (0 to L-1)
+	std::vector<float>	m_coeffs;			// L phases of NUM_TAPS coefficients each
+	std::vector<float>	m_inL, m_inR;		// queued input, including filter history
+	unsigned			m_readIdx;			// first input sample used by next output
+	unsigned			m_writeIdx;			// position at which next input is queued
+};
+
+
+#endif	// INCLUDED_RESAMPLER_H
@@ -57,7 +57,7 @@
 #include <cmath>
 #include "Sound/SCSPDSP.h"
 
-static const Util::Config::Node *s_config = 0;
+static std::unique_ptr<Util::Config::Handle<float>> s_balance;  // read every frame
 static bool s_multiThreaded = false;
 
 //#define NEWSCSP
@@ -557,7 +557,7 @@ void SCSP_StopSlot(_SLOT *slot,int keyoff)
 
 bool SCSP_Init(const Util::Config::Node &config, int n)
 {
-	s_config = &config;
+	s_balance.reset(new Util::Config::Handle<float>(config["Balance"]));
 	s_multiThreaded = config["MultiThreaded"].ValueAs<bool>();
 
 	if(n==2)
@@ -1776,7 +1776,7 @@ void SCSP_DoMasterSamples(int nsamples)
 	 * When one SCSP is fully attenuated, the other's samples will be multiplied
 	 * by 2.
 	 */
-	float balance = (float) s_config->Get("Balance").ValueAs<float>();
+	float balance = s_balance->Get();
 	if (balance < -100.0f)
 	  balance = -100.0f;
   else if (balance > 100.0f)
@@ -1934,6 +1934,16 @@ void SCSP_DoMasterSamples(int nsamples)
 
 void SCSP_Update()
 {
+	PROFILE_SCOPE("SCSP");
+	if (Util::PerfCounters::IsEnabled())
+	{
+		unsigned activeSlots = 0;
+		for (int n = 0; n < MAX_SCSP; n++)
+			for (int sl = 0; sl < 32; sl++)
+				activeSlots += SCSPs[n].Slots[sl].active ? 1 : 0;
+		Util::PerfCounters::Add(Util::PerfCounters::SCSPUpdates);
+		Util::PerfCounters::Add(Util::PerfCounters::SCSPActiveSlots, activeSlots);
+	}
 	SCSP_DoMasterSamples(length);
 }
 
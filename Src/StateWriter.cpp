@@ -0,0 +1,63 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * StateWriter.cpp
+ *
+ * Background save state writer. Implementation of the CStateWriter class.
+ */
+
+#include "Supermodel.h"
+#include "StateWriter.h"
+
+void CStateWriter::WriteThread(void)
+{
+  if (OKAY != CBlockFile::WriteCompressed(m_file, m_state.data(), m_state.size()))
+    ErrorLog("Unable to save state to '%s'.", m_file.c_str());
+  else
+  {
+    printf("Saved state to '%s'.\n", m_file.c_str());
+    DebugLog("Saved state to '%s'.\n", m_file.c_str());
+  }
+  m_state.clear();
+  m_state.shrink_to_fit();
+}
+
+void CStateWriter::Write(const std::string &file, std::vector<uint8_t> *state)
+{
+  Wait();
+  m_file = file;
+  m_state.swap(*state);
+  state->clear();
+  m_thread = std::thread(&CStateWriter::WriteThread, this);
+}
+
+void CStateWriter::Wait(void)
+{
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+CStateWriter::~CStateWriter(void)
+{
+  Wait();
+}
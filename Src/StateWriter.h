@@ -0,0 +1,85 @@
+/**
+ ** Supermodel
+ ** A Sega Model 3 Arcade Emulator.
+ ** Copyright 2011-2019 Bart Trzynadlowski, Nik Henson, Ian Curtis,
+ **                     Harry Tuttle, and Spindizzi
+ **
+ ** This file is part of Supermodel.
+ **
+ ** Supermodel is free software: you can redistribute it and/or modify it under
+ ** the terms of the GNU General Public License as published by the Free
+ ** Software Foundation, either version 3 of the License, or (at your option)
+ ** any later version.
+ **
+ ** Supermodel is distributed in the hope that it will be useful, but WITHOUT
+ ** ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along
+ ** with Supermodel.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*
+ * StateWriter.h
+ *
+ * Header file for the background save state writer.
+ */
+
+#ifndef INCLUDED_STATEWRITER_H
+#define INCLUDED_STATEWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * CStateWriter:
+ *
+ * Compresses and writes save states on a background thread so that the
+ * emulator is only held up for as long as it takes to serialize the state
+ * into memory. One write is in flight at a time; submitting another waits
+ * for the previous one to finish.
+ */
+class CStateWriter
+{
+public:
+  /*
+   * Write(file, state):
+   *
+   * Begins writing a save state. The state is compressed with
+   * CBlockFile::WriteCompressed().
+   *
+   * Parameters:
+   *    file    File path.
+   *    state   Block file contents. Ownership of the data is taken over and
+   *            the vector is left empty.
+   */
+  void Write(const std::string &file, std::vector<uint8_t> *state);
+
+  /*
+   * Wait(void):
+   *
+   * Waits for any write in progress to complete. Must be called before
+   * reading back a file that may still be being written.
+   */
+  void Wait(void);
+
+  /*
+   * ~CStateWriter(void):
+   *
+   * Destructor. Waits for any write in progress.
+   */
+  ~CStateWriter(void);
+
+private:
+  void WriteThread(void);
+
+  std::thread           m_thread;
+  std::string           m_file;
+  std::vector<uint8_t>  m_state;
+};
+
+
+#endif  // INCLUDED_STATEWRITER_H
@@ -27,7 +27,7 @@
  
 #ifndef INCLUDED_SUPERMODEL_H
 #define INCLUDED_SUPERMODEL_H
-#ifdef NET_BOARD
+#if defined(NET_BOARD) && defined(SUPERMODEL_WIN32)
 #include "Winsock2.h" // force include winsock2 before windows.h because conflict with winsock1
 #endif
 // Used throughout Supermodel
@@ -67,6 +67,15 @@
 	#define rotl(val, shift) val = (val>>shift)|(val<<(32-shift))
 #endif
 
+// _rotl() itself is a VS intrinsic; provide it elsewhere
+#ifndef _MSC_VER
+static inline unsigned _rotl(unsigned value, int shift)
+{
+	shift &= 31;
+	return shift ? (value << shift) | (value >> (32 - shift)) : value;
+}
+#endif
+
 /* 
  * Fundamental Data Types:
  *
@@ -114,6 +123,8 @@
 ******************************************************************************/
 
 #include "BlockFile.h"
+#include "Util/Profiler.h"
+#include "Util/PerfCounters.h"
 #include "Graphics/New3D/New3D.h"
 #include "Graphics/Render2D.h"
 #include "Graphics/Legacy3D/TextureRefs.h"
@@ -133,6 +144,7 @@
 #include "Inputs/Input.h"
 #include "Inputs/Inputs.h"
 #include "Inputs/InputSource.h"
+#include "Inputs/InputProgram.h"
 #include "Inputs/InputSystem.h"
 #include "Inputs/InputTypes.h"
 #include "Inputs/MultiInputSource.h"
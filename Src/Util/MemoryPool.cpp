@@ -0,0 +1,149 @@
+#include "Util/MemoryPool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#else
+#include <atomic>
+#include <cstdio>
+#endif
+#endif
+
+namespace Util
+{
+#ifndef _WIN32
+  static size_t PageSize()
+  {
+    long page_size = sysconf(_SC_PAGESIZE);
+    return page_size > 0 ? size_t(page_size) : 4096;
+  }
+
+  static bool IsPageAligned(size_t value)
+  {
+    return (value % PageSize()) == 0;
+  }
+
+  // Anonymous shared memory object that can be mapped more than once
+  static int CreateSharedMemory(size_t size)
+  {
+    int fd = -1;
+#if defined(__linux__) && defined(SYS_memfd_create)
+    fd = int(syscall(SYS_memfd_create, "supermodel", 1u /* MFD_CLOEXEC */));
+#elif !defined(__linux__)
+    static std::atomic<unsigned> counter(0);
+    char name[64];
+    snprintf(name, sizeof(name), "/supermodel-%d-%u", int(getpid()), counter++);
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+      shm_unlink(name);
+#endif
+    if (fd >= 0 && ftruncate(fd, off_t(size)) != 0)
+    {
+      close(fd);
+      fd = -1;
+    }
+    return fd;
+  }
+
+  // Puts back private zero pages over a range
+  static void ResetRange(uint8_t *addr, size_t size)
+  {
+    mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  }
+#endif
+
+  bool MemoryPool::Allocate(size_t size)
+  {
+    Free();
+#ifdef _WIN32
+    // Committed pages are demand-zero and only backed once touched
+    void *base = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (NULL == base)
+      return true;
+    m_base = reinterpret_cast<uint8_t *>(base);
+#else
+    // Over-allocate so that the base can be aligned for huge pages, then trim
+    size = (size + PageSize() - 1) & ~(PageSize() - 1);
+    size_t reserve_size = size + ALIGNMENT;
+    void *reserved = mmap(NULL, reserve_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == reserved)
+      return true;
+    uintptr_t start = reinterpret_cast<uintptr_t>(reserved);
+    uintptr_t aligned = (start + ALIGNMENT - 1) & ~uintptr_t(ALIGNMENT - 1);
+    size_t head = aligned - start;
+    size_t tail = reserve_size - head - size;
+    if (head)
+      munmap(reserved, head);
+    if (tail)
+      munmap(reinterpret_cast<void *>(aligned + size), tail);
+    m_base = reinterpret_cast<uint8_t *>(aligned);
+#endif
+    m_size = size;
+    return false;
+  }
+
+  void MemoryPool::Free()
+  {
+    if (!m_base)
+      return;
+#ifdef _WIN32
+    VirtualFree(m_base, 0, MEM_RELEASE);
+#else
+    munmap(m_base, m_size);
+#endif
+    m_base = nullptr;
+    m_size = 0;
+  }
+
+  bool MemoryPool::Mirror(size_t dest_offset, size_t src_offset, size_t size)
+  {
+#ifdef _WIN32
+    (void) dest_offset;
+    (void) src_offset;
+    (void) size;
+    return true;
+#else
+    if (!m_base || !size || !IsPageAligned(dest_offset) || !IsPageAligned(src_offset) || !IsPageAligned(size))
+      return true;
+    if (dest_offset + size > m_size || src_offset + size > m_size)
+      return true;
+    if (dest_offset < src_offset + size && src_offset < dest_offset + size)
+      return true;
+    int fd = CreateSharedMemory(size);
+    if (fd < 0)
+      return true;
+    uint8_t *src = m_base + src_offset;
+    uint8_t *dest = m_base + dest_offset;
+    bool error = MAP_FAILED == mmap(src, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    if (!error)
+    {
+      error = MAP_FAILED == mmap(dest, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+      if (error)
+        ResetRange(src, size);
+    }
+    close(fd);  // mappings keep the memory alive
+    return error;
+#endif
+  }
+
+  void MemoryPool::AdviseHugePages(size_t offset, size_t size)
+  {
+#if !defined(_WIN32) && defined(MADV_HUGEPAGE)
+    if (m_base && offset + size <= m_size)
+      madvise(m_base + offset, size, MADV_HUGEPAGE);
+#else
+    (void) offset;
+    (void) size;
+#endif
+  }
+
+  MemoryPool::~MemoryPool()
+  {
+    Free();
+  }
+} // Util
@@ -0,0 +1,58 @@
+#ifndef INCLUDED_MEMORYPOOL_H
+#define INCLUDED_MEMORYPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Util
+{
+  /*
+   * Large zero-initialized allocation backed directly by virtual memory.
+   * Pages cost nothing until touched and, where the OS supports it, ranges
+   * can be mirrored (the same physical pages mapped at two offsets) and
+   * backed by transparent huge pages.
+   *
+   * Functions return true on failure.
+   */
+  class MemoryPool
+  {
+  public:
+    // Pool base is aligned to this so that huge pages can be used
+    static const size_t ALIGNMENT = 0x200000;
+
+    bool Allocate(size_t size);
+    void Free();
+
+    uint8_t *GetBase() const
+    {
+      return m_base;
+    }
+
+    size_t GetSize() const
+    {
+      return m_size;
+    }
+
+    /*
+     * Maps the range at src_offset a second time at dest_offset. Offsets and
+     * size must be page aligned. The previous contents of both ranges are
+     * discarded, so this is intended to be called before they are filled.
+     * On failure, the pool is unchanged and the caller should copy instead.
+     */
+    bool Mirror(size_t dest_offset, size_t src_offset, size_t size);
+
+    // Requests transparent huge pages for a range (a hint only)
+    void AdviseHugePages(size_t offset, size_t size);
+
+    MemoryPool() = default;
+    MemoryPool(const MemoryPool &) = delete;
+    MemoryPool &operator=(const MemoryPool &) = delete;
+    ~MemoryPool();
+
+  private:
+    uint8_t *m_base = nullptr;
+    size_t m_size = 0;
+  };
+} // Util
+
+#endif  // INCLUDED_MEMORYPOOL_H
@@ -276,6 +276,7 @@ namespace Util
       *const_cast<std::string *>(&m_key) = that.m_key;
       if (that.m_value)
         m_value = that.m_value->MakeCopy();
+      m_version.fetch_add(1, std::memory_order_release);
       for (ptr_t child = that.m_first_child; child; child = child->m_next_sibling)
       {
         ptr_t copied_child = std::make_shared<Node>(*child);
@@ -291,6 +292,8 @@ namespace Util
       m_children.swap(rhs.m_children);
      const_cast<std::string *>(&m_key)->swap(*const_cast<std::string *>(&rhs.m_key));
       m_value.swap(rhs.m_value); 
+      m_version.fetch_add(1, std::memory_order_release);
+      rhs.m_version.fetch_add(1, std::memory_order_release);
     }
 
     Node &Node::operator=(const Node &rhs)
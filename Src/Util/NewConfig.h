@@ -2,6 +2,8 @@
 #define INCLUDED_UTIL_CONFIG_H
 
 #include "Util/GenericValue.h"
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <iterator>
@@ -24,6 +26,7 @@ namespace Util
       std::map<std::string, ptr_t> m_children;
       mutable std::map<std::string, Node> m_missing_nodes;  // missing nodes from failed queries (must also be empty)
       bool m_missing = false;
+      std::atomic<uint32_t> m_version{0}; // incremented whenever the value changes (see Handle)
 
       void Destroy()
       {
@@ -171,6 +174,12 @@ namespace Util
       inline void SetValue(const std::shared_ptr<GenericValue> &value)
       {
         m_value = value;
+        m_version.fetch_add(1, std::memory_order_release);
+      }
+
+      inline uint32_t Version() const
+      {
+        return m_version.load(std::memory_order_acquire);
       }
 
       template <typename T>
@@ -205,6 +214,7 @@ namespace Util
             m_value->Set(value);
           else
             m_value = std::make_shared<ValueInstance<T>>(value);
+          m_version.fetch_add(1, std::memory_order_release);
         }
         else
           throw std::range_error(Util::Format() << "Node \"" << m_key << "\" does not exist");
@@ -312,6 +322,51 @@ namespace Util
       Node(Node &&that);
       ~Node();
     };
+
+    /*
+     * Pre-resolved reference to a setting, for code that reads it every frame.
+     * The node is looked up once, when the handle is constructed, and the
+     * converted value is cached until the node's value is next set. The node
+     * must outlive the handle.
+     *
+     * Example:
+     *
+     *    Handle<bool> throttle(config["Throttle"]);
+     *    if (throttle.Get())
+     *      ...
+     */
+    template <typename T>
+    class Handle
+    {
+    private:
+      const Node *m_node;
+      mutable std::atomic<T> m_value;
+      mutable std::atomic<uint32_t> m_version;  // node version m_value was converted from
+
+    public:
+      T Get() const
+      {
+        uint32_t version = m_node->Version();
+        if (version != m_version.load(std::memory_order_relaxed))
+        {
+          m_value.store(m_node->ValueAs<T>(), std::memory_order_relaxed);
+          m_version.store(version, std::memory_order_relaxed);
+        }
+        return m_value.load(std::memory_order_relaxed);
+      }
+
+      // Conversion is deferred to the first Get() so that handles may be
+      // created before the setting is assigned
+      Handle(const Node &node)
+        : m_node(&node),
+          m_value(T()),
+          m_version(~node.Version())
+      {
+      }
+
+      Handle(const Handle &) = delete;
+      Handle &operator=(const Handle &) = delete;
+    };
   } // Config
 } // Util
 
@@ -0,0 +1,79 @@
+#include "PerfCounters.h"
+#include "Format.h"
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <vector>
+
+namespace Util
+{
+  namespace PerfCounters
+  {
+    std::atomic<bool> g_enabled(false);
+    std::atomic<uint64_t> g_counters[NumCounters];
+    std::atomic<uint64_t> g_reads[NUM_REGIONS];
+    std::atomic<uint64_t> g_writes[NUM_REGIONS];
+
+    void SetEnabled(bool enabled)
+    {
+      g_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void Take(Snapshot *snapshot)
+    {
+      for (unsigned i = 0; i < NumCounters; i++)
+        snapshot->counters[i] = g_counters[i].load(std::memory_order_relaxed);
+      for (unsigned i = 0; i < NUM_REGIONS; i++)
+      {
+        snapshot->reads[i] = g_reads[i].load(std::memory_order_relaxed);
+        snapshot->writes[i] = g_writes[i].load(std::memory_order_relaxed);
+      }
+    }
+
+    static void AppendBusiestRegions(Util::Format *out, const char *label, const uint64_t *prev, const uint64_t *curr, double frames)
+    {
+      std::vector<std::pair<uint64_t, unsigned>> regions;
+      for (unsigned i = 0; i < NUM_REGIONS; i++)
+      {
+        if (curr[i] != prev[i])
+          regions.emplace_back(curr[i] - prev[i], i);
+      }
+      std::sort(regions.begin(), regions.end(), std::greater<std::pair<uint64_t, unsigned>>());
+      *out << ", " << label << "/frame:";
+      if (regions.empty())
+        *out << " none";
+      for (size_t i = 0; i < std::min<size_t>(regions.size(), 4); i++)
+        *out << ' ' << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << regions[i].second << std::dec << "xxxxxx=" << uint64_t(double(regions[i].first) / frames);
+    }
+
+    std::string Summarize(const Snapshot &prev, const Snapshot &curr, double seconds, bool verbose)
+    {
+      uint64_t delta[NumCounters];
+      for (unsigned i = 0; i < NumCounters; i++)
+        delta[i] = curr.counters[i] - prev.counters[i];
+      double frames = double(std::max<uint64_t>(delta[Frames], 1));
+      seconds = std::max(seconds, 1e-6);
+      uint64_t lookups = delta[ModelCacheHits] + delta[ModelCacheMisses];
+
+      Util::Format out;
+      out << std::fixed << std::setprecision(1);
+      out << double(delta[Frames]) / seconds << " FPS";
+      out << ", " << double(delta[PPCInstructions]) / seconds / 1e6 << " MIPS";
+      out << ", DMA " << double(delta[Real3DDMABytes]) / frames / 1024.0 << " KB/f";
+      out << ", sync " << double(delta[SnapshotBytes]) / frames / 1024.0 << " KB/f";
+      out << ", models " << (lookups ? 100.0 * double(delta[ModelCacheHits]) / double(lookups) : 0.0) << "% cached";
+      out << ", tex " << double(delta[TextureUploads]) / frames << "/f";
+      out << ", slots " << (delta[SCSPUpdates] ? double(delta[SCSPActiveSlots]) / double(delta[SCSPUpdates]) : 0.0);
+      out << ", underruns " << delta[AudioUnderruns];
+      if (delta[NetFramesReceived] || delta[NetFramesMissed])
+        out << ", net " << delta[NetFramesReceived] << " rx/" << delta[NetFramesLate] << " late/" << delta[NetFramesMissed] << " missed";
+      if (verbose)
+      {
+        out << ", texels " << uint64_t(double(delta[TextureTexels]) / frames) << "/f";
+        AppendBusiestRegions(&out, "reads", prev.reads, curr.reads, frames);
+        AppendBusiestRegions(&out, "writes", prev.writes, curr.writes, frames);
+      }
+      return out;
+    }
+  } // PerfCounters
+} // Util
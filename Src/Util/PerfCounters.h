@@ -0,0 +1,92 @@
+#ifndef INCLUDED_PERFCOUNTERS_H
+#define INCLUDED_PERFCOUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*
+ * Emulation performance counters (instructions executed, bus accesses by
+ * region, DMA and snapshot traffic, model and texture cache behavior, sound
+ * activity). Counters are only updated while enabled; when disabled, each
+ * counting site costs a single relaxed load and a predictable branch.
+ *
+ * Counters are cumulative. Callers take a Snapshot() periodically and
+ * subtract the previous one to obtain rates.
+ */
+
+namespace Util
+{
+  namespace PerfCounters
+  {
+    enum Counter
+    {
+      Frames,
+      PPCInstructions,
+      Real3DDMABytes,
+      SnapshotBytes,
+      ModelCacheHits,
+      ModelCacheMisses,
+      TextureUploads,
+      TextureTexels,
+      SCSPUpdates,
+      SCSPActiveSlots,  // summed over updates
+      AudioUnderruns,
+      NetFramesReceived,
+      NetFramesLate,    // arrived after their deadline and were dropped
+      NetFramesMissed,  // deadline passed with nothing received
+      NumCounters
+    };
+
+    // Bus accesses are binned by the upper 8 address bits (16 MB regions)
+    static const unsigned NUM_REGIONS = 256;
+
+    struct Snapshot
+    {
+      uint64_t counters[NumCounters];
+      uint64_t reads[NUM_REGIONS];
+      uint64_t writes[NUM_REGIONS];
+    };
+
+    extern std::atomic<bool> g_enabled;
+    extern std::atomic<uint64_t> g_counters[NumCounters];
+    extern std::atomic<uint64_t> g_reads[NUM_REGIONS];
+    extern std::atomic<uint64_t> g_writes[NUM_REGIONS];
+
+    inline bool IsEnabled()
+    {
+      return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool enabled);
+
+    inline void Add(Counter counter, uint64_t n = 1)
+    {
+      if (IsEnabled())
+        g_counters[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    inline void CountRead(uint32_t addr)
+    {
+      if (IsEnabled())
+        g_reads[addr >> 24].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void CountWrite(uint32_t addr)
+    {
+      if (IsEnabled())
+        g_writes[addr >> 24].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Take(Snapshot *snapshot);
+
+    /*
+     * Formats the difference between two snapshots taken the given number of
+     * seconds apart. The short form fits in a window title; the long form
+     * adds the busiest bus regions and is meant for the log.
+     */
+    std::string Summarize(const Snapshot &prev, const Snapshot &curr, double seconds, bool verbose);
+  } // PerfCounters
+} // Util
+
+#endif  // INCLUDED_PERFCOUNTERS_H
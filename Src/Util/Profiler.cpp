@@ -0,0 +1,110 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Util
+{
+  namespace Profiler
+  {
+    struct Event
+    {
+      const char *name;
+      uint64_t start;
+      uint64_t end;
+    };
+
+    // Per-thread ring of events. Buffers are never freed, so that events of
+    // threads that have exited can still be exported.
+    struct ThreadBuffer
+    {
+      std::string name;
+      unsigned id;
+      std::vector<Event> events;
+      size_t count = 0;   // total number of events recorded
+    };
+
+    static std::mutex s_mutex;
+    static std::vector<std::unique_ptr<ThreadBuffer>> s_threads;
+
+    static ThreadBuffer *GetThreadBuffer()
+    {
+      thread_local ThreadBuffer *buffer = nullptr;
+      if (!buffer)
+      {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_threads.emplace_back(new ThreadBuffer());
+        buffer = s_threads.back().get();
+        buffer->id = unsigned(s_threads.size());
+        buffer->name = "Thread " + std::to_string(buffer->id);
+        buffer->events.resize(EVENTS_PER_THREAD);
+      }
+      return buffer;
+    }
+
+    uint64_t Now()
+    {
+      return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void SetThreadName(const char *name)
+    {
+      ThreadBuffer *buffer = GetThreadBuffer();
+      std::lock_guard<std::mutex> lock(s_mutex);
+      buffer->name = name;
+    }
+
+    void Record(const char *name, uint64_t start, uint64_t end)
+    {
+      ThreadBuffer *buffer = GetThreadBuffer();
+      Event &event = buffer->events[buffer->count % EVENTS_PER_THREAD];
+      event.name = name;
+      event.start = start;
+      event.end = end;
+      buffer->count++;
+    }
+
+    bool WriteChromeTrace(const std::string &file)
+    {
+      FILE *fp = fopen(file.c_str(), "w");
+      if (!fp)
+        return true;
+
+      std::lock_guard<std::mutex> lock(s_mutex);
+
+      // Timestamps are relative to the earliest event still held
+      uint64_t epoch = UINT64_MAX;
+      for (auto &thread: s_threads)
+      {
+        size_t n = std::min(thread->count, EVENTS_PER_THREAD);
+        for (size_t i = 0; i < n; i++)
+          epoch = std::min(epoch, thread->events[i].start);
+      }
+
+      // Complete ("X") events, with times in microseconds
+      bool first = true;
+      fprintf(fp, "{\"traceEvents\":[\n");
+      for (auto &thread: s_threads)
+      {
+        fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", thread->id, thread->name.c_str());
+        first = false;
+        size_t n = std::min(thread->count, EVENTS_PER_THREAD);
+        size_t oldest = thread->count - n;
+        for (size_t i = oldest; i < thread->count; i++)
+        {
+          const Event &event = thread->events[i % EVENTS_PER_THREAD];
+          fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            event.name, thread->id, double(event.start - epoch) / 1e3, double(event.end - event.start) / 1e3);
+        }
+      }
+      fprintf(fp, "\n]}\n");
+
+      bool error = ferror(fp) != 0;
+      error |= fclose(fp) != 0;
+      return error;
+    }
+  } // Profiler
+} // Util
@@ -0,0 +1,75 @@
+#ifndef INCLUDED_PROFILER_H
+#define INCLUDED_PROFILER_H
+
+#include <cstdint>
+#include <string>
+
+/*
+ * Scoped-timer instrumentation. Each thread records the start time and
+ * duration (in nanoseconds) of the scopes it executes into its own ring
+ * buffer, so recording needs no locking. The most recent events of all
+ * threads can then be exported as a Chrome trace (viewable in
+ * chrome://tracing or Perfetto) to see how the threads overlap.
+ *
+ * The PROFILE_ macros compile to nothing unless SUPERMODEL_PROFILER is
+ * defined, so instrumentation may be left in place.
+ */
+
+#ifdef SUPERMODEL_PROFILER
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name)   Util::Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD(name)  Util::Profiler::SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name)   do {} while (0)
+#define PROFILE_THREAD(name)  do {} while (0)
+#endif
+
+namespace Util
+{
+  namespace Profiler
+  {
+    // Number of events kept per thread (oldest are overwritten)
+    static const size_t EVENTS_PER_THREAD = 1 << 16;
+
+    // Nanoseconds since an arbitrary epoch
+    uint64_t Now();
+
+    // Names the calling thread in the exported trace
+    void SetThreadName(const char *name);
+
+    // Records a completed scope. The name must be a string literal (or
+    // otherwise outlive the profiler) as only the pointer is stored.
+    void Record(const char *name, uint64_t start, uint64_t end);
+
+    /*
+     * Writes the recorded events of all threads as Chrome trace JSON. Threads
+     * should be idle while this is called. Returns true on failure.
+     */
+    bool WriteChromeTrace(const std::string &file);
+
+    class Scope
+    {
+    public:
+      explicit Scope(const char *name)
+        : m_name(name),
+          m_start(Now())
+      {
+      }
+
+      ~Scope()
+      {
+        Record(m_name, m_start, Now());
+      }
+
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+    private:
+      const char *m_name;
+      uint64_t m_start;
+    };
+  } // Profiler
+} // Util
+
+#endif  // INCLUDED_PROFILER_H
@@ -202,6 +202,25 @@ int main()
     test_results.push_back({ "Duplicate leaf nodes", config.ToString() == expected_config });
   }
 
+  // Handles convert the value on first use and again whenever it changes
+  {
+    Util::Config::Node config("global");
+    config.Add<std::string>("interval", "5");
+    Util::Config::Handle<unsigned> interval(config["interval"]);
+    test_results.push_back({ "Handle 1", interval.Get() == 5 });
+    config.Get("interval").SetValue<unsigned>(10);
+    test_results.push_back({ "Handle 2", interval.Get() == 10 });
+    test_results.push_back({ "Handle 3", interval.Get() == 10 });
+    config.Get("interval").SetValue("20");
+    test_results.push_back({ "Handle 4", interval.Get() == 20 });
+
+    // Created before the value is assigned
+    config.Add("volume");
+    Util::Config::Handle<unsigned> volume(config["volume"]);
+    config.Get("volume").SetValue<unsigned>(100);
+    test_results.push_back({ "Handle 5", volume.Get() == 100 });
+  }
+
   PrintTestResults(test_results);
   return 0;
 }